@@ -177,37 +177,30 @@ public:
     {
         VERIFY(count <= 32);
 
-        if (count == 32 && !m_next_byte.has_value()) { // fast path for aligned 32 bit writes
-            m_stream << bits;
+        if (m_stream.has_any_error()) {
+            set_fatal_error();
             return;
         }
 
-        size_t n_written = 0;
-        while (n_written < count) {
-            if (m_stream.has_any_error()) {
-                set_fatal_error();
-                return;
-            }
-
-            if (m_next_byte.has_value()) {
-                m_next_byte.value() |= ((bits >> n_written) & 1) << m_bit_offset;
-                ++n_written;
+        // Gather the new bits behind the pending ones and pass all the completed bytes on at once
+        size_t pending_bits = m_next_byte.has_value() ? m_bit_offset : 0;
+        u64 buffer = m_next_byte.value_or(0) | ((bits & ((1ull << count) - 1)) << pending_bits);
+        size_t total_bits = pending_bits + count;
 
-                if (m_bit_offset++ == 7) {
-                    m_stream << m_next_byte.value();
-                    m_next_byte.clear();
-                }
-            } else if (count - n_written >= 16) { // fast path for aligned 16 bit writes
-                m_stream << (u16)((bits >> n_written) & 0xFFFF);
-                n_written += 16;
-            } else if (count - n_written >= 8) { // fast path for aligned 8 bit writes
-                m_stream << (u8)((bits >> n_written) & 0xFF);
-                n_written += 8;
-            } else {
-                m_bit_offset = 0;
-                m_next_byte = 0;
-            }
+        u8 bytes[5];
+        size_t byte_count = total_bits / 8;
+        for (size_t i = 0; i < byte_count; ++i)
+            bytes[i] = buffer >> (i * 8);
+        if (byte_count > 0 && !m_stream.write_or_error(ReadonlyBytes { bytes, byte_count })) {
+            set_fatal_error();
+            return;
         }
+
+        m_bit_offset = total_bits % 8;
+        if (m_bit_offset != 0)
+            m_next_byte = buffer >> (byte_count * 8);
+        else
+            m_next_byte.clear();
     }
 
     void write_bit(bool bit)
@@ -222,6 +215,7 @@ public:
                 set_fatal_error();
             }
             m_next_byte.clear();
+            m_bit_offset = 0;
         }
     }
 
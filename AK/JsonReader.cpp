@@ -0,0 +1,279 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/CharacterTypes.h>
+#include <AK/JsonReader.h>
+#include <AK/StringBuilder.h>
+
+#if !defined(KERNEL)
+#    include <stdlib.h>
+#endif
+
+namespace AK {
+
+bool JsonToken::equals(StringView other) const
+{
+    if (!m_has_escapes)
+        return m_text == other;
+    return to_string() == other;
+}
+
+String JsonToken::to_string() const
+{
+    if (!m_has_escapes)
+        return m_text;
+
+    StringBuilder builder(m_text.length());
+    GenericLexer lexer(m_text);
+    while (!lexer.is_eof()) {
+        builder.append(lexer.consume_while([](char ch) { return ch != '\\'; }));
+        if (lexer.is_eof())
+            break;
+        lexer.ignore();
+        char escaped_ch = lexer.consume();
+        switch (escaped_ch) {
+        case 'n':
+            builder.append('\n');
+            break;
+        case 'r':
+            builder.append('\r');
+            break;
+        case 't':
+            builder.append('\t');
+            break;
+        case 'b':
+            builder.append('\b');
+            break;
+        case 'f':
+            builder.append('\f');
+            break;
+        case 'u': {
+            auto code_point = AK::StringUtils::convert_to_uint_from_hex(lexer.consume(4));
+            if (code_point.has_value())
+                builder.append_code_point(code_point.value());
+            else
+                builder.append('?');
+        } break;
+        default:
+            builder.append(escaped_ch);
+            break;
+        }
+    }
+    return builder.to_string();
+}
+
+#if !defined(KERNEL)
+double JsonToken::to_double(double default_value) const
+{
+    if (m_type != Type::Number)
+        return default_value;
+
+    // strtod() rounds correctly, which adding up the digits one scaled power of ten at a time doesn't.
+    // The text isn't null-terminated, since it points into the middle of the input, so it is copied first.
+    // Numbers are short, so only unusually long ones need the heap.
+    char buffer[64];
+    if (m_text.length() >= sizeof(buffer)) {
+        String number = m_text;
+        return strtod(number.characters(), nullptr);
+    }
+    __builtin_memcpy(buffer, m_text.characters_without_null_termination(), m_text.length());
+    buffer[m_text.length()] = '\0';
+    return strtod(buffer, nullptr);
+}
+#endif
+
+Optional<StringView> JsonReader::read_string(bool& has_escapes)
+{
+    if (!consume_specific('"')) {
+        fail();
+        return {};
+    }
+    size_t start = tell();
+    has_escapes = false;
+    for (;;) {
+        if (is_eof()) {
+            fail();
+            return {};
+        }
+        char ch = consume();
+        if (ch == '"')
+            break;
+        if (ch == '\\') {
+            has_escapes = true;
+            if (is_eof()) {
+                fail();
+                return {};
+            }
+            ignore();
+        }
+    }
+    return m_input.substring_view(start, tell() - start - 1);
+}
+
+Optional<JsonToken> JsonReader::read_name()
+{
+    bool has_escapes;
+    auto name = read_string(has_escapes);
+    if (!name.has_value())
+        return {};
+    ignore_while(is_ascii_space);
+    if (!consume_specific(':')) {
+        fail();
+        return {};
+    }
+    m_expected = Expected::Value;
+    return JsonToken { JsonToken::Type::Name, name.value(), has_escapes };
+}
+
+Optional<JsonToken> JsonReader::read_value()
+{
+    auto finish_scalar = [&](JsonToken token) -> Optional<JsonToken> {
+        if (!m_containers.is_empty()) {
+            m_expected = Expected::CommaOrEnd;
+            return token;
+        }
+        m_expected = Expected::Nothing;
+        ignore_while(is_ascii_space);
+        if (!is_eof())
+            fail();
+        return token;
+    };
+
+    char ch = peek();
+    switch (ch) {
+    case '{':
+    case '[':
+        ignore();
+        m_containers.append(ch);
+        m_expected = ch == '{' ? Expected::FirstMemberOrEnd : Expected::FirstElementOrEnd;
+        return JsonToken { ch == '{' ? JsonToken::Type::ObjectStart : JsonToken::Type::ArrayStart, m_input.substring_view(tell() - 1, 1) };
+    case '"': {
+        bool has_escapes;
+        auto string = read_string(has_escapes);
+        if (!string.has_value())
+            return {};
+        return finish_scalar({ JsonToken::Type::String, string.value(), has_escapes });
+    }
+    case 't':
+        if (!consume_specific("true"))
+            break;
+        return finish_scalar({ JsonToken::Type::True, "true" });
+    case 'f':
+        if (!consume_specific("false"))
+            break;
+        return finish_scalar({ JsonToken::Type::False, "false" });
+    case 'n':
+        if (!consume_specific("null"))
+            break;
+        return finish_scalar({ JsonToken::Type::Null, "null" });
+    default: {
+        // -?digits(.digits)?([eE][+-]?digits)?
+        size_t start = tell();
+        consume_specific('-');
+        if (!is_ascii_digit(peek()))
+            break;
+        ignore_while(is_ascii_digit);
+        if (consume_specific('.')) {
+            if (!is_ascii_digit(peek()))
+                break;
+            ignore_while(is_ascii_digit);
+        }
+        if (next_is('e') || next_is('E')) {
+            ignore();
+            if (!consume_specific('+'))
+                consume_specific('-');
+            if (!is_ascii_digit(peek()))
+                break;
+            ignore_while(is_ascii_digit);
+        }
+        return finish_scalar({ JsonToken::Type::Number, m_input.substring_view(start, tell() - start) });
+    }
+    }
+
+    fail();
+    return {};
+}
+
+Optional<JsonToken> JsonReader::close_container(char ch)
+{
+    VERIFY(!m_containers.is_empty());
+    auto container = m_containers.take_last();
+    if ((container == '{' && ch != '}') || (container == '[' && ch != ']')) {
+        fail();
+        return {};
+    }
+    ignore();
+    JsonToken token { ch == '}' ? JsonToken::Type::ObjectEnd : JsonToken::Type::ArrayEnd, m_input.substring_view(tell() - 1, 1) };
+    if (!m_containers.is_empty()) {
+        m_expected = Expected::CommaOrEnd;
+        return token;
+    }
+    m_expected = Expected::Nothing;
+    ignore_while(is_ascii_space);
+    if (!is_eof())
+        fail();
+    return token;
+}
+
+Optional<JsonToken> JsonReader::next()
+{
+    if (m_has_error)
+        return {};
+
+    ignore_while(is_ascii_space);
+    switch (m_expected) {
+    case Expected::Value:
+        return read_value();
+    case Expected::FirstElementOrEnd:
+        if (next_is(']'))
+            return close_container(']');
+        return read_value();
+    case Expected::FirstMemberOrEnd:
+        if (next_is('}'))
+            return close_container('}');
+        return read_name();
+    case Expected::CommaOrEnd:
+        if (next_is('}') || next_is(']'))
+            return close_container(peek());
+        if (!consume_specific(',')) {
+            fail();
+            return {};
+        }
+        ignore_while(is_ascii_space);
+        if (m_containers.last() == '{')
+            return read_name();
+        return read_value();
+    case Expected::Nothing:
+        return {};
+    }
+    VERIFY_NOT_REACHED();
+}
+
+bool JsonReader::skip_value()
+{
+    auto token = next();
+    if (!token.has_value())
+        return false;
+    if (token->type() == JsonToken::Type::Name)
+        return fail();
+    if (!token->is_container_start())
+        return true;
+
+    auto depth = m_containers.size();
+    while (m_containers.size() >= depth) {
+        if (!next().has_value())
+            return false;
+    }
+    return true;
+}
+
+bool JsonReader::at_array_end()
+{
+    ignore_while(is_ascii_space);
+    return (m_expected == Expected::FirstElementOrEnd || m_expected == Expected::CommaOrEnd) && next_is(']');
+}
+
+}
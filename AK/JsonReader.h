@@ -0,0 +1,191 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/GenericLexer.h>
+#include <AK/Optional.h>
+#include <AK/String.h>
+#include <AK/StringView.h>
+#include <AK/Vector.h>
+
+namespace AK {
+
+// A single token of a JSON document. Its text points into the input of the reader it came from,
+// and strings are only unescaped (and numbers only parsed) when asked for.
+class JsonToken {
+public:
+    enum class Type {
+        ObjectStart,
+        ObjectEnd,
+        ArrayStart,
+        ArrayEnd,
+        Name,
+        String,
+        Number,
+        True,
+        False,
+        Null,
+    };
+
+    JsonToken(Type type, StringView text, bool has_escapes = false)
+        : m_type(type)
+        , m_text(text)
+        , m_has_escapes(has_escapes)
+    {
+    }
+
+    Type type() const { return m_type; }
+    bool is_string() const { return m_type == Type::Name || m_type == Type::String; }
+    bool is_number() const { return m_type == Type::Number; }
+    bool is_container_start() const { return m_type == Type::ObjectStart || m_type == Type::ArrayStart; }
+
+    // The token as it appears in the input, without the quotes around names and strings.
+    StringView text() const { return m_text; }
+    bool has_escapes() const { return m_has_escapes; }
+
+    // Compares a name or string to the given text, without allocating unless the token contains escapes.
+    bool equals(StringView) const;
+
+    // The unescaped value of a name or string, the text of a number, or "true", "false" or "null".
+    String to_string() const;
+
+    int to_int(int default_value = 0) const { return to_i32(default_value); }
+    i32 to_i32(i32 default_value = 0) const { return to_number<i32>(default_value); }
+    i64 to_i64(i64 default_value = 0) const { return to_number<i64>(default_value); }
+    unsigned to_uint(unsigned default_value = 0) const { return to_u32(default_value); }
+    u32 to_u32(u32 default_value = 0) const { return to_number<u32>(default_value); }
+    u64 to_u64(u64 default_value = 0) const { return to_number<u64>(default_value); }
+#if !defined(KERNEL)
+    double to_double(double default_value = 0) const;
+#endif
+
+    bool to_bool(bool default_value = false) const
+    {
+        if (m_type == Type::True)
+            return true;
+        if (m_type == Type::False)
+            return false;
+        return default_value;
+    }
+
+    template<typename T>
+    T to_number(T default_value = 0) const
+    {
+        if (m_type != Type::Number)
+            return default_value;
+        if (m_text.contains('.') || m_text.contains('e') || m_text.contains('E')) {
+#if !defined(KERNEL)
+            return (T)to_double();
+#else
+            return default_value;
+#endif
+        }
+        if (m_text.starts_with('-')) {
+            auto number = m_text.to_int<i64>();
+            return number.has_value() ? (T)number.value() : default_value;
+        }
+        auto number = m_text.to_uint<u64>();
+        return number.has_value() ? (T)number.value() : default_value;
+    }
+
+private:
+    Type m_type;
+    StringView m_text;
+    bool m_has_escapes { false };
+};
+
+// A pull parser that hands out the tokens of a JSON document one at a time, without building a JsonValue tree.
+// The separators between tokens are checked as it goes, so a document that reads through without an error is valid.
+class JsonReader : private GenericLexer {
+public:
+    explicit JsonReader(StringView input)
+        : GenericLexer(input)
+    {
+    }
+
+    // Returns the next token, or nothing once the document is over or turned out to be invalid.
+    Optional<JsonToken> next();
+
+    // Reads past the next value, including everything inside it if it is an object or array.
+    bool skip_value();
+
+    // Reads the object that comes next, calling callback(name) for each of its members. The callback has to read
+    // (or skip) the member's value.
+    template<typename Callback>
+    bool for_each_member(Callback callback)
+    {
+        auto token = next();
+        if (!token.has_value() || token->type() != JsonToken::Type::ObjectStart)
+            return fail();
+        for (;;) {
+            token = next();
+            if (!token.has_value())
+                return false;
+            if (token->type() == JsonToken::Type::ObjectEnd)
+                return true;
+            auto depth = m_containers.size();
+            callback(token.value());
+            if (m_has_error)
+                return false;
+            if (m_containers.size() != depth || m_expected != Expected::CommaOrEnd)
+                return fail(); // the callback didn't read the whole value
+        }
+    }
+
+    // Reads the array that comes next, calling callback() for each of its elements. The callback has to read
+    // (or skip) the element.
+    template<typename Callback>
+    bool for_each_element(Callback callback)
+    {
+        auto token = next();
+        if (!token.has_value() || token->type() != JsonToken::Type::ArrayStart)
+            return fail();
+        for (;;) {
+            if (at_array_end())
+                return next().has_value();
+            auto depth = m_containers.size();
+            callback();
+            if (m_has_error)
+                return false;
+            if (m_containers.size() != depth || m_expected != Expected::CommaOrEnd)
+                return fail(); // the callback didn't read the whole element
+        }
+    }
+
+    bool has_error() const { return m_has_error; }
+    bool is_done() const { return m_expected == Expected::Nothing && !m_has_error; }
+
+private:
+    enum class Expected {
+        Value,
+        FirstElementOrEnd,
+        FirstMemberOrEnd,
+        CommaOrEnd,
+        Nothing,
+    };
+
+    Optional<JsonToken> read_name();
+    Optional<JsonToken> read_value();
+    Optional<StringView> read_string(bool& has_escapes);
+    Optional<JsonToken> close_container(char);
+    bool at_array_end();
+
+    bool fail()
+    {
+        m_has_error = true;
+        return false;
+    }
+
+    Expected m_expected { Expected::Value };
+    Vector<char, 32> m_containers; // '{' or '[' for every object or array we're inside of
+    bool m_has_error { false };
+};
+
+}
+
+using AK::JsonReader;
+using AK::JsonToken;
@@ -0,0 +1,387 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/HashTable.h>
+#include <AK/SIMD.h>
+#include <AK/StdLibExtras.h>
+#include <AK/Types.h>
+#include <AK/kmalloc.h>
+
+namespace AK {
+
+// An open-addressing hash table in the style of Abseil's "Swiss tables".
+//
+// Next to the slots, there's an array with one control byte per slot: either empty, deleted, or
+// 7 bits of the hash of what's stored in the slot. Lookups look at 16 control bytes at a time,
+// so they only compare the keys that are very likely to match, and stop at the first group with
+// an empty slot. Removal only leaves a tombstone behind if a probe might have walked past the slot.
+//
+// It has the same interface as HashTable, so SwissHashMap can stand in for HashMap.
+// Unlike HashTable, there's no ordered variant.
+
+namespace Detail {
+
+class SwissGroup {
+public:
+    static constexpr size_t width = 16;
+    static constexpr i8 empty = -128;
+    static constexpr i8 deleted = -2;
+
+    explicit SwissGroup(const i8* control) { __builtin_memcpy(&m_control, control, width); }
+
+    u32 match(i8 tag) const { return to_bitmask(m_control == splat(tag)); }
+    u32 match_empty() const { return to_bitmask(m_control == splat(empty)); }
+    // Full slots have the top bit clear.
+    u32 match_empty_or_deleted() const { return to_bitmask(m_control < splat(0)); }
+    u32 match_full() const { return ~match_empty_or_deleted() & 0xffff; }
+
+private:
+    static SIMD::i8x16 splat(i8 value)
+    {
+        SIMD::i8x16 vector {};
+        return vector + value;
+    }
+
+    static u32 to_bitmask(SIMD::i8x16 mask)
+    {
+#ifdef __SSE2__
+        using c8x16 = char __attribute__((vector_size(16)));
+        return __builtin_ia32_pmovmskb128((c8x16)mask);
+#else
+        u32 bits = 0;
+        for (size_t i = 0; i < width; ++i) {
+            if (mask[i])
+                bits |= 1u << i;
+        }
+        return bits;
+#endif
+    }
+
+    SIMD::i8x16 m_control;
+};
+
+}
+
+template<typename TableType, typename T>
+class SwissHashTableIterator {
+    friend TableType;
+
+public:
+    bool operator==(const SwissHashTableIterator& other) const { return m_index == other.m_index; }
+    bool operator!=(const SwissHashTableIterator& other) const { return m_index != other.m_index; }
+    T& operator*() { return m_table->slot(m_index); }
+    T* operator->() { return &m_table->slot(m_index); }
+    void operator++() { m_index = m_table->next_full_index(m_index + 1); }
+
+private:
+    SwissHashTableIterator(TableType* table, size_t index)
+        : m_table(table)
+        , m_index(index)
+    {
+    }
+
+    TableType* m_table { nullptr };
+    size_t m_index { 0 };
+};
+
+template<typename T, typename TraitsForT = Traits<T>>
+class SwissHashTable {
+    using Group = Detail::SwissGroup;
+    static constexpr size_t group_width = Group::width;
+
+public:
+    using Iterator = SwissHashTableIterator<SwissHashTable, T>;
+    using ConstIterator = SwissHashTableIterator<const SwissHashTable, const T>;
+
+    SwissHashTable() = default;
+    explicit SwissHashTable(size_t capacity) { ensure_capacity(capacity); }
+
+    ~SwissHashTable()
+    {
+        if (!m_control)
+            return;
+        for (auto index = next_full_index(0); index < m_capacity; index = next_full_index(index + 1))
+            slot(index).~T();
+        kfree(m_control);
+    }
+
+    SwissHashTable(const SwissHashTable& other)
+    {
+        ensure_capacity(other.size());
+        for (auto& it : other)
+            set(it);
+    }
+
+    SwissHashTable& operator=(const SwissHashTable& other)
+    {
+        SwissHashTable temporary(other);
+        swap(*this, temporary);
+        return *this;
+    }
+
+    SwissHashTable(SwissHashTable&& other) noexcept
+        : m_control(exchange(other.m_control, nullptr))
+        , m_slots(exchange(other.m_slots, nullptr))
+        , m_size(exchange(other.m_size, 0))
+        , m_capacity(exchange(other.m_capacity, 0))
+        , m_growth_left(exchange(other.m_growth_left, 0))
+    {
+    }
+
+    SwissHashTable& operator=(SwissHashTable&& other) noexcept
+    {
+        SwissHashTable temporary { move(other) };
+        swap(*this, temporary);
+        return *this;
+    }
+
+    friend void swap(SwissHashTable& a, SwissHashTable& b) noexcept
+    {
+        swap(a.m_control, b.m_control);
+        swap(a.m_slots, b.m_slots);
+        swap(a.m_size, b.m_size);
+        swap(a.m_capacity, b.m_capacity);
+        swap(a.m_growth_left, b.m_growth_left);
+    }
+
+    [[nodiscard]] bool is_empty() const { return !m_size; }
+    [[nodiscard]] size_t size() const { return m_size; }
+    [[nodiscard]] size_t capacity() const { return m_capacity; }
+
+    template<typename U, size_t N>
+    void set_from(U (&from_array)[N])
+    {
+        for (size_t i = 0; i < N; ++i)
+            set(from_array[i]);
+    }
+
+    void ensure_capacity(size_t capacity)
+    {
+        VERIFY(capacity >= size());
+        if (capacity <= m_size + m_growth_left)
+            return;
+        rehash(capacity + capacity / 7 + 1);
+    }
+
+    bool contains(const T& value) const
+    {
+        return find(value) != end();
+    }
+
+    Iterator begin() { return Iterator(this, next_full_index(0)); }
+    Iterator end() { return Iterator(this, m_capacity); }
+    ConstIterator begin() const { return ConstIterator(this, next_full_index(0)); }
+    ConstIterator end() const { return ConstIterator(this, m_capacity); }
+
+    void clear()
+    {
+        *this = SwissHashTable();
+    }
+
+    template<typename U = T>
+    HashSetResult set(U&& value, HashSetExistingEntryBehavior existing_entry_behaviour = HashSetExistingEntryBehavior::Replace)
+    {
+        auto hash = TraitsForT::hash(value);
+        auto index = lookup_with_hash(hash, [&](auto& entry) { return TraitsForT::equals(entry, value); });
+        if (index != m_capacity) {
+            if (existing_entry_behaviour == HashSetExistingEntryBehavior::Keep)
+                return HashSetResult::KeptExistingEntry;
+            slot(index) = forward<U>(value);
+            return HashSetResult::ReplacedExistingEntry;
+        }
+
+        index = prepare_insert(hash);
+        new (&slot(index)) T(forward<U>(value));
+        ++m_size;
+        return HashSetResult::InsertedNewEntry;
+    }
+
+    template<typename Finder>
+    Iterator find(unsigned hash, Finder finder)
+    {
+        return Iterator(this, lookup_with_hash(hash, move(finder)));
+    }
+
+    Iterator find(const T& value)
+    {
+        return find(TraitsForT::hash(value), [&](auto& other) { return TraitsForT::equals(value, other); });
+    }
+
+    template<typename Finder>
+    ConstIterator find(unsigned hash, Finder finder) const
+    {
+        return ConstIterator(this, lookup_with_hash(hash, move(finder)));
+    }
+
+    ConstIterator find(const T& value) const
+    {
+        return find(TraitsForT::hash(value), [&](auto& other) { return TraitsForT::equals(value, other); });
+    }
+
+    bool remove(const T& value)
+    {
+        auto it = find(value);
+        if (it != end()) {
+            remove(it);
+            return true;
+        }
+        return false;
+    }
+
+    void remove(Iterator iterator)
+    {
+        auto index = iterator.m_index;
+        VERIFY(index < m_capacity);
+        VERIFY(m_control[index] >= 0);
+
+        slot(index).~T();
+        --m_size;
+
+        // Probes only continue past a group without empty slots. If there's an empty slot less than a group's
+        // width away on both sides, no group containing this slot has ever been full, so no probe can have
+        // walked past it and there's no need for a tombstone.
+        auto index_before = (index - group_width) & (m_capacity - 1);
+        auto empty_after = Group(m_control + index).match_empty();
+        auto empty_before = Group(m_control + index_before).match_empty();
+        bool was_never_full = empty_before && empty_after
+            && (size_t)(__builtin_ctz(empty_after) + __builtin_clz(empty_before << 16)) < group_width;
+        if (was_never_full) {
+            set_control(index, Group::empty);
+            ++m_growth_left;
+        } else {
+            set_control(index, Group::deleted);
+        }
+    }
+
+private:
+    friend Iterator;
+    friend ConstIterator;
+
+    T& slot(size_t index) { return m_slots[index]; }
+    const T& slot(size_t index) const { return m_slots[index]; }
+
+    // The position in the table comes from the low bits of the hash. The tag stored in the control byte
+    // has to be independent of those, so take it from the top of a multiplicative mix.
+    static i8 tag_for_hash(unsigned hash) { return (i8)((u32)(hash * 0x9e3779b1u) >> 25); }
+
+    size_t next_full_index(size_t index) const
+    {
+        while (index < m_capacity) {
+            if (auto full = Group(m_control + index).match_full())
+                return min(index + __builtin_ctz(full), m_capacity);
+            index += group_width;
+        }
+        return m_capacity;
+    }
+
+    // Returns m_capacity if nothing matches.
+    template<typename Finder>
+    size_t lookup_with_hash(unsigned hash, Finder finder) const
+    {
+        if (is_empty())
+            return m_capacity;
+
+        auto mask = m_capacity - 1;
+        auto tag = tag_for_hash(hash);
+        size_t position = hash & mask;
+        for (size_t stride = group_width;; stride += group_width) {
+            Group group(m_control + position);
+            for (auto matches = group.match(tag); matches; matches &= matches - 1) {
+                auto index = (position + __builtin_ctz(matches)) & mask;
+                if (finder(slot(index)))
+                    return index;
+            }
+            if (group.match_empty())
+                return m_capacity;
+            // Triangular probing visits every group once the table size is a power of two.
+            position = (position + stride) & mask;
+        }
+    }
+
+    size_t find_first_non_full(unsigned hash) const
+    {
+        auto mask = m_capacity - 1;
+        size_t position = hash & mask;
+        for (size_t stride = group_width;; stride += group_width) {
+            if (auto free = Group(m_control + position).match_empty_or_deleted())
+                return (position + __builtin_ctz(free)) & mask;
+            position = (position + stride) & mask;
+        }
+    }
+
+    size_t prepare_insert(unsigned hash)
+    {
+        if (!m_capacity)
+            rehash(group_width);
+        auto index = find_first_non_full(hash);
+        if (m_growth_left == 0 && m_control[index] != Group::deleted) {
+            // Throw away the tombstones if they make up a good part of the table, otherwise grow.
+            rehash(m_size * 32 <= m_capacity * 25 ? m_capacity : m_capacity * 2);
+            index = find_first_non_full(hash);
+        }
+        if (m_control[index] == Group::empty)
+            --m_growth_left;
+        set_control(index, tag_for_hash(hash));
+        return index;
+    }
+
+    // The first group_width control bytes are mirrored after the last one, so a group can be loaded at any position.
+    void set_control(size_t index, i8 control)
+    {
+        m_control[index] = control;
+        if (index < group_width)
+            m_control[m_capacity + index] = control;
+    }
+
+    static size_t growth_capacity(size_t capacity) { return capacity - capacity / 8; }
+
+    void rehash(size_t new_capacity)
+    {
+        size_t capacity = group_width;
+        while (capacity < new_capacity)
+            capacity *= 2;
+
+        auto* old_control = m_control;
+        auto* old_slots = m_slots;
+        auto old_capacity = m_capacity;
+
+        auto slots_offset = align_up_to(capacity + group_width, alignof(T));
+        m_control = (i8*)kmalloc(slots_offset + capacity * sizeof(T));
+        VERIFY(m_control);
+        __builtin_memset(m_control, Group::empty, capacity + group_width);
+        m_slots = reinterpret_cast<T*>(reinterpret_cast<u8*>(m_control) + slots_offset);
+        m_capacity = capacity;
+        m_growth_left = growth_capacity(capacity) - m_size;
+
+        if (!old_control)
+            return;
+
+        for (size_t old_index = 0; old_index < old_capacity; ++old_index) {
+            if (old_control[old_index] < 0)
+                continue;
+            auto& value = old_slots[old_index];
+            auto hash = TraitsForT::hash(value);
+            auto index = find_first_non_full(hash);
+            set_control(index, tag_for_hash(hash));
+            new (&slot(index)) T(move(value));
+            value.~T();
+        }
+
+        kfree(old_control);
+    }
+
+    i8* m_control { nullptr };
+    T* m_slots { nullptr };
+    size_t m_size { 0 };
+    size_t m_capacity { 0 };
+    size_t m_growth_left { 0 };
+};
+
+}
+
+using AK::SwissHashTable;
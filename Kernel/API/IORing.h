@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Types.h>
+
+// An I/O ring is shared between a process and the kernel through mmap() of the descriptor
+// returned by io_ring_create(). The mapping starts with an IORingHeader, followed by the
+// submission and completion entry arrays at the offsets given in the header.
+//
+// Userspace fills in submission entries and advances submission_tail, the kernel consumes them
+// in io_ring_enter() and advances submission_head. The kernel appends completion entries and
+// advances completion_tail, userspace consumes them and advances completion_head.
+// Both sides mask the free-running head/tail counters with the corresponding *_mask.
+
+enum class IORingOpcode : u8 {
+    Nop = 0,
+    Read = 1,
+    Write = 2,
+    Accept = 3, // Completes with -EPERM if the process has pledged, but not "accept".
+    Fsync = 4,
+};
+
+// Use the file description's current offset (and advance it) instead of an explicit one.
+constexpr i64 IO_RING_CURRENT_OFFSET = -1;
+
+struct IORingSubmission {
+    IORingOpcode opcode { IORingOpcode::Nop };
+    u8 reserved[3] {};
+    i32 fd { -1 };
+    i64 offset { IO_RING_CURRENT_OFFSET };
+    u64 buffer { 0 };
+    u32 length { 0 };
+    u32 flags { 0 }; // For Accept: SOCK_NONBLOCK and/or SOCK_CLOEXEC.
+    u64 user_data { 0 };
+};
+
+struct IORingCompletion {
+    u64 user_data { 0 };
+    i32 result { 0 }; // A byte count or file descriptor on success, a negated errno on failure.
+    u32 reserved { 0 };
+};
+
+struct IORingHeader {
+    u32 submission_head;
+    u32 submission_tail;
+    u32 submission_mask;
+    u32 submission_entries_offset;
+    u32 completion_head;
+    u32 completion_tail;
+    u32 completion_mask;
+    u32 completion_entries_offset;
+    u32 ring_size;
+};
+
+constexpr u32 IO_RING_MAX_ENTRIES = 4096;
+
+struct IORingLayout {
+    u32 submission_entries;
+    u32 completion_entries;
+    u32 submission_entries_offset;
+    u32 completion_entries_offset;
+    u32 ring_size;
+};
+
+// Both sides compute the layout of a ring the same way, so userspace knows how much to mmap().
+constexpr IORingLayout io_ring_layout(u32 requested_entries)
+{
+    constexpr u32 page_size = 4096;
+
+    IORingLayout layout {};
+    layout.submission_entries = 1;
+    while (layout.submission_entries < requested_entries)
+        layout.submission_entries *= 2;
+    layout.completion_entries = layout.submission_entries * 2;
+    layout.submission_entries_offset = (sizeof(IORingHeader) + 63) & ~63u;
+    layout.completion_entries_offset = layout.submission_entries_offset + layout.submission_entries * sizeof(IORingSubmission);
+    u32 end = layout.completion_entries_offset + layout.completion_entries * sizeof(IORingCompletion);
+    layout.ring_size = (end + page_size - 1) & ~(page_size - 1);
+    return layout;
+}
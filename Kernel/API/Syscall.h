@@ -180,7 +180,9 @@ namespace Kernel {
     S(readv)                      \
     S(emuctl)                     \
     S(statvfs)                    \
-    S(fstatvfs)
+    S(fstatvfs)                   \
+    S(io_ring_create)             \
+    S(io_ring_enter)
 
 namespace Syscall {
 
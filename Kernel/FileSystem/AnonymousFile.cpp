@@ -30,4 +30,12 @@ KResultOr<Region*> AnonymousFile::mmap(Process& process, FileDescription&, const
     return process.space().allocate_region_with_vmobject(range, m_vmobject, offset, {}, prot, shared);
 }
 
+KResult AnonymousFile::stat(::stat& st) const
+{
+    memset(&st, 0, sizeof(st));
+    st.st_mode = S_IFREG | 0600;
+    st.st_size = m_vmobject->size();
+    return KSuccess;
+}
+
 }
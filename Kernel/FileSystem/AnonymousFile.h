@@ -20,6 +20,7 @@ public:
     virtual ~AnonymousFile() override;
 
     virtual KResultOr<Region*> mmap(Process&, FileDescription&, const Range&, u64 offset, int prot, bool shared) override;
+    virtual KResult stat(::stat&) const override;
 
 private:
     virtual const char* class_name() const override { return "AnonymousFile"; }
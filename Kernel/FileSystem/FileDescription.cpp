@@ -12,6 +12,7 @@
 #include <Kernel/FileSystem/FIFO.h>
 #include <Kernel/FileSystem/FileDescription.h>
 #include <Kernel/FileSystem/FileSystem.h>
+#include <Kernel/FileSystem/IORing.h>
 #include <Kernel/FileSystem/InodeFile.h>
 #include <Kernel/FileSystem/InodeWatcher.h>
 #include <Kernel/Net/Socket.h>
@@ -323,6 +324,25 @@ InodeWatcher* FileDescription::inode_watcher()
     return static_cast<InodeWatcher*>(m_file.ptr());
 }
 
+bool FileDescription::is_io_ring() const
+{
+    return m_file->is_io_ring();
+}
+
+const IORing* FileDescription::io_ring() const
+{
+    if (!is_io_ring())
+        return nullptr;
+    return static_cast<const IORing*>(m_file.ptr());
+}
+
+IORing* FileDescription::io_ring()
+{
+    if (!is_io_ring())
+        return nullptr;
+    return static_cast<IORing*>(m_file.ptr());
+}
+
 bool FileDescription::is_master_pty() const
 {
     return m_file->is_master_pty();
@@ -0,0 +1,521 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Atomic.h>
+#include <Kernel/Debug.h>
+#include <Kernel/FileSystem/FileDescription.h>
+#include <Kernel/FileSystem/IORing.h>
+#include <Kernel/FileSystem/Inode.h>
+#include <Kernel/Net/Socket.h>
+#include <Kernel/Process.h>
+#include <Kernel/Sections.h>
+#include <Kernel/VM/AnonymousVMObject.h>
+#include <Kernel/VM/MemoryManager.h>
+#include <Kernel/WorkQueue.h>
+
+namespace Kernel {
+
+static constexpr size_t worker_count = 4;
+static WorkQueue* s_workers[worker_count];
+static Atomic<u32> s_next_worker;
+
+UNMAP_AFTER_INIT void IORing::initialize()
+{
+    for (auto& worker : s_workers)
+        worker = new WorkQueue("IORing Worker");
+}
+
+KResultOr<NonnullRefPtr<IORing>> IORing::create(Process& process, u32 entries)
+{
+    if (entries == 0 || entries > IO_RING_MAX_ENTRIES)
+        return EINVAL;
+
+    auto layout = io_ring_layout(entries);
+    static_assert(io_ring_layout(1).ring_size % PAGE_SIZE == 0);
+    size_t ring_size = layout.ring_size;
+
+    // The kernel keeps its own mapping of the ring so that worker threads can post completions
+    // without having to run in the owning process' address space.
+    auto vmobject = AnonymousVMObject::create_with_size(ring_size, AllocationStrategy::AllocateNow);
+    if (!vmobject)
+        return ENOMEM;
+    auto kernel_region = MM.allocate_kernel_region_with_vmobject(*vmobject, ring_size, "IORing", Region::Access::Read | Region::Access::Write);
+    if (!kernel_region)
+        return ENOMEM;
+
+    auto& header = *reinterpret_cast<IORingHeader*>(kernel_region->vaddr().as_ptr());
+    header.submission_head = 0;
+    header.submission_tail = 0;
+    header.submission_mask = layout.submission_entries - 1;
+    header.submission_entries_offset = layout.submission_entries_offset;
+    header.completion_head = 0;
+    header.completion_tail = 0;
+    header.completion_mask = layout.completion_entries - 1;
+    header.completion_entries_offset = layout.completion_entries_offset;
+    header.ring_size = ring_size;
+
+    auto ring = adopt_ref_if_nonnull(new (nothrow) IORing(process.pid(), vmobject.release_nonnull(), kernel_region.release_nonnull(), layout.submission_entries, layout.completion_entries));
+    if (!ring)
+        return ENOMEM;
+    return ring.release_nonnull();
+}
+
+IORing::IORing(ProcessID owner_pid, NonnullRefPtr<AnonymousVMObject> vmobject, NonnullOwnPtr<Region> kernel_region, u32 submission_entries, u32 completion_entries)
+    : m_owner_pid(owner_pid)
+    , m_vmobject(move(vmobject))
+    , m_kernel_region(move(kernel_region))
+    , m_submission_entries(submission_entries)
+    , m_completion_entries(completion_entries)
+{
+}
+
+IORing::~IORing()
+{
+    // Operations on the worker threads hold a reference to us, so only ones that are waiting
+    // for readiness (or already finished) can be left. Cancel the watchers before freeing
+    // them, which waits for one that is just firing to be done with us.
+    for (;;) {
+        Operation* operation;
+        {
+            ScopedSpinLock lock(m_finished_lock);
+            operation = m_waiting.take_first();
+        }
+        if (!operation)
+            break;
+        operation->watcher->cancel();
+        delete operation;
+    }
+    while (auto* operation = m_finished.take_first())
+        delete operation;
+}
+
+KResultOr<Region*> IORing::mmap(Process& process, FileDescription&, const Range& range, u64 offset, int prot, bool shared)
+{
+    if (!shared || offset != 0)
+        return EINVAL;
+    if (range.size() != m_vmobject->size())
+        return EINVAL;
+    return process.space().allocate_region_with_vmobject(range, m_vmobject, 0, "IORing", prot, true);
+}
+
+bool IORing::can_read(const FileDescription&, size_t) const
+{
+    {
+        ScopedSpinLock lock(m_finished_lock);
+        if (!m_finished.is_empty())
+            return true;
+    }
+    return unconsumed_completions() > 0;
+}
+
+u32 IORing::unconsumed_completions() const
+{
+    auto& header = this->header();
+    u32 tail = header.completion_tail;
+    u32 head = AK::atomic_load(&header.completion_head, AK::memory_order_acquire);
+    // Don't trust userspace to keep the head within bounds.
+    return min(tail - head, m_completion_entries);
+}
+
+bool IORing::has_room_for_completion() const
+{
+    return unconsumed_completions() + m_in_flight.load() < m_completion_entries;
+}
+
+void IORing::post_completion(u64 user_data, i32 result)
+{
+    auto& header = this->header();
+    u32 tail = header.completion_tail;
+    auto& completion = completion_entries()[tail & (m_completion_entries - 1)];
+    completion.user_data = user_data;
+    completion.result = result;
+    completion.reserved = 0;
+    AK::atomic_store(&header.completion_tail, tail + 1, AK::memory_order_release);
+}
+
+KResultOr<FlatPtr> IORing::enter(Process& process, u32 to_submit, u32 min_complete)
+{
+    if (process.pid() != m_owner_pid)
+        return EPERM;
+
+    Locker locker(m_lock);
+    reap_finished(process);
+
+    auto& header = this->header();
+    u32 head = header.submission_head;
+    u32 tail = AK::atomic_load(&header.submission_tail, AK::memory_order_acquire);
+    u32 submitted = 0;
+    while (submitted < to_submit && head != tail && has_room_for_completion()) {
+        IORingSubmission submission = submission_entries()[head & (m_submission_entries - 1)];
+        AK::atomic_store(&header.submission_head, ++head, AK::memory_order_release);
+        submit(process, submission);
+        ++submitted;
+    }
+
+    min_complete = min(min_complete, m_completion_entries);
+    while (unconsumed_completions() < min_complete && m_in_flight.load() > 0) {
+        locker.unlock();
+        auto result = m_completion_wait_queue.wait_on({});
+        locker.lock();
+        if (result.was_interrupted()) {
+            if (submitted > 0)
+                break;
+            return EINTR;
+        }
+        reap_finished(process);
+    }
+    return submitted;
+}
+
+KResult IORing::validate(const Operation& operation) const
+{
+    auto& submission = operation.submission;
+    auto& description = *operation.description;
+    // An operation on a ring would keep that ring alive.
+    if (description.file().is_io_ring())
+        return EINVAL;
+    switch (submission.opcode) {
+    case IORingOpcode::Read:
+    case IORingOpcode::Write:
+        if (submission.length > (u32)NumericLimits<i32>::max())
+            return EINVAL;
+        if (submission.opcode == IORingOpcode::Read && !description.is_readable())
+            return EBADF;
+        if (submission.opcode == IORingOpcode::Write && !description.is_writable())
+            return EBADF;
+        if (description.is_directory())
+            return EISDIR;
+        if (submission.offset != IO_RING_CURRENT_OFFSET && (submission.offset < 0 || !description.file().is_seekable()))
+            return EINVAL;
+        return KSuccess;
+    case IORingOpcode::Accept:
+        if (!description.is_socket())
+            return ENOTSOCK;
+        return KSuccess;
+    case IORingOpcode::Fsync:
+        if (!description.inode())
+            return EINVAL;
+        return KSuccess;
+    default:
+        return EINVAL;
+    }
+}
+
+bool IORing::should_run_on_worker(const Operation& operation)
+{
+    if (operation.submission.opcode == IORingOpcode::Fsync)
+        return true;
+    if (operation.submission.opcode != IORingOpcode::Read && operation.submission.opcode != IORingOpcode::Write)
+        return false;
+    // These are always "ready", but may still have to wait for the disk.
+    auto& file = operation.description->file();
+    return file.is_inode() || file.is_block_device();
+}
+
+void IORing::submit(Process& process, const IORingSubmission& submission)
+{
+    dbgln_if(IO_DEBUG, "IORing @ {}: submit opcode {} fd {} length {}", this, (u8)submission.opcode, submission.fd, submission.length);
+
+    if (submission.opcode == IORingOpcode::Nop) {
+        post_completion(submission.user_data, 0);
+        return;
+    }
+
+    auto operation = adopt_own_if_nonnull(new (nothrow) Operation);
+    if (!operation) {
+        post_completion(submission.user_data, -ENOMEM);
+        return;
+    }
+    operation->submission = submission;
+
+    operation->description = process.fds().file_description(submission.fd);
+    if (!operation->description) {
+        post_completion(submission.user_data, -EBADF);
+        return;
+    }
+    if (auto result = validate(*operation); result.is_error()) {
+        post_completion(submission.user_data, result.error());
+        return;
+    }
+    // Unlike sys$accept(), this can't crash the process: enter() is holding m_lock, and the submission has already been consumed.
+    if (submission.opcode == IORingOpcode::Accept && process.has_promises() && !process.has_promised(Pledge::accept)) {
+        dbgln("Has not pledged accept");
+        post_completion(submission.user_data, -EPERM);
+        return;
+    }
+
+    if (!should_run_on_worker(*operation)) {
+        if (auto result = try_perform(process, *operation); result.has_value())
+            post_completion(submission.user_data, result.value());
+        else
+            wait_for_readiness(operation.release_nonnull());
+        return;
+    }
+
+    if (submission.opcode == IORingOpcode::Read || submission.opcode == IORingOpcode::Write) {
+        if (submission.length == 0) {
+            post_completion(submission.user_data, 0);
+            return;
+        }
+        operation->bounce_buffer = KBuffer::try_create_with_size(submission.length, Region::Access::Read | Region::Access::Write, "IORing bounce buffer");
+        if (!operation->bounce_buffer) {
+            post_completion(submission.user_data, -ENOMEM);
+            return;
+        }
+        if (submission.opcode == IORingOpcode::Write && !copy_from_user(operation->bounce_buffer->data(), (const u8*)(FlatPtr)submission.buffer, submission.length)) {
+            post_completion(submission.user_data, -EFAULT);
+            return;
+        }
+    }
+    run_on_worker(operation.release_nonnull());
+}
+
+template<typename T>
+static i32 to_completion_result(KResultOr<T> result)
+{
+    if (result.is_error())
+        return result.error();
+    return (i32)result.value();
+}
+
+Optional<i32> IORing::try_perform(Process& process, Operation& operation)
+{
+    auto& submission = operation.submission;
+    auto& description = *operation.description;
+    // If the file reported an error or hangup, let the operation itself report it.
+    bool is_exceptional = has_flag(operation.ready_flags, Thread::FileBlocker::BlockFlags::Exception);
+
+    switch (submission.opcode) {
+    case IORingOpcode::Read: {
+        if (!is_exceptional && !description.can_read())
+            return {};
+        auto buffer = UserOrKernelBuffer::for_user_buffer((u8*)(FlatPtr)submission.buffer, submission.length);
+        if (!buffer.has_value())
+            return -EFAULT;
+        if (submission.offset != IO_RING_CURRENT_OFFSET)
+            return to_completion_result(description.file().read(description, submission.offset, buffer.value(), submission.length));
+        return to_completion_result(description.read(buffer.value(), submission.length));
+    }
+    case IORingOpcode::Write: {
+        if (!is_exceptional && !description.can_write())
+            return {};
+        auto buffer = UserOrKernelBuffer::for_user_buffer((u8*)(FlatPtr)submission.buffer, submission.length);
+        if (!buffer.has_value())
+            return -EFAULT;
+        if (submission.offset != IO_RING_CURRENT_OFFSET)
+            return to_completion_result(description.file().write(description, submission.offset, buffer.value(), submission.length));
+        return to_completion_result(description.write(buffer.value(), submission.length));
+    }
+    case IORingOpcode::Accept: {
+        auto& socket = *description.socket();
+        if (!socket.can_accept())
+            return is_exceptional ? -EINVAL : Optional<i32> {};
+        int accepted_socket_fd = process.fds().allocate();
+        if (accepted_socket_fd < 0)
+            return accepted_socket_fd;
+        auto accepted_socket = socket.accept();
+        VERIFY(accepted_socket);
+        auto accepted_description_or_error = FileDescription::create(*accepted_socket);
+        if (accepted_description_or_error.is_error())
+            return accepted_description_or_error.error();
+        auto accepted_description = accepted_description_or_error.release_value();
+        accepted_description->set_readable(true);
+        accepted_description->set_writable(true);
+        if (submission.flags & SOCK_NONBLOCK)
+            accepted_description->set_blocking(false);
+        process.fds()[accepted_socket_fd].set(move(accepted_description), (submission.flags & SOCK_CLOEXEC) ? FD_CLOEXEC : 0);
+        accepted_socket->set_setup_state(Socket::SetupState::Completed);
+        return accepted_socket_fd;
+    }
+    default:
+        VERIFY_NOT_REACHED();
+    }
+}
+
+void IORing::perform_blocking(Operation& operation)
+{
+    auto& submission = operation.submission;
+    auto& description = *operation.description;
+
+    switch (submission.opcode) {
+    case IORingOpcode::Read: {
+        auto buffer = UserOrKernelBuffer::for_kernel_buffer(operation.bounce_buffer->data());
+        if (submission.offset == IO_RING_CURRENT_OFFSET)
+            operation.result = to_completion_result(description.read(buffer, submission.length));
+        else
+            operation.result = to_completion_result(description.file().read(description, submission.offset, buffer, submission.length));
+        break;
+    }
+    case IORingOpcode::Write: {
+        auto buffer = UserOrKernelBuffer::for_kernel_buffer(operation.bounce_buffer->data());
+        if (submission.offset == IO_RING_CURRENT_OFFSET)
+            operation.result = to_completion_result(description.write(buffer, submission.length));
+        else
+            operation.result = to_completion_result(description.file().write(description, submission.offset, buffer, submission.length));
+        break;
+    }
+    case IORingOpcode::Fsync: {
+        auto& inode = *description.inode();
+        inode.flush_metadata();
+        inode.fs().flush_writes();
+        operation.result = 0;
+        break;
+    }
+    default:
+        VERIFY_NOT_REACHED();
+    }
+}
+
+void IORing::run_on_worker(NonnullOwnPtr<Operation> operation)
+{
+    ++m_in_flight;
+    auto* worker = s_workers[s_next_worker.fetch_add(1, AK::memory_order_relaxed) % worker_count];
+    worker->queue([ring = NonnullRefPtr<IORing>(*this), operation = operation.leak_ptr()]() mutable {
+        perform_blocking(*operation);
+        ring->did_finish(*operation);
+    });
+}
+
+void IORing::wait_for_readiness(NonnullOwnPtr<Operation> operation)
+{
+    VERIFY(m_lock.is_locked());
+    ++m_in_flight;
+    auto& raw_operation = *operation.leak_ptr();
+    raw_operation.ready_flags = Thread::FileBlocker::BlockFlags::None;
+    {
+        ScopedSpinLock lock(m_finished_lock);
+        m_waiting.append(raw_operation);
+    }
+    // Nothing can reap the operation before we're done here, since that needs m_lock.
+    raw_operation.watcher = adopt_own_if_nonnull(new (nothrow) ReadinessWatcher(*this, raw_operation));
+    if (!raw_operation.watcher) {
+        {
+            ScopedSpinLock lock(m_finished_lock);
+            m_waiting.remove(raw_operation);
+        }
+        raw_operation.result = -ENOMEM;
+        did_finish(raw_operation);
+        return;
+    }
+    // The file may have become ready before the watcher was registered.
+    if (raw_operation.watcher->did_fire())
+        did_become_ready(raw_operation, raw_operation.ready_flags);
+}
+
+static Thread::FileBlocker::BlockFlags readiness_flags_for(IORingOpcode opcode)
+{
+    using BlockFlags = Thread::FileBlocker::BlockFlags;
+    switch (opcode) {
+    case IORingOpcode::Read:
+        return BlockFlags::Read | BlockFlags::Exception;
+    case IORingOpcode::Write:
+        return BlockFlags::Write | BlockFlags::Exception;
+    case IORingOpcode::Accept:
+        return BlockFlags::Accept | BlockFlags::Exception;
+    default:
+        VERIFY_NOT_REACHED();
+    }
+}
+
+IORing::ReadinessWatcher::ReadinessWatcher(IORing& ring, Operation& operation)
+    : m_ring(ring)
+    , m_operation(operation)
+{
+    if (!set_block_condition(operation.description->block_condition()))
+        m_should_block = false;
+}
+
+bool IORing::ReadinessWatcher::unblock(bool from_add_blocker, void*)
+{
+    auto ready_flags = m_operation.description->should_unblock(readiness_flags_for(m_operation.submission.opcode));
+    if (ready_flags == BlockFlags::None)
+        return false;
+
+    ScopedSpinLock lock(m_lock);
+    if (m_did_fire)
+        return false;
+    m_did_fire = true;
+    // If this happens while registering, wait_for_readiness() takes care of it.
+    if (from_add_blocker)
+        m_operation.ready_flags = ready_flags;
+    else
+        m_ring.did_become_ready(m_operation, ready_flags);
+    return true;
+}
+
+bool IORing::ReadinessWatcher::did_fire() const
+{
+    ScopedSpinLock lock(m_lock);
+    return m_did_fire;
+}
+
+void IORing::ReadinessWatcher::cancel()
+{
+    // Once we hold the lock, unblock() is either done with the ring or won't touch it anymore.
+    ScopedSpinLock lock(m_lock);
+    m_did_fire = true;
+}
+
+void IORing::did_become_ready(Operation& operation, Thread::FileBlocker::BlockFlags ready_flags)
+{
+    {
+        ScopedSpinLock lock(m_finished_lock);
+        // The ring may be cancelling this operation right now.
+        if (!operation.m_list_node.is_in_list())
+            return;
+        m_waiting.remove(operation);
+        operation.ready_flags = ready_flags;
+        operation.should_retry = true;
+        m_finished.append(operation);
+    }
+    m_completion_wait_queue.wake_one();
+    evaluate_block_conditions();
+}
+
+void IORing::did_finish(Operation& operation)
+{
+    {
+        ScopedSpinLock lock(m_finished_lock);
+        m_finished.append(operation);
+    }
+    m_completion_wait_queue.wake_one();
+    evaluate_block_conditions();
+}
+
+void IORing::reap_finished(Process& process)
+{
+    VERIFY(m_lock.is_locked());
+    for (;;) {
+        Operation* raw_operation;
+        {
+            ScopedSpinLock lock(m_finished_lock);
+            raw_operation = m_finished.take_first();
+        }
+        if (!raw_operation)
+            break;
+        auto operation = adopt_own_if_nonnull(raw_operation).release_nonnull();
+        --m_in_flight;
+
+        auto& submission = operation->submission;
+        if (operation->should_retry) {
+            operation->should_retry = false;
+            operation->watcher = nullptr;
+            if (auto result = try_perform(process, *operation); result.has_value())
+                post_completion(submission.user_data, result.value());
+            else
+                wait_for_readiness(move(operation));
+            continue;
+        }
+
+        if (submission.opcode == IORingOpcode::Read && operation->result > 0) {
+            if (!copy_to_user((u8*)(FlatPtr)submission.buffer, operation->bounce_buffer->data(), operation->result))
+                operation->result = -EFAULT;
+        }
+        post_completion(submission.user_data, operation->result);
+    }
+}
+
+}
@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/IntrusiveList.h>
+#include <AK/NonnullOwnPtr.h>
+#include <Kernel/API/IORing.h>
+#include <Kernel/FileSystem/File.h>
+#include <Kernel/KBuffer.h>
+#include <Kernel/Lock.h>
+#include <Kernel/WaitQueue.h>
+
+namespace Kernel {
+
+// A submission/completion queue pair shared with userspace, see Kernel/API/IORing.h.
+//
+// Operations that can complete without blocking are performed right away in io_ring_enter().
+// Inode and block device I/O (which may have to wait for the disk) is handed to a pool of
+// worker threads, which transfer the data through a kernel bounce buffer. Operations on other
+// files that aren't ready yet register a blocker on the file that tells the ring once they are,
+// after which they are performed on the next io_ring_enter(). Anything that touches userspace
+// memory happens in the context of the owning process. Destroying the ring cancels everything
+// that is still waiting for readiness.
+class IORing final : public File {
+public:
+    static void initialize();
+    static KResultOr<NonnullRefPtr<IORing>> create(Process&, u32 entries);
+    virtual ~IORing() override;
+
+    KResultOr<FlatPtr> enter(Process&, u32 to_submit, u32 min_complete);
+
+    virtual bool can_read(const FileDescription&, size_t) const override;
+    virtual bool can_write(const FileDescription&, size_t) const override { return false; }
+    virtual KResultOr<size_t> read(FileDescription&, u64, UserOrKernelBuffer&, size_t) override { return ENOTSUP; }
+    virtual KResultOr<size_t> write(FileDescription&, u64, const UserOrKernelBuffer&, size_t) override { return ENOTSUP; }
+    virtual KResultOr<Region*> mmap(Process&, FileDescription&, const Range&, u64 offset, int prot, bool shared) override;
+
+    virtual String absolute_path(const FileDescription&) const override { return ":io-ring:"; }
+    virtual const char* class_name() const override { return "IORing"; }
+    virtual bool is_io_ring() const override { return true; }
+
+private:
+    struct Operation;
+
+    // Sits on the block condition of an operation's file (without a thread blocking on it)
+    // and hands the operation back to the ring once the file is ready for it.
+    class ReadinessWatcher final : public Thread::FileBlocker {
+    public:
+        ReadinessWatcher(IORing&, Operation&);
+
+        virtual const char* state_string() const override { return "IORing"; }
+        virtual bool unblock(bool from_add_blocker, void*) override;
+        virtual void not_blocking(bool) override { }
+
+        bool did_fire() const;
+        void cancel();
+
+    private:
+        IORing& m_ring;
+        Operation& m_operation;
+        bool m_did_fire { false };
+    };
+
+    struct Operation {
+        IORingSubmission submission;
+        RefPtr<FileDescription> description;
+        OwnPtr<KBuffer> bounce_buffer;
+        OwnPtr<ReadinessWatcher> watcher;
+        Thread::FileBlocker::BlockFlags ready_flags { Thread::FileBlocker::BlockFlags::None };
+        i32 result { 0 };
+        bool should_retry { false };
+        IntrusiveListNode<Operation> m_list_node;
+    };
+    using OperationList = IntrusiveList<Operation, RawPtr<Operation>, &Operation::m_list_node>;
+
+    IORing(ProcessID, NonnullRefPtr<AnonymousVMObject>, NonnullOwnPtr<Region>, u32 submission_entries, u32 completion_entries);
+
+    IORingHeader& header() { return *reinterpret_cast<IORingHeader*>(m_kernel_region->vaddr().as_ptr()); }
+    const IORingHeader& header() const { return *reinterpret_cast<const IORingHeader*>(m_kernel_region->vaddr().as_ptr()); }
+    IORingSubmission* submission_entries() { return reinterpret_cast<IORingSubmission*>(m_kernel_region->vaddr().offset(header().submission_entries_offset).as_ptr()); }
+    IORingCompletion* completion_entries() { return reinterpret_cast<IORingCompletion*>(m_kernel_region->vaddr().offset(header().completion_entries_offset).as_ptr()); }
+
+    u32 unconsumed_completions() const;
+    bool has_room_for_completion() const;
+    void post_completion(u64 user_data, i32 result);
+
+    void submit(Process&, const IORingSubmission&);
+    KResult validate(const Operation&) const;
+    static bool should_run_on_worker(const Operation&);
+    Optional<i32> try_perform(Process&, Operation&);
+    void run_on_worker(NonnullOwnPtr<Operation>);
+    void wait_for_readiness(NonnullOwnPtr<Operation>);
+    static void perform_blocking(Operation&);
+    void did_become_ready(Operation&, Thread::FileBlocker::BlockFlags);
+    void did_finish(Operation&);
+    void reap_finished(Process&);
+
+    ProcessID m_owner_pid;
+    NonnullRefPtr<AnonymousVMObject> m_vmobject;
+    NonnullOwnPtr<Region> m_kernel_region;
+    u32 m_submission_entries { 0 };
+    u32 m_completion_entries { 0 };
+
+    Lock m_lock { "IORing" };
+    Atomic<u32> m_in_flight { 0 };
+    mutable SpinLock<u8> m_finished_lock; // Protects both m_waiting and m_finished.
+    OperationList m_waiting;
+    OperationList m_finished;
+    WaitQueue m_completion_wait_queue;
+};
+
+}
@@ -18,6 +18,7 @@ class DoubleBuffer;
 class File;
 class FileDescription;
 class FutexQueue;
+class IORing;
 class IPv4Socket;
 class Inode;
 class InodeIdentifier;
@@ -18,9 +18,69 @@ bool FutexQueue::should_add_blocker(Thread::Blocker& b, void* data)
 
     dbgln_if(FUTEXQUEUE_DEBUG, "FutexQueue @ {}: should block thread {}", this, *static_cast<Thread*>(data));
 
+    if (m_unlocked_with_pending_pi_waiters) {
+        m_unlocked_with_pending_pi_waiters = false;
+        dbgln_if(FUTEXQUEUE_DEBUG, "FutexQueue @ {}: lock was released, let thread {} retry", this, *static_cast<Thread*>(data));
+        return false;
+    }
     return true;
 }
 
+void FutexQueue::did_unlock_with_pending_pi_waiters()
+{
+    ScopedSpinLock lock(m_lock);
+    VERIFY(m_pending_pi_waiters > 0);
+    m_unlocked_with_pending_pi_waiters = true;
+}
+
+bool FutexQueue::wake_highest_priority_waiter(const Function<bool(Thread&, bool)>& hand_over, bool& is_empty)
+{
+    ScopedSpinLock lock(m_lock);
+
+    Thread* new_owner = nullptr;
+    size_t waiter_count = 0;
+    do_unblock([&](Thread::Blocker& b, void* data, bool&) {
+        VERIFY(data);
+        VERIFY(b.blocker_type() == Thread::Blocker::Type::Futex);
+        auto& thread = *static_cast<Thread*>(data);
+        if (!new_owner || thread.effective_priority() > new_owner->effective_priority())
+            new_owner = &thread;
+        waiter_count++;
+        return false;
+    });
+
+    is_empty = is_empty_locked();
+    if (!new_owner)
+        return false;
+
+    dbgln_if(FUTEXQUEUE_DEBUG, "FutexQueue @ {}: handing lock over to {}", this, *new_owner);
+
+    // The futex word has to name the new owner before it wakes up and checks it.
+    if (!hand_over(*new_owner, waiter_count > 1 || m_pending_pi_waiters > 0))
+        return false;
+
+    do_unblock([&](Thread::Blocker& b, void* data, bool&) {
+        if (static_cast<Thread*>(data) != new_owner)
+            return false;
+        // If it was already woken up (e.g. by a timeout), it still finds itself owning the lock.
+        static_cast<Thread::FutexBlocker&>(b).unblock();
+        return true;
+    });
+    is_empty = is_empty_locked();
+    return true;
+}
+
+u32 FutexQueue::highest_waiter_priority()
+{
+    ScopedSpinLock lock(m_lock);
+    u32 priority = 0;
+    do_unblock([&](Thread::Blocker&, void* data, bool&) {
+        priority = max(priority, static_cast<Thread*>(data)->effective_priority());
+        return false;
+    });
+    return priority;
+}
+
 u32 FutexQueue::wake_n_requeue(u32 wake_count, const Function<FutexQueue*()>& get_target_queue, u32 requeue_count, bool& is_empty, bool& is_empty_target)
 {
     is_empty_target = false;
@@ -25,6 +25,15 @@ public:
     u32 wake_n(u32, const Optional<u32>&, bool&);
     u32 wake_all(bool&);
 
+    // Priority inheritance (FUTEX_LOCK_PI and FUTEX_UNLOCK_PI) support. All of these
+    // are only used with the process (or global) futex queue lock held.
+    bool wake_highest_priority_waiter(const Function<bool(Thread&, bool)>& hand_over, bool& is_empty);
+    u32 highest_waiter_priority();
+    void did_begin_pi_wait() { m_pending_pi_waiters++; }
+    void did_end_pi_wait() { m_pending_pi_waiters--; }
+    bool has_pending_pi_waiters() const { return m_pending_pi_waiters > 0; }
+    void did_unlock_with_pending_pi_waiters();
+
     template<class... Args>
     Thread::BlockResult wait_on(const Thread::BlockTimeout& timeout, Args&&... args)
     {
@@ -42,6 +51,12 @@ private:
     const FlatPtr m_user_address_or_offset;
     WeakPtr<VMObject> m_vmobject;
     const bool m_is_global;
+
+    // Threads that are on their way to block in FUTEX_LOCK_PI, but haven't added
+    // their blocker yet. If the owner unlocks in between, the next one of them
+    // to block retries taking the lock instead.
+    size_t m_pending_pi_waiters { 0 };
+    bool m_unlocked_with_pending_pi_waiters { false };
 };
 
 }
@@ -21,6 +21,7 @@
 #include <Kernel/KBufferBuilder.h>
 #include <Kernel/Module.h>
 #include <Kernel/Net/LocalSocket.h>
+#include <Kernel/Net/LoopbackAdapter.h>
 #include <Kernel/Net/NetworkAdapter.h>
 #include <Kernel/Net/NetworkingManagement.h>
 #include <Kernel/Net/Routing.h>
@@ -106,6 +107,12 @@ private:
             obj.add("bytes_in", socket.bytes_in());
             obj.add("packets_out", socket.packets_out());
             obj.add("bytes_out", socket.bytes_out());
+            obj.add("retransmitted_packets", socket.retransmitted_packets());
+            obj.add("send_mss", socket.send_mss());
+            obj.add("congestion_window", socket.congestion_window());
+            obj.add("slow_start_threshold", socket.slow_start_threshold());
+            obj.add("smoothed_rtt_us", socket.smoothed_rtt().to_microseconds());
+            obj.add("retransmission_timeout_ms", socket.retransmission_timeout().to_milliseconds());
         });
         array.finish();
         return true;
@@ -289,6 +296,63 @@ private:
     mutable Lock m_lock;
 };
 
+class ProcFSLoopbackSimulatePacketLoss : public ProcFSSystemBoolean {
+public:
+    static NonnullRefPtr<ProcFSLoopbackSimulatePacketLoss> must_create(const ProcFSSystemDirectory&);
+    virtual bool value() const override
+    {
+        Locker locker(m_lock);
+        return g_loopback_simulate_packet_loss.load();
+    }
+    virtual void set_value(bool new_value) override
+    {
+        Locker locker(m_lock);
+        g_loopback_simulate_packet_loss.exchange(new_value);
+    }
+
+private:
+    ProcFSLoopbackSimulatePacketLoss();
+    mutable Lock m_lock;
+};
+
+class ProcFSLoopbackSimulateLatency : public ProcFSSystemBoolean {
+public:
+    static NonnullRefPtr<ProcFSLoopbackSimulateLatency> must_create(const ProcFSSystemDirectory&);
+    virtual bool value() const override
+    {
+        Locker locker(m_lock);
+        return g_loopback_simulate_latency.load();
+    }
+    virtual void set_value(bool new_value) override
+    {
+        Locker locker(m_lock);
+        g_loopback_simulate_latency.exchange(new_value);
+    }
+
+private:
+    ProcFSLoopbackSimulateLatency();
+    mutable Lock m_lock;
+};
+
+class ProcFSTransparentLargePages : public ProcFSSystemBoolean {
+public:
+    static NonnullRefPtr<ProcFSTransparentLargePages> must_create(const ProcFSSystemDirectory&);
+    virtual bool value() const override
+    {
+        Locker locker(m_lock);
+        return g_transparent_large_pages.load();
+    }
+    virtual void set_value(bool new_value) override
+    {
+        Locker locker(m_lock);
+        g_transparent_large_pages.exchange(new_value);
+    }
+
+private:
+    ProcFSTransparentLargePages();
+    mutable Lock m_lock;
+};
+
 UNMAP_AFTER_INIT NonnullRefPtr<ProcFSDumpKmallocStacks> ProcFSDumpKmallocStacks::must_create(const ProcFSSystemDirectory&)
 {
     return adopt_ref_if_nonnull(new (nothrow) ProcFSDumpKmallocStacks).release_nonnull();
@@ -302,6 +366,19 @@ UNMAP_AFTER_INIT NonnullRefPtr<ProcFSCapsLockRemap> ProcFSCapsLockRemap::must_cr
     return adopt_ref_if_nonnull(new (nothrow) ProcFSCapsLockRemap).release_nonnull();
 }
 
+UNMAP_AFTER_INIT NonnullRefPtr<ProcFSLoopbackSimulatePacketLoss> ProcFSLoopbackSimulatePacketLoss::must_create(const ProcFSSystemDirectory&)
+{
+    return adopt_ref_if_nonnull(new (nothrow) ProcFSLoopbackSimulatePacketLoss).release_nonnull();
+}
+UNMAP_AFTER_INIT NonnullRefPtr<ProcFSLoopbackSimulateLatency> ProcFSLoopbackSimulateLatency::must_create(const ProcFSSystemDirectory&)
+{
+    return adopt_ref_if_nonnull(new (nothrow) ProcFSLoopbackSimulateLatency).release_nonnull();
+}
+UNMAP_AFTER_INIT NonnullRefPtr<ProcFSTransparentLargePages> ProcFSTransparentLargePages::must_create(const ProcFSSystemDirectory&)
+{
+    return adopt_ref_if_nonnull(new (nothrow) ProcFSTransparentLargePages).release_nonnull();
+}
+
 UNMAP_AFTER_INIT ProcFSDumpKmallocStacks::ProcFSDumpKmallocStacks()
     : ProcFSSystemBoolean("kmalloc_stacks"sv)
 {
@@ -317,6 +394,21 @@ UNMAP_AFTER_INIT ProcFSCapsLockRemap::ProcFSCapsLockRemap()
 {
 }
 
+UNMAP_AFTER_INIT ProcFSLoopbackSimulatePacketLoss::ProcFSLoopbackSimulatePacketLoss()
+    : ProcFSSystemBoolean("loopback_simulate_packet_loss"sv)
+{
+}
+
+UNMAP_AFTER_INIT ProcFSLoopbackSimulateLatency::ProcFSLoopbackSimulateLatency()
+    : ProcFSSystemBoolean("loopback_simulate_latency"sv)
+{
+}
+
+UNMAP_AFTER_INIT ProcFSTransparentLargePages::ProcFSTransparentLargePages()
+    : ProcFSSystemBoolean("transparent_large_pages"sv)
+{
+}
+
 class ProcFSSelfProcessFolder final : public ProcFSExposedLink {
 public:
     static NonnullRefPtr<ProcFSSelfProcessFolder> must_create();
@@ -383,6 +475,7 @@ private:
 
         auto super_physical_total = MM.super_physical_pages();
         auto super_physical_used = MM.super_physical_pages_used();
+        auto user_large_pages_mapped = MM.user_large_pages_mapped();
         mm_lock.unlock();
 
         JsonObjectSerializer<KBufferBuilder> json { builder };
@@ -395,6 +488,7 @@ private:
         json.add("user_physical_uncommitted", user_physical_pages_uncommitted);
         json.add("super_physical_allocated", super_physical_used);
         json.add("super_physical_available", super_physical_total - super_physical_used);
+        json.add("user_large_pages_mapped", user_large_pages_mapped);
         json.add("kmalloc_call_count", stats.kmalloc_call_count);
         json.add("kfree_call_count", stats.kfree_call_count);
         slab_alloc_stats([&json](size_t slab_size, size_t num_allocated, size_t num_free) {
@@ -834,6 +928,9 @@ UNMAP_AFTER_INIT NonnullRefPtr<ProcFSSystemDirectory> ProcFSSystemDirectory::mus
     folder->m_components.append(ProcFSDumpKmallocStacks::must_create(folder));
     folder->m_components.append(ProcFSUBSanDeadly::must_create(folder));
     folder->m_components.append(ProcFSCapsLockRemap::must_create(folder));
+    folder->m_components.append(ProcFSLoopbackSimulatePacketLoss::must_create(folder));
+    folder->m_components.append(ProcFSLoopbackSimulateLatency::must_create(folder));
+    folder->m_components.append(ProcFSTransparentLargePages::must_create(folder));
     return folder;
 }
 
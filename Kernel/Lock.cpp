@@ -13,6 +13,10 @@
 
 namespace Kernel {
 
+// How long we're willing to spin on a lock whose holder is running on another processor
+// before giving up and blocking. Most critical sections are much shorter than this.
+static constexpr size_t adaptive_spin_limit = 1000;
+
 #if LOCK_DEBUG
 void Lock::lock(Mode mode, const SourceLocation& location)
 #else
@@ -25,6 +29,7 @@ void Lock::lock(Mode mode)
     VERIFY(mode != Mode::Unlocked);
     auto current_thread = Thread::current();
     ScopedCritical critical; // in case we're not in a critical section already
+    bool did_spin = false;
     for (;;) {
         if (m_lock.exchange(true, AK::memory_order_acq_rel) != false) {
             // I don't know *who* is using "m_lock", so just yield.
@@ -106,10 +111,28 @@ void Lock::lock(Mode mode)
         default:
             VERIFY_NOT_REACHED();
         }
+
+        // If the lock is held exclusively by a thread that is running on another
+        // processor right now, it's likely to be released very soon. Spin for a bit
+        // instead of paying for two context switches.
+        if (!did_spin && current_mode == Mode::Exclusive && m_holder->is_active()) {
+            RefPtr<Thread> holder = m_holder;
+            m_lock.store(false, AK::memory_order_release);
+            did_spin = true;
+            dbgln_if(LOCK_TRACE_DEBUG, "Lock::lock @ {} ({}) spinning on {}...", this, m_name, *holder);
+            for (size_t i = 0; i < adaptive_spin_limit; i++) {
+                if (m_mode.load(AK::MemoryOrder::memory_order_relaxed) != Mode::Exclusive || !holder->is_active())
+                    break;
+                Processor::wait_check();
+            }
+            continue;
+        }
+
         m_lock.store(false, AK::memory_order_release);
         dbgln_if(LOCK_TRACE_DEBUG, "Lock::lock @ {} ({}) waiting...", this, m_name);
         m_queue.wait_forever(m_name);
         dbgln_if(LOCK_TRACE_DEBUG, "Lock::lock @ {} ({}) waited", this, m_name);
+        did_spin = false;
     }
 }
 
@@ -186,7 +186,7 @@ PortAllocationResult IPv4Socket::allocate_local_port_if_needed()
     return { m_local_port, true };
 }
 
-KResultOr<size_t> IPv4Socket::sendto(FileDescription&, const UserOrKernelBuffer& data, size_t data_length, [[maybe_unused]] int flags, Userspace<const sockaddr*> addr, socklen_t addr_length)
+KResultOr<size_t> IPv4Socket::sendto(FileDescription& description, const UserOrKernelBuffer& data, size_t data_length, [[maybe_unused]] int flags, Userspace<const sockaddr*> addr, socklen_t addr_length)
 {
     Locker locker(lock());
 
@@ -240,6 +240,16 @@ KResultOr<size_t> IPv4Socket::sendto(FileDescription&, const UserOrKernelBuffer&
     }
 
     auto nsent_or_error = protocol_send(data, data_length);
+    // The protocol may have no room to send right now (e.g. a full TCP send window), so wait for it like sys$write does.
+    while (nsent_or_error.is_error() && nsent_or_error.error() == EAGAIN && description.is_blocking()) {
+        locker.unlock();
+        auto unblock_flags = Thread::FileBlocker::BlockFlags::None;
+        auto res = Thread::current()->block<Thread::WriteBlocker>({}, description, unblock_flags);
+        locker.lock();
+        if (res.was_interrupted())
+            return EINTR;
+        nsent_or_error = protocol_send(data, data_length);
+    }
     if (!nsent_or_error.is_error())
         Thread::current()->did_ipv4_socket_write(nsent_or_error.value());
     return nsent_or_error;
@@ -4,13 +4,19 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/ByteBuffer.h>
 #include <AK/Singleton.h>
 #include <Kernel/Net/LoopbackAdapter.h>
+#include <Kernel/Random.h>
+#include <Kernel/TimerQueue.h>
 
 namespace Kernel {
 
 static bool s_loopback_initialized = false;
 
+Atomic<bool> g_loopback_simulate_packet_loss { false };
+Atomic<bool> g_loopback_simulate_latency { false };
+
 NonnullRefPtr<LoopbackAdapter> LoopbackAdapter::create()
 {
     return adopt_ref(*new LoopbackAdapter());
@@ -32,6 +38,20 @@ LoopbackAdapter::~LoopbackAdapter()
 void LoopbackAdapter::send_raw(ReadonlyBytes payload)
 {
     dbgln("LoopbackAdapter: Sending {} byte(s) to myself.", payload.size());
+
+    if (g_loopback_simulate_packet_loss && get_fast_random<u8>() < simulated_packet_loss_threshold) {
+        dbgln("LoopbackAdapter: Dropping {} byte(s) to simulate packet loss.", payload.size());
+        return;
+    }
+
+    if (g_loopback_simulate_latency) {
+        auto buffer = ByteBuffer::copy(payload);
+        TimerQueue::the().add_timer(CLOCK_MONOTONIC_COARSE, Time::from_milliseconds(simulated_latency_ms), [this, buffer = move(buffer)] {
+            did_receive(buffer);
+        });
+        return;
+    }
+
     did_receive(payload);
 }
 
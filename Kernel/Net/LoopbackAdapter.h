@@ -6,10 +6,16 @@
 
 #pragma once
 
+#include <AK/Atomic.h>
 #include <Kernel/Net/NetworkAdapter.h>
 
 namespace Kernel {
 
+// These make the loopback adapter behave like a lossy long-distance link, which is useful
+// for exercising TCP loss recovery and congestion control without any real network.
+extern Atomic<bool> g_loopback_simulate_packet_loss;
+extern Atomic<bool> g_loopback_simulate_latency;
+
 class LoopbackAdapter final : public NetworkAdapter {
     AK_MAKE_ETERNAL
 
@@ -22,6 +28,11 @@ public:
 
     virtual void send_raw(ReadonlyBytes) override;
     virtual const char* class_name() const override { return "LoopbackAdapter"; }
+
+private:
+    // Drops roughly 1 in 100 packets and delays the rest by 20 ms when enabled.
+    static constexpr u8 simulated_packet_loss_threshold = 3;
+    static constexpr i64 simulated_latency_ms = 20;
 };
 
 }
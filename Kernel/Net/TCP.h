@@ -21,6 +21,15 @@ struct TCPFlags {
     };
 };
 
+enum class TCPOptionKind : u8 {
+    End = 0,
+    NoOperation = 1,
+    MSS = 2,
+    WindowScale = 3,
+    SACKPermitted = 4,
+    SACK = 5,
+};
+
 class [[gnu::packed]] TCPOptionMSS {
 public:
     TCPOptionMSS(u16 value)
@@ -38,6 +47,42 @@ private:
 
 static_assert(sizeof(TCPOptionMSS) == 4);
 
+// Window scale and SACK-permitted are not a multiple of four bytes long, so we
+// pad them with leading NOPs to keep the option block 32-bit aligned.
+class [[gnu::packed]] TCPOptionWindowScale {
+public:
+    TCPOptionWindowScale(u8 shift_count)
+        : m_shift_count(shift_count)
+    {
+    }
+
+    u8 shift_count() const { return m_shift_count; }
+
+private:
+    u8 m_padding { (u8)TCPOptionKind::NoOperation };
+    u8 m_option_kind { (u8)TCPOptionKind::WindowScale };
+    u8 m_option_length { 3 };
+    u8 m_shift_count { 0 };
+};
+
+static_assert(sizeof(TCPOptionWindowScale) == 4);
+
+class [[gnu::packed]] TCPOptionSACKPermitted {
+private:
+    u8 m_padding[2] { (u8)TCPOptionKind::NoOperation, (u8)TCPOptionKind::NoOperation };
+    u8 m_option_kind { (u8)TCPOptionKind::SACKPermitted };
+    u8 m_option_length { 2 };
+};
+
+static_assert(sizeof(TCPOptionSACKPermitted) == 4);
+
+struct [[gnu::packed]] TCPSACKBlock {
+    NetworkOrdered<u32> left_edge;
+    NetworkOrdered<u32> right_edge;
+};
+
+static_assert(sizeof(TCPSACKBlock) == 8);
+
 class [[gnu::packed]] TCPPacket {
 public:
     TCPPacket() = default;
@@ -77,6 +122,31 @@ public:
     u16 urgent() const { return m_urgent; }
     void set_urgent(u16 urgent) { m_urgent = urgent; }
 
+    ReadonlyBytes options() const { return { ((const u8*)this) + sizeof(TCPPacket), header_size() - sizeof(TCPPacket) }; }
+
+    template<typename Callback>
+    void for_each_option(Callback callback) const
+    {
+        auto bytes = options();
+        size_t offset = 0;
+        while (offset < bytes.size()) {
+            auto kind = (TCPOptionKind)bytes[offset];
+            if (kind == TCPOptionKind::End)
+                return;
+            if (kind == TCPOptionKind::NoOperation) {
+                ++offset;
+                continue;
+            }
+            if (offset + 1 >= bytes.size())
+                return;
+            size_t length = bytes[offset + 1];
+            if (length < 2 || offset + length > bytes.size())
+                return;
+            callback(kind, bytes.slice(offset + 2, length - 2));
+            offset += length;
+        }
+    }
+
     const void* payload() const { return ((const u8*)this) + header_size(); }
     void* payload() { return ((u8*)this) + header_size(); }
 
@@ -21,6 +21,23 @@
 
 namespace Kernel {
 
+// Sequence numbers wrap around, so they have to be compared using serial number arithmetic (RFC 1982).
+static inline bool sequence_less_than(u32 a, u32 b)
+{
+    return static_cast<i32>(a - b) < 0;
+}
+
+static inline bool sequence_less_than_or_equal(u32 a, u32 b)
+{
+    return static_cast<i32>(a - b) <= 0;
+}
+
+// RFC 6928: Increasing TCP's Initial Window
+static u32 initial_congestion_window(u32 mss)
+{
+    return min(10 * mss, max(2 * mss, 14600u));
+}
+
 void TCPSocket::for_each(Function<void(const TCPSocket&)> callback)
 {
     Locker locker(sockets_by_tuple().lock(), Lock::Mode::Shared);
@@ -135,6 +152,7 @@ TCPSocket::TCPSocket(int protocol)
     : IPv4Socket(SOCK_STREAM, protocol)
 {
     m_last_retransmit_time = kgettimeofday();
+    m_congestion_window = initial_congestion_window(m_send_mss);
 }
 
 TCPSocket::~TCPSocket()
@@ -172,8 +190,20 @@ KResultOr<size_t> TCPSocket::protocol_send(const UserOrKernelBuffer& data, size_
     RoutingDecision routing_decision = route_to(peer_address(), local_address(), bound_interface());
     if (routing_decision.is_zero())
         return EHOSTUNREACH;
-    size_t mss = routing_decision.adapter->mtu() - sizeof(IPv4Packet) - sizeof(TCPPacket);
+    size_t mss = min<size_t>(routing_decision.adapter->mtu() - sizeof(IPv4Packet) - sizeof(TCPPacket), m_send_mss);
     data_length = min(data_length, mss);
+    {
+        Locker locker(m_not_acked_lock, Lock::Mode::Shared);
+        auto window = send_window();
+        if (m_not_acked_size >= window) {
+            if (m_not_acked_size > 0)
+                return EAGAIN;
+            // RFC 9293 (3.8.6.1): With nothing in flight, probe a zero window with a single byte.
+            data_length = min<size_t>(data_length, 1);
+        } else {
+            data_length = min(data_length, window - m_not_acked_size);
+        }
+    }
     int err = send_tcp_packet(TCPFlags::PUSH | TCPFlags::ACK, &data, data_length, &routing_decision);
     if (err < 0)
         return KResult((ErrnoCode)-err);
@@ -195,8 +225,17 @@ KResult TCPSocket::send_tcp_packet(u16 flags, const UserOrKernelBuffer* payload,
 
     auto ipv4_payload_offset = routing_decision.adapter->ipv4_payload_offset();
 
-    const bool has_mss_option = flags == TCPFlags::SYN;
-    const size_t options_size = has_mss_option ? sizeof(TCPOptionMSS) : 0;
+    const bool has_syn = flags & TCPFlags::SYN;
+    // RFC 7323 and RFC 2018 only allow these options in a SYN-ACK if the peer sent them in its SYN.
+    const bool has_window_scale_option = has_syn && (!(flags & TCPFlags::ACK) || m_window_scaling_enabled);
+    const bool has_sack_permitted_option = has_syn && (!(flags & TCPFlags::ACK) || m_sack_permitted);
+    size_t options_size = 0;
+    if (has_syn)
+        options_size += sizeof(TCPOptionMSS);
+    if (has_window_scale_option)
+        options_size += sizeof(TCPOptionWindowScale);
+    if (has_sack_permitted_option)
+        options_size += sizeof(TCPOptionSACKPermitted);
     const size_t tcp_header_size = sizeof(TCPPacket) + options_size;
     const size_t buffer_size = ipv4_payload_offset + tcp_header_size + payload_size;
     auto packet = routing_decision.adapter->acquire_packet_buffer(buffer_size);
@@ -210,7 +249,7 @@ KResult TCPSocket::send_tcp_packet(u16 flags, const UserOrKernelBuffer* payload,
     VERIFY(local_port());
     tcp_packet.set_source_port(local_port());
     tcp_packet.set_destination_port(peer_port());
-    tcp_packet.set_window_size(NumericLimits<u16>::max());
+    tcp_packet.set_window_size(receive_window_to_advertise(has_syn));
     tcp_packet.set_sequence_number(m_sequence_number);
     tcp_packet.set_data_offset(tcp_header_size / sizeof(u32));
     tcp_packet.set_flags(flags);
@@ -226,17 +265,35 @@ KResult TCPSocket::send_tcp_packet(u16 flags, const UserOrKernelBuffer* payload,
         return EFAULT;
     }
 
-    if (flags & TCPFlags::SYN) {
+    u32 sequence_number = m_sequence_number;
+    if (has_syn) {
+        m_last_ack_number_received = m_sequence_number;
+        m_recover = m_sequence_number;
+        m_highest_sacked = m_sequence_number;
         ++m_sequence_number;
     } else {
         m_sequence_number += payload_size;
     }
 
-    if (has_mss_option) {
+    if (options_size > 0) {
+        VERIFY(packet->buffer.size() >= ipv4_payload_offset + sizeof(TCPPacket) + options_size);
+        u8* options = packet->buffer.data() + ipv4_payload_offset + sizeof(TCPPacket);
+
         u16 mss = routing_decision.adapter->mtu() - sizeof(IPv4Packet) - sizeof(TCPPacket);
         TCPOptionMSS mss_option { mss };
-        VERIFY(packet->buffer.size() >= ipv4_payload_offset + sizeof(TCPPacket) + sizeof(mss_option));
-        memcpy(packet->buffer.data() + ipv4_payload_offset + sizeof(TCPPacket), &mss_option, sizeof(mss_option));
+        memcpy(options, &mss_option, sizeof(mss_option));
+        options += sizeof(mss_option);
+
+        if (has_window_scale_option) {
+            TCPOptionWindowScale window_scale_option { receive_window_scale };
+            memcpy(options, &window_scale_option, sizeof(window_scale_option));
+            options += sizeof(window_scale_option);
+        }
+
+        if (has_sack_permitted_option) {
+            TCPOptionSACKPermitted sack_permitted_option;
+            memcpy(options, &sack_permitted_option, sizeof(sack_permitted_option));
+        }
     }
 
     tcp_packet.set_checksum(compute_tcp_checksum(local_address(), peer_address(), tcp_packet, payload_size));
@@ -247,7 +304,11 @@ KResult TCPSocket::send_tcp_packet(u16 flags, const UserOrKernelBuffer* payload,
     m_bytes_out += buffer_size;
     if (tcp_packet.has_syn() || payload_size > 0) {
         Locker locker(m_not_acked_lock);
-        m_not_acked.append({ m_sequence_number, move(packet), ipv4_payload_offset, *routing_decision.adapter });
+        auto now = kgettimeofday();
+        // RFC 6298 (5.1): Start the retransmission timer if it isn't running already.
+        if (m_not_acked.is_empty())
+            m_last_retransmit_time = now;
+        m_not_acked.append({ sequence_number, m_sequence_number, payload_size, move(packet), ipv4_payload_offset, *routing_decision.adapter, now });
         m_not_acked_size += payload_size;
         enqueue_for_retransmit();
     } else {
@@ -257,45 +318,298 @@ KResult TCPSocket::send_tcp_packet(u16 flags, const UserOrKernelBuffer* payload,
     return KSuccess;
 }
 
+u16 TCPSocket::receive_window_to_advertise(bool is_syn)
+{
+    size_t window = available_space_in_receive_buffer();
+    // RFC 7323 (2.2): The window field in a SYN segment is never scaled.
+    u8 shift = (!is_syn && m_window_scaling_enabled) ? receive_window_scale : 0;
+    u16 scaled_window = min(window >> shift, (size_t)NumericLimits<u16>::max());
+    m_last_advertised_window = (u32)scaled_window << shift;
+    return scaled_window;
+}
+
+void TCPSocket::process_syn_options(const TCPPacket& packet)
+{
+    VERIFY(packet.has_syn());
+
+    u32 peer_mss = default_mss;
+    Optional<u8> window_scale;
+    bool sack_permitted = false;
+    packet.for_each_option([&](TCPOptionKind kind, ReadonlyBytes data) {
+        switch (kind) {
+        case TCPOptionKind::MSS:
+            if (data.size() == 2 && (data[0] || data[1]))
+                peer_mss = (data[0] << 8) | data[1];
+            break;
+        case TCPOptionKind::WindowScale:
+            if (data.size() == 1)
+                window_scale = data[0];
+            break;
+        case TCPOptionKind::SACKPermitted:
+            sack_permitted = true;
+            break;
+        default:
+            break;
+        }
+    });
+
+    auto routing_decision = route_to(peer_address(), local_address(), bound_interface());
+    if (!routing_decision.is_zero())
+        peer_mss = min<u32>(peer_mss, routing_decision.adapter->mtu() - sizeof(IPv4Packet) - sizeof(TCPPacket));
+
+    m_send_mss = peer_mss;
+    // RFC 7323 (2.3): Shift counts larger than 14 must be treated as 14.
+    m_window_scaling_enabled = window_scale.has_value();
+    m_send_window_scale = window_scale.has_value() ? min(window_scale.value(), (u8)14) : 0;
+    m_sack_permitted = sack_permitted;
+    m_send_window_size = packet.window_size();
+    m_congestion_window = initial_congestion_window(m_send_mss);
+
+    dbgln_if(TCP_SOCKET_DEBUG, "TCPSocket({}): peer mss={}, window scale={}, sack permitted={}", this, m_send_mss, m_send_window_scale, m_sack_permitted);
+}
+
 void TCPSocket::receive_tcp_packet(const TCPPacket& packet, u16 size)
 {
-    if (packet.has_ack()) {
-        u32 ack_number = packet.ack_number();
+    if (packet.has_syn() && m_state == State::SynSent)
+        process_syn_options(packet);
 
-        dbgln_if(TCP_SOCKET_DEBUG, "TCPSocket: receive_tcp_packet: {}", ack_number);
+    if (packet.has_ack())
+        process_ack(packet, size - packet.header_size());
 
-        int removed = 0;
-        Locker locker(m_not_acked_lock);
-        while (!m_not_acked.is_empty()) {
-            auto& packet = m_not_acked.first();
-
-            dbgln_if(TCP_SOCKET_DEBUG, "TCPSocket: iterate: {}", packet.ack_number);
-
-            if (packet.ack_number <= ack_number) {
-                auto old_adapter = packet.adapter.strong_ref();
-                if (old_adapter)
-                    old_adapter->release_packet_buffer(*packet.buffer);
-                TCPPacket& tcp_packet = *(TCPPacket*)(packet.buffer->buffer.data() + packet.ipv4_payload_offset);
-                auto payload_size = packet.buffer->buffer.data() + packet.buffer->buffer.size() - (u8*)tcp_packet.payload();
-                m_not_acked_size -= payload_size;
-                evaluate_block_conditions();
-                m_not_acked.take_first();
-                removed++;
+    m_packets_in++;
+    m_bytes_in += packet.header_size() + size;
+}
+
+void TCPSocket::process_ack(const TCPPacket& packet, size_t payload_size)
+{
+    u32 ack_number = packet.ack_number();
+
+    dbgln_if(TCP_SOCKET_DEBUG, "TCPSocket: receive_tcp_packet: {}", ack_number);
+
+    // RFC 7323 (2.2): The window field in a SYN segment is never scaled.
+    u32 send_window_size = (u32)packet.window_size() << (packet.has_syn() ? 0 : m_send_window_scale);
+
+    Locker locker(m_not_acked_lock);
+
+    if (m_sack_permitted)
+        process_sack_blocks(packet);
+
+    auto now = kgettimeofday();
+    Optional<Time> rtt_sample;
+    size_t bytes_acked = 0;
+    int removed = 0;
+    while (!m_not_acked.is_empty()) {
+        auto& packet = m_not_acked.first();
+
+        dbgln_if(TCP_SOCKET_DEBUG, "TCPSocket: iterate: {}", packet.ack_number);
+
+        if (!sequence_less_than_or_equal(packet.ack_number, ack_number))
+            break;
+
+        // Karn's algorithm: Retransmitted packets don't produce usable RTT samples.
+        if (packet.tx_counter == 0)
+            rtt_sample = now - packet.sent_time;
+
+        auto old_adapter = packet.adapter.strong_ref();
+        if (old_adapter)
+            old_adapter->release_packet_buffer(*packet.buffer);
+        m_not_acked_size -= packet.payload_size;
+        bytes_acked += packet.payload_size;
+        m_not_acked.take_first();
+        removed++;
+    }
+
+    // RFC 5681 (2): A duplicate ACK carries no data, doesn't move the window and acknowledges nothing new.
+    bool is_duplicate_ack = ack_number == m_last_ack_number_received
+        && payload_size == 0
+        && !packet.has_syn()
+        && !packet.has_fin()
+        && send_window_size == m_send_window_size
+        && !m_not_acked.is_empty();
+
+    if (sequence_less_than(m_last_ack_number_received, ack_number)) {
+        m_last_ack_number_received = ack_number;
+        m_received_duplicate_acks = 0;
+        if (sequence_less_than(m_highest_sacked, ack_number))
+            m_highest_sacked = ack_number;
+
+        // RFC 6298 (5.3): Restart the retransmission timer whenever new data is acknowledged.
+        m_retransmit_attempts = 0;
+        m_last_retransmit_time = now;
+        if (rtt_sample.has_value())
+            update_rtt_estimate(rtt_sample.value());
+
+        if (m_loss_recovery != LossRecovery::None && sequence_less_than(ack_number, m_recover)) {
+            if (m_loss_recovery == LossRecovery::FastRecovery) {
+                // RFC 6582 (3.2, step 3): A partial acknowledgment means the next packet was lost as well.
+                m_congestion_window -= min<u32>(m_congestion_window, bytes_acked);
+                m_congestion_window += m_send_mss;
+                retransmit_lost_packets(m_send_mss);
             } else {
-                break;
+                // After a timeout we resend everything up to m_recover, clocked by slow start.
+                m_congestion_window += min<u32>(bytes_acked, m_send_mss);
+                retransmit_lost_packets(2 * max<size_t>(bytes_acked, 1));
             }
+        } else if (m_loss_recovery != LossRecovery::None) {
+            // RFC 6582 (3.2, step 3): A full acknowledgment ends recovery.
+            if (m_loss_recovery == LossRecovery::FastRecovery)
+                m_congestion_window = min(m_slow_start_threshold, max<u32>(m_not_acked_size, m_send_mss) + m_send_mss);
+            m_loss_recovery = LossRecovery::None;
+        } else if (m_congestion_window < m_slow_start_threshold) {
+            // RFC 5681 (3.1): Slow start, counting acknowledged bytes as RFC 3465 suggests.
+            m_congestion_window += min<u32>(bytes_acked, m_send_mss);
+        } else {
+            // RFC 5681 (3.1): Congestion avoidance grows the window by roughly one MSS per RTT.
+            m_congestion_window += max<u32>(1, (u64)m_send_mss * m_send_mss / m_congestion_window);
         }
+    } else if (is_duplicate_ack) {
+        ++m_received_duplicate_acks;
+        if (m_loss_recovery == LossRecovery::FastRecovery) {
+            // RFC 5681 (3.2, step 4): Every further duplicate ACK means another packet has left the network.
+            m_congestion_window += m_send_mss;
+            if (m_sack_permitted)
+                retransmit_lost_packets(m_send_mss);
+        } else if (m_loss_recovery == LossRecovery::None && m_received_duplicate_acks == 3 && sequence_less_than(m_recover, ack_number)) {
+            enter_fast_recovery();
+        }
+    }
+
+    bool window_changed = send_window_size != m_send_window_size;
+    m_send_window_size = send_window_size;
+
+    // Writers wait for room in the send window, which acknowledgments and window updates make.
+    if (removed > 0 || window_changed)
+        evaluate_block_conditions();
+
+    if (m_not_acked.is_empty()) {
+        m_retransmit_attempts = 0;
+        m_loss_recovery = LossRecovery::None;
+        dequeue_for_retransmit();
+    }
+
+    dbgln_if(TCP_SOCKET_DEBUG, "TCPSocket: receive_tcp_packet acknowledged {} packets, cwnd={}, ssthresh={}", removed, m_congestion_window, m_slow_start_threshold);
+}
 
-        if (m_not_acked.is_empty()) {
-            m_retransmit_attempts = 0;
-            dequeue_for_retransmit();
+void TCPSocket::process_sack_blocks(const TCPPacket& packet)
+{
+    VERIFY(m_not_acked_lock.is_locked());
+
+    packet.for_each_option([&](TCPOptionKind kind, ReadonlyBytes data) {
+        if (kind != TCPOptionKind::SACK)
+            return;
+        for (size_t offset = 0; offset + sizeof(TCPSACKBlock) <= data.size(); offset += sizeof(TCPSACKBlock)) {
+            TCPSACKBlock block;
+            memcpy(&block, data.offset(offset), sizeof(block));
+            u32 left_edge = block.left_edge;
+            u32 right_edge = block.right_edge;
+            for (auto& outgoing_packet : m_not_acked) {
+                if (sequence_less_than_or_equal(left_edge, outgoing_packet.sequence_number) && sequence_less_than_or_equal(outgoing_packet.ack_number, right_edge))
+                    outgoing_packet.sacked = true;
+            }
+            if (sequence_less_than(m_highest_sacked, right_edge))
+                m_highest_sacked = right_edge;
         }
+    });
+}
 
-        dbgln_if(TCP_SOCKET_DEBUG, "TCPSocket: receive_tcp_packet acknowledged {} packets", removed);
+void TCPSocket::update_rtt_estimate(const Time& sample)
+{
+    // RFC 6298 (2): Computing the RTO, with a clock granularity of one millisecond.
+    i64 rtt_us = max<i64>(sample.to_microseconds(), 1);
+    if (!m_has_rtt_sample) {
+        m_smoothed_rtt_us = rtt_us;
+        m_rtt_variance_us = rtt_us / 2;
+        m_has_rtt_sample = true;
+    } else {
+        i64 delta = m_smoothed_rtt_us > rtt_us ? m_smoothed_rtt_us - rtt_us : rtt_us - m_smoothed_rtt_us;
+        m_rtt_variance_us = (3 * m_rtt_variance_us + delta) / 4;
+        m_smoothed_rtt_us = (7 * m_smoothed_rtt_us + rtt_us) / 8;
     }
 
-    m_packets_in++;
-    m_bytes_in += packet.header_size() + size;
+    i64 rto_us = m_smoothed_rtt_us + max<i64>(4 * m_rtt_variance_us, 1000);
+    rto_us = clamp(rto_us, minimum_retransmission_timeout_ms * 1000, maximum_retransmission_timeout_ms * 1000);
+    m_retransmission_timeout = Time::from_microseconds(rto_us);
+}
+
+void TCPSocket::enter_fast_recovery()
+{
+    VERIFY(m_not_acked_lock.is_locked());
+
+    // RFC 5681 (3.2, step 2) and RFC 6582 (3.2, step 2)
+    m_slow_start_threshold = max<u32>(m_not_acked_size / 2, 2 * m_send_mss);
+    m_recover = m_sequence_number;
+    m_loss_recovery = LossRecovery::FastRecovery;
+    for (auto& packet : m_not_acked)
+        packet.retransmitted_in_recovery = false;
+
+    dbgln_if(TCP_SOCKET_DEBUG, "TCPSocket({}) entering fast recovery, ssthresh={}", this, m_slow_start_threshold);
+
+    retransmit_lost_packets(m_send_mss);
+    m_congestion_window = m_slow_start_threshold + 3 * m_send_mss;
+}
+
+void TCPSocket::retransmit_lost_packets(size_t max_bytes)
+{
+    VERIFY(m_not_acked_lock.is_locked());
+
+    auto routing_decision = route_to(peer_address(), local_address(), bound_interface());
+    if (routing_decision.is_zero())
+        return;
+
+    size_t bytes_sent = 0;
+    for (auto& packet : m_not_acked) {
+        if (packet.sacked || packet.retransmitted_in_recovery)
+            continue;
+
+        // The oldest unacknowledged packet is always presumed lost. Beyond that we only know about
+        // holes below the highest SACKed sequence number (RFC 6675), or everything after a timeout.
+        bool is_oldest = &packet == &m_not_acked.first();
+        bool is_lost = is_oldest
+            || (m_sack_permitted && sequence_less_than(packet.sequence_number, m_highest_sacked))
+            || (m_loss_recovery == LossRecovery::Timeout && sequence_less_than_or_equal(packet.ack_number, m_recover));
+        if (!is_lost)
+            break;
+
+        retransmit_packet(packet, routing_decision);
+        packet.retransmitted_in_recovery = true;
+        bytes_sent += max<size_t>(packet.payload_size, 1);
+        if (bytes_sent >= max_bytes)
+            break;
+    }
+}
+
+void TCPSocket::retransmit_packet(OutgoingPacket& packet, RoutingDecision& routing_decision)
+{
+    packet.tx_counter++;
+
+    if constexpr (TCP_SOCKET_DEBUG) {
+        auto& tcp_packet = *(const TCPPacket*)(packet.buffer->buffer.data() + packet.ipv4_payload_offset);
+        dbgln("Sending TCP packet from {}:{} to {}:{} with ({}{}{}{}) seq_no={}, ack_no={}, tx_counter={}",
+            local_address(), local_port(),
+            peer_address(), peer_port(),
+            (tcp_packet.has_syn() ? "SYN " : ""),
+            (tcp_packet.has_ack() ? "ACK " : ""),
+            (tcp_packet.has_fin() ? "FIN " : ""),
+            (tcp_packet.has_rst() ? "RST " : ""),
+            tcp_packet.sequence_number(),
+            tcp_packet.ack_number(),
+            packet.tx_counter);
+    }
+
+    size_t ipv4_payload_offset = routing_decision.adapter->ipv4_payload_offset();
+    if (ipv4_payload_offset != packet.ipv4_payload_offset) {
+        // FIXME: Add support for this. This can happen if after a route change
+        // we ended up on another adapter which doesn't have the same layer 2 type
+        // like the previous adapter.
+        VERIFY_NOT_REACHED();
+    }
+    routing_decision.adapter->fill_in_ipv4_header(*packet.buffer,
+        local_address(), routing_decision.next_hop, peer_address(),
+        IPv4Protocol::TCP, packet.buffer->buffer.size() - ipv4_payload_offset, ttl());
+    routing_decision.adapter->send_packet({ packet.buffer->buffer.data(), packet.buffer->buffer.size() });
+    m_packets_out++;
+    m_bytes_out += packet.buffer->buffer.size();
+    m_retransmitted_packets++;
 }
 
 bool TCPSocket::should_delay_next_ack() const
@@ -520,13 +834,18 @@ void TCPSocket::retransmit_packets()
 {
     auto now = kgettimeofday();
 
-    // RFC6298 says we should have at least one second between retransmits. According to
+    // RFC 6298 (5.5): Back off the timer by doubling it on every expiry. According to
     // RFC1122 we must do exponential backoff - even for SYN packets.
-    i64 retransmit_interval = 1;
-    for (decltype(m_retransmit_attempts) i = 0; i < m_retransmit_attempts; i++)
-        retransmit_interval *= 2;
+    auto retransmission_timeout = m_retransmission_timeout;
+    for (decltype(m_retransmit_attempts) i = 0; i < m_retransmit_attempts; i++) {
+        retransmission_timeout += retransmission_timeout;
+        if (retransmission_timeout.to_milliseconds() >= maximum_retransmission_timeout_ms) {
+            retransmission_timeout = Time::from_milliseconds(maximum_retransmission_timeout_ms);
+            break;
+        }
+    }
 
-    if (m_last_retransmit_time > now - Time::from_seconds(retransmit_interval))
+    if (m_last_retransmit_time > now - retransmission_timeout)
         return;
 
     dbgln_if(TCP_SOCKET_DEBUG, "TCPSocket({}) handling retransmit", this);
@@ -541,42 +860,29 @@ void TCPSocket::retransmit_packets()
         return;
     }
 
-    auto routing_decision = route_to(peer_address(), local_address(), bound_interface());
-    if (routing_decision.is_zero())
+    Locker locker(m_not_acked_lock);
+    if (m_not_acked.is_empty())
         return;
 
-    Locker locker(m_not_acked_lock, Lock::Mode::Shared);
-    for (auto& packet : m_not_acked) {
-        packet.tx_counter++;
-
-        if constexpr (TCP_SOCKET_DEBUG) {
-            auto& tcp_packet = *(const TCPPacket*)(packet.buffer->buffer.data() + packet.ipv4_payload_offset);
-            dbgln("Sending TCP packet from {}:{} to {}:{} with ({}{}{}{}) seq_no={}, ack_no={}, tx_counter={}",
-                local_address(), local_port(),
-                peer_address(), peer_port(),
-                (tcp_packet.has_syn() ? "SYN " : ""),
-                (tcp_packet.has_ack() ? "ACK " : ""),
-                (tcp_packet.has_fin() ? "FIN " : ""),
-                (tcp_packet.has_rst() ? "RST " : ""),
-                tcp_packet.sequence_number(),
-                tcp_packet.ack_number(),
-                packet.tx_counter);
-        }
-
-        size_t ipv4_payload_offset = routing_decision.adapter->ipv4_payload_offset();
-        if (ipv4_payload_offset != packet.ipv4_payload_offset) {
-            // FIXME: Add support for this. This can happen if after a route change
-            // we ended up on another adapter which doesn't have the same layer 2 type
-            // like the previous adapter.
-            VERIFY_NOT_REACHED();
-        }
-        routing_decision.adapter->fill_in_ipv4_header(*packet.buffer,
-            local_address(), routing_decision.next_hop, peer_address(),
-            IPv4Protocol::TCP, packet.buffer->buffer.size() - ipv4_payload_offset, ttl());
-        routing_decision.adapter->send_packet({ packet.buffer->buffer.data(), packet.buffer->buffer.size() });
-        m_packets_out++;
-        m_bytes_out += packet.buffer->buffer.size();
+    auto& oldest_packet = m_not_acked.first();
+    bool is_syn = ((const TCPPacket*)(oldest_packet.buffer->buffer.data() + oldest_packet.ipv4_payload_offset))->has_syn();
+    if (!is_syn) {
+        // RFC 5681 (3.1): Fall back to slow start with a window of one packet. The threshold
+        // is only reduced once per timeout, not again for each backed-off retransmission.
+        if (m_retransmit_attempts == 1)
+            m_slow_start_threshold = max<u32>(m_not_acked_size / 2, 2 * m_send_mss);
+        m_congestion_window = m_send_mss;
     }
+
+    // RFC 6582 (4): Remember the highest sequence number sent so later partial ACKs
+    // can clock out the rest of the lost data.
+    m_recover = m_sequence_number;
+    m_loss_recovery = LossRecovery::Timeout;
+    m_received_duplicate_acks = 0;
+    for (auto& packet : m_not_acked)
+        packet.retransmitted_in_recovery = false;
+
+    retransmit_lost_packets(m_send_mss);
 }
 
 bool TCPSocket::can_write(const FileDescription& file_description, size_t size) const
@@ -587,11 +893,24 @@ bool TCPSocket::can_write(const FileDescription& file_description, size_t size)
     if (m_state == State::SynSent || m_state == State::SynReceived)
         return false;
 
-    if (!file_description.is_blocking())
-        return true;
-
+    // Blocking and non-blocking writers alike have to respect the send window.
+    // Always allow at least one packet in flight, so a zero window gets probed eventually.
     Locker lock(m_not_acked_lock);
-    return m_not_acked_size + size <= m_send_window_size;
+    return m_not_acked_size == 0 || m_not_acked_size < send_window();
+}
+
+KResultOr<size_t> TCPSocket::recvfrom(FileDescription& description, UserOrKernelBuffer& buffer, size_t buffer_length, int flags, Userspace<sockaddr*> addr, Userspace<socklen_t*> addr_length, Time& packet_timestamp)
+{
+    auto nreceived_or_error = IPv4Socket::recvfrom(description, buffer, buffer_length, flags, addr, addr_length, packet_timestamp);
+    if (nreceived_or_error.is_error() || nreceived_or_error.value() == 0)
+        return nreceived_or_error;
+
+    // RFC 1122 (4.2.3.3): Once the application has drained a good part of the receive buffer,
+    // tell the peer about the larger window instead of waiting for it to probe us.
+    Locker locker(lock());
+    if (m_state == State::Established && available_space_in_receive_buffer() / 2 > m_last_advertised_window)
+        [[maybe_unused]] auto rc = send_ack(true);
+    return nreceived_or_error;
 }
 
 }
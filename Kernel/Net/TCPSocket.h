@@ -138,6 +138,14 @@ public:
     KResult send_ack(bool allow_duplicate = false);
     KResult send_tcp_packet(u16 flags, const UserOrKernelBuffer* = nullptr, size_t = 0, RoutingDecision* = nullptr);
     void receive_tcp_packet(const TCPPacket&, u16 size);
+    void process_syn_options(const TCPPacket&);
+
+    u32 send_mss() const { return m_send_mss; }
+    u32 congestion_window() const { return m_congestion_window; }
+    u32 slow_start_threshold() const { return m_slow_start_threshold; }
+    Time smoothed_rtt() const { return Time::from_microseconds(m_smoothed_rtt_us); }
+    Time retransmission_timeout() const { return m_retransmission_timeout; }
+    u32 retransmitted_packets() const { return m_retransmitted_packets; }
 
     bool should_delay_next_ack() const;
 
@@ -156,6 +164,7 @@ public:
     void retransmit_packets();
 
     virtual KResult close() override;
+    virtual KResultOr<size_t> recvfrom(FileDescription&, UserOrKernelBuffer&, size_t, int flags, Userspace<sockaddr*>, Userspace<socklen_t*>, Time&) override;
 
     virtual bool can_write(const FileDescription&, size_t) const override;
 
@@ -181,6 +190,17 @@ private:
     void enqueue_for_retransmit();
     void dequeue_for_retransmit();
 
+    struct OutgoingPacket;
+    void retransmit_packet(OutgoingPacket&, RoutingDecision&);
+    void retransmit_lost_packets(size_t max_bytes);
+    void process_ack(const TCPPacket&, size_t payload_size);
+    void process_sack_blocks(const TCPPacket&);
+    void update_rtt_estimate(const Time& sample);
+    void enter_fast_recovery();
+
+    u16 receive_window_to_advertise(bool is_syn);
+    u32 send_window() const { return min(m_send_window_size, m_congestion_window); }
+
     WeakPtr<TCPSocket> m_originator;
     HashMap<IPv4SocketTuple, NonnullRefPtr<TCPSocket>> m_pending_release_for_accept;
     Direction m_direction { Direction::Unspecified };
@@ -195,11 +215,16 @@ private:
     u32 m_bytes_out { 0 };
 
     struct OutgoingPacket {
+        u32 sequence_number { 0 };
         u32 ack_number { 0 };
+        size_t payload_size { 0 };
         RefPtr<PacketWithTimestamp> buffer;
         size_t ipv4_payload_offset;
         WeakPtr<NetworkAdapter> adapter;
+        Time sent_time;
         int tx_counter { 0 };
+        bool sacked { false };
+        bool retransmitted_in_recovery { false };
     };
 
     mutable Lock m_not_acked_lock { "TCPSocket unacked packets" };
@@ -212,11 +237,48 @@ private:
     Time m_last_ack_sent_time;
 
     // FIXME: Make this configurable (sysctl)
-    static constexpr u32 maximum_retransmits = 5;
+    // With the 200ms minimum RTO this backs off for roughly 100 seconds before giving up, as RFC 1122 suggests.
+    static constexpr u32 maximum_retransmits = 8;
     Time m_last_retransmit_time;
     u32 m_retransmit_attempts { 0 };
+    u32 m_retransmitted_packets { 0 };
+
+    // RFC 6298: Computing TCP's Retransmission Timer
+    static constexpr i64 minimum_retransmission_timeout_ms = 200;
+    static constexpr i64 maximum_retransmission_timeout_ms = 60 * 1000;
+    Time m_retransmission_timeout { Time::from_seconds(1) };
+    i64 m_smoothed_rtt_us { 0 };
+    i64 m_rtt_variance_us { 0 };
+    bool m_has_rtt_sample { false };
+
+    // RFC 879 says we must assume 536 bytes unless the peer tells us otherwise.
+    static constexpr u32 default_mss = 536;
+    u32 m_send_mss { default_mss };
+
+    // RFC 7323: Our receive buffer is 256 KiB, which needs a shift of 3 to fit the 16-bit window field.
+    static constexpr u8 receive_window_scale = 3;
+    bool m_window_scaling_enabled { false };
+    u8 m_send_window_scale { 0 };
+    u32 m_last_advertised_window { 0 };
+
+    // RFC 2018: The peer may report segments it has received out of order.
+    bool m_sack_permitted { false };
+    u32 m_highest_sacked { 0 };
+
+    // RFC 5681 / RFC 6582: NewReno congestion control
+    u32 m_congestion_window { 0 };
+    u32 m_slow_start_threshold { NumericLimits<u32>::max() };
+    u32 m_last_ack_number_received { 0 };
+    u32 m_received_duplicate_acks { 0 };
+    u32 m_recover { 0 };
+
+    enum class LossRecovery {
+        None,
+        FastRecovery,
+        Timeout,
+    };
+    LossRecovery m_loss_recovery { LossRecovery::None };
 
-    // FIXME: Parse window size TCP option from the peer
     u32 m_send_window_size { 64 * KiB };
 };
 
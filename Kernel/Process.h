@@ -415,6 +415,8 @@ public:
     KResultOr<FlatPtr> sys$anon_create(size_t, int options);
     KResultOr<FlatPtr> sys$statvfs(Userspace<const Syscall::SC_statvfs_params*> user_params);
     KResultOr<FlatPtr> sys$fstatvfs(int fd, statvfs* buf);
+    KResultOr<FlatPtr> sys$io_ring_create(u32 entries, int options);
+    KResultOr<FlatPtr> sys$io_ring_enter(int fd, u32 to_submit, u32 min_complete);
 
     template<bool sockname, typename Params>
     int get_sock_or_peer_name(const Params&);
@@ -138,7 +138,7 @@ void Scheduler::queue_runnable_thread(Thread& thread)
     VERIFY(g_scheduler_lock.own_lock());
     if (thread.is_idle_thread())
         return;
-    auto priority = thread_priority_to_priority_index(thread.priority());
+    auto priority = thread_priority_to_priority_index(thread.effective_priority());
 
     ScopedSpinLock lock(g_ready_queues_lock);
     VERIFY(thread.m_runnable_priority < 0);
@@ -99,8 +99,7 @@ KResultOr<FlatPtr> Process::sys$futex(Userspace<const Syscall::SC_futex_params*>
     switch (cmd) {
     case FUTEX_WAIT:
     case FUTEX_WAIT_BITSET:
-    case FUTEX_REQUEUE:
-    case FUTEX_CMP_REQUEUE: {
+    case FUTEX_LOCK_PI: {
         if (params.timeout) {
             auto timeout_time = copy_time_from_user(params.timeout);
             if (!timeout_time.has_value())
@@ -142,7 +141,7 @@ KResultOr<FlatPtr> Process::sys$futex(Userspace<const Syscall::SC_futex_params*>
             if (!region2)
                 return EFAULT;
             vmobject2 = region2->vmobject();
-            user_address_or_offset2 = region->offset_in_vmobject_from_vaddr(VirtualAddress(user_address_or_offset2));
+            user_address_or_offset2 = region2->offset_in_vmobject_from_vaddr(VirtualAddress(user_address_or_offset2));
             break;
         }
         }
@@ -266,6 +265,129 @@ KResultOr<FlatPtr> Process::sys$futex(Userspace<const Syscall::SC_futex_params*>
         return woken_or_requeued;
     };
 
+    auto do_lock_pi = [&](bool is_trylock) -> int {
+        auto current_thread = Thread::current();
+        u32 current_tid = current_thread->tid().value();
+        for (;;) {
+            auto user_value = user_atomic_load_relaxed(params.userspace_address);
+            if (!user_value.has_value())
+                return EFAULT;
+            u32 value = user_value.value();
+            u32 owner_tid = value & FUTEX_TID_MASK;
+
+            if (owner_tid == 0) {
+                // Nobody owns it (anymore), so take it. Keep the waiters bit if anyone is still queued.
+                auto futex_queue = find_futex_queue(vmobject.ptr(), user_address_or_offset, false);
+                bool has_waiters = futex_queue && (!futex_queue->is_empty() || futex_queue->has_pending_pi_waiters());
+                auto result = user_atomic_compare_exchange_relaxed(params.userspace_address, value, current_tid | (has_waiters ? FUTEX_WAITERS : 0));
+                if (!result.has_value())
+                    return EFAULT;
+                if (!result.value())
+                    continue;
+                atomic_thread_fence(AK::MemoryOrder::memory_order_acquire);
+                return 0;
+            }
+            if (owner_tid == current_tid)
+                return EDEADLK;
+            if (is_trylock)
+                return EAGAIN;
+
+            if (!(value & FUTEX_WAITERS)) {
+                // Make sure the owner comes to us when it unlocks.
+                auto result = user_atomic_compare_exchange_relaxed(params.userspace_address, value, value | FUTEX_WAITERS);
+                if (!result.has_value())
+                    return EFAULT;
+                if (!result.value())
+                    continue;
+            }
+
+            auto owner = Thread::from_tid(owner_tid);
+            if (!owner || (is_private && owner->pid() != pid())) {
+                // The owner is gone without unlocking. Mark the lock as free so we can take it.
+                auto result = user_atomic_compare_exchange_relaxed(params.userspace_address, value, (value & FUTEX_WAITERS) | FUTEX_OWNER_DIED);
+                if (!result.has_value())
+                    return EFAULT;
+                continue;
+            }
+
+            auto futex_queue = find_futex_queue(vmobject.ptr(), user_address_or_offset, true);
+            VERIFY(futex_queue);
+            futex_queue->did_begin_pi_wait();
+
+            // Run the owner with our priority until it hands the lock over.
+            owner->did_own_contended_pi_futex(*futex_queue);
+            if (owner->effective_priority() < current_thread->effective_priority())
+                owner->set_inherited_priority(current_thread->effective_priority());
+
+            lock.unlock();
+            Thread::BlockResult block_result = futex_queue->wait_on(timeout, FUTEX_BITSET_MATCH_ANY);
+            lock.lock();
+
+            futex_queue->did_end_pi_wait();
+            if (futex_queue->is_empty() && !futex_queue->has_pending_pi_waiters())
+                remove_futex_queue(vmobject, user_address_or_offset);
+
+            // The unlocking thread hands ownership straight to the waiter it wakes up.
+            user_value = user_atomic_load_relaxed(params.userspace_address);
+            if (!user_value.has_value())
+                return EFAULT;
+            if ((user_value.value() & FUTEX_TID_MASK) == current_tid) {
+                atomic_thread_fence(AK::MemoryOrder::memory_order_acquire);
+                return 0;
+            }
+            if (block_result == Thread::BlockResult::InterruptedByTimeout)
+                return ETIMEDOUT;
+            if (block_result.was_interrupted())
+                return EINTR;
+        }
+    };
+
+    auto do_unlock_pi = [&]() -> int {
+        auto current_thread = Thread::current();
+        u32 current_tid = current_thread->tid().value();
+        auto user_value = user_atomic_load_relaxed(params.userspace_address);
+        if (!user_value.has_value())
+            return EFAULT;
+        if ((user_value.value() & FUTEX_TID_MASK) != current_tid)
+            return EPERM;
+
+        atomic_thread_fence(AK::MemoryOrder::memory_order_release);
+
+        if (auto futex_queue = find_futex_queue(vmobject.ptr(), user_address_or_offset, false)) {
+            // We're giving up the lock, and with it the priority we inherited through it,
+            // but not what the waiters on other locks we still hold lend us.
+            current_thread->did_release_pi_futex(*futex_queue);
+
+            RefPtr<Thread> new_owner;
+            bool is_empty = true;
+            bool has_more_waiters = false;
+            bool did_hand_over = futex_queue->wake_highest_priority_waiter(
+                [&](Thread& thread, bool has_more) {
+                    new_owner = thread;
+                    has_more_waiters = has_more;
+                    u32 new_value = thread.tid().value() | (has_more ? FUTEX_WAITERS : 0);
+                    return user_atomic_exchange_relaxed(params.userspace_address, new_value).has_value();
+                },
+                is_empty);
+            if (did_hand_over) {
+                if (has_more_waiters)
+                    new_owner->did_own_contended_pi_futex(*futex_queue);
+                new_owner->update_inherited_priority();
+                if (is_empty && !futex_queue->has_pending_pi_waiters())
+                    remove_futex_queue(vmobject, user_address_or_offset);
+                return 0;
+            }
+            if (new_owner)
+                return EFAULT;
+            if (futex_queue->has_pending_pi_waiters())
+                futex_queue->did_unlock_with_pending_pi_waiters();
+        }
+
+        if (!user_atomic_store_relaxed(params.userspace_address, 0))
+            return EFAULT;
+        return 0;
+    };
+
     switch (cmd) {
     case FUTEX_WAIT:
         return do_wait(0);
@@ -341,6 +463,15 @@ KResultOr<FlatPtr> Process::sys$futex(Userspace<const Syscall::SC_futex_params*>
     case FUTEX_CMP_REQUEUE:
         return do_requeue(params.val3);
 
+    case FUTEX_LOCK_PI:
+        return do_lock_pi(false);
+
+    case FUTEX_TRYLOCK_PI:
+        return do_lock_pi(true);
+
+    case FUTEX_UNLOCK_PI:
+        return do_unlock_pi();
+
     case FUTEX_WAIT_BITSET:
         VERIFY(params.val3 != FUTEX_BITSET_MATCH_ANY); // we should have turned it into FUTEX_WAIT
         if (params.val3 == 0)
@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Kernel/FileSystem/FileDescription.h>
+#include <Kernel/FileSystem/IORing.h>
+#include <Kernel/Process.h>
+
+namespace Kernel {
+
+KResultOr<FlatPtr> Process::sys$io_ring_create(u32 entries, int options)
+{
+    REQUIRE_PROMISE(stdio);
+
+    int new_fd = m_fds.allocate();
+    if (new_fd < 0)
+        return new_fd;
+
+    auto ring_or_error = IORing::create(*this, entries);
+    if (ring_or_error.is_error())
+        return ring_or_error.error();
+
+    auto description_or_error = FileDescription::create(*ring_or_error.value());
+    if (description_or_error.is_error())
+        return description_or_error.error();
+
+    auto description = description_or_error.release_value();
+    description->set_readable(true);
+
+    u32 fd_flags = 0;
+    if (options & O_CLOEXEC)
+        fd_flags |= FD_CLOEXEC;
+
+    m_fds[new_fd].set(move(description), fd_flags);
+    return new_fd;
+}
+
+KResultOr<FlatPtr> Process::sys$io_ring_enter(int fd, u32 to_submit, u32 min_complete)
+{
+    REQUIRE_PROMISE(stdio);
+
+    auto description = fds().file_description(fd);
+    if (!description)
+        return EBADF;
+    if (!description->is_io_ring())
+        return EINVAL;
+    return description->io_ring()->enter(*this, to_submit, min_complete);
+}
+
+}
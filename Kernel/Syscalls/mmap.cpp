@@ -195,6 +195,10 @@ KResultOr<FlatPtr> Process::sys$mmap(Userspace<const Syscall::SC_mmap_params*> u
     if (map_stack && (!map_private || !map_anonymous))
         return EINVAL;
 
+    // Give large anonymous mappings a 2 MiB aligned range, so they can be backed by large pages.
+    if (map_anonymous && map_private && !map_stack && !addr && size >= LARGE_PAGE_SIZE && alignment < LARGE_PAGE_SIZE)
+        alignment = LARGE_PAGE_SIZE;
+
     Region* region = nullptr;
     Optional<Range> range;
 
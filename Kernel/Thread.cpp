@@ -12,6 +12,7 @@
 #include <Kernel/Arch/x86/TrapFrame.h>
 #include <Kernel/Debug.h>
 #include <Kernel/FileSystem/FileDescription.h>
+#include <Kernel/FutexQueue.h>
 #include <Kernel/KSyms.h>
 #include <Kernel/Panic.h>
 #include <Kernel/PerformanceEventBuffer.h>
@@ -940,6 +941,50 @@ RefPtr<Thread> Thread::clone(Process& process)
     return clone;
 }
 
+void Thread::set_inherited_priority(u32 priority)
+{
+    ScopedSpinLock lock(g_scheduler_lock);
+    if (m_inherited_priority == priority)
+        return;
+    m_inherited_priority = priority;
+
+    // If we're sitting in a ready queue, move over to the one matching our new priority.
+    if (m_runnable_priority >= 0 && Scheduler::dequeue_runnable_thread(*this))
+        Scheduler::queue_runnable_thread(*this);
+}
+
+void Thread::did_own_contended_pi_futex(FutexQueue& futex_queue)
+{
+    ScopedSpinLock lock(m_lock);
+    for (auto& queue : m_contended_pi_futexes) {
+        if (&queue == &futex_queue)
+            return;
+    }
+    m_contended_pi_futexes.append(futex_queue);
+}
+
+void Thread::did_release_pi_futex(FutexQueue& futex_queue)
+{
+    {
+        ScopedSpinLock lock(m_lock);
+        m_contended_pi_futexes.remove_first_matching([&](auto& queue) { return queue.ptr() == &futex_queue; });
+    }
+    update_inherited_priority();
+}
+
+void Thread::update_inherited_priority()
+{
+    NonnullRefPtrVector<FutexQueue> futex_queues;
+    {
+        ScopedSpinLock lock(m_lock);
+        futex_queues = m_contended_pi_futexes;
+    }
+    u32 priority = 0;
+    for (auto& futex_queue : futex_queues)
+        priority = max(priority, futex_queue.highest_waiter_priority());
+    set_inherited_priority(priority);
+}
+
 void Thread::set_state(State new_state, u8 stop_signal)
 {
     State previous_state;
@@ -11,6 +11,7 @@
 #include <AK/Function.h>
 #include <AK/HashMap.h>
 #include <AK/IntrusiveList.h>
+#include <AK/NonnullRefPtrVector.h>
 #include <AK/Optional.h>
 #include <AK/OwnPtr.h>
 #include <AK/SourceLocation.h>
@@ -144,6 +145,17 @@ public:
     void set_priority(u32 p) { m_priority = p; }
     u32 priority() const { return m_priority; }
 
+    // While holding a priority inheriting futex that a higher priority thread is
+    // waiting on, a thread gets scheduled with the waiter's priority.
+    u32 effective_priority() const { return max(m_priority, m_inherited_priority); }
+    void set_inherited_priority(u32);
+
+    // The priority inheriting futexes this thread owns while others are waiting on them.
+    // Releasing one recomputes the inherited priority from the waiters on the rest.
+    void did_own_contended_pi_futex(FutexQueue&);
+    void did_release_pi_futex(FutexQueue&);
+    void update_inherited_priority();
+
     void detach()
     {
         ScopedSpinLock lock(m_lock);
@@ -1317,6 +1329,8 @@ private:
     State m_state { Invalid };
     String m_name;
     u32 m_priority { THREAD_PRIORITY_NORMAL };
+    u32 m_inherited_priority { 0 };
+    NonnullRefPtrVector<FutexQueue> m_contended_pi_futexes;
 
     State m_stop_state { Invalid };
 
@@ -395,6 +395,65 @@ RefPtr<PhysicalPage> AnonymousVMObject::allocate_committed_page(size_t page_inde
     return MM.allocate_committed_user_physical_page(MemoryManager::ShouldZeroFill::Yes);
 }
 
+NonnullRefPtrVector<PhysicalPage> AnonymousVMObject::take_committed_large_page(size_t first_page_index)
+{
+    VERIFY(first_page_index + PAGES_PER_LARGE_PAGE <= page_count());
+    {
+        ScopedSpinLock lock(m_lock);
+
+        if (m_unused_committed_pages < PAGES_PER_LARGE_PAGE)
+            return {};
+
+        // Only replace pages that nobody has touched yet, and never anything that
+        // is still shared copy-on-write with a clone.
+        if (!can_install_large_page(first_page_index))
+            return {};
+
+        m_unused_committed_pages -= PAGES_PER_LARGE_PAGE;
+    }
+
+    // The caller zeroes the pages, so that doesn't have to happen with the MM lock held.
+    auto physical_pages = MM.allocate_contiguous_committed_user_physical_pages(PAGES_PER_LARGE_PAGE, LARGE_PAGE_SIZE, MemoryManager::ShouldZeroFill::No);
+    if (physical_pages.is_empty()) {
+        ScopedSpinLock lock(m_lock);
+        m_unused_committed_pages += PAGES_PER_LARGE_PAGE;
+    }
+    return physical_pages;
+}
+
+bool AnonymousVMObject::install_committed_large_page(size_t first_page_index, NonnullRefPtrVector<PhysicalPage>&& physical_pages)
+{
+    VERIFY(s_mm_lock.own_lock());
+    VERIFY(physical_pages.size() == PAGES_PER_LARGE_PAGE);
+    ScopedSpinLock lock(m_lock);
+
+    // The MM lock was released while the pages were being zeroed, so check again that they are still wanted.
+    if (!can_install_large_page(first_page_index)) {
+        // Freeing the pages puts them in the uncommitted pool, so commit them again for our other lazy pages.
+        physical_pages.clear();
+        bool committed = MM.commit_user_physical_pages(PAGES_PER_LARGE_PAGE);
+        VERIFY(committed);
+        m_unused_committed_pages += PAGES_PER_LARGE_PAGE;
+        return false;
+    }
+
+    for (size_t i = 0; i < PAGES_PER_LARGE_PAGE; ++i)
+        m_physical_pages[first_page_index + i] = physical_pages[i];
+    return true;
+}
+
+bool AnonymousVMObject::can_install_large_page(size_t first_page_index) const
+{
+    VERIFY(m_lock.is_locked());
+    for (size_t i = first_page_index; i < first_page_index + PAGES_PER_LARGE_PAGE; ++i) {
+        if (!m_physical_pages[i] || !m_physical_pages[i]->is_lazy_committed_page())
+            return false;
+        if (!m_cow_map.is_null() && m_cow_map.get(i))
+            return false;
+    }
+    return true;
+}
+
 Bitmap& AnonymousVMObject::ensure_cow_map()
 {
     if (m_cow_map.is_null())
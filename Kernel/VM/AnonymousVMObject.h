@@ -28,6 +28,8 @@ public:
     virtual RefPtr<VMObject> clone() override;
 
     RefPtr<PhysicalPage> allocate_committed_page(size_t);
+    NonnullRefPtrVector<PhysicalPage> take_committed_large_page(size_t first_page_index);
+    bool install_committed_large_page(size_t first_page_index, NonnullRefPtrVector<PhysicalPage>&&);
     PageFaultResponse handle_cow_fault(size_t, VirtualAddress);
     size_t cow_pages() const;
     bool should_cow(size_t page_index, bool) const;
@@ -124,6 +126,8 @@ private:
 
     virtual const char* class_name() const override { return "AnonymousVMObject"; }
 
+    bool can_install_large_page(size_t first_page_index) const;
+
     int purge_impl();
     void update_volatile_cache();
     void set_was_purged(const VolatilePageRange&);
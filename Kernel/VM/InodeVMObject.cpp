@@ -31,6 +31,27 @@ InodeVMObject::~InodeVMObject()
 {
 }
 
+static constexpr size_t minimum_readahead_pages = 4;
+
+size_t InodeVMObject::readahead_page_count(size_t page_index)
+{
+    VERIFY(m_paging_lock.is_locked());
+    VERIFY(page_index < page_count());
+
+    if (m_readahead_window && page_index == m_readahead_next_page_index)
+        m_readahead_window = min(m_readahead_window * 2, maximum_readahead_page_count);
+    else
+        m_readahead_window = minimum_readahead_pages;
+
+    // Don't read past the end of the object, or over pages we already have.
+    size_t count = 1;
+    while (count < m_readahead_window && page_index + count < page_count() && !m_physical_pages[page_index + count])
+        ++count;
+
+    m_readahead_next_page_index = page_index + count;
+    return count;
+}
+
 size_t InodeVMObject::amount_clean() const
 {
     size_t count = 0;
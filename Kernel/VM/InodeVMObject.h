@@ -27,6 +27,12 @@ public:
     u32 writable_mappings() const;
     u32 executable_mappings() const;
 
+    static constexpr size_t maximum_readahead_page_count = 32;
+
+    // Returns how many pages, starting at page_index, should be read from the inode
+    // to satisfy a fault. Sequential faults grow the readahead window.
+    size_t readahead_page_count(size_t page_index);
+
 protected:
     explicit InodeVMObject(Inode&, size_t);
     explicit InodeVMObject(const InodeVMObject&);
@@ -41,6 +47,9 @@ protected:
 
     NonnullRefPtr<Inode> m_inode;
     Bitmap m_dirty_pages;
+
+    size_t m_readahead_next_page_index { 0 };
+    size_t m_readahead_window { 0 };
 };
 
 }
@@ -47,6 +47,8 @@ namespace Kernel {
 static MemoryManager* s_the;
 RecursiveSpinLock s_mm_lock;
 
+Atomic<bool> g_transparent_large_pages { true };
+
 MemoryManager& MM
 {
     return *s_the;
@@ -308,7 +310,7 @@ PageTableEntry* MemoryManager::pte(PageDirectory& page_directory, VirtualAddress
 
     auto* pd = quickmap_pd(const_cast<PageDirectory&>(page_directory), page_directory_table_index);
     const PageDirectoryEntry& pde = pd[page_directory_index];
-    if (!pde.is_present())
+    if (!pde.is_present() || pde.is_huge())
         return nullptr;
 
     return &quickmap_pt(PhysicalAddress((FlatPtr)pde.page_table_base()))[page_table_index];
@@ -325,6 +327,14 @@ PageTableEntry* MemoryManager::ensure_pte(PageDirectory& page_directory, Virtual
 
     auto* pd = quickmap_pd(page_directory, page_directory_table_index);
     PageDirectoryEntry& pde = pd[page_directory_index];
+    if (pde.is_huge()) {
+        // Someone wants to change an individual page inside a large page (mprotect, COW, ...),
+        // so we have to break it up into a regular page table first.
+        if (!split_large_page(page_directory, vaddr))
+            return nullptr;
+        pd = quickmap_pd(page_directory, page_directory_table_index);
+        VERIFY(&pde == &pd[page_directory_index]); // Sanity check
+    }
     if (!pde.is_present()) {
         bool did_purge = false;
         auto page_table = allocate_user_physical_page(ShouldZeroFill::Yes, &did_purge);
@@ -366,6 +376,14 @@ void MemoryManager::release_pte(PageDirectory& page_directory, VirtualAddress va
 
     auto* pd = quickmap_pd(page_directory, page_directory_table_index);
     PageDirectoryEntry& pde = pd[page_directory_index];
+    if (pde.is_huge()) {
+        // Large pages are only installed for regions that cover them entirely, so the
+        // first release inside one takes down the whole mapping. The physical pages
+        // themselves are owned by the VMObject.
+        pde.clear();
+        --m_user_large_pages_mapped;
+        return;
+    }
     if (pde.is_present()) {
         auto* page_table = quickmap_pt(PhysicalAddress((FlatPtr)pde.page_table_base()));
         auto& pte = page_table[page_table_index];
@@ -391,6 +409,88 @@ void MemoryManager::release_pte(PageDirectory& page_directory, VirtualAddress va
     }
 }
 
+bool MemoryManager::split_large_page(PageDirectory& page_directory, VirtualAddress vaddr)
+{
+    VERIFY_INTERRUPTS_DISABLED();
+    VERIFY(s_mm_lock.own_lock());
+    VERIFY(page_directory.get_lock().own_lock());
+    u32 page_directory_table_index = (vaddr.get() >> 30) & 0x3;
+    u32 page_directory_index = (vaddr.get() >> 21) & 0x1ff;
+    auto large_page_vaddr = VirtualAddress(vaddr.get() & ~(LARGE_PAGE_SIZE - 1));
+
+    bool did_purge = false;
+    auto page_table = allocate_user_physical_page(ShouldZeroFill::No, &did_purge);
+    if (!page_table) {
+        dbgln("MM: Unable to allocate page table to split large page at {}", large_page_vaddr);
+        return false;
+    }
+
+    // Allocating may have purged memory and remapped things, so (re-)map the pd afterwards.
+    auto* pd = quickmap_pd(page_directory, page_directory_table_index);
+    PageDirectoryEntry& pde = pd[page_directory_index];
+    if (!pde.is_huge())
+        return true;
+
+    auto large_page_base = (FlatPtr)pde.page_table_base();
+    auto* page_table_entries = quickmap_pt(page_table->paddr());
+    for (u32 i = 0; i <= 0x1ff; i++) {
+        auto& pte = page_table_entries[i];
+        pte.clear();
+        pte.set_physical_page_base(large_page_base + i * PAGE_SIZE);
+        pte.set_cache_disabled(pde.is_cache_disabled());
+        pte.set_writable(pde.is_writable());
+        pte.set_execute_disabled(pde.is_execute_disabled());
+        pte.set_user_allowed(pde.is_user_allowed());
+        pte.set_global(pde.is_global());
+        pte.set_present(true);
+    }
+
+    pde.set_huge(false);
+    pde.set_cache_disabled(false);
+    pde.set_execute_disabled(false);
+    pde.set_writable(true);
+    pde.set_user_allowed(true);
+    pde.set_page_table_base(page_table->paddr().get());
+    auto result = page_directory.m_page_tables.set(large_page_vaddr.get(), move(page_table));
+    VERIFY(result == AK::HashSetResult::InsertedNewEntry);
+    --m_user_large_pages_mapped;
+
+    flush_tlb(&page_directory, large_page_vaddr, PAGES_PER_LARGE_PAGE);
+    return true;
+}
+
+void MemoryManager::map_large_page(PageDirectory& page_directory, VirtualAddress vaddr, PhysicalAddress paddr, bool writable, bool executable)
+{
+    VERIFY_INTERRUPTS_DISABLED();
+    VERIFY(s_mm_lock.own_lock());
+    VERIFY(page_directory.get_lock().own_lock());
+    VERIFY(vaddr.get() % LARGE_PAGE_SIZE == 0);
+    VERIFY(paddr.get() % LARGE_PAGE_SIZE == 0);
+    u32 page_directory_table_index = (vaddr.get() >> 30) & 0x3;
+    u32 page_directory_index = (vaddr.get() >> 21) & 0x1ff;
+
+    auto* pd = quickmap_pd(page_directory, page_directory_table_index);
+    PageDirectoryEntry& pde = pd[page_directory_index];
+    VERIFY(!pde.is_huge());
+    if (pde.is_present()) {
+        // The old page table only held the (read-only) lazy committed page mappings
+        // for this range, which the large page replaces entirely.
+        pde.clear();
+        page_directory.m_page_tables.remove(vaddr.get());
+    }
+
+    pde.set_page_table_base(paddr.get());
+    pde.set_huge(true);
+    pde.set_user_allowed(true);
+    pde.set_writable(writable);
+    if (Processor::current().has_feature(CPUFeature::NX))
+        pde.set_execute_disabled(!executable);
+    pde.set_present(true);
+    ++m_user_large_pages_mapped;
+
+    flush_tlb(&page_directory, vaddr, PAGES_PER_LARGE_PAGE);
+}
+
 UNMAP_AFTER_INIT void MemoryManager::initialize(u32 cpu)
 {
     auto mm_data = new MemoryManagerData;
@@ -610,6 +710,37 @@ NonnullRefPtr<PhysicalPage> MemoryManager::allocate_committed_user_physical_page
     return page.release_nonnull();
 }
 
+NonnullRefPtrVector<PhysicalPage> MemoryManager::allocate_contiguous_committed_user_physical_pages(size_t count, size_t physical_alignment, ShouldZeroFill should_zero_fill)
+{
+    ScopedSpinLock lock(s_mm_lock);
+    VERIFY(m_user_physical_pages_committed >= count);
+
+    NonnullRefPtrVector<PhysicalPage> physical_pages;
+    for (auto& region : m_user_physical_regions) {
+        physical_pages = region.take_contiguous_free_pages(count, false, physical_alignment);
+        if (!physical_pages.is_empty())
+            break;
+    }
+
+    // Unlike single committed pages, physical memory may simply be too fragmented
+    // to satisfy this. The caller is expected to fall back to individual pages.
+    if (physical_pages.is_empty())
+        return {};
+
+    m_user_physical_pages_committed -= count;
+    m_user_physical_pages_used += count;
+
+    if (should_zero_fill == ShouldZeroFill::No)
+        return physical_pages;
+
+    for (auto& page : physical_pages) {
+        auto* ptr = quickmap_page(page);
+        memset(ptr, 0, PAGE_SIZE);
+        unquickmap_page();
+    }
+    return physical_pages;
+}
+
 RefPtr<PhysicalPage> MemoryManager::allocate_user_physical_page(ShouldZeroFill should_zero_fill, bool* did_purge)
 {
     ScopedSpinLock lock(s_mm_lock);
@@ -677,7 +808,7 @@ NonnullRefPtrVector<PhysicalPage> MemoryManager::allocate_contiguous_supervisor_
     for (auto& region : m_super_physical_regions) {
         physical_pages = region.take_contiguous_free_pages(count, true, physical_alignment);
         if (!physical_pages.is_empty())
-            continue;
+            break;
     }
 
     if (physical_pages.is_empty()) {
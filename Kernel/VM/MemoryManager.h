@@ -20,6 +20,11 @@
 
 namespace Kernel {
 
+constexpr FlatPtr LARGE_PAGE_SIZE = 2 * MiB;
+constexpr size_t PAGES_PER_LARGE_PAGE = LARGE_PAGE_SIZE / PAGE_SIZE;
+
+extern Atomic<bool> g_transparent_large_pages;
+
 constexpr bool page_round_up_would_wrap(FlatPtr x)
 {
     return x > (explode_byte(0xFF) & ~0xFFF);
@@ -138,6 +143,7 @@ public:
     bool commit_user_physical_pages(size_t);
     void uncommit_user_physical_pages(size_t);
     NonnullRefPtr<PhysicalPage> allocate_committed_user_physical_page(ShouldZeroFill = ShouldZeroFill::Yes);
+    NonnullRefPtrVector<PhysicalPage> allocate_contiguous_committed_user_physical_pages(size_t count, size_t physical_alignment = PAGE_SIZE, ShouldZeroFill = ShouldZeroFill::Yes);
     RefPtr<PhysicalPage> allocate_user_physical_page(ShouldZeroFill = ShouldZeroFill::Yes, bool* did_purge = nullptr);
     RefPtr<PhysicalPage> allocate_supervisor_physical_page();
     NonnullRefPtrVector<PhysicalPage> allocate_contiguous_supervisor_physical_pages(size_t size, size_t physical_alignment = PAGE_SIZE);
@@ -157,6 +163,9 @@ public:
     unsigned user_physical_pages_uncommitted() const { return m_user_physical_pages_uncommitted; }
     unsigned super_physical_pages() const { return m_super_physical_pages; }
     unsigned super_physical_pages_used() const { return m_super_physical_pages_used; }
+    unsigned user_large_pages_mapped() const { return m_user_large_pages_mapped; }
+
+    void map_large_page(PageDirectory&, VirtualAddress, PhysicalAddress, bool writable, bool executable);
 
     template<IteratorFunction<VMObject&> Callback>
     static void for_each_vmobject(Callback callback)
@@ -217,6 +226,7 @@ private:
     PageTableEntry* pte(PageDirectory&, VirtualAddress);
     PageTableEntry* ensure_pte(PageDirectory&, VirtualAddress);
     void release_pte(PageDirectory&, VirtualAddress, bool);
+    bool split_large_page(PageDirectory&, VirtualAddress);
 
     RefPtr<PageDirectory> m_kernel_page_directory;
 
@@ -229,6 +239,7 @@ private:
     Atomic<unsigned, AK::MemoryOrder::memory_order_relaxed> m_user_physical_pages_uncommitted { 0 };
     Atomic<unsigned, AK::MemoryOrder::memory_order_relaxed> m_super_physical_pages { 0 };
     Atomic<unsigned, AK::MemoryOrder::memory_order_relaxed> m_super_physical_pages_used { 0 };
+    Atomic<unsigned, AK::MemoryOrder::memory_order_relaxed> m_user_large_pages_mapped { 0 };
 
     NonnullRefPtrVector<PhysicalRegion> m_user_physical_regions;
     NonnullRefPtrVector<PhysicalRegion> m_super_physical_regions;
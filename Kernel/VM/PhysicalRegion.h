@@ -36,7 +36,7 @@ public:
     void return_page(const PhysicalPage& page);
 
 private:
-    unsigned find_contiguous_free_pages(size_t count, size_t physical_alignment = PAGE_SIZE);
+    Optional<unsigned> find_contiguous_free_pages(size_t count, size_t physical_alignment = PAGE_SIZE);
     Optional<unsigned> find_and_allocate_contiguous_range(size_t count, unsigned alignment = 1);
     Optional<unsigned> find_one_free_page();
     void free_page_at(PhysicalAddress addr);
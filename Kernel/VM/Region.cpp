@@ -5,13 +5,17 @@
  */
 
 #include <AK/Memory.h>
+#include <AK/ScopeGuard.h>
+#include <AK/Singleton.h>
 #include <AK/StringView.h>
 #include <Kernel/Debug.h>
 #include <Kernel/FileSystem/Inode.h>
+#include <Kernel/KBuffer.h>
 #include <Kernel/Panic.h>
 #include <Kernel/Process.h>
 #include <Kernel/Thread.h>
 #include <Kernel/VM/AnonymousVMObject.h>
+#include <Kernel/VM/InodeVMObject.h>
 #include <Kernel/VM/MemoryManager.h>
 #include <Kernel/VM/PageDirectory.h>
 #include <Kernel/VM/Region.h>
@@ -19,6 +23,39 @@
 
 namespace Kernel {
 
+// Inode faults read ahead into one of a few buffers that are kept around, instead of allocating and mapping
+// a new one every time. A buffer is only busy while its read is in progress, so a handful is plenty; if they're
+// all taken, a fault allocates one of its own.
+class InodeReadaheadBufferPool {
+public:
+    static constexpr size_t buffer_size = InodeVMObject::maximum_readahead_page_count * PAGE_SIZE;
+
+    OwnPtr<KBuffer> take()
+    {
+        {
+            ScopedSpinLock lock(m_lock);
+            if (!m_free_buffers.is_empty())
+                return m_free_buffers.take_last();
+        }
+        return KBuffer::try_create_with_size(buffer_size, Region::Access::Read | Region::Access::Write, "Inode readahead", AllocationStrategy::AllocateNow);
+    }
+
+    void give_back(NonnullOwnPtr<KBuffer> buffer)
+    {
+        ScopedSpinLock lock(m_lock);
+        if (m_free_buffers.size() < max_free_buffer_count)
+            m_free_buffers.unchecked_append(move(buffer));
+    }
+
+private:
+    static constexpr size_t max_free_buffer_count = 4;
+
+    SpinLock<u8> m_lock;
+    Vector<NonnullOwnPtr<KBuffer>, max_free_buffer_count> m_free_buffers;
+};
+
+static AK::Singleton<InodeReadaheadBufferPool> s_inode_readahead_buffer_pool;
+
 Region::Region(const Range& range, NonnullRefPtr<VMObject> vmobject, size_t offset_in_vmobject, OwnPtr<KString> name, Region::Access access, Cacheable cacheable, bool shared)
     : PurgeablePageRanges(vmobject)
     , m_range(range)
@@ -415,19 +452,15 @@ PageFaultResponse Region::handle_fault(const PageFault& fault, ScopedSpinLock<Re
         }
 
         auto& page_slot = physical_page_slot(page_index_in_region);
-        if (page_slot->is_lazy_committed_page()) {
-            auto page_index_in_vmobject = translate_to_vmobject_page(page_index_in_region);
-            page_slot = static_cast<AnonymousVMObject&>(*m_vmobject).allocate_committed_page(page_index_in_vmobject);
-            remap_vmobject_page(page_index_in_vmobject);
-            return PageFaultResponse::Continue;
-        }
+        if (page_slot->is_lazy_committed_page())
+            return handle_zero_fault(page_index_in_region, mm_lock);
 #ifdef MAP_SHARED_ZERO_PAGE_LAZILY
         if (fault.is_read()) {
             page_slot = MM.shared_zero_page();
             remap_vmobject_page(translate_to_vmobject_page(page_index_in_region));
             return PageFaultResponse::Continue;
         }
-        return handle_zero_fault(page_index_in_region);
+        return handle_zero_fault(page_index_in_region, mm_lock);
 #else
         dbgln("BUG! Unexpected NP fault at {}", fault.vaddr());
         return PageFaultResponse::ShouldCrash;
@@ -439,7 +472,7 @@ PageFaultResponse Region::handle_fault(const PageFault& fault, ScopedSpinLock<Re
         auto* phys_page = physical_page(page_index_in_region);
         if (phys_page->is_shared_zero_page() || phys_page->is_lazy_committed_page()) {
             dbgln_if(PAGE_FAULT_DEBUG, "NP(zero) fault in Region({})[{}] at {}", this, page_index_in_region, fault.vaddr());
-            return handle_zero_fault(page_index_in_region);
+            return handle_zero_fault(page_index_in_region, mm_lock);
         }
         return handle_cow_fault(page_index_in_region);
     }
@@ -447,13 +480,20 @@ PageFaultResponse Region::handle_fault(const PageFault& fault, ScopedSpinLock<Re
     return PageFaultResponse::ShouldCrash;
 }
 
-PageFaultResponse Region::handle_zero_fault(size_t page_index_in_region)
+PageFaultResponse Region::handle_zero_fault(size_t page_index_in_region, ScopedSpinLock<RecursiveSpinLock>& mm_lock)
 {
     VERIFY_INTERRUPTS_DISABLED();
     VERIFY(vmobject().is_anonymous());
 
+    // try_map_large_page() releases the MM lock while it zeroes the page, so take the
+    // paging lock first like handle_inode_fault() does.
+    mm_lock.unlock();
+    VERIFY(!s_mm_lock.own_lock());
+
     Locker locker(vmobject().m_paging_lock);
 
+    mm_lock.lock();
+
     auto& page_slot = physical_page_slot(page_index_in_region);
     auto page_index_in_vmobject = translate_to_vmobject_page(page_index_in_region);
 
@@ -469,6 +509,10 @@ PageFaultResponse Region::handle_zero_fault(size_t page_index_in_region)
         current_thread->did_zero_fault();
 
     if (page_slot->is_lazy_committed_page()) {
+        if (try_map_large_page(page_index_in_region, mm_lock)) {
+            dbgln_if(PAGE_FAULT_DEBUG, "      >> MAPPED LARGE PAGE {}", page_slot->paddr());
+            return PageFaultResponse::Continue;
+        }
         page_slot = static_cast<AnonymousVMObject&>(*m_vmobject).allocate_committed_page(page_index_in_vmobject);
         dbgln_if(PAGE_FAULT_DEBUG, "      >> ALLOCATED COMMITTED {}", page_slot->paddr());
     } else {
@@ -487,6 +531,47 @@ PageFaultResponse Region::handle_zero_fault(size_t page_index_in_region)
     return PageFaultResponse::Continue;
 }
 
+bool Region::try_map_large_page(size_t page_index_in_region, ScopedSpinLock<RecursiveSpinLock>& mm_lock)
+{
+    VERIFY(s_mm_lock.own_lock());
+    if (!g_transparent_large_pages.load(AK::MemoryOrder::memory_order_relaxed))
+        return false;
+    if (!m_page_directory || !is_user() || m_shared || !m_cacheable || !is_readable() || !is_writable())
+        return false;
+    if (!vmobject().is_anonymous() || vmobject().is_shared_by_multiple_regions())
+        return false;
+
+    // Only use a large page if this region covers the entire aligned 2 MiB block around
+    // the faulting address. Mapping changes on partial ranges split it up again.
+    auto large_page_vaddr = VirtualAddress(vaddr_from_page_index(page_index_in_region).get() & ~(LARGE_PAGE_SIZE - 1));
+    if (large_page_vaddr < vaddr() || large_page_vaddr.offset(LARGE_PAGE_SIZE) > range().end())
+        return false;
+
+    auto first_page_index_in_region = (large_page_vaddr - vaddr()).get() / PAGE_SIZE;
+    auto first_page_index_in_vmobject = translate_to_vmobject_page(first_page_index_in_region);
+    auto& vmobject = static_cast<AnonymousVMObject&>(this->vmobject());
+    auto physical_pages = vmobject.take_committed_large_page(first_page_index_in_vmobject);
+    if (physical_pages.is_empty())
+        return false;
+
+    // Nobody else can see these pages yet, so zero them without holding up every other page fault in the system.
+    // quickmap_page() only takes the MM lock for as long as it takes to set up the mapping.
+    mm_lock.unlock();
+    for (auto& page : physical_pages) {
+        auto* ptr = MM.quickmap_page(page);
+        memset(ptr, 0, PAGE_SIZE);
+        MM.unquickmap_page();
+    }
+    mm_lock.lock();
+
+    if (!vmobject.install_committed_large_page(first_page_index_in_vmobject, move(physical_pages)))
+        return false;
+
+    ScopedSpinLock page_lock(m_page_directory->get_lock());
+    MM.map_large_page(*m_page_directory, large_page_vaddr, physical_page(first_page_index_in_region)->paddr(), is_writable(), is_executable());
+    return true;
+}
+
 PageFaultResponse Region::handle_cow_fault(size_t page_index_in_region)
 {
     VERIFY_INTERRUPTS_DISABLED();
@@ -528,6 +613,7 @@ PageFaultResponse Region::handle_inode_fault(size_t page_index_in_region, Scoped
         dbgln_if(PAGE_FAULT_DEBUG, "MM: page_in_from_inode() but page already present. Fine with me!");
         if (!remap_vmobject_page(page_index_in_vmobject))
             return PageFaultResponse::OutOfMemory;
+        map_cached_pages_around(page_index_in_region);
         return PageFaultResponse::Continue;
     }
 
@@ -537,15 +623,26 @@ PageFaultResponse Region::handle_inode_fault(size_t page_index_in_region, Scoped
 
     u8 page_buffer[PAGE_SIZE];
     auto& inode = inode_vmobject.inode();
+    auto page_count_to_read = inode_vmobject.readahead_page_count(page_index_in_vmobject);
 
-    // Reading the page may block, so release the MM lock temporarily
+    // Reading the pages may block, so release the MM lock temporarily
     mm_lock.unlock();
 
+    OwnPtr<KBuffer> readahead_buffer;
+    ScopeGuard give_back_readahead_buffer([&] {
+        if (readahead_buffer)
+            s_inode_readahead_buffer_pool->give_back(readahead_buffer.release_nonnull());
+    });
     KResultOr<size_t> result(KSuccess);
     {
         ScopedLockRelease release_paging_lock(vmobject().m_paging_lock);
-        auto buffer = UserOrKernelBuffer::for_kernel_buffer(page_buffer);
-        result = inode.read_bytes(page_index_in_vmobject * PAGE_SIZE, PAGE_SIZE, buffer, nullptr);
+        if (page_count_to_read > 1) {
+            readahead_buffer = s_inode_readahead_buffer_pool->take();
+            if (!readahead_buffer)
+                page_count_to_read = 1;
+        }
+        auto buffer = UserOrKernelBuffer::for_kernel_buffer(readahead_buffer ? readahead_buffer->data() : page_buffer);
+        result = inode.read_bytes(page_index_in_vmobject * PAGE_SIZE, page_count_to_read * PAGE_SIZE, buffer, nullptr);
     }
 
     mm_lock.lock();
@@ -555,36 +652,82 @@ PageFaultResponse Region::handle_inode_fault(size_t page_index_in_region, Scoped
         return PageFaultResponse::ShouldCrash;
     }
     auto nread = result.value();
-    if (nread < PAGE_SIZE) {
-        // If we read less than a page, zero out the rest to avoid leaking uninitialized data.
-        memset(page_buffer + nread, 0, PAGE_SIZE - nread);
-    }
+    u8* data = readahead_buffer ? readahead_buffer->data() : page_buffer;
+
+    // Always fill in the faulting page, but only the readahead pages that actually have file data.
+    size_t pages_read = max(ceil_div(nread, static_cast<size_t>(PAGE_SIZE)), static_cast<size_t>(1));
+    size_t pages_populated = 0;
+    for (size_t i = 0; i < min(pages_read, page_count_to_read); ++i) {
+        auto& physical_page_entry = inode_vmobject.physical_pages()[page_index_in_vmobject + i];
+        u8* page_data = data + i * PAGE_SIZE;
+        if (!physical_page_entry.is_null()) {
+            // Someone else paged this one in while we were reading.
+            ++pages_populated;
+            continue;
+        }
 
-    vmobject_physical_page_entry = MM.allocate_user_physical_page(MemoryManager::ShouldZeroFill::No);
-    if (vmobject_physical_page_entry.is_null()) {
-        dmesgln("MM: handle_inode_fault was unable to allocate a physical page");
-        return PageFaultResponse::OutOfMemory;
-    }
+        size_t page_nread = nread > i * PAGE_SIZE ? min(nread - i * PAGE_SIZE, static_cast<size_t>(PAGE_SIZE)) : 0;
+        if (page_nread < PAGE_SIZE) {
+            // If we read less than a page, zero out the rest to avoid leaking uninitialized data.
+            memset(page_data + page_nread, 0, PAGE_SIZE - page_nread);
+        }
 
-    u8* dest_ptr = MM.quickmap_page(*vmobject_physical_page_entry);
-    {
-        void* fault_at;
-        if (!safe_memcpy(dest_ptr, page_buffer, PAGE_SIZE, fault_at)) {
-            if ((u8*)fault_at >= dest_ptr && (u8*)fault_at <= dest_ptr + PAGE_SIZE)
-                dbgln("      >> inode fault: error copying data to {}/{}, failed at {}",
-                    vmobject_physical_page_entry->paddr(),
-                    VirtualAddress(dest_ptr),
-                    VirtualAddress(fault_at));
-            else
-                VERIFY_NOT_REACHED();
+        physical_page_entry = MM.allocate_user_physical_page(MemoryManager::ShouldZeroFill::No);
+        if (physical_page_entry.is_null()) {
+            if (i > 0)
+                break;
+            dmesgln("MM: handle_inode_fault was unable to allocate a physical page");
+            return PageFaultResponse::OutOfMemory;
         }
+
+        u8* dest_ptr = MM.quickmap_page(*physical_page_entry);
+        {
+            void* fault_at;
+            if (!safe_memcpy(dest_ptr, page_data, PAGE_SIZE, fault_at)) {
+                if ((u8*)fault_at >= dest_ptr && (u8*)fault_at <= dest_ptr + PAGE_SIZE)
+                    dbgln("      >> inode fault: error copying data to {}/{}, failed at {}",
+                        physical_page_entry->paddr(),
+                        VirtualAddress(dest_ptr),
+                        VirtualAddress(fault_at));
+                else
+                    VERIFY_NOT_REACHED();
+            }
+        }
+        MM.unquickmap_page();
+        ++pages_populated;
     }
-    MM.unquickmap_page();
+
+    dbgln_if(PAGE_FAULT_DEBUG, "      >> paged in {} pages from inode", pages_populated);
 
     remap_vmobject_page(page_index_in_vmobject);
+    map_cached_pages_around(page_index_in_region);
     return PageFaultResponse::Continue;
 }
 
+void Region::map_cached_pages_around(size_t page_index_in_region)
+{
+    // Map the neighbors of a faulting page that are already in memory (read ahead by us,
+    // or paged in by another process mapping the same file), so we don't take a separate
+    // fault for each of them.
+    static constexpr size_t fault_around_page_count = 16;
+
+    VERIFY(s_mm_lock.own_lock());
+    if (!m_page_directory)
+        return;
+
+    size_t first_page_index = page_index_in_region & ~(fault_around_page_count - 1);
+    size_t end_page_index = min(first_page_index + fault_around_page_count, page_count());
+
+    ScopedSpinLock page_lock(m_page_directory->get_lock());
+    for (size_t page_index = first_page_index; page_index < end_page_index; ++page_index) {
+        if (page_index == page_index_in_region || !physical_page(page_index))
+            continue;
+        // Entries either go from not-present to present or are rewritten unchanged, so no TLB flush is needed.
+        if (!map_individual_page_impl(page_index))
+            break;
+    }
+}
+
 RefPtr<Process> Region::get_owner()
 {
     return m_owner.strong_ref();
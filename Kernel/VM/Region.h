@@ -245,7 +245,9 @@ private:
 
     PageFaultResponse handle_cow_fault(size_t page_index);
     PageFaultResponse handle_inode_fault(size_t page_index, ScopedSpinLock<RecursiveSpinLock>&);
-    PageFaultResponse handle_zero_fault(size_t page_index);
+    PageFaultResponse handle_zero_fault(size_t page_index, ScopedSpinLock<RecursiveSpinLock>&);
+    bool try_map_large_page(size_t page_index, ScopedSpinLock<RecursiveSpinLock>&);
+    void map_cached_pages_around(size_t page_index);
 
     bool map_individual_page_impl(size_t page_index);
 
@@ -24,6 +24,7 @@
 #include <Kernel/Devices/VMWareBackdoor.h>
 #include <Kernel/Devices/ZeroDevice.h>
 #include <Kernel/FileSystem/Ext2FileSystem.h>
+#include <Kernel/FileSystem/IORing.h>
 #include <Kernel/FileSystem/SysFS.h>
 #include <Kernel/FileSystem/VirtualFileSystem.h>
 #include <Kernel/Graphics/GraphicsManagement.h>
@@ -176,6 +177,7 @@ extern "C" [[noreturn]] UNMAP_AFTER_INIT void init()
     Scheduler::initialize();
 
     WorkQueue::initialize();
+    IORing::initialize();
 
     {
         RefPtr<Thread> init_stage2_thread;
@@ -0,0 +1,233 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+
+#include <AK/JsonArray.h>
+#include <AK/JsonArraySerializer.h>
+#include <AK/JsonObject.h>
+#include <AK/JsonObjectSerializer.h>
+#include <AK/JsonReader.h>
+#include <AK/JsonValue.h>
+#include <AK/String.h>
+#include <AK/StringBuilder.h>
+
+using Type = JsonToken::Type;
+
+static Vector<Type> token_types(StringView input, bool& valid)
+{
+    Vector<Type> types;
+    JsonReader reader(input);
+    for (;;) {
+        auto token = reader.next();
+        if (!token.has_value())
+            break;
+        types.append(token->type());
+    }
+    valid = reader.is_done();
+    return types;
+}
+
+static bool is_valid(StringView input)
+{
+    bool valid;
+    token_types(input, valid);
+    return valid;
+}
+
+TEST_CASE(json_reader_tokens)
+{
+    bool valid;
+    auto types = token_types(R"( {"a": [1, -2.5e3, "x"], "b": {}, "c": [], "d": true, "e": false, "f": null} )", valid);
+    EXPECT(valid);
+    Vector<Type> expected {
+        Type::ObjectStart,
+        Type::Name, Type::ArrayStart, Type::Number, Type::Number, Type::String, Type::ArrayEnd,
+        Type::Name, Type::ObjectStart, Type::ObjectEnd,
+        Type::Name, Type::ArrayStart, Type::ArrayEnd,
+        Type::Name, Type::True,
+        Type::Name, Type::False,
+        Type::Name, Type::Null,
+        Type::ObjectEnd
+    };
+    EXPECT_EQ(types, expected);
+
+    EXPECT(is_valid("42"));
+    EXPECT(is_valid("\"just a string\""));
+    EXPECT(is_valid("[[[]]]"));
+}
+
+TEST_CASE(json_reader_rejects_invalid_documents)
+{
+    EXPECT(!is_valid(""));
+    EXPECT(!is_valid("{"));
+    EXPECT(!is_valid("[1, 2"));
+    EXPECT(!is_valid("[1, 2,]"));
+    EXPECT(!is_valid("{\"a\": 1,}"));
+    EXPECT(!is_valid("{\"a\" 1}"));
+    EXPECT(!is_valid("{\"a\": 1 \"b\": 2}"));
+    EXPECT(!is_valid("{1: 2}"));
+    EXPECT(!is_valid("[1}"));
+    EXPECT(!is_valid("{\"a\": 1]"));
+    EXPECT(!is_valid("[\"unterminated]"));
+    EXPECT(!is_valid("[tru]"));
+    EXPECT(!is_valid("[-]"));
+    EXPECT(!is_valid("[1.]"));
+    EXPECT(!is_valid("[1e]"));
+    EXPECT(!is_valid("[] []"));
+    EXPECT(!is_valid("{} x"));
+}
+
+TEST_CASE(json_reader_strings_point_into_the_input)
+{
+    StringView input = R"({"name": "plain", "escaped": "tab\there \"quoted\" é"})";
+    JsonReader reader(input);
+    EXPECT_EQ(reader.next()->type(), Type::ObjectStart);
+
+    auto name = reader.next().value();
+    EXPECT_EQ(name.type(), Type::Name);
+    EXPECT(name.equals("name"));
+    auto plain = reader.next().value();
+    EXPECT(!plain.has_escapes());
+    EXPECT_EQ(plain.text(), "plain");
+    EXPECT_EQ(plain.text().characters_without_null_termination(), input.characters_without_null_termination() + 10);
+
+    EXPECT(reader.next()->equals("escaped"));
+    auto escaped = reader.next().value();
+    EXPECT(escaped.has_escapes());
+    EXPECT_EQ(escaped.text(), R"(tab\there \"quoted\" é)");
+    EXPECT_EQ(escaped.to_string(), "tab\there \"quoted\" \xc3\xa9");
+    EXPECT(escaped.equals("tab\there \"quoted\" \xc3\xa9"));
+
+    EXPECT_EQ(reader.next()->type(), Type::ObjectEnd);
+    EXPECT(!reader.next().has_value());
+    EXPECT(reader.is_done());
+}
+
+TEST_CASE(json_reader_numbers)
+{
+    JsonReader reader("[0, 42, -7, 4294967296, 1.5, -0.25, 2e3, 25E-2, 0.3, 0.30000000000000000000000000000000000000000000000000000000000000000001, \"12\"]");
+    EXPECT_EQ(reader.next()->type(), Type::ArrayStart);
+    EXPECT_EQ(reader.next()->to_u32(), 0u);
+    EXPECT_EQ(reader.next()->to_u32(), 42u);
+    EXPECT_EQ(reader.next()->to_i32(), -7);
+    EXPECT_EQ(reader.next()->to_u64(), 4294967296u);
+    EXPECT_EQ(reader.next()->to_double(), 1.5);
+    EXPECT_EQ(reader.next()->to_double(), -0.25);
+    EXPECT_EQ(reader.next()->to_i32(), 2000);
+    EXPECT_EQ(reader.next()->to_double(), 0.25);
+    EXPECT_EQ(reader.next()->to_double(), 0.3);
+    // Too long for the stack buffer.
+    EXPECT_EQ(reader.next()->to_double(), 0.3);
+    // Like JsonValue, strings don't convert to numbers.
+    EXPECT_EQ(reader.next()->to_u32(123), 123u);
+    EXPECT_EQ(reader.next()->type(), Type::ArrayEnd);
+    EXPECT(reader.is_done());
+}
+
+TEST_CASE(json_reader_for_each_member)
+{
+    JsonReader reader(R"([{"pid": 1, "name": "init", "threads": [{"tid": 1}, {"tid": 2}], "skipped": {"a": [1, {"b": 2}]}}, {"pid": 2}])");
+    Vector<u32> pids;
+    Vector<u32> tids;
+    Vector<String> names;
+    bool ok = reader.for_each_element([&] {
+        reader.for_each_member([&](JsonToken const& name) {
+            if (name.equals("pid")) {
+                pids.append(reader.next()->to_u32());
+            } else if (name.equals("name")) {
+                names.append(reader.next()->to_string());
+            } else if (name.equals("threads")) {
+                reader.for_each_element([&] {
+                    reader.for_each_member([&](auto&) {
+                        tids.append(reader.next()->to_u32());
+                    });
+                });
+            } else {
+                reader.skip_value();
+            }
+        });
+    });
+    EXPECT(ok);
+    EXPECT(reader.is_done());
+    EXPECT_EQ(pids, (Vector<u32> { 1, 2 }));
+    EXPECT_EQ(tids, (Vector<u32> { 1, 2 }));
+    EXPECT_EQ(names, (Vector<String> { "init" }));
+}
+
+TEST_CASE(json_reader_for_each_member_needs_values_read)
+{
+    JsonReader reader(R"({"a": 1, "b": 2})");
+    EXPECT(!reader.for_each_member([](auto&) {}));
+    EXPECT(reader.has_error());
+
+    JsonReader array_reader("[[1, 2], 3]");
+    EXPECT(!array_reader.for_each_element([&] { [[maybe_unused]] auto token = array_reader.next(); }));
+    EXPECT(array_reader.has_error());
+}
+
+// Something that looks like /proc/all on a busy system.
+static String make_process_list(size_t process_count, size_t threads_per_process)
+{
+    StringBuilder builder;
+    JsonArraySerializer array { builder };
+    for (size_t pid = 0; pid < process_count; ++pid) {
+        auto process = array.add_object();
+        process.add("pid", pid);
+        process.add("pgid", pid);
+        process.add("uid", 100);
+        process.add("kernel", false);
+        process.add("name", String::formatted("Process{}", pid));
+        process.add("executable", String::formatted("/bin/Process{}", pid));
+        process.add("pledge", "stdio recvfd sendfd rpath unix");
+        process.add("amount_virtual", 123456789);
+        process.add("amount_resident", 2345678);
+        auto threads = process.add_array("threads");
+        for (size_t tid = 0; tid < threads_per_process; ++tid) {
+            auto thread = threads.add_object();
+            thread.add("tid", pid * 100 + tid);
+            thread.add("name", "Thread");
+            thread.add("state", "Running");
+            thread.add("times_scheduled", 98765);
+            thread.add("ticks_user", 1234);
+            thread.add("ticks_kernel", 567);
+        }
+    }
+    array.finish();
+    return builder.to_string();
+}
+
+BENCHMARK_CASE(json_parse_process_list)
+{
+    auto json = make_process_list(200, 10);
+    u64 total = 0;
+    for (size_t i = 0; i < 100; ++i) {
+        auto value = JsonValue::from_string(json);
+        value.value().as_array().for_each([&](auto& process) {
+            total += process.as_object().get("pid").to_u32();
+        });
+    }
+    EXPECT_EQ(total, 100u * 199 * 200 / 2);
+}
+
+BENCHMARK_CASE(json_read_process_list)
+{
+    auto json = make_process_list(200, 10);
+    u64 total = 0;
+    for (size_t i = 0; i < 100; ++i) {
+        JsonReader reader(json);
+        reader.for_each_element([&] {
+            reader.for_each_member([&](auto& name) {
+                if (name.equals("pid"))
+                    total += reader.next()->to_u32();
+                else
+                    reader.skip_value();
+            });
+        });
+        EXPECT(reader.is_done());
+    }
+    EXPECT_EQ(total, 100u * 199 * 200 / 2);
+}
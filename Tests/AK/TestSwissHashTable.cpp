@@ -0,0 +1,251 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+
+#include <AK/HashMap.h>
+#include <AK/HashTable.h>
+#include <AK/String.h>
+#include <AK/SwissHashMap.h>
+#include <AK/SwissHashTable.h>
+
+TEST_CASE(construct)
+{
+    using IntTable = SwissHashTable<int>;
+    EXPECT(IntTable().is_empty());
+    EXPECT_EQ(IntTable().size(), 0u);
+    EXPECT(IntTable().begin() == IntTable().end());
+}
+
+TEST_CASE(basic_move)
+{
+    SwissHashTable<int> foo;
+    foo.set(1);
+    EXPECT_EQ(foo.size(), 1u);
+    auto bar = move(foo);
+    EXPECT_EQ(bar.size(), 1u);
+    EXPECT_EQ(foo.size(), 0u);
+    foo = move(bar);
+    EXPECT_EQ(bar.size(), 0u);
+    EXPECT_EQ(foo.size(), 1u);
+    EXPECT(foo.contains(1));
+}
+
+TEST_CASE(copy)
+{
+    SwissHashTable<String> strings;
+    strings.set("One");
+    strings.set("Two");
+    auto copy = strings;
+    strings.remove("One");
+    EXPECT_EQ(copy.size(), 2u);
+    EXPECT(copy.contains("One"));
+    EXPECT(copy.contains("Two"));
+    EXPECT_EQ(strings.size(), 1u);
+}
+
+TEST_CASE(set_existing_entry)
+{
+    SwissHashTable<String> strings;
+    EXPECT_EQ(strings.set("Apple"), AK::HashSetResult::InsertedNewEntry);
+    EXPECT_EQ(strings.set("Apple"), AK::HashSetResult::ReplacedExistingEntry);
+    EXPECT_EQ(strings.set("Apple", AK::HashSetExistingEntryBehavior::Keep), AK::HashSetResult::KeptExistingEntry);
+    EXPECT_EQ(strings.size(), 1u);
+}
+
+TEST_CASE(iterate_and_remove)
+{
+    SwissHashTable<int> numbers;
+    for (int i = 0; i < 100; ++i)
+        numbers.set(i);
+
+    int sum = 0;
+    for (auto number : numbers)
+        sum += number;
+    EXPECT_EQ(sum, 4950);
+
+    for (int i = 0; i < 100; i += 2)
+        EXPECT(numbers.remove(i));
+    EXPECT(!numbers.remove(0));
+    EXPECT_EQ(numbers.size(), 50u);
+
+    size_t count = 0;
+    for (auto number : numbers) {
+        EXPECT_EQ(number % 2, 1);
+        ++count;
+    }
+    EXPECT_EQ(count, 50u);
+}
+
+TEST_CASE(remove_and_reinsert_does_not_grow)
+{
+    SwissHashTable<int> numbers;
+    numbers.ensure_capacity(64);
+    auto capacity = numbers.capacity();
+    for (int round = 0; round < 1000; ++round) {
+        for (int i = 0; i < 64; ++i)
+            numbers.set(round * 64 + i);
+        for (int i = 0; i < 64; ++i)
+            EXPECT(numbers.remove(round * 64 + i));
+    }
+    EXPECT(numbers.is_empty());
+    EXPECT_EQ(numbers.capacity(), capacity);
+}
+
+TEST_CASE(many_operations_match_hash_table)
+{
+    // Mix inserts and removals with a simple LCG so tombstones, rehashes and wrap-around all get exercised.
+    HashTable<u32> expected;
+    SwissHashTable<u32> actual;
+    u32 state = 1;
+    for (int i = 0; i < 100000; ++i) {
+        state = state * 1103515245 + 12345;
+        auto value = (state >> 8) % 4096;
+        if (state & 0x10000) {
+            EXPECT_EQ(actual.remove(value), expected.remove(value));
+        } else {
+            actual.set(value);
+            expected.set(value);
+        }
+        EXPECT_EQ(actual.size(), expected.size());
+    }
+    for (u32 value = 0; value < 4096; ++value)
+        EXPECT_EQ(actual.contains(value), expected.contains(value));
+    size_t count = 0;
+    for (auto value : actual) {
+        EXPECT(expected.contains(value));
+        ++count;
+    }
+    EXPECT_EQ(count, expected.size());
+}
+
+TEST_CASE(map_basic)
+{
+    SwissHashMap<int, String> number_to_string;
+    number_to_string.set(1, "One");
+    number_to_string.set(2, "Two");
+    number_to_string.set(3, "Three");
+
+    EXPECT_EQ(number_to_string.is_empty(), false);
+    EXPECT_EQ(number_to_string.size(), 3u);
+
+    int loop_counter = 0;
+    for (auto& it : number_to_string) {
+        EXPECT(!it.value.is_null());
+        ++loop_counter;
+    }
+    EXPECT_EQ(loop_counter, 3);
+
+    EXPECT_EQ(number_to_string.get(2).value(), "Two");
+    EXPECT(!number_to_string.get(4).has_value());
+
+    number_to_string.set(2, "Deux");
+    EXPECT_EQ(number_to_string.get(2).value(), "Deux");
+    EXPECT_EQ(number_to_string.size(), 3u);
+
+    EXPECT(number_to_string.remove(1));
+    EXPECT(!number_to_string.contains(1));
+    EXPECT_EQ(number_to_string.size(), 2u);
+
+    number_to_string.ensure(4) = "Four";
+    EXPECT_EQ(number_to_string.get(4).value(), "Four");
+    EXPECT_EQ(number_to_string.keys().size(), 3u);
+}
+
+TEST_CASE(map_initializer_list)
+{
+    SwissHashMap<String, int> map { { "One", 1 }, { "Two", 2 } };
+    EXPECT_EQ(map.size(), 2u);
+    EXPECT_EQ(map.get("One").value(), 1);
+    EXPECT_EQ(map.get("Two").value(), 2);
+}
+
+// Benchmarks: run the same workload against HashMap and SwissHashMap.
+
+static constexpr int benchmark_key_count = 100000;
+
+template<typename Key>
+static Key make_key(int i);
+
+template<>
+int make_key<int>(int i)
+{
+    return i;
+}
+
+template<>
+void* make_key<void*>(int i)
+{
+    return reinterpret_cast<void*>((FlatPtr)i * 16);
+}
+
+template<>
+String make_key<String>(int i)
+{
+    return String::formatted("key-{}", i);
+}
+
+template<typename Map, typename Key>
+static void benchmark_insert()
+{
+    Vector<Key> keys;
+    for (int i = 0; i < benchmark_key_count; ++i)
+        keys.append(make_key<Key>(i));
+    for (int round = 0; round < 10; ++round) {
+        Map map;
+        for (auto& key : keys)
+            map.set(key, 0);
+        EXPECT_EQ(map.size(), (size_t)benchmark_key_count);
+    }
+}
+
+template<typename Map, typename Key>
+static void benchmark_lookup(bool hit)
+{
+    Map map;
+    Vector<Key> keys;
+    for (int i = 0; i < benchmark_key_count; ++i) {
+        map.set(make_key<Key>(i), i);
+        keys.append(make_key<Key>(hit ? i : i + benchmark_key_count));
+    }
+    size_t found = 0;
+    for (int round = 0; round < 20; ++round) {
+        for (auto& key : keys)
+            found += map.contains(key);
+    }
+    EXPECT_EQ(found, hit ? 20u * benchmark_key_count : 0u);
+}
+
+template<typename Map, typename Key>
+static void benchmark_erase()
+{
+    Vector<Key> keys;
+    for (int i = 0; i < benchmark_key_count; ++i)
+        keys.append(make_key<Key>(i));
+    for (int round = 0; round < 10; ++round) {
+        Map map;
+        for (auto& key : keys)
+            map.set(key, 0);
+        for (auto& key : keys)
+            map.remove(key);
+        EXPECT(map.is_empty());
+    }
+}
+
+#define __ENUMERATE_MAP_BENCHMARKS(name, key_type)                                                          \
+    BENCHMARK_CASE(hash_map_insert_##name) { benchmark_insert<HashMap<key_type, int>, key_type>(); }        \
+    BENCHMARK_CASE(swiss_map_insert_##name) { benchmark_insert<SwissHashMap<key_type, int>, key_type>(); }  \
+    BENCHMARK_CASE(hash_map_hit_##name) { benchmark_lookup<HashMap<key_type, int>, key_type>(true); }       \
+    BENCHMARK_CASE(swiss_map_hit_##name) { benchmark_lookup<SwissHashMap<key_type, int>, key_type>(true); } \
+    BENCHMARK_CASE(hash_map_miss_##name) { benchmark_lookup<HashMap<key_type, int>, key_type>(false); }     \
+    BENCHMARK_CASE(swiss_map_miss_##name) { benchmark_lookup<SwissHashMap<key_type, int>, key_type>(false); } \
+    BENCHMARK_CASE(hash_map_erase_##name) { benchmark_erase<HashMap<key_type, int>, key_type>(); }          \
+    BENCHMARK_CASE(swiss_map_erase_##name) { benchmark_erase<SwissHashMap<key_type, int>, key_type>(); }
+
+__ENUMERATE_MAP_BENCHMARKS(int, int)
+__ENUMERATE_MAP_BENCHMARKS(pointer, void*)
+__ENUMERATE_MAP_BENCHMARKS(string, String)
+#undef __ENUMERATE_MAP_BENCHMARKS
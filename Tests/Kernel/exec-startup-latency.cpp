@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Vector.h>
+#include <LibCore/ArgsParser.h>
+#include <LibCore/ElapsedTimer.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <spawn.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+int main(int argc, char** argv)
+{
+    int iterations = 10;
+    Vector<const char*> command;
+
+    Core::ArgsParser args_parser;
+    args_parser.set_general_help("Measure how long it takes to spawn a program and wait for it to exit. Defaults to 'Browser --help', which maps LibWeb, LibJS and LibGUI before exiting.");
+    args_parser.add_option(iterations, "Number of times to run the program", "iterations", 'n', "count");
+    args_parser.add_positional_argument(command, "Command to run", "command", Core::ArgsParser::Required::No);
+    args_parser.parse(argc, argv);
+
+    if (command.is_empty()) {
+        command.append("/bin/Browser");
+        command.append("--help");
+    }
+    command.append(nullptr);
+
+    posix_spawn_file_actions_t file_actions;
+    posix_spawn_file_actions_init(&file_actions);
+    posix_spawn_file_actions_addopen(&file_actions, STDOUT_FILENO, "/dev/null", O_WRONLY, 0);
+    posix_spawn_file_actions_addopen(&file_actions, STDERR_FILENO, "/dev/null", O_WRONLY, 0);
+
+    int total_ms = 0;
+    int min_ms = 0;
+    int max_ms = 0;
+    for (int i = 0; i < iterations; ++i) {
+        Core::ElapsedTimer timer;
+        timer.start();
+
+        pid_t pid;
+        if ((errno = posix_spawn(&pid, command[0], &file_actions, nullptr, const_cast<char**>(command.data()), environ))) {
+            perror("posix_spawn");
+            return 1;
+        }
+        int status = 0;
+        if (waitpid(pid, &status, 0) < 0) {
+            perror("waitpid");
+            return 1;
+        }
+
+        auto elapsed_ms = timer.elapsed();
+        total_ms += elapsed_ms;
+        min_ms = i == 0 ? elapsed_ms : min(min_ms, elapsed_ms);
+        max_ms = max(max_ms, elapsed_ms);
+        printf("Run %d: %d ms\n", i + 1, elapsed_ms);
+    }
+
+    posix_spawn_file_actions_destroy(&file_actions);
+
+    printf("%s: min %d ms, max %d ms, average %d ms over %d runs\n", command[0], min_ms, max_ms, total_ms / max(iterations, 1), iterations);
+    return 0;
+}
@@ -0,0 +1,172 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/ByteBuffer.h>
+#include <AK/Vector.h>
+#include <LibCore/ArgsParser.h>
+#include <LibCore/ElapsedTimer.h>
+#include <LibCore/IORing.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static bool copy_with_read_write(int src_fd, int dst_fd, size_t chunk_size)
+{
+    auto buffer = ByteBuffer::create_uninitialized(chunk_size);
+    for (;;) {
+        auto nread = read(src_fd, buffer.data(), buffer.size());
+        if (nread < 0) {
+            perror("read");
+            return false;
+        }
+        if (nread == 0)
+            return true;
+        if (write(dst_fd, buffer.data(), nread) != nread) {
+            perror("write");
+            return false;
+        }
+    }
+}
+
+static bool copy_with_io_ring(int src_fd, int dst_fd, size_t chunk_size, size_t depth, off_t size)
+{
+    auto ring_or_error = Core::IORing::create(depth);
+    if (ring_or_error.is_error()) {
+        warnln("IORing::create: {}", ring_or_error.error());
+        return false;
+    }
+    auto& ring = *ring_or_error.value();
+
+    Vector<ByteBuffer> buffers;
+    Vector<off_t> offsets;
+    off_t next_offset = 0;
+    size_t in_flight = 0;
+
+    // Each slot alternates between reading a chunk and writing it back out.
+    // The low bit of user_data says which of the two just completed.
+    auto read_next = [&](size_t slot) {
+        if (next_offset >= size)
+            return;
+        offsets[slot] = next_offset;
+        auto length = min<size_t>(chunk_size, size - next_offset);
+        next_offset += length;
+        VERIFY(ring.submit_read(src_fd, buffers[slot].bytes().slice(0, length), slot << 1, offsets[slot]));
+        ++in_flight;
+    };
+
+    for (size_t slot = 0; slot < depth; ++slot) {
+        buffers.append(ByteBuffer::create_uninitialized(chunk_size));
+        offsets.append(0);
+        read_next(slot);
+    }
+
+    while (in_flight > 0) {
+        if (auto result = ring.submit_and_wait(1); result.is_error()) {
+            warnln("IORing::submit_and_wait: {}", result.error());
+            return false;
+        }
+        for (;;) {
+            auto completion = ring.pop_completion();
+            if (!completion.has_value())
+                break;
+            --in_flight;
+            if (completion->is_error()) {
+                warnln("I/O failed: {}", strerror(completion->error()));
+                return false;
+            }
+            size_t slot = completion->user_data >> 1;
+            bool was_write = completion->user_data & 1;
+            if (was_write) {
+                read_next(slot);
+                continue;
+            }
+            // Short reads only happen at the end of a regular file, which is the last chunk anyway.
+            VERIFY(ring.submit_write(dst_fd, buffers[slot].bytes().slice(0, completion->result), (slot << 1) | 1, offsets[slot]));
+            ++in_flight;
+        }
+    }
+    return true;
+}
+
+static bool measure_nops(size_t count, size_t batch_size)
+{
+    auto ring_or_error = Core::IORing::create(batch_size);
+    if (ring_or_error.is_error()) {
+        warnln("IORing::create: {}", ring_or_error.error());
+        return false;
+    }
+    auto& ring = *ring_or_error.value();
+
+    Core::ElapsedTimer timer;
+    timer.start();
+    for (size_t done = 0; done < count;) {
+        size_t batch = min(batch_size, count - done);
+        for (size_t i = 0; i < batch; ++i)
+            VERIFY(ring.submit_nop(i));
+        if (auto result = ring.submit_and_wait(batch); result.is_error()) {
+            warnln("IORing::submit_and_wait: {}", result.error());
+            return false;
+        }
+        while (ring.pop_completion().has_value())
+            ++done;
+    }
+    auto elapsed_ms = max(timer.elapsed(), 1);
+    printf("%zu no-op submissions in batches of %zu: %d ms (%.2f M/s)\n", count, batch_size, elapsed_ms, count / 1000.0 / elapsed_ms);
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    const char* source_path = nullptr;
+    const char* destination_path = "/tmp/io-ring-throughput.out";
+    int chunk_kib = 64;
+    int depth = 8;
+
+    Core::ArgsParser args_parser;
+    args_parser.set_general_help("Compare copying a file with plain read()/write() against an I/O ring with several chunks in flight.");
+    args_parser.add_option(chunk_kib, "Size of each read and write", "chunk-size", 'c', "KiB");
+    args_parser.add_option(depth, "Number of chunks in flight on the ring", "depth", 'd', "count");
+    args_parser.add_option(destination_path, "File to copy to", "output", 'o', "path");
+    args_parser.add_positional_argument(source_path, "File to copy", "source");
+    args_parser.parse(argc, argv);
+
+    struct stat st;
+    if (stat(source_path, &st) < 0) {
+        perror("stat");
+        return 1;
+    }
+    size_t chunk_size = chunk_kib * KiB;
+
+    auto run = [&](const char* name, auto copy) {
+        int src_fd = open(source_path, O_RDONLY);
+        int dst_fd = open(destination_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (src_fd < 0 || dst_fd < 0) {
+            perror("open");
+            return false;
+        }
+        Core::ElapsedTimer timer;
+        timer.start();
+        bool ok = copy(src_fd, dst_fd);
+        auto elapsed_ms = max(timer.elapsed(), 1);
+        close(src_fd);
+        close(dst_fd);
+        if (ok)
+            printf("%s: %lld bytes in %d ms (%.2f MiB/s)\n", name, (long long)st.st_size, elapsed_ms, (double)st.st_size / MiB / (elapsed_ms / 1000.0));
+        return ok;
+    };
+
+    if (!run("read/write", [&](int src_fd, int dst_fd) { return copy_with_read_write(src_fd, dst_fd, chunk_size); }))
+        return 1;
+    if (!run("io ring", [&](int src_fd, int dst_fd) { return copy_with_io_ring(src_fd, dst_fd, chunk_size, depth, st.st_size); }))
+        return 1;
+    if (!measure_nops(1000000, 256))
+        return 1;
+
+    unlink(destination_path);
+    return 0;
+}
@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/JsonObject.h>
+#include <AK/Random.h>
+#include <LibCore/ArgsParser.h>
+#include <LibCore/ElapsedTimer.h>
+#include <LibCore/File.h>
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+
+static bool set_transparent_large_pages(bool enabled)
+{
+    auto* file = fopen("/proc/sys/transparent_large_pages", "w");
+    if (!file) {
+        fprintf(stderr, "Couldn't open /proc/sys/transparent_large_pages: %s\n", strerror(errno));
+        return false;
+    }
+    fputs(enabled ? "1" : "0", file);
+    fclose(file);
+    return true;
+}
+
+static unsigned large_pages_mapped()
+{
+    auto file = Core::File::construct("/proc/memstat");
+    if (!file->open(Core::OpenMode::ReadOnly))
+        return 0;
+    auto json = JsonValue::from_string(file->read_all());
+    if (!json.has_value() || !json->is_object())
+        return 0;
+    return json->as_object().get("user_large_pages_mapped").to_u32();
+}
+
+int main(int argc, char** argv)
+{
+    int megabytes = 1024;
+    int touches = 16 * 1024 * 1024;
+    bool disable_large_pages = false;
+
+    Core::ArgsParser args_parser;
+    args_parser.set_general_help("Measure random access throughput on a large anonymous mapping, with and without transparent large pages.");
+    args_parser.add_option(megabytes, "Size of the mapping", "size", 's', "MiB");
+    args_parser.add_option(touches, "Number of random accesses", "touches", 't', "count");
+    args_parser.add_option(disable_large_pages, "Only use 4 KiB pages", "no-large-pages", 'n');
+    args_parser.parse(argc, argv);
+
+    if (disable_large_pages && !set_transparent_large_pages(false))
+        return 1;
+
+    size_t size = (size_t)megabytes * MiB;
+    auto* buffer = (u8*)mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE, 0, 0);
+    if (buffer == MAP_FAILED) {
+        perror("mmap");
+        return 1;
+    }
+
+    Core::ElapsedTimer timer;
+    timer.start();
+    for (size_t offset = 0; offset < size; offset += PAGE_SIZE)
+        buffer[offset] = 1;
+    auto populate_ms = timer.elapsed();
+    auto mapped = large_pages_mapped();
+
+    u32 state = get_random<u32>() | 1;
+    u32 sum = 0;
+    timer.start();
+    for (int i = 0; i < touches; ++i) {
+        // xorshift32, so the access pattern itself stays out of the measurement.
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        auto& byte = buffer[state % size];
+        sum += byte;
+        byte = (u8)sum;
+    }
+    auto touch_ms = max(timer.elapsed(), 1);
+
+    munmap(buffer, size);
+
+    if (disable_large_pages)
+        set_transparent_large_pages(true);
+
+    printf("Populated %d MiB in %d ms (%u large pages mapped)\n", megabytes, populate_ms, mapped);
+    printf("%d random accesses in %d ms: %.2f M/s (checksum %u)\n", touches, touch_ms, touches / 1000.0 / touch_ms, sum);
+    return 0;
+}
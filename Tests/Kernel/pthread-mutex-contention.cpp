@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Vector.h>
+#include <LibCore/ArgsParser.h>
+#include <LibCore/ElapsedTimer.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+
+static pthread_mutex_t s_mutex;
+static pthread_cond_t s_cond = PTHREAD_COND_INITIALIZER;
+static int s_iterations;
+static int s_critical_section_length;
+static volatile u32 s_counter;
+static bool s_go;
+
+static void* worker(void*)
+{
+    pthread_mutex_lock(&s_mutex);
+    while (!s_go)
+        pthread_cond_wait(&s_cond, &s_mutex);
+    pthread_mutex_unlock(&s_mutex);
+
+    for (int i = 0; i < s_iterations; ++i) {
+        pthread_mutex_lock(&s_mutex);
+        for (int j = 0; j < s_critical_section_length; ++j)
+            s_counter = s_counter + 1;
+        pthread_mutex_unlock(&s_mutex);
+    }
+    return nullptr;
+}
+
+int main(int argc, char** argv)
+{
+    int thread_count = 4;
+    s_iterations = 100000;
+    s_critical_section_length = 16;
+    bool priority_inheritance = false;
+
+    Core::ArgsParser args_parser;
+    args_parser.set_general_help("Measure lock/unlock throughput of a pthread mutex shared by several threads.");
+    args_parser.add_option(thread_count, "Number of threads", "threads", 't', "count");
+    args_parser.add_option(s_iterations, "Number of lock/unlock pairs per thread", "iterations", 'n', "count");
+    args_parser.add_option(s_critical_section_length, "Number of increments done while holding the lock", "critical-section", 'c', "count");
+    args_parser.add_option(priority_inheritance, "Use a priority inheriting mutex", "pi", 'p');
+    args_parser.parse(argc, argv);
+
+    pthread_mutexattr_t attr;
+    pthread_mutexattr_init(&attr);
+    if (priority_inheritance) {
+        if (int rc = pthread_mutexattr_setprotocol(&attr, PTHREAD_PRIO_INHERIT); rc != 0) {
+            fprintf(stderr, "pthread_mutexattr_setprotocol: %s\n", strerror(rc));
+            return 1;
+        }
+    }
+    pthread_mutex_init(&s_mutex, &attr);
+    pthread_mutexattr_destroy(&attr);
+
+    Vector<pthread_t> threads;
+    for (int i = 0; i < thread_count; ++i) {
+        pthread_t thread;
+        if (int rc = pthread_create(&thread, nullptr, worker, nullptr); rc != 0) {
+            fprintf(stderr, "pthread_create: %s\n", strerror(rc));
+            return 1;
+        }
+        threads.append(thread);
+    }
+
+    Core::ElapsedTimer timer;
+    timer.start();
+    pthread_mutex_lock(&s_mutex);
+    s_go = true;
+    pthread_cond_broadcast(&s_cond);
+    pthread_mutex_unlock(&s_mutex);
+
+    for (auto thread : threads)
+        pthread_join(thread, nullptr);
+    auto elapsed_ms = max(timer.elapsed(), 1);
+
+    u32 expected = (u32)thread_count * s_iterations * s_critical_section_length;
+    printf("%d threads, %d lock/unlock pairs each in %d ms: %.2f M/s\n", thread_count, s_iterations, elapsed_ms, (double)thread_count * s_iterations / 1000.0 / elapsed_ms);
+
+    if (s_counter != expected) {
+        fprintf(stderr, "FAIL: counter is %u, expected %u\n", s_counter, expected);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,159 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/ByteBuffer.h>
+#include <AK/Time.h>
+#include <LibCore/ArgsParser.h>
+#include <LibCore/ElapsedTimer.h>
+#include <arpa/inet.h>
+#include <errno.h>
+#include <netinet/in.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+static bool set_loopback_knob(const char* name, bool enabled)
+{
+    auto path = String::formatted("/proc/sys/{}", name);
+    auto* file = fopen(path.characters(), "w");
+    if (!file) {
+        fprintf(stderr, "Couldn't open %s: %s\n", path.characters(), strerror(errno));
+        return false;
+    }
+    fputs(enabled ? "1" : "0", file);
+    fclose(file);
+    return true;
+}
+
+static int run_sender(u16 port, size_t total_bytes, size_t chunk_size)
+{
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) {
+        perror("socket");
+        return 1;
+    }
+
+    sockaddr_in address {};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (connect(fd, (const sockaddr*)&address, sizeof(address)) < 0) {
+        perror("connect");
+        return 1;
+    }
+
+    auto buffer = ByteBuffer::create_uninitialized(chunk_size);
+    for (size_t i = 0; i < chunk_size; ++i)
+        buffer[i] = i & 0xff;
+
+    size_t sent = 0;
+    while (sent < total_bytes) {
+        auto nwritten = write(fd, buffer.data(), min(chunk_size, total_bytes - sent));
+        if (nwritten < 0) {
+            perror("write");
+            return 1;
+        }
+        sent += nwritten;
+    }
+    close(fd);
+    return 0;
+}
+
+int main(int argc, char** argv)
+{
+    int megabytes = 16;
+    int chunk_size = 64 * KiB;
+    int port = 9321;
+    bool simulate_loss = false;
+    bool simulate_latency = false;
+
+    Core::ArgsParser args_parser;
+    args_parser.set_general_help("Measure TCP goodput over the loopback adapter, optionally with simulated loss and latency.");
+    args_parser.add_option(megabytes, "Number of megabytes to transfer", "size", 's', "MiB");
+    args_parser.add_option(chunk_size, "Size of each write()", "chunk-size", 'c', "bytes");
+    args_parser.add_option(port, "Port to listen on", "port", 'p', "port");
+    args_parser.add_option(simulate_loss, "Drop about 1% of loopback packets", "loss", 'l');
+    args_parser.add_option(simulate_latency, "Delay loopback packets by 20 ms", "latency", 'd');
+    args_parser.parse(argc, argv);
+
+    if (simulate_loss && !set_loopback_knob("loopback_simulate_packet_loss", true))
+        return 1;
+    if (simulate_latency && !set_loopback_knob("loopback_simulate_latency", true))
+        return 1;
+
+    int listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (listen_fd < 0) {
+        perror("socket");
+        return 1;
+    }
+
+    sockaddr_in address {};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (bind(listen_fd, (const sockaddr*)&address, sizeof(address)) < 0) {
+        perror("bind");
+        return 1;
+    }
+    if (listen(listen_fd, 1) < 0) {
+        perror("listen");
+        return 1;
+    }
+
+    size_t total_bytes = (size_t)megabytes * MiB;
+
+    pid_t sender_pid = fork();
+    if (sender_pid < 0) {
+        perror("fork");
+        return 1;
+    }
+    if (sender_pid == 0) {
+        close(listen_fd);
+        _exit(run_sender(port, total_bytes, chunk_size));
+    }
+
+    int fd = accept(listen_fd, nullptr, nullptr);
+    if (fd < 0) {
+        perror("accept");
+        return 1;
+    }
+
+    auto buffer = ByteBuffer::create_uninitialized(chunk_size);
+    size_t received = 0;
+    Core::ElapsedTimer timer;
+    timer.start();
+    for (;;) {
+        auto nread = read(fd, buffer.data(), buffer.size());
+        if (nread < 0) {
+            perror("read");
+            return 1;
+        }
+        if (nread == 0)
+            break;
+        received += nread;
+    }
+    auto elapsed_ms = max(timer.elapsed(), 1);
+
+    int status = 0;
+    waitpid(sender_pid, &status, 0);
+    close(fd);
+    close(listen_fd);
+
+    if (simulate_loss)
+        set_loopback_knob("loopback_simulate_packet_loss", false);
+    if (simulate_latency)
+        set_loopback_knob("loopback_simulate_latency", false);
+
+    printf("Received %zu of %zu bytes in %d ms: %.2f MiB/s\n", received, total_bytes, elapsed_ms, (double)received / MiB / (elapsed_ms / 1000.0));
+
+    if (received != total_bytes || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+        fprintf(stderr, "FAIL\n");
+        return 1;
+    }
+    return 0;
+}
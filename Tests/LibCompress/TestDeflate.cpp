@@ -9,9 +9,39 @@
 #include <AK/Array.h>
 #include <AK/MemoryStream.h>
 #include <AK/Random.h>
+#include <AK/String.h>
 #include <LibCompress/Deflate.h>
 #include <cstring>
 
+using CompressionLevel = Compress::DeflateCompressor::CompressionLevel;
+
+// Random words and numbers, which compress roughly as well as prose does
+static ByteBuffer make_text_like_data(size_t size)
+{
+    // A simple linear congruential generator is plenty random for this, and much faster than get_random()
+    u32 state = 1;
+    auto next_random = [&] {
+        state = state * 1103515245 + 12345;
+        return state >> 16;
+    };
+
+    Array<StringView, 16> words { "the", "a", "compressor", "stream", "of", "bytes", "and", "window", "match", "length",
+        "distance", "to", "huffman", "block", "literal", "is" };
+    ByteBuffer data;
+    while (data.size() < size) {
+        if (next_random() % 8 == 0) {
+            auto number = String::number(next_random() % 1000);
+            data.append(number.characters(), number.length());
+        } else {
+            auto word = words[next_random() % words.size()];
+            data.append(word.characters_without_null_termination(), word.length());
+        }
+        data.append(next_random() % 16 == 0 ? "\n" : " ", 1);
+    }
+    data.resize(size);
+    return data;
+}
+
 TEST_CASE(canonical_code_simple)
 {
     const Array<u8, 32> code {
@@ -154,3 +184,77 @@ TEST_CASE(deflate_compress_literals)
     auto compressed = Compress::DeflateCompressor::compress_all(test, Compress::DeflateCompressor::CompressionLevel::GOOD);
     EXPECT(compressed.has_value());
 }
+
+TEST_CASE(deflate_round_trip_compress_matches_across_blocks)
+{
+    // A random piece repeated over several blocks only compresses well if back references can reach into the previous block
+    auto piece = ByteBuffer::create_uninitialized(20000);
+    for (size_t i = 0; i < piece.size(); i++)
+        piece[i] = get_random<u8>();
+    ByteBuffer original;
+    for (size_t i = 0; i < 5; i++)
+        original.append(piece.data(), piece.size());
+
+    auto compressed = Compress::DeflateCompressor::compress_all(original, Compress::DeflateCompressor::CompressionLevel::FAST);
+    EXPECT(compressed.has_value());
+    EXPECT(compressed.value().size() < 2 * piece.size());
+    auto uncompressed = Compress::DeflateDecompressor::decompress_all(compressed.value());
+    EXPECT(uncompressed.has_value());
+    EXPECT(uncompressed.value() == original);
+}
+
+TEST_CASE(deflate_round_trip_compress_every_level)
+{
+    auto original = make_text_like_data(3 * Compress::DeflateCompressor::block_size);
+    for (auto level : { CompressionLevel::STORE, CompressionLevel::FASTEST, CompressionLevel::FAST, CompressionLevel::GOOD, CompressionLevel::GREAT, CompressionLevel::BEST }) {
+        auto compressed = Compress::DeflateCompressor::compress_all(original, level);
+        EXPECT(compressed.has_value());
+        if (level != CompressionLevel::STORE)
+            EXPECT(compressed.value().size() < original.size() / 2);
+        auto uncompressed = Compress::DeflateDecompressor::decompress_all(compressed.value());
+        EXPECT(uncompressed.has_value());
+        EXPECT(uncompressed.value() == original);
+    }
+}
+
+TEST_CASE(deflate_round_trip_compress_long_matches)
+{
+    // Runs of the same byte produce matches that end exactly at the maximum match length and at the end of the input
+    auto original = ByteBuffer::create_zeroed(10000);
+    for (size_t i = 0; i < original.size(); i += 777)
+        original[i] = get_random<u8>();
+    for (auto level : { CompressionLevel::FASTEST, CompressionLevel::FAST, CompressionLevel::GOOD }) {
+        auto compressed = Compress::DeflateCompressor::compress_all(original, level);
+        EXPECT(compressed.has_value());
+        auto uncompressed = Compress::DeflateDecompressor::decompress_all(compressed.value());
+        EXPECT(uncompressed.has_value());
+        EXPECT(uncompressed.value() == original);
+    }
+}
+
+static void benchmark_compression_level(CompressionLevel level)
+{
+    auto original = make_text_like_data(4 * MiB);
+    auto compressed = Compress::DeflateCompressor::compress_all(original, level);
+    EXPECT(compressed.has_value());
+}
+
+BENCHMARK_CASE(deflate_compress_fastest_4mib)
+{
+    benchmark_compression_level(CompressionLevel::FASTEST);
+}
+
+BENCHMARK_CASE(deflate_compress_fast_4mib)
+{
+    benchmark_compression_level(CompressionLevel::FAST);
+}
+
+BENCHMARK_CASE(deflate_compress_good_4mib)
+{
+    benchmark_compression_level(CompressionLevel::GOOD);
+}
+
+BENCHMARK_CASE(deflate_compress_great_4mib)
+{
+    benchmark_compression_level(CompressionLevel::GREAT);
+}
@@ -95,3 +95,42 @@ TEST_CASE(gzip_round_trip)
     EXPECT(uncompressed.has_value());
     EXPECT(uncompressed.value() == original);
 }
+
+static Optional<ByteBuffer> compress_in_chunks(ReadonlyBytes input)
+{
+    Vector<Compress::GzipCompressor::CompressedChunk> chunks;
+    for (size_t i = 0; i < Compress::GzipCompressor::chunk_count(input); ++i) {
+        auto chunk = Compress::GzipCompressor::compress_chunk(input, i);
+        if (!chunk.has_value())
+            return {};
+        chunks.append(chunk.release_value());
+    }
+    return Compress::GzipCompressor::assemble_chunks(input, chunks);
+}
+
+TEST_CASE(gzip_round_trip_in_chunks)
+{
+    // Each chunk is primed with the end of the one before it, so a random piece repeated across chunks still compresses well
+    auto piece = ByteBuffer::create_uninitialized(20000);
+    for (size_t i = 0; i < piece.size(); ++i)
+        piece[i] = get_random<u8>();
+    ByteBuffer original;
+    while (original.size() < 3 * Compress::GzipCompressor::parallel_chunk_size + 1000)
+        original.append(piece.data(), piece.size());
+
+    auto compressed = compress_in_chunks(original);
+    EXPECT(compressed.has_value());
+    EXPECT(compressed.value().size() < 2 * piece.size());
+    auto uncompressed = Compress::GzipDecompressor::decompress_all(compressed.value());
+    EXPECT(uncompressed.has_value());
+    EXPECT(uncompressed.value() == original);
+}
+
+TEST_CASE(gzip_round_trip_in_chunks_empty)
+{
+    auto compressed = compress_in_chunks({});
+    EXPECT(compressed.has_value());
+    auto uncompressed = Compress::GzipDecompressor::decompress_all(compressed.value());
+    EXPECT(uncompressed.has_value());
+    EXPECT(uncompressed.value().is_empty());
+}
@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/Random.h>
 #include <LibCrypto/BigInt/UnsignedBigInteger.h>
 #include <LibCrypto/Checksum/Adler32.h>
 #include <LibCrypto/Cipher/AES.h>
@@ -131,6 +132,31 @@ TEST_CASE(test_AES_CBC_256bit_key_decrypt)
 
 // TODO: Test non-CMS padding options for AES CBC decrypt
 
+TEST_CASE(test_AES_CBC_round_trip_many_blocks)
+{
+    // Long enough to go through several of the batches that decryption is split into, plus a partial one.
+    auto in = ByteBuffer::create_uninitialized(1000);
+    fill_with_random(in.data(), in.size());
+    auto iv = "Sixteen byte IV!"_b;
+
+    Crypto::Cipher::AESCipher::CBCMode encryptor("WellHelloFriends"_b, 128, Crypto::Cipher::Intent::Encryption);
+    auto encrypted = encryptor.create_aligned_buffer(in.size());
+    auto encrypted_span = encrypted.bytes();
+    encryptor.encrypt(in, encrypted_span, iv);
+    EXPECT_EQ(encrypted_span.size(), 1008u);
+
+    Crypto::Cipher::AESCipher::CBCMode decryptor("WellHelloFriends"_b, 128, Crypto::Cipher::Intent::Decryption);
+    auto decrypted = decryptor.create_aligned_buffer(encrypted_span.size());
+    auto decrypted_span = decrypted.bytes();
+    decryptor.decrypt(encrypted_span, decrypted_span, iv);
+    EXPECT_EQ(decrypted_span, in.bytes());
+
+    // Decrypting in place must give the same result.
+    auto in_place_span = encrypted_span;
+    decryptor.decrypt(encrypted_span, in_place_span, iv);
+    EXPECT_EQ(in_place_span, in.bytes());
+}
+
 TEST_CASE(test_AES_CTR_name)
 {
     Crypto::Cipher::AESCipher::CTRMode cipher("WellHelloFriends"_b, 128, Crypto::Cipher::Intent::Encryption);
@@ -336,6 +362,36 @@ TEST_CASE(test_AES_CTR_128bit_decrypt_16bytes)
     // If encryption works, then decryption works, too.
 }
 
+TEST_CASE(test_AES_CTR_long_input_matches_block_by_block_key_stream)
+{
+    u8 key[] {
+        0x76, 0x91, 0xbe, 0x03, 0x5e, 0x50, 0x20, 0xa8, 0xac, 0x6e, 0x61, 0x85, 0x29, 0xf9, 0xa0, 0xdc
+    };
+    // Close enough to wrapping that the carry lands in the middle of a batch.
+    u8 ivec[] {
+        0x00, 0xe0, 0x01, 0x7b, 0x27, 0x77, 0x7f, 0x3f, 0x4a, 0x17, 0x86, 0xf0, 0xff, 0xff, 0xff, 0xfd
+    };
+    auto in = ByteBuffer::create_uninitialized(300);
+    fill_with_random(in.data(), in.size());
+
+    Crypto::Cipher::AESCipher::CTRMode cipher(AS_BB(key), 128, Crypto::Cipher::Intent::Encryption);
+    auto out = ByteBuffer::create_zeroed(in.size());
+    auto out_span = out.bytes();
+    cipher.encrypt(in, out_span, AS_BB(ivec));
+
+    Crypto::Cipher::AESCipher block_cipher(AS_BB(key), 128, Crypto::Cipher::Intent::Encryption);
+    Crypto::Cipher::AESCipherBlock counter;
+    Crypto::Cipher::AESCipherBlock key_stream;
+    Bytes counter_bytes { ivec, sizeof(ivec) };
+    for (size_t offset = 0; offset < in.size(); offset += 16) {
+        counter.overwrite(counter_bytes);
+        block_cipher.encrypt_block(counter, key_stream);
+        for (size_t i = 0; i < 16 && offset + i < in.size(); ++i)
+            EXPECT_EQ(out[offset + i], in[offset + i] ^ key_stream.bytes()[i]);
+        Crypto::Cipher::IncrementInplace {}(counter_bytes);
+    }
+}
+
 TEST_CASE(test_AES_GCM_name)
 {
     Crypto::Cipher::AESCipher::GCMMode cipher("WellHelloFriends"_b, 128, Crypto::Cipher::Intent::Encryption);
@@ -401,6 +457,25 @@ TEST_CASE(test_AES_GCM_128bit_encrypt_with_aad)
     EXPECT(memcmp(result_tag, tag.data(), tag.size()) == 0);
 }
 
+// From the GCM specification, test case 4: neither the plaintext nor the AAD fill their last block.
+TEST_CASE(test_AES_GCM_128bit_encrypt_partial_blocks_with_aad)
+{
+    Crypto::Cipher::AESCipher::GCMMode cipher("\xfe\xff\xe9\x92\x86\x65\x73\x1c\x6d\x6a\x8f\x94\x67\x30\x83\x08"_b, 128, Crypto::Cipher::Intent::Encryption);
+    u8 result_tag[] { 0x5b, 0xc9, 0x4f, 0xbc, 0x32, 0x21, 0xa5, 0xdb, 0x94, 0xfa, 0xe9, 0x5a, 0xe7, 0x12, 0x1a, 0x47 };
+    u8 result_ct[] { 0x42, 0x83, 0x1e, 0xc2, 0x21, 0x77, 0x74, 0x24, 0x4b, 0x72, 0x21, 0xb7, 0x84, 0xd0, 0xd4, 0x9c, 0xe3, 0xaa, 0x21, 0x2f, 0x2c, 0x02, 0xa4, 0xe0, 0x35, 0xc1, 0x7e, 0x23, 0x29, 0xac, 0xa1, 0x2e, 0x21, 0xd5, 0x14, 0xb2, 0x54, 0x66, 0x93, 0x1c, 0x7d, 0x8f, 0x6a, 0x5a, 0xac, 0x84, 0xaa, 0x05, 0x1b, 0xa3, 0x0b, 0x39, 0x6a, 0x0a, 0xac, 0x97, 0x3d, 0x58, 0xe0, 0x91 };
+    auto tag = ByteBuffer::create_uninitialized(16);
+    auto out = ByteBuffer::create_uninitialized(60);
+    auto out_bytes = out.bytes();
+    cipher.encrypt(
+        "\xd9\x31\x32\x25\xf8\x84\x06\xe5\xa5\x59\x09\xc5\xaf\xf5\x26\x9a\x86\xa7\xa9\x53\x15\x34\xf7\xda\x2e\x4c\x30\x3d\x8a\x31\x8a\x72\x1c\x3c\x0c\x95\x95\x68\x09\x53\x2f\xcf\x0e\x24\x49\xa6\xb5\x25\xb1\x6a\xed\xf5\xaa\x0d\xe6\x57\xba\x63\x7b\x39"_b.bytes(),
+        out_bytes,
+        "\xca\xfe\xba\xbe\xfa\xce\xdb\xad\xde\xca\xf8\x88\x00\x00\x00\x00"_b.bytes(),
+        "\xfe\xed\xfa\xce\xde\xad\xbe\xef\xfe\xed\xfa\xce\xde\xad\xbe\xef\xab\xad\xda\xd2"_b.bytes(),
+        tag);
+    EXPECT(memcmp(result_ct, out.data(), out.size()) == 0);
+    EXPECT(memcmp(result_tag, tag.data(), tag.size()) == 0);
+}
+
 TEST_CASE(test_AES_GCM_128bit_decrypt_empty)
 {
     Crypto::Cipher::AESCipher::GCMMode cipher("\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00"_b, 128, Crypto::Cipher::Intent::Encryption);
@@ -454,3 +529,45 @@ TEST_CASE(test_AES_GCM_128bit_decrypt_multiple_blocks_with_aad)
     EXPECT(memcmp(result_pt, out.data(), out.size()) == 0);
     EXPECT_EQ(consistency, Crypto::VerificationConsistency::Consistent);
 }
+
+static constexpr size_t benchmark_buffer_size = 1 * MiB;
+
+BENCHMARK_CASE(aes_cbc_128bit_encrypt_and_decrypt)
+{
+    auto in = ByteBuffer::create_zeroed(benchmark_buffer_size);
+    auto iv = ByteBuffer::create_zeroed(Crypto::Cipher::AESCipher::block_size());
+    Crypto::Cipher::AESCipher::CBCMode encryptor("WellHelloFriends"_b, 128, Crypto::Cipher::Intent::Encryption);
+    Crypto::Cipher::AESCipher::CBCMode decryptor("WellHelloFriends"_b, 128, Crypto::Cipher::Intent::Decryption);
+    auto encrypted = encryptor.create_aligned_buffer(in.size());
+    auto decrypted = decryptor.create_aligned_buffer(encrypted.size());
+    for (size_t i = 0; i < 16; ++i) {
+        auto encrypted_span = encrypted.bytes();
+        encryptor.encrypt(in, encrypted_span, iv);
+        auto decrypted_span = decrypted.bytes();
+        decryptor.decrypt(encrypted_span, decrypted_span, iv);
+        EXPECT_EQ(decrypted_span.size(), in.size());
+    }
+}
+
+BENCHMARK_CASE(aes_ctr_128bit_encrypt)
+{
+    auto in = ByteBuffer::create_zeroed(benchmark_buffer_size);
+    auto iv = ByteBuffer::create_zeroed(Crypto::Cipher::AESCipher::block_size());
+    Crypto::Cipher::AESCipher::CTRMode cipher("WellHelloFriends"_b, 128, Crypto::Cipher::Intent::Encryption);
+    auto out = ByteBuffer::create_uninitialized(in.size());
+    for (size_t i = 0; i < 32; ++i) {
+        auto out_span = out.bytes();
+        cipher.encrypt(in, out_span, iv);
+    }
+}
+
+BENCHMARK_CASE(aes_gcm_128bit_encrypt)
+{
+    auto in = ByteBuffer::create_zeroed(benchmark_buffer_size);
+    auto iv = ByteBuffer::create_zeroed(Crypto::Cipher::AESCipher::block_size());
+    Crypto::Cipher::AESCipher::GCMMode cipher("WellHelloFriends"_b, 128, Crypto::Cipher::Intent::Encryption);
+    auto out = ByteBuffer::create_uninitialized(in.size());
+    auto tag = ByteBuffer::create_uninitialized(16);
+    for (size_t i = 0; i < 32; ++i)
+        cipher.encrypt(in, out.bytes(), iv, {}, tag);
+}
@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/Random.h>
 #include <LibCrypto/BigInt/Algorithms/UnsignedBigIntegerAlgorithms.h>
 #include <LibCrypto/BigInt/SignedBigInteger.h>
 #include <LibCrypto/BigInt/UnsignedBigInteger.h>
@@ -23,6 +24,16 @@ static Crypto::UnsignedBigInteger bigint_fibonacci(size_t n)
     return num1;
 }
 
+// Returns a random number that takes up exactly the given number of words.
+static Crypto::UnsignedBigInteger random_bigint(size_t words)
+{
+    Vector<u32, Crypto::STARTING_WORD_SIZE> result;
+    for (size_t i = 0; i < words; ++i)
+        result.append(get_random<u32>());
+    result.last() |= 0x80000000;
+    return Crypto::UnsignedBigInteger(move(result));
+}
+
 static Crypto::SignedBigInteger bigint_signed_fibonacci(size_t n)
 {
     Crypto::SignedBigInteger num1(0);
@@ -201,6 +212,40 @@ TEST_CASE(test_unsigned_bigint_multiplication_with_big_numbers2)
     EXPECT_EQ(result.words(), expected_result);
 }
 
+TEST_CASE(test_unsigned_bigint_multiplication_around_karatsuba_threshold)
+{
+    // Checks the product through division, which works bit by bit and shares no code with multiplication.
+    for (size_t left_words : { 1, 20, 31, 32, 33, 47, 64, 65, 100, 128, 257 }) {
+        for (size_t right_words : { 1, 17, 32, 33, 64, 128 }) {
+            auto left = random_bigint(left_words);
+            auto right = random_bigint(right_words);
+            auto product = left.multiplied_by(right);
+            EXPECT_EQ(product, right.multiplied_by(left));
+            auto division = product.divided_by(right);
+            EXPECT_EQ(division.quotient, left);
+            EXPECT_EQ(division.remainder, 0u);
+        }
+    }
+}
+
+TEST_CASE(test_unsigned_bigint_squaring)
+{
+    for (size_t words : { 1, 2, 31, 32, 33, 64, 65, 128 }) {
+        auto number = random_bigint(words);
+        auto copy = number;
+        auto square = number.multiplied_by(number);
+        EXPECT_EQ(square, number.multiplied_by(copy));
+        EXPECT_EQ(square.divided_by(number).quotient, number);
+    }
+}
+
+TEST_CASE(test_unsigned_bigint_multiplication_by_zero)
+{
+    auto number = random_bigint(40);
+    EXPECT_EQ(number.multiplied_by(0), 0u);
+    EXPECT_EQ(Crypto::UnsignedBigInteger(0).multiplied_by(number), 0u);
+}
+
 TEST_CASE(test_unsigned_bigint_simple_division)
 {
     Crypto::UnsignedBigInteger num1(27194);
@@ -330,6 +375,25 @@ TEST_CASE(test_bigint_modular_power_extra_tests)
     }
 }
 
+TEST_CASE(test_bigint_montgomery_modular_power_matches_square_and_multiply)
+{
+    for (size_t modulo_words : { 1, 3, 16, 33 }) {
+        auto modulo = random_bigint(modulo_words);
+        modulo.set_bit_inplace(0);
+        for (size_t exponent_words : { 0, 1, 2, 9, 33 }) {
+            auto base = random_bigint(modulo_words + 1);
+            auto exponent = exponent_words ? random_bigint(exponent_words) : Crypto::UnsignedBigInteger(0);
+            auto actual = Crypto::NumberTheory::ModularPower(base, exponent, modulo);
+
+            Crypto::UnsignedBigInteger ep { exponent };
+            Crypto::UnsignedBigInteger base_copy { base };
+            Crypto::UnsignedBigInteger temp_1, temp_2, temp_3, temp_4, temp_multiply, temp_quotient, temp_remainder, expected;
+            Crypto::UnsignedBigIntegerAlgorithms::destructive_modular_power_without_allocation(ep, base_copy, modulo, temp_1, temp_2, temp_3, temp_4, temp_multiply, temp_quotient, temp_remainder, expected);
+            EXPECT_EQ(actual, expected);
+        }
+    }
+}
+
 TEST_CASE(test_bigint_primality_test)
 {
     struct {
@@ -573,3 +637,33 @@ TEST_CASE(test_signed_multiplication_with_two_big_numbers)
     EXPECT_EQ(result.unsigned_value().words(), expected_results);
     EXPECT(result.is_negative());
 }
+
+static void benchmark_multiplication(size_t bits)
+{
+    auto left = random_bigint(bits / 32);
+    auto right = random_bigint(bits / 32);
+    for (size_t i = 0; i < 1000; ++i) {
+        auto product = left.multiplied_by(right);
+        EXPECT_EQ(product.length(), bits / 16);
+    }
+}
+
+BENCHMARK_CASE(bigint_multiplication_1024bit) { benchmark_multiplication(1024); }
+BENCHMARK_CASE(bigint_multiplication_2048bit) { benchmark_multiplication(2048); }
+BENCHMARK_CASE(bigint_multiplication_4096bit) { benchmark_multiplication(4096); }
+
+static void benchmark_modular_power(size_t bits, size_t iterations)
+{
+    auto base = random_bigint(bits / 32);
+    auto exponent = random_bigint(bits / 32);
+    auto modulo = random_bigint(bits / 32);
+    modulo.set_bit_inplace(0);
+    for (size_t i = 0; i < iterations; ++i) {
+        auto result = Crypto::NumberTheory::ModularPower(base, exponent, modulo);
+        EXPECT(result < modulo);
+    }
+}
+
+BENCHMARK_CASE(bigint_modular_power_1024bit) { benchmark_modular_power(1024, 10); }
+BENCHMARK_CASE(bigint_modular_power_2048bit) { benchmark_modular_power(2048, 2); }
+BENCHMARK_CASE(bigint_modular_power_4096bit) { benchmark_modular_power(4096, 1); }
@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/Random.h>
 #include <LibCrypto/Checksum/Adler32.h>
 #include <LibCrypto/Checksum/CRC32.h>
 #include <LibTest/TestCase.h>
@@ -33,3 +34,97 @@ TEST_CASE(test_crc32)
     do_test(String("The quick brown fox jumps over the lazy dog").bytes(), 0x414FA339);
     do_test(String("various CRC algorithms input data").bytes(), 0x9BD366AE);
 }
+
+static ByteBuffer random_bytes(size_t size)
+{
+    auto buffer = ByteBuffer::create_uninitialized(size);
+    for (size_t i = 0; i < size; ++i)
+        buffer[i] = get_random<u8>();
+    return buffer;
+}
+
+// The checksums as the specifications describe them, one byte at a time.
+static u32 reference_adler32(ReadonlyBytes data)
+{
+    u32 a = 1;
+    u32 b = 0;
+    for (auto byte : data) {
+        a = (a + byte) % 65521;
+        b = (b + a) % 65521;
+    }
+    return (b << 16) | a;
+}
+
+static u32 reference_crc32(ReadonlyBytes data)
+{
+    u32 state = ~0u;
+    for (auto byte : data) {
+        state ^= byte;
+        for (size_t i = 0; i < 8; ++i)
+            state = (state & 1) ? (0xEDB88320 ^ (state >> 1)) : (state >> 1);
+    }
+    return ~state;
+}
+
+TEST_CASE(test_checksums_match_reference_over_many_lengths)
+{
+    auto data = random_bytes(20000);
+    for (size_t size : { 1, 7, 8, 15, 16, 31, 32, 33, 63, 64, 65, 79, 80, 127, 128, 200, 1000, 5552, 5553, 11104, 20000 }) {
+        auto input = data.bytes().trim(size);
+        EXPECT_EQ(Crypto::Checksum::Adler32(input).digest(), reference_adler32(input));
+        EXPECT_EQ(Crypto::Checksum::CRC32(input).digest(), reference_crc32(input));
+    }
+}
+
+TEST_CASE(test_checksums_with_successive_updates)
+{
+    auto data = random_bytes(20000);
+    Crypto::Checksum::Adler32 adler32;
+    Crypto::Checksum::CRC32 crc32;
+    size_t piece_sizes[] { 1, 3, 64, 100, 4096, 17 };
+    size_t offset = 0;
+    for (size_t i = 0; offset < data.size(); ++i) {
+        auto size = min(piece_sizes[i % array_size(piece_sizes)], data.size() - offset);
+        adler32.update(data.bytes().slice(offset, size));
+        crc32.update(data.bytes().slice(offset, size));
+        offset += size;
+    }
+    EXPECT_EQ(adler32.digest(), reference_adler32(data));
+    EXPECT_EQ(crc32.digest(), reference_crc32(data));
+}
+
+TEST_CASE(test_crc32_combine)
+{
+    auto data = random_bytes(3000);
+    for (size_t split : { 0, 1, 100, 1500, 2999, 3000 }) {
+        auto first = Crypto::Checksum::CRC32(data.bytes().trim(split)).digest();
+        auto second = Crypto::Checksum::CRC32(data.bytes().slice(split)).digest();
+        EXPECT_EQ(Crypto::Checksum::CRC32::combine(first, second, data.size() - split), reference_crc32(data));
+    }
+}
+
+TEST_CASE(test_adler32_all_ones)
+{
+    // The worst case for overflowing the sums in between reductions.
+    auto data = ByteBuffer::create_uninitialized(100000);
+    data.bytes().fill(0xff);
+    EXPECT_EQ(Crypto::Checksum::Adler32(data).digest(), reference_adler32(data));
+}
+
+BENCHMARK_CASE(adler32_32mib)
+{
+    auto data = ByteBuffer::create_zeroed(1 * MiB);
+    Crypto::Checksum::Adler32 adler32;
+    for (size_t i = 0; i < 32; ++i)
+        adler32.update(data);
+    (void)adler32.digest();
+}
+
+BENCHMARK_CASE(crc32_32mib)
+{
+    auto data = ByteBuffer::create_zeroed(1 * MiB);
+    Crypto::Checksum::CRC32 crc32;
+    for (size_t i = 0; i < 32; ++i)
+        crc32.update(data);
+    (void)crc32.digest();
+}
@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/Random.h>
 #include <LibCrypto/Authentication/GHash.h>
 #include <LibCrypto/Authentication/HMAC.h>
 #include <LibCrypto/Hash/MD5.h>
@@ -205,6 +206,59 @@ TEST_CASE(test_SHA512_hash_empty_string)
     EXPECT(memcmp(result, digest.data, Crypto::Hash::SHA512::digest_size()) == 0);
 }
 
+// Feeds a million 'a's in uneven pieces, so that updates both straddle block boundaries and hash whole blocks at once.
+template<typename HashType>
+static typename HashType::DigestType hash_million_as_in_pieces()
+{
+    auto data = ByteBuffer::create_uninitialized(1000000);
+    data.bytes().fill('a');
+    HashType hasher;
+    size_t piece_sizes[] { 1, 63, 64, 65, 127, 1000, 4096 };
+    size_t offset = 0;
+    for (size_t i = 0; offset < data.size(); ++i) {
+        auto size = min(piece_sizes[i % array_size(piece_sizes)], data.size() - offset);
+        hasher.update(data.offset_pointer(offset), size);
+        offset += size;
+    }
+    return hasher.digest();
+}
+
+TEST_CASE(test_SHA1_hash_million_as)
+{
+    u8 result[] {
+        0x34, 0xaa, 0x97, 0x3c, 0xd4, 0xc4, 0xda, 0xa4, 0xf6, 0x1e, 0xeb, 0x2b, 0xdb, 0xad, 0x27, 0x31, 0x65, 0x34, 0x01, 0x6f
+    };
+    auto digest = hash_million_as_in_pieces<Crypto::Hash::SHA1>();
+    EXPECT(memcmp(result, digest.data, Crypto::Hash::SHA1::digest_size()) == 0);
+}
+
+TEST_CASE(test_SHA256_hash_million_as)
+{
+    u8 result[] {
+        0xcd, 0xc7, 0x6e, 0x5c, 0x99, 0x14, 0xfb, 0x92, 0x81, 0xa1, 0xc7, 0xe2, 0x84, 0xd7, 0x3e, 0x67, 0xf1, 0x80, 0x9a, 0x48, 0xa4, 0x97, 0x20, 0x0e, 0x04, 0x6d, 0x39, 0xcc, 0xc7, 0x11, 0x2c, 0xd0
+    };
+    auto digest = hash_million_as_in_pieces<Crypto::Hash::SHA256>();
+    EXPECT(memcmp(result, digest.data, Crypto::Hash::SHA256::digest_size()) == 0);
+}
+
+TEST_CASE(test_SHA384_hash_million_as)
+{
+    u8 result[] {
+        0x9d, 0x0e, 0x18, 0x09, 0x71, 0x64, 0x74, 0xcb, 0x08, 0x6e, 0x83, 0x4e, 0x31, 0x0a, 0x4a, 0x1c, 0xed, 0x14, 0x9e, 0x9c, 0x00, 0xf2, 0x48, 0x52, 0x79, 0x72, 0xce, 0xc5, 0x70, 0x4c, 0x2a, 0x5b, 0x07, 0xb8, 0xb3, 0xdc, 0x38, 0xec, 0xc4, 0xeb, 0xae, 0x97, 0xdd, 0xd8, 0x7f, 0x3d, 0x89, 0x85
+    };
+    auto digest = hash_million_as_in_pieces<Crypto::Hash::SHA384>();
+    EXPECT(memcmp(result, digest.data, Crypto::Hash::SHA384::digest_size()) == 0);
+}
+
+TEST_CASE(test_SHA512_hash_million_as)
+{
+    u8 result[] {
+        0xe7, 0x18, 0x48, 0x3d, 0x0c, 0xe7, 0x69, 0x64, 0x4e, 0x2e, 0x42, 0xc7, 0xbc, 0x15, 0xb4, 0x63, 0x8e, 0x1f, 0x98, 0xb1, 0x3b, 0x20, 0x44, 0x28, 0x56, 0x32, 0xa8, 0x03, 0xaf, 0xa9, 0x73, 0xeb, 0xde, 0x0f, 0xf2, 0x44, 0x87, 0x7e, 0xa6, 0x0a, 0x4c, 0xb0, 0x43, 0x2c, 0xe5, 0x77, 0xc3, 0x1b, 0xeb, 0x00, 0x9c, 0x5c, 0x2c, 0x49, 0xaa, 0x2e, 0x4e, 0xad, 0xb2, 0x17, 0xad, 0x8c, 0xc0, 0x9b
+    };
+    auto digest = hash_million_as_in_pieces<Crypto::Hash::SHA512>();
+    EXPECT(memcmp(result, digest.data, Crypto::Hash::SHA512::digest_size()) == 0);
+}
+
 TEST_CASE(test_ghash_test_name)
 {
     Crypto::Authentication::GHash ghash("WellHelloFriends");
@@ -230,3 +284,94 @@ TEST_CASE(test_ghash_galois_field_multiply2)
     Crypto::Authentication::galois_multiply(z, x, y);
     EXPECT(memcmp(result, z, 4 * sizeof(u32)) == 0);
 }
+
+// Computes GHASH one bit-by-bit multiplication at a time, the way the specification describes it.
+static void reference_ghash(const u32 (&key)[4], ReadonlyBytes aad, ReadonlyBytes cipher, u8 (&tag)[16])
+{
+    u32 y[4] { 0, 0, 0, 0 };
+    auto absorb = [&](const u8* block) {
+        u32 x[4];
+        for (size_t i = 0; i < 4; ++i)
+            x[i] = y[i] ^ ((u32)block[4 * i] << 24 | (u32)block[4 * i + 1] << 16 | (u32)block[4 * i + 2] << 8 | block[4 * i + 3]);
+        Crypto::Authentication::galois_multiply(y, key, x);
+    };
+    auto absorb_padded = [&](ReadonlyBytes data) {
+        for (size_t offset = 0; offset < data.size(); offset += 16) {
+            u8 block[16] {};
+            memcpy(block, data.offset(offset), min<size_t>(16, data.size() - offset));
+            absorb(block);
+        }
+    };
+    absorb_padded(aad);
+    absorb_padded(cipher);
+
+    u8 lengths[16] {};
+    u64 aad_bits = aad.size() * 8;
+    u64 cipher_bits = cipher.size() * 8;
+    for (size_t i = 0; i < 8; ++i) {
+        lengths[7 - i] = aad_bits >> (8 * i);
+        lengths[15 - i] = cipher_bits >> (8 * i);
+    }
+    absorb(lengths);
+
+    for (size_t i = 0; i < 16; ++i)
+        tag[i] = y[i / 4] >> (24 - 8 * (i % 4));
+}
+
+TEST_CASE(test_ghash_matches_reference_multiplication)
+{
+    u8 key[16];
+    u8 data[200];
+    fill_with_random(key, sizeof(key));
+    fill_with_random(data, sizeof(data));
+    u32 key_words[4];
+    for (size_t i = 0; i < 4; ++i)
+        key_words[i] = (u32)key[4 * i] << 24 | (u32)key[4 * i + 1] << 16 | (u32)key[4 * i + 2] << 8 | key[4 * i + 3];
+
+    Crypto::Authentication::GHash ghash({ key, sizeof(key) });
+    for (size_t aad_size : { 0, 5, 16, 20 }) {
+        for (size_t cipher_size : { 0, 1, 15, 16, 17, 64, 180 }) {
+            ReadonlyBytes aad { data, aad_size };
+            ReadonlyBytes cipher { data + aad_size, cipher_size };
+            u8 expected[16];
+            reference_ghash(key_words, aad, cipher, expected);
+            auto tag = ghash.process(aad, cipher);
+            EXPECT_EQ(ReadonlyBytes(tag.data, 16), ReadonlyBytes(expected, 16));
+        }
+    }
+}
+
+BENCHMARK_CASE(ghash_1mib)
+{
+    auto data = ByteBuffer::create_zeroed(1 * MiB);
+    Crypto::Authentication::GHash ghash("WellHelloFriends");
+    for (size_t i = 0; i < 32; ++i)
+        ghash.process({}, data);
+}
+
+BENCHMARK_CASE(sha1_32mib)
+{
+    auto data = ByteBuffer::create_zeroed(1 * MiB);
+    Crypto::Hash::SHA1 sha;
+    for (size_t i = 0; i < 32; ++i)
+        sha.update(data);
+    (void)sha.digest();
+}
+
+BENCHMARK_CASE(sha256_32mib)
+{
+    auto data = ByteBuffer::create_zeroed(1 * MiB);
+    Crypto::Hash::SHA256 sha;
+    for (size_t i = 0; i < 32; ++i)
+        sha.update(data);
+    (void)sha.digest();
+}
+
+BENCHMARK_CASE(sha512_32mib)
+{
+    auto data = ByteBuffer::create_zeroed(1 * MiB);
+    Crypto::Hash::SHA512 sha;
+    for (size_t i = 0; i < 32; ++i)
+        sha.update(data);
+    (void)sha.digest();
+}
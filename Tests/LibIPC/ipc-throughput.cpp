@@ -0,0 +1,164 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/ByteBuffer.h>
+#include <LibCore/ArgsParser.h>
+#include <LibCore/ElapsedTimer.h>
+#include <LibCore/EventLoop.h>
+#include <LibCore/LocalServer.h>
+#include <LibIPC/ClientConnection.h>
+#include <LibIPC/ServerConnection.h>
+#include <signal.h>
+#include <stdio.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "BenchmarkClientEndpoint.h"
+#include "BenchmarkServerEndpoint.h"
+
+class BenchmarkClientConnection final
+    : public IPC::ClientConnection<BenchmarkClientEndpoint, BenchmarkServerEndpoint> {
+    C_OBJECT(BenchmarkClientConnection);
+
+public:
+    virtual void die() override { exit(0); }
+
+private:
+    BenchmarkClientConnection(NonnullRefPtr<Core::LocalSocket> socket, int client_id)
+        : IPC::ClientConnection<BenchmarkClientEndpoint, BenchmarkServerEndpoint>(*this, move(socket), client_id)
+    {
+        enable_out_of_line_messages();
+    }
+
+    virtual void ping() override { }
+    virtual Messages::BenchmarkServer::EchoResponse echo(ByteBuffer const& data) override { return data; }
+};
+
+class BenchmarkServerConnection final
+    : public IPC::ServerConnection<BenchmarkClientEndpoint, BenchmarkServerEndpoint>
+    , public BenchmarkClientEndpoint {
+    C_OBJECT(BenchmarkServerConnection);
+
+private:
+    explicit BenchmarkServerConnection(const StringView& address)
+        : IPC::ServerConnection<BenchmarkClientEndpoint, BenchmarkServerEndpoint>(*this, address)
+    {
+        enable_out_of_line_messages();
+    }
+};
+
+static void run_server(const String& socket_path, int ready_fd)
+{
+    Core::EventLoop event_loop;
+    auto server = Core::LocalServer::construct();
+    if (!server->listen(socket_path)) {
+        warnln("Failed to listen on {}", socket_path);
+        exit(1);
+    }
+    RefPtr<BenchmarkClientConnection> client;
+    server->on_ready_to_accept = [&] {
+        auto socket = server->accept();
+        if (socket)
+            client = IPC::new_client_connection<BenchmarkClientConnection>(socket.release_nonnull(), 1);
+    };
+    char ready = 1;
+    (void)write(ready_fd, &ready, 1);
+    close(ready_fd);
+    exit(event_loop.exec());
+}
+
+int main(int argc, char** argv)
+{
+    int round_trips = 10000;
+    int iterations = 100;
+    int pipeline_depth = 32;
+
+    Core::ArgsParser args_parser;
+    args_parser.set_general_help("Measure IPC latency with empty round trips, and throughput with payloads of various sizes.");
+    args_parser.add_option(round_trips, "Number of empty round trips", "round-trips", 'r', "count");
+    args_parser.add_option(iterations, "Number of round trips per payload size", "iterations", 'i', "count");
+    args_parser.add_option(pipeline_depth, "Number of pipelined requests in flight", "depth", 'd', "count");
+    args_parser.parse(argc, argv);
+
+    auto socket_path = String::formatted("/tmp/ipc-throughput.{}", getpid());
+    int ready_pipe[2];
+    if (pipe(ready_pipe) < 0) {
+        perror("pipe");
+        return 1;
+    }
+
+    // The server gets its own process (and event loop), so synchronous requests really wait for a peer.
+    pid_t server_pid = fork();
+    if (server_pid < 0) {
+        perror("fork");
+        return 1;
+    }
+    if (server_pid == 0) {
+        close(ready_pipe[0]);
+        run_server(socket_path, ready_pipe[1]);
+    }
+    close(ready_pipe[1]);
+    char ready = 0;
+    if (read(ready_pipe[0], &ready, 1) != 1) {
+        warnln("Server failed to start");
+        return 1;
+    }
+    close(ready_pipe[0]);
+
+    Core::EventLoop event_loop;
+    auto connection = BenchmarkServerConnection::construct(socket_path);
+
+    Core::ElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < round_trips; ++i)
+        connection->ping();
+    auto elapsed_ms = max(timer.elapsed(), 1);
+    printf("%d empty round trips: %d ms (%.2f us each)\n", round_trips, elapsed_ms, elapsed_ms * 1000.0 / round_trips);
+
+    // Keep a window of requests in flight, instead of waiting for each response before sending the next request.
+    int sent = 0;
+    int completed = 0;
+    Function<void()> send_ping = [&] {
+        ++sent;
+        connection->async_ping([&](auto&) {
+            if (sent < round_trips)
+                send_ping();
+            if (++completed == round_trips)
+                event_loop.quit(0);
+        });
+    };
+    timer.start();
+    while (sent < min(pipeline_depth, round_trips))
+        send_ping();
+    event_loop.exec();
+    elapsed_ms = max(timer.elapsed(), 1);
+    printf("%d pipelined round trips, %d in flight: %d ms (%.2f us each)\n", round_trips, pipeline_depth, elapsed_ms, elapsed_ms * 1000.0 / round_trips);
+
+    for (size_t size : { 4 * KiB, 64 * KiB, 1 * MiB, 8 * MiB }) {
+#ifndef __serenity__
+        // Without fd passing, everything goes through the socket, and a peer that can't keep up gets disconnected.
+        if (size >= IPC::out_of_line_message_threshold) {
+            printf("%zu KiB payloads: skipped, needs anonymous buffers\n", size / KiB);
+            continue;
+        }
+#endif
+        auto payload = ByteBuffer::create_zeroed(size);
+        timer.start();
+        for (int i = 0; i < iterations; ++i) {
+            auto response = connection->echo(payload);
+            VERIFY(response.size() == size);
+        }
+        elapsed_ms = max(timer.elapsed(), 1);
+        // Every round trip moves the payload both ways.
+        printf("%zu KiB payloads: %d round trips in %d ms (%.2f us each, %.2f MiB/s)\n", size / KiB, iterations, elapsed_ms,
+            elapsed_ms * 1000.0 / iterations, 2.0 * size * iterations / MiB / (elapsed_ms / 1000.0));
+    }
+
+    kill(server_pid, SIGTERM);
+    waitpid(server_pid, nullptr, 0);
+    unlink(socket_path.characters());
+    return 0;
+}
@@ -8,6 +8,7 @@
 #include <LibCore/EventLoop.h>
 #include <LibCore/File.h>
 #include <LibCrypto/ASN1/ASN1.h>
+#include <LibTLS/SessionCache.h>
 #include <LibTLS/TLSv12.h>
 #include <LibTest/TestCase.h>
 
@@ -67,9 +68,17 @@ Vector<Certificate> load_certificates()
 
 static Vector<Certificate> s_root_ca_certificates = load_certificates();
 
+// LibCore only supports one main event loop per process, so all the tests share this one.
+static Core::EventLoop& event_loop()
+{
+    static Core::EventLoop loop;
+    loop.unquit();
+    return loop;
+}
+
 TEST_CASE(test_TLS_hello_handshake)
 {
-    Core::EventLoop loop;
+    auto& loop = event_loop();
     RefPtr<TLS::TLSv12> tls = TLS::TLSv12::construct(nullptr);
     tls->set_root_certificates(s_root_ca_certificates);
     bool sent_request = false;
@@ -115,3 +124,53 @@ TEST_CASE(test_TLS_hello_handshake)
     }
     loop.exec();
 }
+
+static bool connect_and_send_request(bool& is_resumed_session)
+{
+    auto& loop = event_loop();
+    RefPtr<TLS::TLSv12> tls = TLS::TLSv12::construct(nullptr);
+    tls->set_root_certificates(s_root_ca_certificates);
+    bool sent_request = false;
+    bool received_response = false;
+    tls->on_tls_ready_to_write = [&](TLS::TLSv12& tls) {
+        if (sent_request)
+            return;
+        sent_request = true;
+        is_resumed_session = tls.is_resumed_session();
+        auto request = String::formatted("GET / HTTP/1.1\r\nHost: {}\r\nConnection: close\r\n\r\n", DEFAULT_SERVER);
+        if (!tls.write(request.bytes()))
+            loop.quit(1);
+    };
+    tls->on_tls_ready_to_read = [&](TLS::TLSv12& tls) {
+        if (tls.read().has_value())
+            received_response = true;
+    };
+    tls->on_tls_finished = [&] {
+        loop.quit(0);
+    };
+    tls->on_tls_error = [&](TLS::AlertDescription) {
+        loop.quit(1);
+    };
+    if (!tls->connect(DEFAULT_SERVER, port))
+        return false;
+    return loop.exec() == 0 && received_response;
+}
+
+TEST_CASE(test_TLS_session_resumption)
+{
+    // The first connection does a full handshake, and leaves a session behind for the second one to resume.
+    // Both have to verify the server's finished message to get this far.
+    TLS::SessionCache::the().remove(String::formatted("{}:{}", DEFAULT_SERVER, port));
+    bool is_resumed_session = true;
+    if (!connect_and_send_request(is_resumed_session)) {
+        FAIL("First connection failed");
+        return;
+    }
+    EXPECT(!is_resumed_session);
+
+    if (!connect_and_send_request(is_resumed_session)) {
+        FAIL("Resumed connection failed");
+        return;
+    }
+    EXPECT(is_resumed_session);
+}
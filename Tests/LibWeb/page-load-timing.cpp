@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/URL.h>
+#include <LibCore/ArgsParser.h>
+#include <LibCore/ElapsedTimer.h>
+#include <LibCore/EventLoop.h>
+#include <LibGfx/Palette.h>
+#include <LibGfx/SystemTheme.h>
+#include <LibWeb/Loader/ResourceLoader.h>
+#include <LibWeb/Page/BrowsingContext.h>
+#include <LibWeb/Page/Page.h>
+#include <stdio.h>
+
+// A page without a view: it loads and lays out the document, and tells us when it's done.
+class HeadlessPageClient final : public Web::PageClient {
+public:
+    HeadlessPageClient()
+        : m_palette_impl(Gfx::PaletteImpl::create_with_anonymous_buffer(Gfx::load_system_theme("/res/themes/Default.ini")))
+    {
+    }
+
+    Function<void()> on_finish_loading;
+
+private:
+    virtual bool is_multi_process() const override { return false; }
+    virtual Gfx::Palette palette() const override { return Gfx::Palette(*m_palette_impl); }
+    virtual Gfx::IntRect screen_rect() const override { return { 0, 0, 1024, 768 }; }
+    virtual void page_did_finish_loading(const URL&) override
+    {
+        if (on_finish_loading)
+            on_finish_loading();
+    }
+
+    NonnullRefPtr<Gfx::PaletteImpl> m_palette_impl;
+};
+
+int main(int argc, char** argv)
+{
+    const char* url_string = nullptr;
+    int iterations = 5;
+
+    Core::ArgsParser args_parser;
+    args_parser.set_general_help("Measure how long it takes to load a page along with all of its subresources.");
+    args_parser.add_option(iterations, "Number of times to load the page", "iterations", 'i', "count");
+    args_parser.add_positional_argument(url_string, "URL to load, preferably from a local web server", "url");
+    args_parser.parse(argc, argv);
+
+    URL url(url_string);
+    if (!url.is_valid()) {
+        warnln("Invalid URL: {}", url_string);
+        return 1;
+    }
+
+    Core::EventLoop event_loop;
+    HeadlessPageClient page_client;
+    Web::Page page(page_client);
+    page.top_level_browsing_context().set_size({ 1024, 768 });
+
+    auto& resource_loader = Web::ResourceLoader::the();
+    for (int i = 0; i < iterations; ++i) {
+        // Every iteration should go to the network, like a first visit would.
+        resource_loader.clear_cache();
+
+        Core::ElapsedTimer timer;
+        bool document_finished_loading = false;
+        int parse_ms = 0;
+        auto quit_if_done = [&] {
+            if (document_finished_loading && resource_loader.pending_loads() == 0)
+                event_loop.quit(0);
+        };
+        page_client.on_finish_loading = [&] {
+            document_finished_loading = true;
+            parse_ms = timer.elapsed();
+            quit_if_done();
+        };
+        resource_loader.on_load_counter_change = [&] {
+            quit_if_done();
+        };
+
+        timer.start();
+        page.load(url);
+        event_loop.exec();
+        printf("Load %d: document finished after %d ms, all subresources after %d ms\n", i + 1, parse_ms, timer.elapsed());
+    }
+    return 0;
+}
@@ -0,0 +1,171 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/HashTable.h>
+#include <AK/StringBuilder.h>
+#include <AK/URL.h>
+#include <LibCore/ArgsParser.h>
+#include <LibCore/ElapsedTimer.h>
+#include <LibCore/File.h>
+#include <LibWeb/CSS/StyleResolver.h>
+#include <LibWeb/DOM/Document.h>
+#include <LibWeb/DOM/Element.h>
+#include <LibWeb/HTML/Parser/HTMLDocumentParser.h>
+#include <stdio.h>
+
+// A page in the spirit of a large site: a few thousand rules, most of them keyed on classes and
+// hidden behind descendant combinators, applied to a deep and fairly wide DOM with lots of lists.
+static String generate_page(int rule_count, int depth, int breadth)
+{
+    StringBuilder builder;
+    builder.append("<!DOCTYPE html><html><head><style>\n");
+    for (int i = 0; i < rule_count; ++i) {
+        switch (i % 4) {
+        case 0:
+            builder.appendff(".section-{} .item-{} {{ color: red; }}\n", i % 97, i);
+            break;
+        case 1:
+            builder.appendff("#widget-{} > div span {{ margin-left: {}px; }}\n", i, i % 10);
+            break;
+        case 2:
+            builder.appendff("ul.menu-{} li a.link-{} {{ text-decoration: none; }}\n", i % 13, i);
+            break;
+        case 3:
+            builder.appendff("div.card-{} {{ padding: {}px; }}\n", i, i % 7);
+            break;
+        }
+    }
+    builder.append("</style></head><body>\n");
+
+    int counter = 0;
+    Function<void(int)> generate_subtree = [&](int level) {
+        int id = counter++;
+        builder.appendff("<div class=\"section-{} card-{}\" id=\"widget-{}\"><span class=\"item-{}\">text</span>", id % 97, id, id, id);
+        // Long runs of identical siblings, like the rows of a list or table.
+        builder.appendff("<ul class=\"menu-{}\">", id % 13);
+        for (int i = 0; i < 8; ++i)
+            builder.appendff("<li><a class=\"link-{}\" href=\"#\">item</a></li>", id % 13);
+        builder.append("</ul>");
+        if (level < depth) {
+            for (int i = 0; i < breadth; ++i)
+                generate_subtree(level + 1);
+        }
+        builder.append("</div>\n");
+    };
+    for (int i = 0; i < breadth; ++i)
+        generate_subtree(0);
+
+    builder.append("</body></html>\n");
+    return builder.to_string();
+}
+
+struct Statistics {
+    size_t element_count { 0 };
+    HashTable<const Web::CSS::StyleProperties*> distinct_styles;
+    Vector<NonnullRefPtr<Web::CSS::StyleProperties>> styles;
+};
+
+// Without the ancestor filter, the style resolver also can't share styles between elements.
+static void resolve_style_for_subtree(Web::CSS::StyleResolver& style_resolver, Web::DOM::Node& node, bool use_ancestor_filter, Statistics& statistics)
+{
+    node.for_each_child([&](auto& child) {
+        if (!is<Web::DOM::Element>(child)) {
+            resolve_style_for_subtree(style_resolver, child, use_ancestor_filter, statistics);
+            return IterationDecision::Continue;
+        }
+        auto& element = verify_cast<Web::DOM::Element>(child);
+        // Keep the styles around like layout would, otherwise the address of a freed one could be counted twice.
+        auto style = style_resolver.resolve_style(element);
+        statistics.distinct_styles.set(style.ptr());
+        statistics.styles.append(move(style));
+        ++statistics.element_count;
+        if (use_ancestor_filter)
+            style_resolver.push_ancestor(element);
+        resolve_style_for_subtree(style_resolver, element, use_ancestor_filter, statistics);
+        if (use_ancestor_filter)
+            style_resolver.pop_ancestor(element);
+        return IterationDecision::Continue;
+    });
+}
+
+int main(int argc, char** argv)
+{
+    const char* path = nullptr;
+    int rule_count = 4000;
+    int depth = 6;
+    int breadth = 4;
+    int iterations = 3;
+
+    Core::ArgsParser args_parser;
+    args_parser.set_general_help("Measure how long it takes to resolve the style of every element on a page.");
+    args_parser.add_option(rule_count, "Number of rules on the generated page", "rules", 'r', "count");
+    args_parser.add_option(depth, "Nesting depth of the generated page", "depth", 'd', "levels");
+    args_parser.add_option(breadth, "Children per element on the generated page", "breadth", 'b', "count");
+    args_parser.add_option(iterations, "Number of times to resolve all styles", "iterations", 'i', "count");
+    args_parser.add_positional_argument(path, "HTML file to load instead of a generated page", "file", Core::ArgsParser::Required::No);
+    args_parser.parse(argc, argv);
+
+    String html;
+    URL url;
+    if (path) {
+        auto file_or_error = Core::File::open(path, Core::OpenMode::ReadOnly);
+        if (file_or_error.is_error()) {
+            warnln("Failed to open {}: {}", path, file_or_error.error());
+            return 1;
+        }
+        html = String::copy(file_or_error.value()->read_all());
+        url = URL::create_with_file_protocol(path);
+    } else {
+        html = generate_page(rule_count, depth, breadth);
+        url = URL("about:blank");
+    }
+
+    Core::ElapsedTimer timer;
+    timer.start();
+    auto document = Web::HTML::parse_html_document(html, url, "utf-8");
+    printf("Parsed %zu bytes of HTML in %d ms\n", html.length(), timer.elapsed());
+
+    auto& style_resolver = document->style_resolver();
+    auto run = [&](const char* name, bool use_ancestor_filter) {
+        for (int i = 0; i < iterations; ++i) {
+            Statistics statistics;
+            timer.start();
+            resolve_style_for_subtree(style_resolver, *document, use_ancestor_filter, statistics);
+            auto elapsed_ms = timer.elapsed();
+            printf("%s: resolved style for %zu elements in %d ms, %zu distinct styles\n", name, statistics.element_count, elapsed_ms, statistics.distinct_styles.size());
+        }
+    };
+
+    // The first resolution after loading also pays for building the rule cache.
+    run("Without ancestor filter or style sharing", false);
+    run("With ancestor filter and style sharing", true);
+
+    // Like a script updating a UI: change the class of a bunch of elements, then restyle whatever that invalidated.
+    document->update_style();
+    Vector<Web::DOM::Element&> elements_to_change;
+    document->for_each_in_inclusive_subtree_of_type<Web::DOM::Element>([&](auto& element) {
+        if (element.local_name() == "span")
+            elements_to_change.append(element);
+        return IterationDecision::Continue;
+    });
+    for (int i = 0; i < iterations; ++i) {
+        size_t invalidated_count = 0;
+        timer.start();
+        for (auto& element : elements_to_change) {
+            auto class_name = element.attribute(Web::HTML::AttributeNames::class_);
+            (void)element.set_attribute(Web::HTML::AttributeNames::class_, i % 2 ? class_name.substring(0, class_name.length() - 8) : String::formatted("{} toggled", class_name));
+        }
+        document->for_each_in_inclusive_subtree_of_type<Web::DOM::Element>([&](auto& element) {
+            if (element.needs_style_update())
+                ++invalidated_count;
+            return IterationDecision::Continue;
+        });
+        document->update_style();
+        auto elapsed_ms = timer.elapsed();
+        printf("Changed the class of %zu elements: restyled %zu elements in %d ms\n", elements_to_change.size(), invalidated_count, elapsed_ms);
+    }
+    return 0;
+}
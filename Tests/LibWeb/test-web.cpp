@@ -11,6 +11,7 @@
 #include <LibGUI/Window.h>
 #include <LibTest/JavaScriptTestRunner.h>
 #include <LibWeb/Bindings/MainThreadVM.h>
+#include <LibWeb/DOM/Document.h>
 #include <LibWeb/HTML/Parser/HTMLDocumentParser.h>
 #include <LibWeb/InProcessWebView.h>
 #include <LibWeb/Loader/ResourceLoader.h>
@@ -126,3 +127,11 @@ TESTJS_GLOBAL_FUNCTION(wait_for_page_to_load, waitForPageToLoad)
 
     return JS::js_undefined();
 }
+
+TESTJS_GLOBAL_FUNCTION(layout_reuse_count, layoutReuseCount)
+{
+    auto* document = g_page_view->document();
+    if (!document)
+        return JS::js_undefined();
+    return JS::Value(static_cast<double>(document->reused_layout_count()));
+}
@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+
+#include <RequestServer/HTTPCache.h>
+
+using RequestServer::HTTPCache;
+
+static const URL url { "http://example.com/style.css" };
+static constexpr auto body = "body { color: red; }"sv;
+
+static HTTPCache& empty_cache()
+{
+    auto& cache = HTTPCache::the();
+    cache.clear();
+    return cache;
+}
+
+static void store(HTTPCache::Headers const& headers, u32 status_code = 200)
+{
+    HTTPCache::the().store(url, status_code, headers, body.bytes());
+}
+
+TEST_CASE(fresh_for_max_age)
+{
+    auto& cache = empty_cache();
+    store({ { "Cache-Control", "public, max-age=3600" } });
+    auto entry = cache.lookup(url);
+    EXPECT(entry);
+    EXPECT(entry->is_fresh());
+    EXPECT_EQ(entry->status_code(), 200u);
+    EXPECT(entry->body() == body.bytes());
+}
+
+TEST_CASE(age_counts_against_max_age)
+{
+    auto& cache = empty_cache();
+    store({ { "Cache-Control", "max-age=60" }, { "Age", "120" }, { "ETag", "\"v1\"" } });
+    auto entry = cache.lookup(url);
+    EXPECT(entry);
+    EXPECT(!entry->is_fresh());
+    EXPECT(entry->has_validators());
+}
+
+TEST_CASE(freshness_from_expires)
+{
+    auto& cache = empty_cache();
+    store({ { "Date", "Thu, 01 Jan 2015 00:00:00 GMT" }, { "Expires", "Thu, 01 Jan 2015 01:00:00 GMT" } });
+    auto entry = cache.lookup(url);
+    EXPECT(entry);
+    EXPECT(entry->is_fresh());
+
+    // Already expired, and without validators there's no point in keeping it.
+    store({ { "Date", "Thu, 01 Jan 2015 00:00:00 GMT" }, { "Expires", "Wed, 31 Dec 2014 00:00:00 GMT" } });
+    EXPECT(!cache.lookup(url));
+
+    // Max-age wins over Expires.
+    store({ { "Cache-Control", "max-age=0" }, { "Date", "Thu, 01 Jan 2015 00:00:00 GMT" }, { "Expires", "Thu, 01 Jan 2015 01:00:00 GMT" }, { "ETag", "\"v1\"" } });
+    entry = cache.lookup(url);
+    EXPECT(entry);
+    EXPECT(!entry->is_fresh());
+}
+
+TEST_CASE(heuristic_freshness_from_last_modified)
+{
+    auto& cache = empty_cache();
+    store({ { "Date", "Sun, 11 Jan 2015 00:00:00 GMT" }, { "Last-Modified", "Thu, 01 Jan 2015 00:00:00 GMT" } });
+    auto entry = cache.lookup(url);
+    EXPECT(entry);
+    EXPECT(entry->is_fresh());
+
+    // Modified just now, so it's only good for revalidation.
+    store({ { "Date", "Sun, 11 Jan 2015 00:00:00 GMT" }, { "Last-Modified", "Sun, 11 Jan 2015 00:00:00 GMT" } });
+    entry = cache.lookup(url);
+    EXPECT(entry);
+    EXPECT(!entry->is_fresh());
+}
+
+TEST_CASE(responses_that_must_not_be_reused_from_the_cache)
+{
+    auto& cache = empty_cache();
+    store({ { "Cache-Control", "no-store, max-age=3600" } });
+    EXPECT(!cache.lookup(url));
+
+    store({ { "Cache-Control", "max-age=3600" } }, 500);
+    EXPECT(!cache.lookup(url));
+
+    store({ { "Cache-Control", "max-age=3600" }, { "Vary", "Cookie" } });
+    EXPECT(!cache.lookup(url));
+
+    // No-cache responses can be stored, but have to be revalidated every time.
+    store({ { "Cache-Control", "no-cache, max-age=3600" }, { "ETag", "\"v1\"" } });
+    auto entry = cache.lookup(url);
+    EXPECT(entry);
+    EXPECT(!entry->is_fresh());
+
+    // A response that can't be stored replaces the one that was there before.
+    store({ { "Cache-Control", "no-store" } });
+    EXPECT(!cache.lookup(url));
+}
+
+TEST_CASE(revalidation)
+{
+    auto& cache = empty_cache();
+    store({ { "Cache-Control", "max-age=0" }, { "ETag", "\"v1\"" }, { "Last-Modified", "Thu, 01 Jan 2015 00:00:00 GMT" }, { "Content-Length", "20" } });
+    auto stale_entry = cache.lookup(url);
+    EXPECT(stale_entry);
+    EXPECT(!stale_entry->is_fresh());
+
+    HashMap<String, String> request_headers;
+    cache.add_validators(*stale_entry, request_headers);
+    EXPECT_EQ(request_headers.get("If-None-Match"), String("\"v1\""));
+    EXPECT_EQ(request_headers.get("If-Modified-Since"), String("Thu, 01 Jan 2015 00:00:00 GMT"));
+
+    auto entry = cache.did_revalidate(*stale_entry, { { "Cache-Control", "max-age=3600" }, { "Content-Length", "0" }, { "Set-Cookie", "a=b" } });
+    EXPECT(entry->is_fresh());
+    EXPECT(entry->body() == body.bytes());
+    EXPECT_EQ(entry->response_headers().get("Content-Length"), String("20"));
+    EXPECT(!entry->response_headers().contains("Set-Cookie"));
+    EXPECT_EQ(entry->response_headers().get("ETag"), String("\"v1\""));
+
+    // Loads that still hold on to the old entry aren't affected.
+    EXPECT(!stale_entry->is_fresh());
+    EXPECT_EQ(cache.lookup(url), entry);
+}
+
+TEST_CASE(stored_headers_describe_the_decoded_body)
+{
+    auto& cache = empty_cache();
+    store({ { "Cache-Control", "max-age=3600" }, { "Content-Encoding", "gzip" }, { "Content-Length", "7" }, { "Transfer-Encoding", "chunked" } });
+    auto entry = cache.lookup(url);
+    EXPECT(entry);
+    EXPECT(!entry->response_headers().contains("Content-Encoding"));
+    EXPECT(!entry->response_headers().contains("Transfer-Encoding"));
+    EXPECT_EQ(entry->response_headers().get("Content-Length"), String::number(body.length()));
+}
+
+TEST_CASE(requests_that_can_use_the_cache)
+{
+    EXPECT(HTTPCache::can_use_cache_for("GET", url, {}, {}));
+    EXPECT(!HTTPCache::can_use_cache_for("GET", URL("file:///res/html/misc/welcome.html"), {}, {}));
+    EXPECT(!HTTPCache::can_use_cache_for("POST", url, {}, {}));
+    EXPECT(!HTTPCache::can_use_cache_for("GET", url, {}, body.bytes()));
+    EXPECT(!HTTPCache::can_use_cache_for("GET", url, { { "Authorization", "Basic dXNlcjpwYXNz" } }, {}));
+    EXPECT(!HTTPCache::can_use_cache_for("GET", url, { { "If-None-Match", "\"v1\"" } }, {}));
+}
@@ -243,6 +243,7 @@ int main(int argc, char** argv)
 
     generator.append(R"~~~(
 #pragma once
+#include <AK/Function.h>
 #include <AK/MemoryStream.h>
 #include <AK/OwnPtr.h>
 #include <AK/Result.h>
@@ -603,10 +604,44 @@ public:
 )~~~");
             };
 
+            // Like async_foo(), but also calls back with the response, so several requests can be in flight at once.
+            auto do_implement_pipelined_proxy = [&](String const& name, Vector<Parameter> const& parameters) {
+                message_generator.set("message.name", message.name);
+                message_generator.set("message.pascal_name", pascal_case(message.name));
+                message_generator.set("message.response_type", message_name(endpoint.name, message.name, true));
+                message_generator.set("handler_name", name);
+                message_generator.append(R"~~~(
+    void async_@handler_name@()~~~");
+
+                for (auto& parameter : parameters) {
+                    auto argument_generator = message_generator.fork();
+                    argument_generator.set("argument.type", parameter.type);
+                    argument_generator.set("argument.name", parameter.name);
+                    argument_generator.append("@argument.type@ @argument.name@, ");
+                }
+
+                message_generator.append(R"~~~(Function<void(@message.response_type@&)> on_response) {
+        m_connection.template post_message_with_response<Messages::@endpoint.name@::@message.pascal_name@>(move(on_response))~~~");
+
+                for (auto& parameter : parameters) {
+                    auto argument_generator = message_generator.fork();
+                    argument_generator.set("argument.name", parameter.name);
+                    if (is_primitive_type(parameter.type))
+                        argument_generator.append(", @argument.name@");
+                    else
+                        argument_generator.append(", move(@argument.name@)");
+                }
+
+                message_generator.append(R"~~~();
+    }
+)~~~");
+            };
+
             do_implement_proxy(message.name, message.inputs, message.is_synchronous, false);
             if (message.is_synchronous) {
                 do_implement_proxy(message.name, message.inputs, false, false);
                 do_implement_proxy(message.name, message.inputs, true, true);
+                do_implement_pipelined_proxy(message.name, message.inputs);
             }
         }
 
@@ -19,6 +19,7 @@ void __pthread_fork_atfork_register_parent(void (*)(void));
 void __pthread_fork_atfork_register_child(void (*)(void));
 
 int __pthread_mutex_lock(pthread_mutex_t*);
+int __pthread_mutex_lock_pessimistic(pthread_mutex_t*);
 int __pthread_mutex_trylock(pthread_mutex_t*);
 int __pthread_mutex_unlock(pthread_mutex_t*);
 int __pthread_mutex_init(pthread_mutex_t*, const pthread_mutexattr_t*);
@@ -36,9 +37,11 @@ void __pthread_key_destroy_for_current_thread();
 
 #define __PTHREAD_MUTEX_NORMAL 0
 #define __PTHREAD_MUTEX_RECURSIVE 1
-#define __PTHREAD_MUTEX_INITIALIZER     \
-    {                                   \
-        0, 0, 0, __PTHREAD_MUTEX_NORMAL \
+#define __PTHREAD_PRIO_NONE 0
+#define __PTHREAD_PRIO_INHERIT 1
+#define __PTHREAD_MUTEX_INITIALIZER                          \
+    {                                                        \
+        0, 0, 0, __PTHREAD_MUTEX_NORMAL, __PTHREAD_PRIO_NONE \
     }
 
 __END_DECLS
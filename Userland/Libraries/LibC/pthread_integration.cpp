@@ -9,7 +9,7 @@
 #include <AK/Vector.h>
 #include <bits/pthread_integration.h>
 #include <errno.h>
-#include <sched.h>
+#include <serenity.h>
 #include <unistd.h>
 
 namespace {
@@ -91,27 +91,107 @@ int __pthread_self()
 
 int pthread_self() __attribute__((weak, alias("__pthread_self")));
 
-int __pthread_mutex_lock(pthread_mutex_t* mutex)
+// Lock word states for normal (non priority inheriting) mutexes.
+static constexpr u32 MUTEX_UNLOCKED = 0;
+static constexpr u32 MUTEX_LOCKED_NO_WAITERS = 1;
+static constexpr u32 MUTEX_LOCKED_WITH_WAITERS = 2;
+
+// How many times to retry a contended lock before going to sleep in the kernel.
+// Most critical sections are short enough that the owner releases it before this runs out.
+static constexpr int MUTEX_SPIN_COUNT = 100;
+
+// Tells the CPU we're in a spin loop, so it can go easy on the pipeline and the sibling hyperthread.
+static ALWAYS_INLINE void relax_while_spinning()
 {
-    pthread_t this_thread = __pthread_self();
+#if ARCH(I386) || ARCH(X86_64)
+    __builtin_ia32_pause();
+#endif
+}
+
+static void mutex_did_lock(pthread_mutex_t* mutex, pthread_t this_thread)
+{
+    mutex->owner = this_thread;
+    mutex->level = 0;
+}
+
+static void mutex_lock_contended(pthread_mutex_t* mutex)
+{
+    // Once we've had to wait, we can't know whether anyone else is waiting, so we leave
+    // the lock marked as having waiters and let the unlock go through the kernel.
+    while (AK::atomic_exchange(&mutex->lock, MUTEX_LOCKED_WITH_WAITERS, AK::memory_order_acquire) != MUTEX_UNLOCKED)
+        futex(&mutex->lock, FUTEX_WAIT, MUTEX_LOCKED_WITH_WAITERS, nullptr, nullptr, 0);
+}
+
+static int mutex_lock_pi(pthread_mutex_t* mutex, pthread_t this_thread)
+{
+    u32 expected = MUTEX_UNLOCKED;
+    if (AK::atomic_compare_exchange_strong(&mutex->lock, expected, (u32)this_thread, AK::memory_order_acquire))
+        return 0;
+    // The kernel queues us by priority and lends ours to the owner until it hands the lock over.
+    int saved_errno = errno;
     for (;;) {
-        u32 expected = 0;
-        if (!AK::atomic_compare_exchange_strong(&mutex->lock, expected, 1u, AK::memory_order_acquire)) {
-            if (mutex->type == __PTHREAD_MUTEX_RECURSIVE && mutex->owner == this_thread) {
-                mutex->level++;
-                return 0;
-            }
-            sched_yield();
-            continue;
+        if (futex(&mutex->lock, FUTEX_LOCK_PI, 0, nullptr, nullptr, 0) == 0)
+            return 0;
+        if (errno != EINTR) {
+            int error = errno;
+            errno = saved_errno;
+            return error;
         }
-        mutex->owner = this_thread;
-        mutex->level = 0;
+    }
+}
+
+int __pthread_mutex_lock(pthread_mutex_t* mutex)
+{
+    pthread_t this_thread = __pthread_self();
+    if (mutex->type == __PTHREAD_MUTEX_RECURSIVE && mutex->owner == this_thread) {
+        mutex->level++;
         return 0;
     }
+
+    if (mutex->protocol == __PTHREAD_PRIO_INHERIT) {
+        if (int rc = mutex_lock_pi(mutex, this_thread); rc != 0)
+            return rc;
+        mutex_did_lock(mutex, this_thread);
+        return 0;
+    }
+
+    for (int i = 0; i < MUTEX_SPIN_COUNT; ++i) {
+        u32 expected = MUTEX_UNLOCKED;
+        if (AK::atomic_compare_exchange_strong(&mutex->lock, expected, MUTEX_LOCKED_NO_WAITERS, AK::memory_order_acquire)) {
+            mutex_did_lock(mutex, this_thread);
+            return 0;
+        }
+        if (expected == MUTEX_LOCKED_WITH_WAITERS)
+            break; // Others are already sleeping on it, no point in spinning.
+        relax_while_spinning();
+    }
+
+    mutex_lock_contended(mutex);
+    mutex_did_lock(mutex, this_thread);
+    return 0;
 }
 
 int pthread_mutex_lock(pthread_mutex_t*) __attribute__((weak, alias("__pthread_mutex_lock")));
 
+int __pthread_mutex_lock_pessimistic(pthread_mutex_t* mutex)
+{
+    // Used by threads that were woken up from (or requeued off of) a condition variable,
+    // which may have left other waiters sleeping on the mutex without marking it as such.
+    pthread_t this_thread = __pthread_self();
+    if (mutex->type == __PTHREAD_MUTEX_RECURSIVE && mutex->owner == this_thread) {
+        mutex->level++;
+        return 0;
+    }
+    if (mutex->protocol == __PTHREAD_PRIO_INHERIT) {
+        if (int rc = mutex_lock_pi(mutex, this_thread); rc != 0)
+            return rc;
+    } else {
+        mutex_lock_contended(mutex);
+    }
+    mutex_did_lock(mutex, this_thread);
+    return 0;
+}
+
 int __pthread_mutex_unlock(pthread_mutex_t* mutex)
 {
     if (mutex->type == __PTHREAD_MUTEX_RECURSIVE && mutex->level > 0) {
@@ -119,7 +199,16 @@ int __pthread_mutex_unlock(pthread_mutex_t* mutex)
         return 0;
     }
     mutex->owner = 0;
-    AK::atomic_store(&mutex->lock, 0u, AK::memory_order_release);
+
+    if (mutex->protocol == __PTHREAD_PRIO_INHERIT) {
+        u32 expected = (u32)__pthread_self();
+        if (!AK::atomic_compare_exchange_strong(&mutex->lock, expected, MUTEX_UNLOCKED, AK::memory_order_release))
+            futex(&mutex->lock, FUTEX_UNLOCK_PI, 0, nullptr, nullptr, 0);
+        return 0;
+    }
+
+    if (AK::atomic_exchange(&mutex->lock, MUTEX_UNLOCKED, AK::memory_order_release) == MUTEX_LOCKED_WITH_WAITERS)
+        futex(&mutex->lock, FUTEX_WAKE, 1, nullptr, nullptr, 0);
     return 0;
 }
 
@@ -127,16 +216,17 @@ int pthread_mutex_unlock(pthread_mutex_t*) __attribute__((weak, alias("__pthread
 
 int __pthread_mutex_trylock(pthread_mutex_t* mutex)
 {
-    u32 expected = 0;
-    if (!AK::atomic_compare_exchange_strong(&mutex->lock, expected, 1u, AK::memory_order_acquire)) {
-        if (mutex->type == __PTHREAD_MUTEX_RECURSIVE && mutex->owner == pthread_self()) {
+    pthread_t this_thread = __pthread_self();
+    u32 desired = mutex->protocol == __PTHREAD_PRIO_INHERIT ? (u32)this_thread : MUTEX_LOCKED_NO_WAITERS;
+    u32 expected = MUTEX_UNLOCKED;
+    if (!AK::atomic_compare_exchange_strong(&mutex->lock, expected, desired, AK::memory_order_acquire)) {
+        if (mutex->type == __PTHREAD_MUTEX_RECURSIVE && mutex->owner == this_thread) {
             mutex->level++;
             return 0;
         }
         return EBUSY;
     }
-    mutex->owner = pthread_self();
-    mutex->level = 0;
+    mutex_did_lock(mutex, this_thread);
     return 0;
 }
 
@@ -148,6 +238,7 @@ int __pthread_mutex_init(pthread_mutex_t* mutex, const pthread_mutexattr_t* attr
     mutex->owner = 0;
     mutex->level = 0;
     mutex->type = attributes ? attributes->type : __PTHREAD_MUTEX_NORMAL;
+    mutex->protocol = attributes ? attributes->protocol : __PTHREAD_PRIO_NONE;
     return 0;
 }
 
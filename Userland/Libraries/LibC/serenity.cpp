@@ -52,8 +52,8 @@ int futex(uint32_t* userspace_address, int futex_op, uint32_t value, const struc
 {
     int rc;
     switch (futex_op & FUTEX_CMD_MASK) {
-    //case FUTEX_CMP_REQUEUE:
-    // FUTEX_CMP_REQUEUE_PI:
+    case FUTEX_REQUEUE:
+    case FUTEX_CMP_REQUEUE:
     case FUTEX_WAKE_OP: {
         // These interpret timeout as a u32 value for val2
         Syscall::SC_futex_params params {
@@ -107,6 +107,18 @@ int anon_create(size_t size, int options)
     __RETURN_WITH_ERRNO(rc, rc, -1);
 }
 
+int io_ring_create(unsigned entries, int options)
+{
+    int rc = syscall(SC_io_ring_create, entries, options);
+    __RETURN_WITH_ERRNO(rc, rc, -1);
+}
+
+int io_ring_enter(int fd, unsigned to_submit, unsigned min_complete)
+{
+    int rc = syscall(SC_io_ring_enter, fd, to_submit, min_complete);
+    __RETURN_WITH_ERRNO(rc, rc, -1);
+}
+
 int serenity_readlink(const char* path, size_t path_length, char* buffer, size_t buffer_size)
 {
     Syscall::SC_readlink_params small_params {
@@ -59,6 +59,9 @@ int profiling_free_buffer(pid_t);
 #define FUTEX_REQUEUE 3
 #define FUTEX_CMP_REQUEUE 4
 #define FUTEX_WAKE_OP 5
+#define FUTEX_LOCK_PI 6
+#define FUTEX_UNLOCK_PI 7
+#define FUTEX_TRYLOCK_PI 8
 #define FUTEX_WAIT_BITSET 9
 #define FUTEX_WAKE_BITSET 10
 
@@ -68,6 +71,11 @@ int profiling_free_buffer(pid_t);
 
 #define FUTEX_BITSET_MATCH_ANY 0xffffffff
 
+// Layout of the futex word used by FUTEX_LOCK_PI and friends.
+#define FUTEX_WAITERS 0x80000000
+#define FUTEX_OWNER_DIED 0x40000000
+#define FUTEX_TID_MASK 0x3fffffff
+
 int futex(uint32_t* userspace_address, int futex_op, uint32_t value, const struct timespec* timeout, uint32_t* userspace_address2, uint32_t value3);
 
 #define PURGE_ALL_VOLATILE 0x1
@@ -100,6 +108,9 @@ int get_stack_bounds(uintptr_t* user_stack_base, size_t* user_stack_size);
 
 int anon_create(size_t size, int options);
 
+int io_ring_create(unsigned entries, int options);
+int io_ring_enter(int fd, unsigned to_submit, unsigned min_complete);
+
 int serenity_readlink(const char* path, size_t path_length, char* buffer, size_t buffer_size);
 
 int getkeymap(char* name_buffer, size_t name_buffer_size, uint32_t* map, uint32_t* shift_map, uint32_t* alt_map, uint32_t* altgr_map, uint32_t* shift_altgr_map);
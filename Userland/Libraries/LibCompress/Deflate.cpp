@@ -9,6 +9,8 @@
 #include <AK/Assertions.h>
 #include <AK/BinaryHeap.h>
 #include <AK/BinarySearch.h>
+#include <AK/ByteReader.h>
+#include <AK/Endian.h>
 #include <AK/MemoryStream.h>
 #include <string.h>
 
@@ -514,7 +516,8 @@ DeflateCompressor::DeflateCompressor(OutputStream& stream, CompressionLevel comp
 
 DeflateCompressor::~DeflateCompressor()
 {
-    VERIFY(m_finished);
+    // A stream that ends in a sync flush doesn't need a final block, as it's going to be continued by another one.
+    VERIFY(m_finished || m_pending_block_size == 0);
 }
 
 size_t DeflateCompressor::write(ReadonlyBytes bytes)
@@ -547,28 +550,37 @@ bool DeflateCompressor::write_or_error(ReadonlyBytes bytes)
 u16 DeflateCompressor::hash_sequence(const u8* bytes)
 {
     constexpr const u32 knuth_constant = 2654435761; // shares no common factors with 2^32
-    return ((bytes[0] | bytes[1] << 8 | bytes[2] << 16 | bytes[3] << 24) * knuth_constant) >> (32 - hash_bits);
+    return (AK::convert_between_host_and_little_endian(ByteReader::load32(bytes)) * knuth_constant) >> (32 - hash_bits);
 }
 
 size_t DeflateCompressor::compare_match_candidate(size_t start, size_t candidate, size_t previous_match_length, size_t maximum_match_length)
 {
     VERIFY(previous_match_length < maximum_match_length);
 
-    // We firstly check that the match is at least (prev_match_length + 1) long, we check backwards as there's a higher chance the end mismatches
-    for (ssize_t i = previous_match_length; i >= 0; i--) {
-        if (m_rolling_window[start + i] != m_rolling_window[candidate + i])
-            return 0;
+    // Most candidates can be rejected by checking the byte that would make them longer than the previous match
+    if (m_rolling_window[start + previous_match_length] != m_rolling_window[candidate + previous_match_length])
+        return 0;
+
+    // Find the actual length, 8 bytes at a time: the lowest set bit of the difference marks the first mismatching byte
+    size_t match_length = 0;
+    while (match_length + sizeof(u64) <= maximum_match_length) {
+        u64 start_word;
+        u64 candidate_word;
+        __builtin_memcpy(&start_word, &m_rolling_window[start + match_length], sizeof(u64));
+        __builtin_memcpy(&candidate_word, &m_rolling_window[candidate + match_length], sizeof(u64));
+        auto difference = AK::convert_between_host_and_little_endian(start_word ^ candidate_word);
+        if (difference != 0) {
+            match_length += __builtin_ctzll(difference) / 8;
+            return match_length > previous_match_length ? match_length : 0;
+        }
+        match_length += sizeof(u64);
     }
-
-    // Find the actual length
-    auto match_length = previous_match_length + 1;
     while (match_length < maximum_match_length && m_rolling_window[start + match_length] == m_rolling_window[candidate + match_length]) {
         match_length++;
     }
 
-    VERIFY(match_length > previous_match_length);
     VERIFY(match_length <= maximum_match_length);
-    return match_length;
+    return match_length > previous_match_length ? match_length : 0;
 }
 
 size_t DeflateCompressor::find_back_match(size_t start, u16 hash, size_t previous_match_length, size_t maximum_match_length, size_t& match_position)
@@ -590,7 +602,7 @@ size_t DeflateCompressor::find_back_match(size_t start, u16 hash, size_t previou
             break; // no remaining candidates
 
         VERIFY(candidate < start);
-        if (start - candidate > window_size)
+        if (start - candidate > max_back_reference_distance)
             break; // outside the window
 
         auto match_length = compare_match_candidate(start, candidate, previous_match_length, maximum_match_length);
@@ -600,11 +612,11 @@ size_t DeflateCompressor::find_back_match(size_t start, u16 hash, size_t previou
             match_position = candidate;
             previous_match_length = match_length;
 
-            if (match_length == maximum_match_length)
-                return match_length; // bail if we got the maximum possible length
+            if (match_length == maximum_match_length || match_length >= m_compression_constants.great_match_length)
+                return match_length; // bail if we got a great (or the maximum possible) match
         }
 
-        candidate = m_hash_prev[candidate % window_size];
+        candidate = m_hash_prev[candidate];
     }
     if (!match_found)
         return 0;                 // we didn't find any matches
@@ -694,10 +706,10 @@ void DeflateCompressor::lz77_compress_block()
         slot = empty_slot;
     }
 
+    // positions never reach window_size, as the pending block ends the window
     auto insert_hash = [&](auto pos, auto hash) {
-        auto window_pos = pos % window_size;
-        m_hash_prev[window_pos] = m_hash_head[hash];
-        m_hash_head[hash] = window_pos;
+        m_hash_prev[pos] = m_hash_head[hash];
+        m_hash_head[hash] = pos;
     };
 
     auto emit_literal = [&](auto literal) {
@@ -717,11 +729,13 @@ void DeflateCompressor::lz77_compress_block()
         m_distance_frequencies[distance_to_base(distance)]++;
     };
 
+    // make the data that came before this block available for back references
+    for (size_t position = block_size - m_history_size; position < block_size; position++)
+        insert_hash(position, hash_sequence(&m_rolling_window[position]));
+
     size_t previous_match_length = 0;
     size_t previous_match_position = 0;
 
-    VERIFY(m_compression_constants.great_match_length <= max_match_length);
-
     // our block starts at block_size and is m_pending_block_size in length
     auto block_end = block_size + m_pending_block_size;
     size_t current_position;
@@ -729,7 +743,7 @@ void DeflateCompressor::lz77_compress_block()
         auto hash = hash_sequence(&m_rolling_window[current_position]);
         size_t match_position;
         auto match_length = find_back_match(current_position, hash, previous_match_length,
-            min(m_compression_constants.great_match_length, block_end - current_position), match_position);
+            min(max_match_length, block_end - current_position), match_position);
 
         insert_hash(current_position, hash);
 
@@ -737,9 +751,11 @@ void DeflateCompressor::lz77_compress_block()
         if (previous_match_length != 0 && previous_match_length >= match_length) {
             emit_back_reference((current_position - 1) - previous_match_position, previous_match_length);
 
-            // skip all the bytes that are included in this match
-            for (size_t j = current_position + 1; j < min(current_position - 1 + previous_match_length, block_end - min_match_length + 1); j++) {
-                insert_hash(j, hash_sequence(&m_rolling_window[j]));
+            // skip all the bytes that are included in this match, only hashing them if the match is short enough to make that worth it
+            if (previous_match_length <= m_compression_constants.max_insert_length) {
+                for (size_t j = current_position + 1; j < min(current_position - 1 + previous_match_length, block_end - min_match_length + 1); j++) {
+                    insert_hash(j, hash_sequence(&m_rolling_window[j]));
+                }
             }
             current_position = (current_position - 1) + previous_match_length - 1;
             previous_match_length = 0;
@@ -1036,13 +1052,28 @@ void DeflateCompressor::flush()
     if (m_finished)
         m_output_stream.align_to_byte_boundary();
 
+    append_to_history(pending_block().trim(m_pending_block_size));
+
     // reset all block specific members
     m_pending_block_size = 0;
     m_pending_symbol_size = 0;
     m_symbol_frequencies.fill(0);
     m_distance_frequencies.fill(0);
-    // On the final block this copy will potentially produce an invalid search window, but since its the final block we dont care
-    pending_block().copy_trimmed_to({ m_rolling_window, block_size });
+}
+
+void DeflateCompressor::append_to_history(ReadonlyBytes bytes)
+{
+    VERIFY(bytes.size() <= block_size);
+    auto kept_size = min(m_history_size, block_size - bytes.size());
+    __builtin_memmove(m_rolling_window + block_size - bytes.size() - kept_size, m_rolling_window + block_size - kept_size, kept_size);
+    __builtin_memcpy(m_rolling_window + block_size - bytes.size(), bytes.data(), bytes.size());
+    m_history_size = kept_size + bytes.size();
+}
+
+void DeflateCompressor::set_dictionary(ReadonlyBytes dictionary)
+{
+    VERIFY(!m_finished && m_pending_block_size == 0);
+    append_to_history(dictionary.slice(dictionary.size() - min(dictionary.size(), block_size)));
 }
 
 void DeflateCompressor::final_flush()
@@ -1052,6 +1083,21 @@ void DeflateCompressor::final_flush()
     flush();
 }
 
+void DeflateCompressor::sync_flush()
+{
+    VERIFY(!m_finished);
+    if (m_pending_block_size != 0)
+        flush();
+
+    m_output_stream.write_bit(false);    // not the final block
+    m_output_stream.write_bits(0b00, 2); // no compression
+    m_output_stream.align_to_byte_boundary();
+    LittleEndian<u16> len = 0;
+    m_output_stream << len;
+    LittleEndian<u16> nlen = ~0;
+    m_output_stream << nlen;
+}
+
 Optional<ByteBuffer> DeflateCompressor::compress_all(const ReadonlyBytes& bytes, CompressionLevel compression_level)
 {
     DuplexMemoryStream output_stream;
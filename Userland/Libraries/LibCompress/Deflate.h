@@ -118,6 +118,7 @@ public:
     static constexpr size_t max_huffman_distances = 32;
     static constexpr size_t min_match_length = 4;   // matches smaller than these are not worth the size of the back reference
     static constexpr size_t max_match_length = 258; // matches longer than these cannot be encoded using huffman codes
+    static constexpr size_t max_back_reference_distance = 32 * KiB;
     static constexpr u16 empty_slot = UINT16_MAX;
 
     struct CompressionConstants {
@@ -125,19 +126,22 @@ public:
         size_t max_lazy_length;    // If the match is at least this long we dont defer matching to the next byte (which takes time) as its good enough
         size_t great_match_length; // Once we find a match of at least this length (a great match) we can just stop searching for longer ones
         size_t max_chain;          // We only check the actual length of the max_chain closest matches
+        size_t max_insert_length;  // The positions inside a match are only added to the hash table if the match is at most this long
     };
 
     // These constants were shamelessly "borrowed" from zlib
     static constexpr CompressionConstants compression_constants[] = {
-        { 0, 0, 0, 0 },
-        { 4, 4, 8, 4 },
-        { 8, 16, 128, 128 },
-        { 32, 258, 258, 4096 },
-        { max_match_length, max_match_length, max_match_length, 1 << hash_bits } // disable all limits
+        { 0, 0, 0, 0, 0 },
+        { 4, 4, 8, 1, 4 },
+        { 4, 4, 16, 8, max_match_length },
+        { 8, 16, 128, 128, max_match_length },
+        { 32, 258, 258, 4096, max_match_length },
+        { max_match_length, max_match_length, max_match_length, 1 << hash_bits, max_match_length } // disable all limits
     };
 
     enum class CompressionLevel : int {
         STORE = 0,
+        FASTEST,
         FAST,
         GOOD,
         GREAT,
@@ -151,10 +155,19 @@ public:
     bool write_or_error(ReadonlyBytes) override;
     void final_flush();
 
+    // Lets back references point into the given data, as if it had been compressed right before this stream.
+    // Has to be called before anything is written.
+    void set_dictionary(ReadonlyBytes);
+
+    // Flushes everything written so far and ends the output on a byte boundary with an empty stored block, without
+    // marking the end of the stream. Another deflate stream can then be appended to the output directly.
+    void sync_flush();
+
     static Optional<ByteBuffer> compress_all(const ReadonlyBytes& bytes, CompressionLevel = CompressionLevel::GOOD);
 
 private:
     Bytes pending_block() { return { m_rolling_window + block_size, block_size }; }
+    void append_to_history(ReadonlyBytes);
 
     // LZ77 Compression
     static u16 hash_sequence(const u8* bytes);
@@ -186,8 +199,11 @@ private:
     CompressionConstants m_compression_constants;
     OutputBitStream m_output_stream;
 
+    // The pending block lives in the second half of the window, and the data that came before it (up to a block's worth)
+    // at the end of the first half, where back references can reach it.
     u8 m_rolling_window[window_size];
     size_t m_pending_block_size { 0 };
+    size_t m_history_size { 0 };
 
     struct [[gnu::packed]] {
         u16 distance; // back reference length
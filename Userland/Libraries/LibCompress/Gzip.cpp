@@ -229,7 +229,7 @@ GzipCompressor::~GzipCompressor()
 {
 }
 
-size_t GzipCompressor::write(ReadonlyBytes bytes)
+void GzipCompressor::write_header(OutputStream& stream)
 {
     BlockHeader header;
     header.identification_1 = 0x1f;
@@ -239,7 +239,12 @@ size_t GzipCompressor::write(ReadonlyBytes bytes)
     header.modification_time = 0;
     header.extra_flags = 3;      // DEFLATE sets 2 for maximum compression and 4 for minimum compression
     header.operating_system = 3; // unix
-    m_output_stream << Bytes { &header, sizeof(header) };
+    stream << Bytes { &header, sizeof(header) };
+}
+
+size_t GzipCompressor::write(ReadonlyBytes bytes)
+{
+    write_header(m_output_stream);
     DeflateCompressor compressed_stream { m_output_stream };
     VERIFY(compressed_stream.write_or_error(bytes));
     compressed_stream.final_flush();
@@ -274,4 +279,62 @@ Optional<ByteBuffer> GzipCompressor::compress_all(const ReadonlyBytes& bytes)
     return output_stream.copy_into_contiguous_buffer();
 }
 
+size_t GzipCompressor::chunk_count(ReadonlyBytes input)
+{
+    // Even an empty input has one (empty) chunk, which carries the final deflate block.
+    return max<size_t>(1, ceil_div(input.size(), parallel_chunk_size));
+}
+
+Optional<GzipCompressor::CompressedChunk> GzipCompressor::compress_chunk(ReadonlyBytes input, size_t chunk_index)
+{
+    VERIFY(chunk_index < chunk_count(input));
+    auto offset = chunk_index * parallel_chunk_size;
+    auto chunk = input.slice(offset, min(parallel_chunk_size, input.size() - offset));
+
+    DuplexMemoryStream output_stream;
+    {
+        DeflateCompressor deflate_stream { output_stream };
+        deflate_stream.set_dictionary(input.slice(0, offset));
+        deflate_stream.write_or_error(chunk);
+
+        // Every chunk but the last ends on a byte boundary without a final block, so that the next one can follow it directly.
+        if (chunk_index == chunk_count(input) - 1)
+            deflate_stream.final_flush();
+        else
+            deflate_stream.sync_flush();
+
+        if (deflate_stream.handle_any_error())
+            return {};
+    }
+
+    return CompressedChunk {
+        .data = output_stream.copy_into_contiguous_buffer(),
+        .checksum = Crypto::Checksum::CRC32 { chunk }.digest(),
+    };
+}
+
+Optional<ByteBuffer> GzipCompressor::assemble_chunks(ReadonlyBytes input, Vector<CompressedChunk> const& chunks)
+{
+    VERIFY(chunks.size() == chunk_count(input));
+
+    DuplexMemoryStream output_stream;
+    write_header(output_stream);
+
+    u32 checksum = 0;
+    for (size_t i = 0; i < chunks.size(); ++i) {
+        output_stream << chunks[i].data;
+        auto chunk_size = min(parallel_chunk_size, input.size() - i * parallel_chunk_size);
+        checksum = Crypto::Checksum::CRC32::combine(checksum, chunks[i].checksum, chunk_size);
+    }
+
+    LittleEndian<u32> digest = checksum;
+    LittleEndian<u32> size = input.size();
+    output_stream << digest << size;
+
+    if (output_stream.handle_any_error())
+        return {};
+
+    return output_stream.copy_into_contiguous_buffer();
+}
+
 }
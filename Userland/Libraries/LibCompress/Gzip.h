@@ -89,7 +89,22 @@ public:
 
     static Optional<ByteBuffer> compress_all(const ReadonlyBytes& bytes);
 
+    // For compressing in parallel (like pigz): the input is split into chunks, which can be compressed independently,
+    // each primed with the end of the chunk before it, and then stitched together into a single gzip member.
+    static constexpr size_t parallel_chunk_size = 128 * KiB;
+
+    struct CompressedChunk {
+        ByteBuffer data;
+        u32 checksum { 0 };
+    };
+
+    static size_t chunk_count(ReadonlyBytes input);
+    static Optional<CompressedChunk> compress_chunk(ReadonlyBytes input, size_t chunk_index);
+    static Optional<ByteBuffer> assemble_chunks(ReadonlyBytes input, Vector<CompressedChunk> const& chunks);
+
 private:
+    static void write_header(OutputStream&);
+
     OutputStream& m_output_stream;
 };
 
@@ -11,6 +11,7 @@
 #include <AK/ScopeGuard.h>
 #include <LibCore/DirIterator.h>
 #include <LibCore/File.h>
+#include <LibCore/IORing.h>
 #include <errno.h>
 #include <fcntl.h>
 #include <libgen.h>
@@ -325,6 +326,101 @@ Result<void, File::CopyError> File::copy_file_or_directory(const String& dst_pat
     return copy_file(dst_path, src_stat, source);
 }
 
+// Keeps several chunks of a regular file in flight at once, so that reading the next chunk
+// overlaps with writing out the previous one. Returns the number of bytes copied.
+static constexpr size_t io_ring_copy_chunk_count = 8;
+
+static Result<off_t, OSError> copy_file_contents_with_io_ring(IORing& ring, int src_fd, int dst_fd, off_t size)
+{
+    static constexpr size_t chunk_size = 64 * KiB;
+    static constexpr size_t chunk_count = io_ring_copy_chunk_count;
+
+    struct Chunk {
+        ByteBuffer buffer;
+        off_t offset { 0 };
+        size_t length { 0 };
+        size_t filled { 0 };
+        size_t written { 0 };
+        bool is_writing { false };
+    };
+    Vector<Chunk, chunk_count> chunks;
+    chunks.resize(chunk_count);
+
+    off_t next_offset = 0;
+    off_t copied = 0;
+    size_t in_flight = 0;
+
+    auto start_next_chunk = [&](size_t index) {
+        auto& chunk = chunks[index];
+        if (next_offset >= size)
+            return;
+        if (chunk.buffer.is_empty())
+            chunk.buffer = ByteBuffer::create_uninitialized(chunk_size);
+        chunk.offset = next_offset;
+        chunk.length = min<size_t>(chunk_size, size - next_offset);
+        chunk.filled = 0;
+        chunk.written = 0;
+        chunk.is_writing = false;
+        next_offset += chunk.length;
+        VERIFY(ring.submit_read(src_fd, chunk.buffer.bytes().slice(0, chunk.length), index, chunk.offset));
+        ++in_flight;
+    };
+
+    for (size_t i = 0; i < chunk_count; ++i)
+        start_next_chunk(i);
+
+    Optional<OSError> error;
+    while (in_flight > 0) {
+        auto result = ring.submit_and_wait(1);
+        if (result.is_error())
+            return result.error();
+
+        for (;;) {
+            auto completion = ring.pop_completion();
+            if (!completion.has_value())
+                break;
+            --in_flight;
+            auto index = completion->user_data;
+            auto& chunk = chunks[index];
+            if (completion->is_error()) {
+                error = OSError(completion->error());
+                continue;
+            }
+            if (error.has_value())
+                continue;
+
+            if (!chunk.is_writing) {
+                // A zero-length read means the file shrunk under us, don't go any further.
+                if (completion->result == 0) {
+                    size = min(size, chunk.offset + (off_t)chunk.filled);
+                    continue;
+                }
+                chunk.filled += completion->result;
+                chunk.is_writing = true;
+            } else {
+                chunk.written += completion->result;
+                copied += completion->result;
+            }
+
+            if (chunk.written < chunk.filled) {
+                auto pending = chunk.buffer.bytes().slice(chunk.written, chunk.filled - chunk.written);
+                VERIFY(ring.submit_write(dst_fd, pending, index, chunk.offset + chunk.written));
+                ++in_flight;
+            } else if (chunk.filled < chunk.length) {
+                auto remaining = chunk.buffer.bytes().slice(chunk.filled, chunk.length - chunk.filled);
+                chunk.is_writing = false;
+                VERIFY(ring.submit_read(src_fd, remaining, index, chunk.offset + chunk.filled));
+                ++in_flight;
+            } else {
+                start_next_chunk(index);
+            }
+        }
+    }
+    if (error.has_value())
+        return error.value();
+    return copied;
+}
+
 Result<void, File::CopyError> File::copy_file(const String& dst_path, const struct stat& src_stat, File& source)
 {
     int dst_fd = creat(dst_path.characters(), 0666);
@@ -345,6 +441,19 @@ Result<void, File::CopyError> File::copy_file(const String& dst_path, const stru
             return CopyError { OSError(errno), false };
     }
 
+    // If we can't get a ring (e.g. because we're out of memory), the loop below copies the whole file instead.
+    if (S_ISREG(src_stat.st_mode) && src_stat.st_size > 0) {
+        if (auto ring_or_error = IORing::create(io_ring_copy_chunk_count); !ring_or_error.is_error()) {
+            auto copied_or_error = copy_file_contents_with_io_ring(*ring_or_error.value(), source.fd(), dst_fd, src_stat.st_size);
+            if (copied_or_error.is_error())
+                return CopyError { copied_or_error.error(), false };
+            // Pick up anything that was appended to the source while we were copying.
+            auto copied = copied_or_error.value();
+            if (lseek(source.fd(), copied, SEEK_SET) < 0 || lseek(dst_fd, copied, SEEK_SET) < 0)
+                return CopyError { OSError(errno), false };
+        }
+    }
+
     for (;;) {
         char buffer[32768];
         ssize_t nread = ::read(source.fd(), buffer, sizeof(buffer));
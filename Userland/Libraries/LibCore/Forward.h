@@ -20,6 +20,7 @@ class Event;
 class EventLoop;
 class File;
 class IODevice;
+class IORing;
 class LocalServer;
 class LocalSocket;
 class MimeData;
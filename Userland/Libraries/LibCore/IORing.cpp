@@ -0,0 +1,221 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibCore/IORing.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#ifdef __serenity__
+#    include <serenity.h>
+#endif
+
+namespace Core {
+
+Result<NonnullOwnPtr<IORing>, OSError> IORing::create(u32 entries)
+{
+    if (entries == 0 || entries > IO_RING_MAX_ENTRIES)
+        return OSError(EINVAL);
+    auto layout = io_ring_layout(entries);
+
+#ifdef __serenity__
+    int fd = io_ring_create(entries, O_CLOEXEC);
+    if (fd < 0)
+        return OSError(errno);
+    auto* ring = mmap(nullptr, layout.ring_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (ring == MAP_FAILED) {
+        int saved_errno = errno;
+        close(fd);
+        return OSError(saved_errno);
+    }
+    return adopt_own(*new IORing(fd, reinterpret_cast<u8*>(ring), layout));
+#else
+    return adopt_own(*new IORing(-1, nullptr, layout));
+#endif
+}
+
+IORing::IORing(int fd, u8* ring, IORingLayout const& layout)
+    : m_fd(fd)
+    , m_ring(ring)
+    , m_layout(layout)
+{
+}
+
+IORing::~IORing()
+{
+    if (m_ring)
+        munmap(m_ring, m_layout.ring_size);
+    if (m_fd >= 0)
+        close(m_fd);
+}
+
+bool IORing::submit_nop(u64 user_data)
+{
+    IORingSubmission submission;
+    submission.opcode = IORingOpcode::Nop;
+    submission.user_data = user_data;
+    return enqueue(submission);
+}
+
+bool IORing::submit_read(int fd, Bytes buffer, u64 user_data, i64 offset)
+{
+    IORingSubmission submission;
+    submission.opcode = IORingOpcode::Read;
+    submission.fd = fd;
+    submission.offset = offset;
+    submission.buffer = (FlatPtr)buffer.data();
+    submission.length = buffer.size();
+    submission.user_data = user_data;
+    return enqueue(submission);
+}
+
+bool IORing::submit_write(int fd, ReadonlyBytes buffer, u64 user_data, i64 offset)
+{
+    IORingSubmission submission;
+    submission.opcode = IORingOpcode::Write;
+    submission.fd = fd;
+    submission.offset = offset;
+    submission.buffer = (FlatPtr)buffer.data();
+    submission.length = buffer.size();
+    submission.user_data = user_data;
+    return enqueue(submission);
+}
+
+bool IORing::submit_accept(int fd, int flags, u64 user_data)
+{
+    IORingSubmission submission;
+    submission.opcode = IORingOpcode::Accept;
+    submission.fd = fd;
+    submission.flags = flags;
+    submission.user_data = user_data;
+    return enqueue(submission);
+}
+
+bool IORing::submit_fsync(int fd, u64 user_data)
+{
+    IORingSubmission submission;
+    submission.opcode = IORingOpcode::Fsync;
+    submission.fd = fd;
+    submission.user_data = user_data;
+    return enqueue(submission);
+}
+
+#ifdef __serenity__
+
+size_t IORing::queued_submissions() const
+{
+    return header().submission_tail - AK::atomic_load(&header().submission_head, AK::memory_order_acquire);
+}
+
+bool IORing::enqueue(IORingSubmission const& submission)
+{
+    auto& header = this->header();
+    u32 tail = header.submission_tail;
+    if (tail - AK::atomic_load(&header.submission_head, AK::memory_order_acquire) >= m_layout.submission_entries)
+        return false;
+    auto* entries = reinterpret_cast<IORingSubmission*>(m_ring + header.submission_entries_offset);
+    entries[tail & header.submission_mask] = submission;
+    AK::atomic_store(&header.submission_tail, tail + 1, AK::memory_order_release);
+    return true;
+}
+
+Result<size_t, OSError> IORing::submit_and_wait(size_t min_complete)
+{
+    int rc = io_ring_enter(m_fd, queued_submissions(), min_complete);
+    if (rc < 0)
+        return OSError(errno);
+    return (size_t)rc;
+}
+
+Optional<IORing::Completion> IORing::pop_completion()
+{
+    auto& header = this->header();
+    u32 head = header.completion_head;
+    if (head == AK::atomic_load(&header.completion_tail, AK::memory_order_acquire))
+        return {};
+    auto* entries = reinterpret_cast<IORingCompletion const*>(m_ring + header.completion_entries_offset);
+    auto& entry = entries[head & header.completion_mask];
+    Completion completion { entry.user_data, entry.result };
+    AK::atomic_store(&header.completion_head, head + 1, AK::memory_order_release);
+    return completion;
+}
+
+#else
+
+size_t IORing::queued_submissions() const
+{
+    return m_submissions.size();
+}
+
+bool IORing::enqueue(IORingSubmission const& submission)
+{
+    if (m_submissions.size() >= m_layout.submission_entries)
+        return false;
+    m_submissions.append(submission);
+    return true;
+}
+
+void IORing::perform(IORingSubmission const& submission)
+{
+    ssize_t rc = 0;
+    auto* buffer = (u8*)(FlatPtr)submission.buffer;
+    switch (submission.opcode) {
+    case IORingOpcode::Nop:
+        break;
+    case IORingOpcode::Read:
+        if (submission.offset == IO_RING_CURRENT_OFFSET)
+            rc = read(submission.fd, buffer, submission.length);
+        else
+            rc = pread(submission.fd, buffer, submission.length, submission.offset);
+        break;
+    case IORingOpcode::Write:
+        if (submission.offset == IO_RING_CURRENT_OFFSET)
+            rc = write(submission.fd, buffer, submission.length);
+        else
+            rc = pwrite(submission.fd, buffer, submission.length, submission.offset);
+        break;
+    case IORingOpcode::Accept:
+        rc = accept(submission.fd, nullptr, nullptr);
+        if (rc >= 0 && (submission.flags & SOCK_NONBLOCK))
+            fcntl(rc, F_SETFL, fcntl(rc, F_GETFL) | O_NONBLOCK);
+        if (rc >= 0 && (submission.flags & SOCK_CLOEXEC))
+            fcntl(rc, F_SETFD, FD_CLOEXEC);
+        break;
+    case IORingOpcode::Fsync:
+        rc = fsync(submission.fd);
+        break;
+    default:
+        rc = -1;
+        errno = EINVAL;
+        break;
+    }
+    m_completions.append({ submission.user_data, rc < 0 ? -errno : (i32)rc });
+}
+
+Result<size_t, OSError> IORing::submit_and_wait(size_t)
+{
+    size_t submitted = m_submissions.size();
+    for (auto& submission : m_submissions)
+        perform(submission);
+    m_submissions.clear();
+    return submitted;
+}
+
+Optional<IORing::Completion> IORing::pop_completion()
+{
+    if (m_next_completion == m_completions.size()) {
+        m_completions.clear();
+        m_next_completion = 0;
+        return {};
+    }
+    return m_completions[m_next_completion++];
+}
+
+#endif
+
+}
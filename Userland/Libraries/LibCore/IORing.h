@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Noncopyable.h>
+#include <AK/NonnullOwnPtr.h>
+#include <AK/OSError.h>
+#include <AK/Optional.h>
+#include <AK/Result.h>
+#include <AK/Span.h>
+#include <AK/Vector.h>
+#include <Kernel/API/IORing.h>
+
+namespace Core {
+
+// Queues up I/O operations and submits them to the kernel in batches, see Kernel/API/IORing.h.
+// Buffers passed to the submit_*() functions must stay alive until the matching completion has
+// been popped. Outside of Serenity, operations are simply performed synchronously on submission.
+class IORing {
+    AK_MAKE_NONCOPYABLE(IORing);
+    AK_MAKE_NONMOVABLE(IORing);
+
+public:
+    struct Completion {
+        u64 user_data { 0 };
+        i32 result { 0 }; // A byte count or file descriptor, or a negated errno.
+
+        bool is_error() const { return result < 0; }
+        int error() const { return -result; }
+    };
+
+    static Result<NonnullOwnPtr<IORing>, OSError> create(u32 entries = 64);
+    ~IORing();
+
+    // These return false if the submission queue is full; call submit() or submit_and_wait() to drain it.
+    bool submit_nop(u64 user_data);
+    bool submit_read(int fd, Bytes, u64 user_data, i64 offset = IO_RING_CURRENT_OFFSET);
+    bool submit_write(int fd, ReadonlyBytes, u64 user_data, i64 offset = IO_RING_CURRENT_OFFSET);
+    bool submit_accept(int fd, int flags, u64 user_data);
+    bool submit_fsync(int fd, u64 user_data);
+
+    // Hands all queued operations to the kernel and waits until at least `min_complete` completions are available.
+    Result<size_t, OSError> submit_and_wait(size_t min_complete);
+    Result<size_t, OSError> submit() { return submit_and_wait(0); }
+
+    Optional<Completion> pop_completion();
+
+    size_t queued_submissions() const;
+    size_t capacity() const { return m_layout.submission_entries; }
+    int fd() const { return m_fd; }
+
+private:
+    IORing(int fd, u8* ring, IORingLayout const&);
+
+    bool enqueue(IORingSubmission const&);
+
+    int m_fd { -1 };
+    u8* m_ring { nullptr };
+    IORingLayout m_layout;
+
+#ifdef __serenity__
+    IORingHeader& header() { return *reinterpret_cast<IORingHeader*>(m_ring); }
+    IORingHeader const& header() const { return *reinterpret_cast<IORingHeader const*>(m_ring); }
+#else
+    void perform(IORingSubmission const&);
+
+    Vector<IORingSubmission> m_submissions;
+    Vector<Completion> m_completions;
+    size_t m_next_completion { 0 };
+#endif
+};
+
+}
@@ -5,9 +5,7 @@
  */
 
 #include <AK/ByteBuffer.h>
-#include <AK/JsonArray.h>
-#include <AK/JsonObject.h>
-#include <AK/JsonValue.h>
+#include <AK/JsonReader.h>
 #include <LibCore/File.h>
 #include <LibCore/ProcessStatisticsReader.h>
 #include <pwd.h>
@@ -34,66 +32,118 @@ Optional<Vector<Core::ProcessStatistics>> ProcessStatisticsReader::get_all(RefPt
     Vector<Core::ProcessStatistics> processes;
 
     auto file_contents = proc_all_file->read_all();
-    auto json = JsonValue::from_string(file_contents);
-    if (!json.has_value())
-        return {};
-    json.value().as_array().for_each([&](auto& value) {
-        const JsonObject& process_object = value.as_object();
-        Core::ProcessStatistics process;
 
-        // kernel data first
-        process.pid = process_object.get("pid").to_u32();
-        process.pgid = process_object.get("pgid").to_u32();
-        process.pgp = process_object.get("pgp").to_u32();
-        process.sid = process_object.get("sid").to_u32();
-        process.uid = process_object.get("uid").to_u32();
-        process.gid = process_object.get("gid").to_u32();
-        process.ppid = process_object.get("ppid").to_u32();
-        process.nfds = process_object.get("nfds").to_u32();
-        process.kernel = process_object.get("kernel").to_bool();
-        process.name = process_object.get("name").to_string();
-        process.executable = process_object.get("executable").to_string();
-        process.tty = process_object.get("tty").to_string();
-        process.pledge = process_object.get("pledge").to_string();
-        process.veil = process_object.get("veil").to_string();
-        process.amount_virtual = process_object.get("amount_virtual").to_u32();
-        process.amount_resident = process_object.get("amount_resident").to_u32();
-        process.amount_shared = process_object.get("amount_shared").to_u32();
-        process.amount_dirty_private = process_object.get("amount_dirty_private").to_u32();
-        process.amount_clean_inode = process_object.get("amount_clean_inode").to_u32();
-        process.amount_purgeable_volatile = process_object.get("amount_purgeable_volatile").to_u32();
-        process.amount_purgeable_nonvolatile = process_object.get("amount_purgeable_nonvolatile").to_u32();
+    // We read the fields right out of the text, instead of building a JsonValue tree (with a String for every key and value) first.
+    JsonReader reader(file_contents);
+    auto read_value = [&] {
+        auto token = reader.next();
+        return token.has_value() ? token.release_value() : JsonToken { JsonToken::Type::Null, "null" };
+    };
 
-        auto& thread_array = process_object.get_ptr("threads")->as_array();
-        process.threads.ensure_capacity(thread_array.size());
-        thread_array.for_each([&](auto& value) {
-            auto& thread_object = value.as_object();
-            Core::ThreadStatistics thread;
-            thread.tid = thread_object.get("tid").to_u32();
-            thread.times_scheduled = thread_object.get("times_scheduled").to_u32();
-            thread.name = thread_object.get("name").to_string();
-            thread.state = thread_object.get("state").to_string();
-            thread.ticks_user = thread_object.get("ticks_user").to_u32();
-            thread.ticks_kernel = thread_object.get("ticks_kernel").to_u32();
-            thread.cpu = thread_object.get("cpu").to_u32();
-            thread.priority = thread_object.get("priority").to_u32();
-            thread.syscall_count = thread_object.get("syscall_count").to_u32();
-            thread.inode_faults = thread_object.get("inode_faults").to_u32();
-            thread.zero_faults = thread_object.get("zero_faults").to_u32();
-            thread.cow_faults = thread_object.get("cow_faults").to_u32();
-            thread.unix_socket_read_bytes = thread_object.get("unix_socket_read_bytes").to_u32();
-            thread.unix_socket_write_bytes = thread_object.get("unix_socket_write_bytes").to_u32();
-            thread.ipv4_socket_read_bytes = thread_object.get("ipv4_socket_read_bytes").to_u32();
-            thread.ipv4_socket_write_bytes = thread_object.get("ipv4_socket_write_bytes").to_u32();
-            thread.file_read_bytes = thread_object.get("file_read_bytes").to_u32();
-            thread.file_write_bytes = thread_object.get("file_write_bytes").to_u32();
-            process.threads.append(move(thread));
+    auto success = reader.for_each_element([&] {
+        Core::ProcessStatistics process;
+        reader.for_each_member([&](JsonToken const& key) {
+            if (key.equals("threads")) {
+                reader.for_each_element([&] {
+                    Core::ThreadStatistics thread;
+                    reader.for_each_member([&](JsonToken const& thread_key) {
+                        if (thread_key.equals("tid"))
+                            thread.tid = read_value().to_u32();
+                        else if (thread_key.equals("times_scheduled"))
+                            thread.times_scheduled = read_value().to_u32();
+                        else if (thread_key.equals("name"))
+                            thread.name = read_value().to_string();
+                        else if (thread_key.equals("state"))
+                            thread.state = read_value().to_string();
+                        else if (thread_key.equals("ticks_user"))
+                            thread.ticks_user = read_value().to_u32();
+                        else if (thread_key.equals("ticks_kernel"))
+                            thread.ticks_kernel = read_value().to_u32();
+                        else if (thread_key.equals("cpu"))
+                            thread.cpu = read_value().to_u32();
+                        else if (thread_key.equals("priority"))
+                            thread.priority = read_value().to_u32();
+                        else if (thread_key.equals("syscall_count"))
+                            thread.syscall_count = read_value().to_u32();
+                        else if (thread_key.equals("inode_faults"))
+                            thread.inode_faults = read_value().to_u32();
+                        else if (thread_key.equals("zero_faults"))
+                            thread.zero_faults = read_value().to_u32();
+                        else if (thread_key.equals("cow_faults"))
+                            thread.cow_faults = read_value().to_u32();
+                        else if (thread_key.equals("unix_socket_read_bytes"))
+                            thread.unix_socket_read_bytes = read_value().to_u32();
+                        else if (thread_key.equals("unix_socket_write_bytes"))
+                            thread.unix_socket_write_bytes = read_value().to_u32();
+                        else if (thread_key.equals("ipv4_socket_read_bytes"))
+                            thread.ipv4_socket_read_bytes = read_value().to_u32();
+                        else if (thread_key.equals("ipv4_socket_write_bytes"))
+                            thread.ipv4_socket_write_bytes = read_value().to_u32();
+                        else if (thread_key.equals("file_read_bytes"))
+                            thread.file_read_bytes = read_value().to_u32();
+                        else if (thread_key.equals("file_write_bytes"))
+                            thread.file_write_bytes = read_value().to_u32();
+                        else
+                            reader.skip_value();
+                    });
+                    process.threads.append(move(thread));
+                });
+                return;
+            }
+
+            // kernel data first
+            if (key.equals("pid"))
+                process.pid = read_value().to_u32();
+            else if (key.equals("pgid"))
+                process.pgid = read_value().to_u32();
+            else if (key.equals("pgp"))
+                process.pgp = read_value().to_u32();
+            else if (key.equals("sid"))
+                process.sid = read_value().to_u32();
+            else if (key.equals("uid"))
+                process.uid = read_value().to_u32();
+            else if (key.equals("gid"))
+                process.gid = read_value().to_u32();
+            else if (key.equals("ppid"))
+                process.ppid = read_value().to_u32();
+            else if (key.equals("nfds"))
+                process.nfds = read_value().to_u32();
+            else if (key.equals("kernel"))
+                process.kernel = read_value().to_bool();
+            else if (key.equals("name"))
+                process.name = read_value().to_string();
+            else if (key.equals("executable"))
+                process.executable = read_value().to_string();
+            else if (key.equals("tty"))
+                process.tty = read_value().to_string();
+            else if (key.equals("pledge"))
+                process.pledge = read_value().to_string();
+            else if (key.equals("veil"))
+                process.veil = read_value().to_string();
+            else if (key.equals("amount_virtual"))
+                process.amount_virtual = read_value().to_u32();
+            else if (key.equals("amount_resident"))
+                process.amount_resident = read_value().to_u32();
+            else if (key.equals("amount_shared"))
+                process.amount_shared = read_value().to_u32();
+            else if (key.equals("amount_dirty_private"))
+                process.amount_dirty_private = read_value().to_u32();
+            else if (key.equals("amount_clean_inode"))
+                process.amount_clean_inode = read_value().to_u32();
+            else if (key.equals("amount_purgeable_volatile"))
+                process.amount_purgeable_volatile = read_value().to_u32();
+            else if (key.equals("amount_purgeable_nonvolatile"))
+                process.amount_purgeable_nonvolatile = read_value().to_u32();
+            else
+                reader.skip_value();
         });
 
         // and synthetic data last
         process.username = username_from_uid(process.uid);
         processes.append(move(process));
     });
+    if (!success || !reader.is_done())
+        return {};
 
     return processes;
 }
@@ -6,11 +6,14 @@
 
 #include <AK/ByteReader.h>
 #include <AK/Debug.h>
-#include <AK/MemoryStream.h>
+#include <AK/Platform.h>
 #include <AK/Types.h>
-#include <AK/Vector.h>
 #include <LibCrypto/Authentication/GHash.h>
-#include <LibCrypto/BigInt/UnsignedBigInteger.h>
+#include <LibCrypto/CPUFeatures.h>
+
+#if ARCH(I386) || ARCH(X86_64)
+#    include <wmmintrin.h>
+#endif
 
 namespace {
 
@@ -19,73 +22,177 @@ static u32 to_u32(const u8* b)
     return AK::convert_between_host_and_big_endian(ByteReader::load32(b));
 }
 
-static void to_u8s(u8* b, const u32* w)
+static u64 to_u64(const u8* b)
 {
-    for (auto i = 0; i < 4; ++i) {
-        ByteReader::store(b + i * 4, AK::convert_between_host_and_big_endian(w[i]));
+    return ((u64)to_u32(b) << 32) | to_u32(b + 4);
+}
+
+static void to_u8s(u8* b, u64 high, u64 low)
+{
+    ByteReader::store(b + 0, AK::convert_between_host_and_big_endian((u32)(high >> 32)));
+    ByteReader::store(b + 4, AK::convert_between_host_and_big_endian((u32)high));
+    ByteReader::store(b + 8, AK::convert_between_host_and_big_endian((u32)(low >> 32)));
+    ByteReader::store(b + 12, AK::convert_between_host_and_big_endian((u32)low));
+}
+
+#if ARCH(I386) || ARCH(X86_64)
+// Multiplication in GF(2^128) with PCLMULQDQ, following Intel's "Carry-Less Multiplication Instruction and its Usage for
+// Computing the GCM Mode" (Algorithm 5). Both operands hold the block as a big-endian 128-bit integer, and since GHASH
+// reflects the bits, the 256-bit product is shifted left by one before it gets reduced.
+[[gnu::target("pclmul,sse2")]] static __m128i galois_multiply_pclmul(__m128i a, __m128i b)
+{
+    __m128i low = _mm_clmulepi64_si128(a, b, 0x00);
+    __m128i middle = _mm_xor_si128(_mm_clmulepi64_si128(a, b, 0x10), _mm_clmulepi64_si128(a, b, 0x01));
+    __m128i high = _mm_clmulepi64_si128(a, b, 0x11);
+    low = _mm_xor_si128(low, _mm_slli_si128(middle, 8));
+    high = _mm_xor_si128(high, _mm_srli_si128(middle, 8));
+
+    // Shift the 256-bit product <high:low> left by one bit.
+    __m128i low_carry = _mm_srli_epi32(low, 31);
+    __m128i high_carry = _mm_srli_epi32(high, 31);
+    low = _mm_slli_epi32(low, 1);
+    high = _mm_slli_epi32(high, 1);
+    __m128i carry_into_high = _mm_srli_si128(low_carry, 12);
+    high_carry = _mm_slli_si128(high_carry, 4);
+    low_carry = _mm_slli_si128(low_carry, 4);
+    low = _mm_or_si128(low, low_carry);
+    high = _mm_or_si128(high, high_carry);
+    high = _mm_or_si128(high, carry_into_high);
+
+    // Reduce modulo x^128 + x^7 + x^2 + x + 1.
+    __m128i a_term = _mm_xor_si128(_mm_xor_si128(_mm_slli_epi32(low, 31), _mm_slli_epi32(low, 30)), _mm_slli_epi32(low, 25));
+    __m128i b_term = _mm_srli_si128(a_term, 4);
+    a_term = _mm_slli_si128(a_term, 12);
+    low = _mm_xor_si128(low, a_term);
+    __m128i c_term = _mm_xor_si128(_mm_xor_si128(_mm_srli_epi32(low, 1), _mm_srli_epi32(low, 2)), _mm_srli_epi32(low, 7));
+    c_term = _mm_xor_si128(c_term, b_term);
+    low = _mm_xor_si128(low, c_term);
+    return _mm_xor_si128(high, low);
+}
+
+[[gnu::target("pclmul,sse2")]] static void process_blocks_pclmul(u64& high, u64& low, const u32 (&key)[4], const u8* data, size_t block_count)
+{
+    __m128i key_vector = _mm_set_epi32(key[0], key[1], key[2], key[3]);
+    __m128i state = _mm_set_epi64x(high, low);
+    for (size_t i = 0; i < block_count; ++i, data += 16) {
+        __m128i block = _mm_set_epi64x(to_u64(data), to_u64(data + 8));
+        state = galois_multiply_pclmul(_mm_xor_si128(state, block), key_vector);
     }
+
+    u64 result[2];
+    _mm_storeu_si128((__m128i*)result, state);
+    low = result[0];
+    high = result[1];
 }
+#endif
 
 }
 
 namespace Crypto {
 namespace Authentication {
 
-GHash::TagType GHash::process(ReadonlyBytes aad, ReadonlyBytes cipher)
+// Shoup's method, as laid out in the GCM specification, section 4.1:
+// Instead of going bit by bit, multiply by the key four bits at a time using a table of the key's multiples.
+void GHash::precompute_table()
 {
-    u32 tag[4] { 0, 0, 0, 0 };
-
-    auto transform_one = [&](auto& buf) {
-        size_t i = 0;
-        for (; i < buf.size(); i += 16) {
-            if (i + 16 <= buf.size()) {
-                for (auto j = 0; j < 4; ++j) {
-                    tag[j] ^= to_u32(buf.offset(i + j * 4));
-                }
-                galois_multiply(tag, m_key, tag);
-            }
+    u64 high = ((u64)m_key[0] << 32) | m_key[1];
+    u64 low = ((u64)m_key[2] << 32) | m_key[3];
+
+    // Index 8 is the key itself (the polynomial "1" in GHASH's reflected bit order), 4, 2 and 1 are the key times x, x^2 and x^3.
+    m_table_high[0] = 0;
+    m_table_low[0] = 0;
+    m_table_high[8] = high;
+    m_table_low[8] = low;
+    for (size_t i = 4; i > 0; i >>= 1) {
+        u64 reduction = (low & 1) ? 0xe100000000000000 : 0;
+        low = (high << 63) | (low >> 1);
+        high = (high >> 1) ^ reduction;
+        m_table_high[i] = high;
+        m_table_low[i] = low;
+    }
+
+    // Everything else is a sum of those.
+    for (size_t i = 2; i <= 8; i *= 2) {
+        for (size_t j = 1; j < i; ++j) {
+            m_table_high[i + j] = m_table_high[i] ^ m_table_high[j];
+            m_table_low[i + j] = m_table_low[i] ^ m_table_low[j];
         }
+    }
+}
 
-        if (i > buf.size()) {
-            static u8 buffer[16];
-            Bytes buffer_bytes { buffer, 16 };
-            OutputMemoryStream stream { buffer_bytes };
-            stream.write(buf.slice(i - 16));
-            stream.fill_to_end(0);
+void GHash::process_blocks(u64& high, u64& low, const u8* data, size_t block_count) const
+{
+#if ARCH(I386) || ARCH(X86_64)
+    if (CPUFeatures::the().has_pclmul) {
+        process_blocks_pclmul(high, low, m_key, data, block_count);
+        return;
+    }
+#endif
+
+    // What shifting the product right by four bits drops off the end, reduced back into the top.
+    static constexpr u64 reduction_table[16] {
+        0x0000, 0x1c20, 0x3840, 0x2460, 0x7080, 0x6ca0, 0x48c0, 0x54e0,
+        0xe100, 0xfd20, 0xd940, 0xc560, 0x9180, 0x8da0, 0xa9c0, 0xb5e0
+    };
 
-            for (auto j = 0; j < 4; ++j) {
-                tag[j] ^= to_u32(buffer_bytes.offset(j * 4));
+    for (size_t block = 0; block < block_count; ++block, data += 16) {
+        high ^= to_u64(data);
+        low ^= to_u64(data + 8);
+
+        u64 z_high = 0;
+        u64 z_low = 0;
+        // Go from the last nibble to the first one, multiplying the accumulated product by x^4 in between.
+        for (ssize_t i = 31; i >= 0; --i) {
+            u64 half = i >= 16 ? low : high;
+            size_t nibble = (half >> (60 - 4 * (i % 16))) & 0xf;
+            if (i != 31) {
+                size_t remainder = z_low & 0xf;
+                z_low = (z_high << 60) | (z_low >> 4);
+                z_high = (z_high >> 4) ^ (reduction_table[remainder] << 48);
             }
-            galois_multiply(tag, m_key, tag);
+            z_high ^= m_table_high[nibble];
+            z_low ^= m_table_low[nibble];
+        }
+
+        high = z_high;
+        low = z_low;
+    }
+}
+
+GHash::TagType GHash::process(ReadonlyBytes aad, ReadonlyBytes cipher)
+{
+    u64 high = 0;
+    u64 low = 0;
+
+    auto transform_one = [&](ReadonlyBytes buffer) {
+        size_t full_blocks = buffer.size() / 16;
+        process_blocks(high, low, buffer.data(), full_blocks);
+
+        if (auto remaining = buffer.size() % 16; remaining > 0) {
+            u8 block[16] {};
+            __builtin_memcpy(block, buffer.offset(full_blocks * 16), remaining);
+            process_blocks(high, low, block, 1);
         }
     };
 
     transform_one(aad);
     transform_one(cipher);
 
-    auto aad_bits = 8 * (u64)aad.size();
-    auto cipher_bits = 8 * (u64)cipher.size();
-
-    auto high = [](u64 value) -> u32 { return value >> 32; };
-    auto low = [](u64 value) -> u32 { return value & 0xffffffff; };
+    u64 aad_bits = 8 * (u64)aad.size();
+    u64 cipher_bits = 8 * (u64)cipher.size();
 
     if constexpr (GHASH_PROCESS_DEBUG) {
-        dbgln("AAD bits: {} : {}", high(aad_bits), low(aad_bits));
-        dbgln("Cipher bits: {} : {}", high(cipher_bits), low(cipher_bits));
-        dbgln("Tag bits: {} : {} : {} : {}", tag[0], tag[1], tag[2], tag[3]);
+        dbgln("AAD bits: {}", aad_bits);
+        dbgln("Cipher bits: {}", cipher_bits);
+        dbgln("Tag bits: {:016x} : {:016x}", high, low);
     }
 
-    tag[0] ^= high(aad_bits);
-    tag[1] ^= low(aad_bits);
-    tag[2] ^= high(cipher_bits);
-    tag[3] ^= low(cipher_bits);
-
-    dbgln_if(GHASH_PROCESS_DEBUG, "Tag bits: {} : {} : {} : {}", tag[0], tag[1], tag[2], tag[3]);
-
-    galois_multiply(tag, m_key, tag);
+    u8 lengths[16];
+    to_u8s(lengths, aad_bits, cipher_bits);
+    process_blocks(high, low, lengths, 1);
 
     TagType digest;
-    to_u8s(digest.data, tag);
+    to_u8s(digest.data, high, low);
 
     return digest;
 }
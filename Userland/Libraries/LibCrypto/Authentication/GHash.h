@@ -40,6 +40,7 @@ public:
         for (size_t i = 0; i < 16; i += 4) {
             m_key[i / 4] = AK::convert_between_host_and_big_endian(ByteReader::load32(key.offset(i)));
         }
+        precompute_table();
     }
 
     constexpr static size_t digest_size() { return TagType::Size; }
@@ -49,9 +50,14 @@ public:
     TagType process(ReadonlyBytes aad, ReadonlyBytes cipher);
 
 private:
-    inline void transform(ReadonlyBytes, ReadonlyBytes);
+    void precompute_table();
+    void process_blocks(u64& high, u64& low, const u8* data, size_t block_count) const;
 
     u32 m_key[4];
+
+    // Shoup's 4-bit tables: the products of the key with every 4-bit polynomial, split into 64-bit halves.
+    u64 m_table_high[16];
+    u64 m_table_low[16];
 };
 
 }
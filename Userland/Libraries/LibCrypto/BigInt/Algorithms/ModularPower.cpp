@@ -26,7 +26,7 @@ void UnsignedBigIntegerAlgorithms::destructive_modular_power_without_allocation(
     while (!(ep < 1)) {
         if (ep.words()[0] % 2 == 1) {
             // exp = (exp * base) % m;
-            multiply_without_allocation(exp, base, temp_1, temp_2, temp_3, temp_multiply);
+            multiply_without_allocation(exp, base, temp_1, temp_multiply);
             divide_without_allocation(temp_multiply, m, temp_1, temp_2, temp_3, temp_4, temp_quotient, temp_remainder);
             exp.set_to(temp_remainder);
         }
@@ -36,7 +36,7 @@ void UnsignedBigIntegerAlgorithms::destructive_modular_power_without_allocation(
         ep.set_to(temp_quotient);
 
         // base = (base * base) % m;
-        multiply_without_allocation(base, base, temp_1, temp_2, temp_3, temp_multiply);
+        multiply_without_allocation(base, base, temp_1, temp_multiply);
         divide_without_allocation(temp_multiply, m, temp_1, temp_2, temp_3, temp_4, temp_quotient, temp_remainder);
         base.set_to(temp_remainder);
 
@@ -94,93 +94,156 @@ ALWAYS_INLINE static void addition_with_carry(u32 a, u32 b, u32& z_carry, u32& z
  * Computes a montgomery "fragment" for y_i. This computes "z[i] += x[i] * y_i" for all words while rippling the carry, and returns the carry.
  * Algorithm from: Gueron, "Efficient Software Implementations of Modular Exponentiation". (https://eprint.iacr.org/2011/239.pdf)
  */
-UnsignedBigInteger::Word UnsignedBigIntegerAlgorithms::montgomery_fragment(UnsignedBigInteger& z, size_t offset_in_z, UnsignedBigInteger const& x, UnsignedBigInteger::Word y_digit, size_t num_words)
+UnsignedBigInteger::Word UnsignedBigIntegerAlgorithms::montgomery_fragment(Word* z, Word const* x, Word y_digit, size_t num_words)
 {
-    UnsignedBigInteger::Word carry { 0 };
+    Word carry { 0 };
     for (size_t i = 0; i < num_words; ++i) {
-        UnsignedBigInteger::Word a_carry;
-        UnsignedBigInteger::Word a;
-        linear_multiplication_with_carry(x.m_words[i], y_digit, z.m_words[offset_in_z + i], a_carry, a);
-        UnsignedBigInteger::Word b_carry;
-        UnsignedBigInteger::Word b;
+        Word a_carry;
+        Word a;
+        linear_multiplication_with_carry(x[i], y_digit, z[i], a_carry, a);
+        Word b_carry;
+        Word b;
         addition_with_carry(a, carry, b_carry, b);
-        z.m_words[offset_in_z + i] = b;
+        z[i] = b;
         carry = a_carry + b_carry;
     }
     return carry;
 }
 
+/**
+ * Computes the montgomery reduction of z : z * 2 ^ (-num_words * BITS_IN_WORD) % modulo, "almost" in the same sense as below.
+ * z is 2 * num_words long, and gets clobbered.
+ * Algorithm from: Gueron, "Efficient Software Implementations of Modular Exponentiation". (https://eprint.iacr.org/2011/239.pdf)
+ */
+void UnsignedBigIntegerAlgorithms::montgomery_reduction(Word* result, Word* z, Word const* modulo, Word k, size_t num_words)
+{
+    Word overflow { 0 };
+    for (size_t i = 0; i < num_words; ++i) {
+        // z[i->num_words+i] += modulo * (z_i * k), which zeroes out z_i
+        Word t = z[i] * k;
+        Word carry = montgomery_fragment(z + i, modulo, t, num_words);
+
+        // Put the carry "right after" the range that we computed above, along with the overflow out of the previous word
+        Word sum_carry;
+        Word sum;
+        addition_with_carry(z[num_words + i], carry, sum_carry, sum);
+        Word overflow_carry;
+        addition_with_carry(sum, overflow, overflow_carry, z[num_words + i]);
+        overflow = sum_carry + overflow_carry;
+    }
+
+    if (overflow == 0) {
+        // Return the top num_words words of Z, which contains our result.
+        __builtin_memcpy(result, z + num_words, num_words * sizeof(Word));
+        return;
+    }
+
+    // We have a carry, so we're "one bigger" than we need to be.
+    // Subtract the modulo from the result (the top half of z). (With carry, of course.)
+    Word c { 0 };
+    for (size_t i = 0; i < num_words; ++i) {
+        Word z_digit = z[num_words + i];
+        Word modulo_digit = modulo[i];
+        Word new_z_digit = z_digit - modulo_digit - c;
+        result[i] = new_z_digit;
+        // Detect if the subtraction underflowed - from "Hacker's Delight"
+        c = ((modulo_digit & ~z_digit) | ((modulo_digit | ~z_digit) & new_z_digit)) >> (UnsignedBigInteger::BITS_IN_WORD - 1);
+    }
+}
+
 /**
  * Computes the "almost montgomery" product : x * y * 2 ^ (-num_words * BITS_IN_WORD) % modulo
  * [Note : that means that the result z satisfies z * 2^(num_words * BITS_IN_WORD) % modulo = x * y % modulo]
  * assuming :
- *  - x, y and modulo are all already padded to num_words
+ *  - x, y and modulo are all num_words long
  *  - k = inverse_wrapped(modulo) (optimization to not recompute K each time)
- * Algorithm from: Gueron, "Efficient Software Implementations of Modular Exponentiation". (https://eprint.iacr.org/2011/239.pdf)
+ *  - scratch holds at least 2 * num_words + karatsuba_scratch_length(num_words) words
+ * The multiplication and the reduction are done one after the other, so that large products can use Karatsuba.
  */
 void UnsignedBigIntegerAlgorithms::almost_montgomery_multiplication_without_allocation(
-    UnsignedBigInteger const& x,
-    UnsignedBigInteger const& y,
-    UnsignedBigInteger const& modulo,
-    UnsignedBigInteger& z,
-    UnsignedBigInteger::Word k,
+    Word* result,
+    Word const* x,
+    Word const* y,
+    Word const* modulo,
+    Word k,
     size_t num_words,
-    UnsignedBigInteger& result)
+    Word* scratch)
 {
-    VERIFY(x.length() >= num_words);
-    VERIFY(y.length() >= num_words);
-    VERIFY(modulo.length() >= num_words);
+    karatsuba_multiply_words(scratch, x, y, num_words, scratch + 2 * num_words);
+    montgomery_reduction(result, scratch, modulo, k, num_words);
+}
 
-    z.set_to(0);
-    z.resize_with_leading_zeros(num_words * 2);
+/**
+ * The same as almost_montgomery_multiplication_without_allocation with x = y, but using a dedicated squaring.
+ */
+void UnsignedBigIntegerAlgorithms::almost_montgomery_square_without_allocation(
+    Word* result,
+    Word const* x,
+    Word const* modulo,
+    Word k,
+    size_t num_words,
+    Word* scratch)
+{
+    karatsuba_square_words(scratch, x, num_words, scratch + 2 * num_words);
+    montgomery_reduction(result, scratch, modulo, k, num_words);
+}
 
-    UnsignedBigInteger::Word previous_double_carry { 0 };
+/**
+ * Computes number = (2 * number) % modulo, for a number that's already below the modulo.
+ */
+static void double_modulo(UnsignedBigInteger::Word* number, UnsignedBigInteger::Word const* modulo, size_t num_words)
+{
+    UnsignedBigInteger::Word carry { 0 };
     for (size_t i = 0; i < num_words; ++i) {
-        // z[i->num_words+i] += x * y_i
-        UnsignedBigInteger::Word carry_1 = montgomery_fragment(z, i, x, y.m_words[i], num_words);
-        // z[i->num_words+i] += modulo * (z_i * k)
-        UnsignedBigInteger::Word t = z.m_words[i] * k;
-        UnsignedBigInteger::Word carry_2 = montgomery_fragment(z, i, modulo, t, num_words);
-
-        // Compute the carry by combining all of the carrys of the previous computations
-        // Put it "right after" the range that we computed above
-        UnsignedBigInteger::Word temp_carry = previous_double_carry + carry_1;
-        UnsignedBigInteger::Word overall_carry = temp_carry + carry_2;
-        z.m_words[num_words + i] = overall_carry;
-
-        // Detect if there was a "double carry" for this word by checking if our carry results are smaller than their components
-        previous_double_carry = (temp_carry < carry_1 || overall_carry < carry_2) ? 1 : 0;
+        UnsignedBigInteger::Word word = number[i];
+        number[i] = (word << 1) | carry;
+        carry = word >> (UnsignedBigInteger::BITS_IN_WORD - 1);
     }
 
-    if (previous_double_carry == 0) {
-        // Return the top num_words bytes of Z, which contains our result.
-        shift_right_by_n_words(z, num_words, result);
-        result.resize_with_leading_zeros(num_words);
-        return;
+    bool at_least_modulo = carry != 0;
+    if (!at_least_modulo) {
+        at_least_modulo = true;
+        for (size_t i = num_words; i > 0; --i) {
+            if (number[i - 1] != modulo[i - 1]) {
+                at_least_modulo = number[i - 1] > modulo[i - 1];
+                break;
+            }
+        }
     }
+    if (!at_least_modulo)
+        return;
 
-    // We have a carry, so we're "one bigger" than we need to be.
-    // Subtract the modulo from the result (the top half of z), and write it to the bottom half of Z since we have space.
-    // (With carry, of course.)
-    UnsignedBigInteger::Word c { 0 };
+    // The doubled number is below twice the modulo, so one subtraction brings it back under it (wrapping around any carry).
+    UnsignedBigInteger::Word borrow { 0 };
     for (size_t i = 0; i < num_words; ++i) {
-        UnsignedBigInteger::Word z_digit = z.m_words[num_words + i];
-        UnsignedBigInteger::Word modulo_digit = modulo.m_words[i];
-        UnsignedBigInteger::Word new_z_digit = z_digit - modulo_digit - c;
-        z.m_words[i] = new_z_digit;
-        // Detect if the subtraction underflowed - from "Hacker's Delight"
-        c = ((modulo_digit & ~z_digit) | ((modulo_digit | ~z_digit) & new_z_digit)) >> (UnsignedBigInteger::BITS_IN_WORD - 1);
+        u64 difference = static_cast<u64>(number[i]) - modulo[i] - borrow;
+        number[i] = static_cast<UnsignedBigInteger::Word>(difference);
+        borrow = (difference >> UnsignedBigInteger::BITS_IN_WORD) ? 1 : 0;
     }
+}
 
-    // Return the bottom num_words bytes of Z (with the carry bit handled)
-    z.m_words.resize(num_words);
-    result.set_to(z);
-    result.resize_with_leading_zeros(num_words);
+/**
+ * Returns how many bits of the exponent are worth looking at at once, trading the odd powers that have to be
+ * computed up front for the multiplications saved while going through the exponent (same thresholds as OpenSSL).
+ */
+static size_t sliding_window_size(size_t exponent_bits)
+{
+    if (exponent_bits > 671)
+        return 6;
+    if (exponent_bits > 239)
+        return 5;
+    if (exponent_bits > 79)
+        return 4;
+    if (exponent_bits > 23)
+        return 3;
+    return 1;
 }
 
 /**
- * Complexity: still O(N^3) with N the number of words in the largest word, but less complex than the classical mod power.
+ * Complexity: still O(N^3) with N the number of words in the largest word (O(N^(2 + log2(3))) with Karatsuba), but less complex than the classical mod power.
  * Note: the montgomery multiplications requires an inverse modulo over 2^32, which is only defined for odd numbers.
+ * The exponent is handled with a sliding window, so that only the odd powers of the base need to be precomputed.
+ * All of the working space comes out of the temporaries that are passed in.
  */
 void UnsignedBigIntegerAlgorithms::montgomery_modular_power_with_minimal_allocations(
     UnsignedBigInteger const& base,
@@ -197,19 +260,24 @@ void UnsignedBigIntegerAlgorithms::montgomery_modular_power_with_minimal_allocat
 {
     VERIFY(modulo.is_odd());
 
-    // Note: While this is a constexpr variable for clarity and could be changed in theory,
-    // various optimized parts of the algorithm rely on this value being exactly 4.
-    constexpr size_t window_size = 4;
-
     size_t num_words = modulo.trimmed_length();
-    UnsignedBigInteger::Word k = inverse_wrapped(modulo.m_words[0]);
-
-    one.set_to(1);
-
-    // rr = ( 2 ^ (2 * modulo.length() * BITS_IN_WORD) ) % modulo
-    shift_left_by_n_words(one, 2 * num_words, x);
-    divide_without_allocation(x, modulo, temp_z, one, z, zz, temp_extra, rr);
-    rr.resize_with_leading_zeros(num_words);
+    Word k = inverse_wrapped(modulo.m_words[0]);
+
+    // Resets a temporary to num_words words that are about to be written to directly.
+    auto words_of = [](UnsignedBigInteger& number, size_t length) {
+        number.set_to_0();
+        number.m_words.resize_and_keep_capacity(length);
+        return number.m_words.data();
+    };
+
+    // rr = ( 2 ^ (2 * num_words * BITS_IN_WORD) ) % modulo
+    // Start from the largest power of two below the modulo, and keep doubling it; that's much cheaper than dividing.
+    size_t modulo_bits = num_words * UnsignedBigInteger::BITS_IN_WORD - __builtin_clz(modulo.m_words[num_words - 1]);
+    Word* rr_words = words_of(rr, num_words);
+    __builtin_memset(rr_words, 0, num_words * sizeof(Word));
+    rr_words[(modulo_bits - 1) / UnsignedBigInteger::BITS_IN_WORD] = 1u << ((modulo_bits - 1) % UnsignedBigInteger::BITS_IN_WORD);
+    for (size_t i = modulo_bits - 1; i < 2 * num_words * UnsignedBigInteger::BITS_IN_WORD; ++i)
+        double_modulo(rr_words, modulo.m_words.data(), num_words);
 
     // x = base [% modulo, if x doesn't already fit in modulo's words]
     x.set_to(base);
@@ -220,45 +288,73 @@ void UnsignedBigIntegerAlgorithms::montgomery_modular_power_with_minimal_allocat
     one.set_to(1);
     one.resize_with_leading_zeros(num_words);
 
-    // Compute the montgomery powers from 0 to 2^window_size. powers[i] = x^i
-    UnsignedBigInteger powers[1 << window_size];
-    almost_montgomery_multiplication_without_allocation(one, rr, modulo, temp_z, k, num_words, powers[0]);
-    almost_montgomery_multiplication_without_allocation(x, rr, modulo, temp_z, k, num_words, powers[1]);
-    for (size_t i = 2; i < (1 << window_size); ++i)
-        almost_montgomery_multiplication_without_allocation(powers[i - 1], powers[1], modulo, temp_z, k, num_words, powers[i]);
-
-    z.set_to(powers[0]);
-    z.resize_with_leading_zeros(num_words);
-    zz.set_to(0);
-    zz.resize_with_leading_zeros(num_words);
-
-    ssize_t exponent_length = exponent.trimmed_length();
-    for (ssize_t word_in_exponent = exponent_length - 1; word_in_exponent >= 0; --word_in_exponent) {
-        UnsignedBigInteger::Word exponent_word = exponent.m_words[word_in_exponent];
-        size_t bit_in_word = 0;
-        while (bit_in_word < UnsignedBigInteger::BITS_IN_WORD) {
-            if (word_in_exponent != exponent_length - 1 || bit_in_word != 0) {
-                almost_montgomery_multiplication_without_allocation(z, z, modulo, temp_z, k, num_words, zz);
-                almost_montgomery_multiplication_without_allocation(zz, zz, modulo, temp_z, k, num_words, z);
-                almost_montgomery_multiplication_without_allocation(z, z, modulo, temp_z, k, num_words, zz);
-                almost_montgomery_multiplication_without_allocation(zz, zz, modulo, temp_z, k, num_words, z);
+    size_t exponent_length = exponent.trimmed_length();
+    size_t exponent_bits = 0;
+    if (exponent_length > 0)
+        exponent_bits = exponent_length * UnsignedBigInteger::BITS_IN_WORD - __builtin_clz(exponent.m_words[exponent_length - 1]);
+    auto exponent_bit = [&](size_t index) {
+        return (exponent.m_words[index / UnsignedBigInteger::BITS_IN_WORD] >> (index % UnsignedBigInteger::BITS_IN_WORD)) & 1;
+    };
+
+    size_t window_size = sliding_window_size(exponent_bits);
+    size_t odd_power_count = 1 << (window_size - 1);
+
+    Word* scratch = words_of(temp_z, 2 * num_words + karatsuba_scratch_length(num_words));
+    Word* current = words_of(z, num_words);
+    Word* next = words_of(zz, num_words);
+
+    // Compute the montgomery form of the odd powers of x. odd_powers[i] = x^(2 * i + 1)
+    Word* odd_powers = words_of(temp_extra, odd_power_count * num_words);
+    almost_montgomery_multiplication_without_allocation(odd_powers, x.m_words.data(), rr.m_words.data(), modulo.m_words.data(), k, num_words, scratch);
+    almost_montgomery_square_without_allocation(next, odd_powers, modulo.m_words.data(), k, num_words, scratch);
+    for (size_t i = 1; i < odd_power_count; ++i)
+        almost_montgomery_multiplication_without_allocation(odd_powers + i * num_words, odd_powers + (i - 1) * num_words, next, modulo.m_words.data(), k, num_words, scratch);
+
+    // current = 1, in montgomery form
+    almost_montgomery_multiplication_without_allocation(current, one.m_words.data(), rr.m_words.data(), modulo.m_words.data(), k, num_words, scratch);
+    bool current_is_one = true;
+
+    ssize_t bit = exponent_bits - 1;
+    while (bit >= 0) {
+        if (!exponent_bit(bit)) {
+            if (!current_is_one) {
+                almost_montgomery_square_without_allocation(next, current, modulo.m_words.data(), k, num_words, scratch);
+                swap(current, next);
             }
-            auto power_index = exponent_word >> (UnsignedBigInteger::BITS_IN_WORD - window_size);
-            auto& power = powers[power_index];
-            almost_montgomery_multiplication_without_allocation(z, power, modulo, temp_z, k, num_words, zz);
-
-            swap(z, zz);
+            --bit;
+            continue;
+        }
 
-            // Move to the next window
-            exponent_word <<= window_size;
-            bit_in_word += window_size;
+        // Take the longest window of at most window_size bits that starts at this bit and ends on a set bit.
+        ssize_t window_end = max<ssize_t>(bit - window_size + 1, 0);
+        while (!exponent_bit(window_end))
+            ++window_end;
+        size_t window_value = 0;
+        for (ssize_t i = bit; i >= window_end; --i)
+            window_value = (window_value << 1) | exponent_bit(i);
+        Word const* power = odd_powers + (window_value >> 1) * num_words;
+
+        if (current_is_one) {
+            __builtin_memcpy(current, power, num_words * sizeof(Word));
+            current_is_one = false;
+        } else {
+            for (ssize_t i = bit; i >= window_end; --i) {
+                almost_montgomery_square_without_allocation(next, current, modulo.m_words.data(), k, num_words, scratch);
+                swap(current, next);
+            }
+            almost_montgomery_multiplication_without_allocation(next, current, power, modulo.m_words.data(), k, num_words, scratch);
+            swap(current, next);
         }
+
+        bit = window_end - 1;
     }
 
-    almost_montgomery_multiplication_without_allocation(z, one, modulo, temp_z, k, num_words, zz);
+    // Leave the montgomery form, x isn't needed anymore at this point.
+    Word* final_words = words_of(x, num_words);
+    almost_montgomery_multiplication_without_allocation(final_words, current, one.m_words.data(), modulo.m_words.data(), k, num_words, scratch);
 
-    if (zz < modulo) {
-        result.set_to(zz);
+    if (x < modulo) {
+        result.set_to(x);
         result.clamp_to_trimmed_length();
         return;
     }
@@ -266,15 +362,15 @@ void UnsignedBigIntegerAlgorithms::montgomery_modular_power_with_minimal_allocat
     // Note : Since we were using "almost montgomery" multiplications, we aren't guaranteed to be under the modulo already.
     // So, if we're here, we need to respect the modulo.
     // We can, however, start by trying to subtract the modulo, just in case we're close.
-    subtract_without_allocation(zz, modulo, result);
+    subtract_without_allocation(x, modulo, result);
 
-    if (modulo < zz) {
+    if (!(result < modulo)) {
         // Note: This branch shouldn't happen in theory (as noted in https://github.com/rust-num/num-bigint/blob/master/src/biguint/monty.rs#L210)
         // Let's dbgln the values we used. That way, if we hit this branch, we can contribute these values for test cases.
         dbgln("Encountered the modulo branch during a montgomery modular power. Params : {} - {} - {}", base, exponent, modulo);
         // We just clobber all the other temporaries that we don't need for the division.
         // This is wasteful, but we're on the edgiest of cases already.
-        divide_without_allocation(zz, modulo, temp_z, rr, z, x, temp_extra, result);
+        divide_without_allocation(x, modulo, temp_z, rr, z, zz, temp_extra, result);
     }
 
     result.clamp_to_trimmed_length();
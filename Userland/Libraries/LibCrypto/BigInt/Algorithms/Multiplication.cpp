@@ -9,38 +9,269 @@
 
 namespace Crypto {
 
+using Word = UnsignedBigInteger::Word;
+using DoubleWord = u64;
+
+/**
+ * Below this many words, the schoolbook method's tight loop beats Karatsuba's extra additions.
+ * Squaring gets a higher threshold, since the schoolbook square already skips half of the multiplications.
+ * Karatsuba needs both halves to be at least two words long.
+ */
+static constexpr size_t karatsuba_threshold = 32;
+static constexpr size_t karatsuba_square_threshold = 48;
+static_assert(karatsuba_threshold >= 4 && karatsuba_square_threshold >= karatsuba_threshold);
+
+/**
+ * Computes accumulator += value, where value is no longer than the accumulator. Returns the carry out of the accumulator.
+ */
+static Word add_words(Word* accumulator, size_t accumulator_length, Word const* value, size_t value_length)
+{
+    DoubleWord carry = 0;
+    size_t i = 0;
+    for (; i < value_length; ++i) {
+        carry += static_cast<DoubleWord>(accumulator[i]) + value[i];
+        accumulator[i] = static_cast<Word>(carry);
+        carry >>= UnsignedBigInteger::BITS_IN_WORD;
+    }
+    for (; carry && i < accumulator_length; ++i) {
+        carry += accumulator[i];
+        accumulator[i] = static_cast<Word>(carry);
+        carry >>= UnsignedBigInteger::BITS_IN_WORD;
+    }
+    return static_cast<Word>(carry);
+}
+
 /**
- * Complexity: O(N^2) where N is the number of words in the larger number
+ * Computes accumulator -= value, where value is no longer than the accumulator. Returns the borrow out of the accumulator.
+ */
+static Word subtract_words(Word* accumulator, size_t accumulator_length, Word const* value, size_t value_length)
+{
+    Word borrow = 0;
+    size_t i = 0;
+    for (; i < value_length; ++i) {
+        DoubleWord difference = static_cast<DoubleWord>(accumulator[i]) - value[i] - borrow;
+        accumulator[i] = static_cast<Word>(difference);
+        borrow = (difference >> UnsignedBigInteger::BITS_IN_WORD) ? 1 : 0;
+    }
+    for (; borrow && i < accumulator_length; ++i) {
+        borrow = accumulator[i] == 0 ? 1 : 0;
+        --accumulator[i];
+    }
+    return borrow;
+}
+
+/**
+ * Complexity: O(N*M) where N and M are the lengths of the operands
+ * output[0 .. left_length + right_length) = left * right
+ */
+static void schoolbook_multiply_words(Word* output, Word const* left, size_t left_length, Word const* right, size_t right_length)
+{
+    __builtin_memset(output, 0, (left_length + right_length) * sizeof(Word));
+    for (size_t i = 0; i < left_length; ++i) {
+        DoubleWord left_word = left[i];
+        DoubleWord carry = 0;
+        for (size_t j = 0; j < right_length; ++j) {
+            // This can't overflow: (2^32 - 1)^2 + 2 * (2^32 - 1) = 2^64 - 1
+            carry += left_word * right[j] + output[i + j];
+            output[i + j] = static_cast<Word>(carry);
+            carry >>= UnsignedBigInteger::BITS_IN_WORD;
+        }
+        output[i + right_length] = static_cast<Word>(carry);
+    }
+}
+
+/**
+ * Complexity: O(N^2), but with about half the multiplications of schoolbook_multiply_words,
+ * since every cross product a_i * a_j shows up twice in the square.
+ * output[0 .. 2 * length) = number * number
+ */
+static void schoolbook_square_words(Word* output, Word const* number, size_t length)
+{
+    __builtin_memset(output, 0, 2 * length * sizeof(Word));
+    for (size_t i = 0; i < length; ++i) {
+        DoubleWord number_word = number[i];
+        DoubleWord carry = 0;
+        for (size_t j = i + 1; j < length; ++j) {
+            carry += number_word * number[j] + output[i + j];
+            output[i + j] = static_cast<Word>(carry);
+            carry >>= UnsignedBigInteger::BITS_IN_WORD;
+        }
+        output[i + length] = static_cast<Word>(carry);
+    }
+
+    // Double the cross products; they add up to less than half the square, so nothing gets shifted out.
+    Word top_bit = 0;
+    for (size_t i = 0; i < 2 * length; ++i) {
+        Word word = output[i];
+        output[i] = (word << 1) | top_bit;
+        top_bit = word >> (UnsignedBigInteger::BITS_IN_WORD - 1);
+    }
+
+    // And add the squares of each word on the diagonal.
+    DoubleWord carry = 0;
+    for (size_t i = 0; i < length; ++i) {
+        carry += static_cast<DoubleWord>(number[i]) * number[i] + output[2 * i];
+        output[2 * i] = static_cast<Word>(carry);
+        carry >>= UnsignedBigInteger::BITS_IN_WORD;
+        carry += output[2 * i + 1];
+        output[2 * i + 1] = static_cast<Word>(carry);
+        carry >>= UnsignedBigInteger::BITS_IN_WORD;
+    }
+}
+
+size_t UnsignedBigIntegerAlgorithms::karatsuba_scratch_length(size_t length)
+{
+    if (length < karatsuba_threshold)
+        return 0;
+    size_t high_length = length - length / 2;
+    return 4 * (high_length + 1) + karatsuba_scratch_length(high_length + 1);
+}
+
+size_t UnsignedBigIntegerAlgorithms::multiplication_scratch_length(size_t left_length, size_t right_length)
+{
+    size_t shorter_length = min(left_length, right_length);
+    if (left_length == right_length || shorter_length < karatsuba_threshold)
+        return karatsuba_scratch_length(shorter_length);
+    return 3 * shorter_length + karatsuba_scratch_length(shorter_length);
+}
+
+/**
+ * Complexity: O(N^log2(3)) where N is the length of both operands
  * Multiplication method:
- * An integer is equal to the sum of the powers of two
- * according to the indices of its 'on' bits.
- * So to multiple x*y, we go over each '1' bit in x (say the i'th bit),
- * and add y<<i to the result.
+ * Split both numbers into halves, left = l1 * B + l0 and right = r1 * B + r0, then
+ * left * right = l1 * r1 * B^2 + ((l0 + l1) * (r0 + r1) - l0 * r0 - l1 * r1) * B + l0 * r0
+ * which only takes three multiplications of half the size.
+ */
+void UnsignedBigIntegerAlgorithms::karatsuba_multiply_words(Word* output, Word const* left, Word const* right, size_t length, Word* scratch)
+{
+    if (length < karatsuba_threshold) {
+        schoolbook_multiply_words(output, left, length, right, length);
+        return;
+    }
+
+    size_t low_length = length / 2;
+    size_t high_length = length - low_length;
+
+    // The low product goes into the bottom of the output, and the high product right above it.
+    karatsuba_multiply_words(output, left, right, low_length, scratch);
+    karatsuba_multiply_words(output + 2 * low_length, left + low_length, right + low_length, high_length, scratch);
+
+    Word* left_sum = scratch;
+    Word* right_sum = left_sum + high_length + 1;
+    Word* middle = right_sum + high_length + 1;
+    Word* next_scratch = middle + 2 * (high_length + 1);
+
+    __builtin_memcpy(left_sum, left + low_length, high_length * sizeof(Word));
+    left_sum[high_length] = add_words(left_sum, high_length, left, low_length);
+    __builtin_memcpy(right_sum, right + low_length, high_length * sizeof(Word));
+    right_sum[high_length] = add_words(right_sum, high_length, right, low_length);
+
+    size_t middle_length = 2 * (high_length + 1);
+    karatsuba_multiply_words(middle, left_sum, right_sum, high_length + 1, next_scratch);
+    subtract_words(middle, middle_length, output, 2 * low_length);
+    subtract_words(middle, middle_length, output + 2 * low_length, 2 * high_length);
+
+    add_words(output + low_length, 2 * length - low_length, middle, middle_length);
+}
+
+/**
+ * Complexity: O(N^log2(3)) where N is the length of the number
+ * The same as karatsuba_multiply_words, except that all three products are squares too.
+ */
+void UnsignedBigIntegerAlgorithms::karatsuba_square_words(Word* output, Word const* number, size_t length, Word* scratch)
+{
+    if (length < karatsuba_square_threshold) {
+        schoolbook_square_words(output, number, length);
+        return;
+    }
+
+    size_t low_length = length / 2;
+    size_t high_length = length - low_length;
+
+    karatsuba_square_words(output, number, low_length, scratch);
+    karatsuba_square_words(output + 2 * low_length, number + low_length, high_length, scratch);
+
+    Word* sum = scratch;
+    Word* middle = sum + high_length + 1;
+    Word* next_scratch = middle + 2 * (high_length + 1);
+
+    __builtin_memcpy(sum, number + low_length, high_length * sizeof(Word));
+    sum[high_length] = add_words(sum, high_length, number, low_length);
+
+    size_t middle_length = 2 * (high_length + 1);
+    karatsuba_square_words(middle, sum, high_length + 1, next_scratch);
+    subtract_words(middle, middle_length, output, 2 * low_length);
+    subtract_words(middle, middle_length, output + 2 * low_length, 2 * high_length);
+
+    add_words(output + low_length, 2 * length - low_length, middle, middle_length);
+}
+
+/**
+ * output[0 .. left_length + right_length) = left * right
+ * scratch must hold at least multiplication_scratch_length(left_length, right_length) words.
+ */
+void UnsignedBigIntegerAlgorithms::multiply_words(Word* output, Word const* left, size_t left_length, Word const* right, size_t right_length, Word* scratch)
+{
+    if (left_length < right_length) {
+        swap(left, right);
+        swap(left_length, right_length);
+    }
+
+    if (right_length < karatsuba_threshold) {
+        schoolbook_multiply_words(output, left, left_length, right, right_length);
+        return;
+    }
+
+    if (left_length == right_length) {
+        karatsuba_multiply_words(output, left, right, left_length, scratch);
+        return;
+    }
+
+    // Karatsuba wants operands of the same size, so cut the longer one into pieces as long as the shorter one,
+    // and add up their products. The last piece is padded with zeros.
+    __builtin_memset(output, 0, (left_length + right_length) * sizeof(Word));
+    Word* piece = scratch;
+    Word* piece_product = piece + right_length;
+    Word* next_scratch = piece_product + 2 * right_length;
+    for (size_t offset = 0; offset < left_length; offset += right_length) {
+        size_t piece_length = min(right_length, left_length - offset);
+        __builtin_memcpy(piece, left + offset, piece_length * sizeof(Word));
+        __builtin_memset(piece + piece_length, 0, (right_length - piece_length) * sizeof(Word));
+        karatsuba_multiply_words(piece_product, piece, right, right_length, next_scratch);
+        add_words(output + offset, left_length + right_length - offset, piece_product, piece_length + right_length);
+    }
+}
+
+/**
+ * Complexity: O(N^2) where N is the number of words in the larger number, or O(N^log2(3)) once both numbers
+ * are at least karatsuba_threshold words long. Squaring a number (passing the same integer as both operands)
+ * takes a dedicated path that needs fewer multiplications.
+ * The output must not be one of the operands.
  */
 FLATTEN void UnsignedBigIntegerAlgorithms::multiply_without_allocation(
     UnsignedBigInteger const& left,
     UnsignedBigInteger const& right,
-    UnsignedBigInteger& temp_shift_result,
-    UnsignedBigInteger& temp_shift_plus,
-    UnsignedBigInteger& temp_shift,
+    UnsignedBigInteger& temp_scratch,
     UnsignedBigInteger& output)
 {
-    output.set_to_0();
+    VERIFY(&output != &left && &output != &right);
 
-    // iterate all bits
-    for (size_t word_index = 0; word_index < left.length(); ++word_index) {
-        for (size_t bit_index = 0; bit_index < UnsignedBigInteger::BITS_IN_WORD; ++bit_index) {
-            // If the bit is off - skip over it
-            if (!(left.m_words[word_index] & (1 << bit_index)))
-                continue;
+    size_t left_length = left.trimmed_length();
+    size_t right_length = right.trimmed_length();
 
-            size_t shift_amount = word_index * UnsignedBigInteger::BITS_IN_WORD + bit_index;
+    output.set_to_0();
+    if (left_length == 0 || right_length == 0)
+        return;
 
-            // output += (right << shift_amount);
-            shift_left_without_allocation(right, shift_amount, temp_shift_result, temp_shift_plus, temp_shift);
-            add_into_accumulator_without_allocation(output, temp_shift);
-        }
+    output.m_words.resize_and_keep_capacity(left_length + right_length);
+    if (&left == &right) {
+        temp_scratch.m_words.resize_and_keep_capacity(karatsuba_scratch_length(left_length));
+        karatsuba_square_words(output.m_words.data(), left.m_words.data(), left_length, temp_scratch.m_words.data());
+    } else {
+        temp_scratch.m_words.resize_and_keep_capacity(multiplication_scratch_length(left_length, right_length));
+        multiply_words(output.m_words.data(), left.m_words.data(), left_length, right.m_words.data(), right_length, temp_scratch.m_words.data());
     }
+    output.clamp_to_trimmed_length();
 }
 
 }
@@ -0,0 +1,39 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Platform.h>
+#include <LibCrypto/CPUFeatures.h>
+
+#if ARCH(I386) || ARCH(X86_64)
+#    include <cpuid.h>
+#endif
+
+namespace Crypto {
+
+static CPUFeatures detect_cpu_features()
+{
+    CPUFeatures features;
+#if ARCH(I386) || ARCH(X86_64)
+    unsigned eax, ebx, ecx, edx;
+    if (__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+        features.has_aes_ni = ecx & bit_AES;
+        features.has_pclmul = ecx & bit_PCLMUL;
+        features.has_ssse3 = ecx & bit_SSSE3;
+        features.has_sse41 = ecx & bit_SSE4_1;
+    }
+    if (__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx))
+        features.has_sha = ebx & bit_SHA;
+#endif
+    return features;
+}
+
+const CPUFeatures& CPUFeatures::the()
+{
+    static CPUFeatures s_features = detect_cpu_features();
+    return s_features;
+}
+
+}
@@ -0,0 +1,23 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+namespace Crypto {
+
+// Instruction set extensions that the ciphers can use when the CPU has them, detected once at runtime.
+// The kernel never gets to use these, as it doesn't save the SSE state for itself.
+struct CPUFeatures {
+    bool has_aes_ni { false };
+    bool has_pclmul { false };
+    bool has_ssse3 { false };
+    bool has_sse41 { false };
+    bool has_sha { false };
+
+    static const CPUFeatures& the();
+};
+
+}
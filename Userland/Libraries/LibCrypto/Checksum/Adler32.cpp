@@ -4,17 +4,89 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/Platform.h>
 #include <AK/Span.h>
 #include <AK/Types.h>
 #include <LibCrypto/Checksum/Adler32.h>
 
+#if ARCH(I386) || ARCH(X86_64)
+#    define ADLER32_SSSE3_AVAILABLE 1
+#    include <LibCrypto/CPUFeatures.h>
+#    include <immintrin.h>
+#endif
+
 namespace Crypto::Checksum {
 
+static constexpr u32 modulus = 65521;
+
+// The largest number of bytes that can be summed up before b might overflow 32 bits, so the modulo only has to be
+// taken once per this many bytes: 255 * n * (n + 1) / 2 + (n + 1) * (modulus - 1) <= 2^32 - 1
+static constexpr size_t max_bytes_between_reductions = 5552;
+
+#ifdef ADLER32_SSSE3_AVAILABLE
+[[gnu::target("ssse3")]] ALWAYS_INLINE static u32 horizontal_sum(__m128i vector)
+{
+    vector = _mm_add_epi32(vector, _mm_shuffle_epi32(vector, 0xb1));
+    vector = _mm_add_epi32(vector, _mm_shuffle_epi32(vector, 0x4e));
+    return _mm_cvtsi128_si32(vector);
+}
+
+// Processes 32 bytes per iteration: a gets the plain sum of the bytes, and b the sum weighted by 32, 31, ..., 1,
+// plus 32 times the value a had before each chunk.
+[[gnu::target("ssse3")]] static void update_ssse3(u32& a, u32& b, const u8* data, size_t chunk_count)
+{
+    auto const first_half_weights = _mm_setr_epi8(32, 31, 30, 29, 28, 27, 26, 25, 24, 23, 22, 21, 20, 19, 18, 17);
+    auto const second_half_weights = _mm_setr_epi8(16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1);
+    auto const ones = _mm_set1_epi16(1);
+    auto const zero = _mm_setzero_si128();
+
+    while (chunk_count > 0) {
+        auto chunks_before_reduction = min(chunk_count, max_bytes_between_reductions / 32);
+        chunk_count -= chunks_before_reduction;
+
+        auto previous_a_sum = _mm_cvtsi32_si128(a * chunks_before_reduction);
+        auto a_sum = _mm_setzero_si128();
+        auto b_sum = _mm_cvtsi32_si128(b);
+        for (size_t i = 0; i < chunks_before_reduction; ++i, data += 32) {
+            auto first_half = _mm_loadu_si128((const __m128i*)data);
+            auto second_half = _mm_loadu_si128((const __m128i*)(data + 16));
+            previous_a_sum = _mm_add_epi32(previous_a_sum, a_sum);
+            a_sum = _mm_add_epi32(a_sum, _mm_add_epi32(_mm_sad_epu8(first_half, zero), _mm_sad_epu8(second_half, zero)));
+            b_sum = _mm_add_epi32(b_sum, _mm_madd_epi16(_mm_maddubs_epi16(first_half, first_half_weights), ones));
+            b_sum = _mm_add_epi32(b_sum, _mm_madd_epi16(_mm_maddubs_epi16(second_half, second_half_weights), ones));
+        }
+        b_sum = _mm_add_epi32(b_sum, _mm_slli_epi32(previous_a_sum, 5));
+
+        a = (a + horizontal_sum(a_sum)) % modulus;
+        b = horizontal_sum(b_sum) % modulus;
+    }
+}
+#endif
+
 void Adler32::update(ReadonlyBytes data)
 {
-    for (size_t i = 0; i < data.size(); i++) {
-        m_state_a = (m_state_a + data.at(i)) % 65521;
-        m_state_b = (m_state_b + m_state_a) % 65521;
+    auto* bytes = data.data();
+    auto size = data.size();
+
+#ifdef ADLER32_SSSE3_AVAILABLE
+    if (size >= 32 && CPUFeatures::the().has_ssse3) {
+        auto chunk_count = size / 32;
+        update_ssse3(m_state_a, m_state_b, bytes, chunk_count);
+        bytes += chunk_count * 32;
+        size -= chunk_count * 32;
+    }
+#endif
+
+    while (size > 0) {
+        auto run_length = min(size, max_bytes_between_reductions);
+        for (size_t i = 0; i < run_length; i++) {
+            m_state_a += bytes[i];
+            m_state_b += m_state_a;
+        }
+        m_state_a %= modulus;
+        m_state_b %= modulus;
+        bytes += run_length;
+        size -= run_length;
     }
 };
 
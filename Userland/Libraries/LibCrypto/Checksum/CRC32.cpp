@@ -4,17 +4,134 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/Platform.h>
 #include <AK/Span.h>
 #include <AK/Types.h>
 #include <LibCrypto/Checksum/CRC32.h>
 
+#if ARCH(I386) || ARCH(X86_64)
+#    define CRC32_PCLMUL_AVAILABLE 1
+#    include <LibCrypto/CPUFeatures.h>
+#    include <immintrin.h>
+#endif
+
 namespace Crypto::Checksum {
 
+// Slicing-by-8: data[0] is the usual byte-at-a-time table, and data[k][i] is the CRC of byte i followed by k zero bytes.
+// That lets us look up eight bytes independently and combine the results, instead of going through them one by one.
+struct Table {
+    u32 data[8][256];
+
+    constexpr Table()
+        : data()
+    {
+        for (auto i = 0; i < 256; i++) {
+            u32 value = i;
+
+            for (auto j = 0; j < 8; j++) {
+                if (value & 1) {
+                    value = 0xEDB88320 ^ (value >> 1);
+                } else {
+                    value = value >> 1;
+                }
+            }
+
+            data[0][i] = value;
+        }
+
+        for (auto i = 0; i < 256; i++) {
+            for (auto k = 1; k < 8; k++)
+                data[k][i] = data[0][data[k - 1][i] & 0xFF] ^ (data[k - 1][i] >> 8);
+        }
+    }
+};
+
+constexpr static auto table = Table();
+
+static u32 update_bytewise(u32 state, const u8* data, size_t size)
+{
+    for (size_t i = 0; i < size; i++)
+        state = table.data[0][(state ^ data[i]) & 0xFF] ^ (state >> 8);
+    return state;
+}
+
+static u32 update_slicing_by_8(u32 state, const u8* data, size_t size)
+{
+    for (; size >= 8; size -= 8, data += 8) {
+        u32 low = state ^ (data[0] | (data[1] << 8) | (data[2] << 16) | ((u32)data[3] << 24));
+        u32 high = data[4] | (data[5] << 8) | (data[6] << 16) | ((u32)data[7] << 24);
+        state = table.data[7][low & 0xFF] ^ table.data[6][(low >> 8) & 0xFF] ^ table.data[5][(low >> 16) & 0xFF] ^ table.data[4][low >> 24]
+            ^ table.data[3][high & 0xFF] ^ table.data[2][(high >> 8) & 0xFF] ^ table.data[1][(high >> 16) & 0xFF] ^ table.data[0][high >> 24];
+    }
+    return update_bytewise(state, data, size);
+}
+
+#ifdef CRC32_PCLMUL_AVAILABLE
+// Folds a 128-bit chunk of the remainder forward over the next 128 (or 512) bits of input, with the constants being
+// x^(n + 32) and x^(n - 32) mod P for the distance n, bit-reflected like the CRC itself.
+// See "Fast CRC Computation for Generic Polynomials Using PCLMULQDQ Instruction" by Intel.
+[[gnu::target("pclmul,sse4.1")]] ALWAYS_INLINE static __m128i fold(__m128i chunk, __m128i constants)
+{
+    return _mm_xor_si128(_mm_clmulepi64_si128(chunk, constants, 0x00), _mm_clmulepi64_si128(chunk, constants, 0x11));
+}
+
+// Processes a multiple of 16 bytes, at least 64 of them.
+[[gnu::target("pclmul,sse4.1")]] static u32 update_pclmul(u32 state, const u8* data, size_t size)
+{
+    auto const fold_by_4_constants = _mm_set_epi64x(0x1c6e41596, 0x154442bd4);
+    auto const fold_by_1_constants = _mm_set_epi64x(0x0ccaa009e, 0x1751997d0);
+    auto const final_constant = _mm_set_epi64x(0, 0x163cd6124);
+    auto const barrett_constants = _mm_set_epi64x(0x1f7011641, 0x1db710641);
+    auto const low_32_bits = _mm_set_epi32(0, 0, 0, ~0);
+
+    auto x0 = _mm_xor_si128(_mm_loadu_si128((const __m128i*)(data + 0)), _mm_cvtsi32_si128(state));
+    auto x1 = _mm_loadu_si128((const __m128i*)(data + 16));
+    auto x2 = _mm_loadu_si128((const __m128i*)(data + 32));
+    auto x3 = _mm_loadu_si128((const __m128i*)(data + 48));
+    data += 64;
+    size -= 64;
+
+    // Four independent folds per iteration keep the carry-less multiplier busy.
+    for (; size >= 64; size -= 64, data += 64) {
+        x0 = _mm_xor_si128(fold(x0, fold_by_4_constants), _mm_loadu_si128((const __m128i*)(data + 0)));
+        x1 = _mm_xor_si128(fold(x1, fold_by_4_constants), _mm_loadu_si128((const __m128i*)(data + 16)));
+        x2 = _mm_xor_si128(fold(x2, fold_by_4_constants), _mm_loadu_si128((const __m128i*)(data + 32)));
+        x3 = _mm_xor_si128(fold(x3, fold_by_4_constants), _mm_loadu_si128((const __m128i*)(data + 48)));
+    }
+
+    x0 = _mm_xor_si128(fold(x0, fold_by_1_constants), x1);
+    x0 = _mm_xor_si128(fold(x0, fold_by_1_constants), x2);
+    x0 = _mm_xor_si128(fold(x0, fold_by_1_constants), x3);
+    for (; size >= 16; size -= 16, data += 16)
+        x0 = _mm_xor_si128(fold(x0, fold_by_1_constants), _mm_loadu_si128((const __m128i*)data));
+
+    // Fold 128 bits down to 64, then to 32 (appending the 32 zero bits the CRC definition implies)...
+    x0 = _mm_xor_si128(_mm_srli_si128(x0, 8), _mm_clmulepi64_si128(fold_by_1_constants, x0, 0x01));
+    x0 = _mm_xor_si128(_mm_srli_si128(x0, 4), _mm_clmulepi64_si128(_mm_and_si128(x0, low_32_bits), final_constant, 0x00));
+
+    // ...and finish with a Barrett reduction from 64 to 32 bits.
+    auto quotient = _mm_and_si128(_mm_clmulepi64_si128(_mm_and_si128(x0, low_32_bits), barrett_constants, 0x10), low_32_bits);
+    x0 = _mm_xor_si128(x0, _mm_clmulepi64_si128(quotient, barrett_constants, 0x00));
+    return _mm_extract_epi32(x0, 1);
+}
+#endif
+
 void CRC32::update(ReadonlyBytes data)
 {
-    for (size_t i = 0; i < data.size(); i++) {
-        m_state = table[(m_state ^ data.at(i)) & 0xFF] ^ (m_state >> 8);
+    auto* bytes = data.data();
+    auto size = data.size();
+
+#ifdef CRC32_PCLMUL_AVAILABLE
+    auto& features = CPUFeatures::the();
+    if (size >= 64 && features.has_pclmul && features.has_sse41) {
+        auto folded_size = size & ~(size_t)15;
+        m_state = update_pclmul(m_state, bytes, folded_size);
+        bytes += folded_size;
+        size -= folded_size;
     }
+#endif
+
+    m_state = update_slicing_by_8(m_state, bytes, size);
 };
 
 u32 CRC32::digest()
@@ -22,4 +139,59 @@ u32 CRC32::digest()
     return ~m_state;
 }
 
+// Appending a zero bit to the message is a linear operation on the CRC, so it can be written as a 32x32 matrix over GF(2),
+// with column i stored as a bitmask in matrix[i]. Squaring that matrix gives the operator for appending two zero bits,
+// and so on, which lets us append n zero bits in O(log n) steps. This is the same approach zlib's crc32_combine() takes.
+static u32 gf2_matrix_times(const u32* matrix, u32 vector)
+{
+    u32 sum = 0;
+    for (; vector; vector >>= 1, ++matrix) {
+        if (vector & 1)
+            sum ^= *matrix;
+    }
+    return sum;
+}
+
+static void gf2_matrix_square(u32* square, const u32* matrix)
+{
+    for (size_t i = 0; i < 32; ++i)
+        square[i] = gf2_matrix_times(matrix, matrix[i]);
+}
+
+u32 CRC32::combine(u32 first_digest, u32 second_digest, u64 second_length)
+{
+    if (second_length == 0)
+        return first_digest;
+
+    u32 even[32];
+    u32 odd[32];
+
+    // The operator for one zero bit: shift right, and reduce by the polynomial if a one fell out.
+    odd[0] = 0xEDB88320;
+    for (size_t i = 1; i < 32; ++i)
+        odd[i] = 1u << (i - 1);
+
+    gf2_matrix_square(even, odd); // two zero bits
+    gf2_matrix_square(odd, even); // four zero bits
+
+    // Append second_length zero bytes to the first CRC, one bit of the length at a time (the first square gives one byte).
+    while (true) {
+        gf2_matrix_square(even, odd);
+        if (second_length & 1)
+            first_digest = gf2_matrix_times(even, first_digest);
+        second_length >>= 1;
+        if (second_length == 0)
+            break;
+
+        gf2_matrix_square(odd, even);
+        if (second_length & 1)
+            first_digest = gf2_matrix_times(odd, first_digest);
+        second_length >>= 1;
+        if (second_length == 0)
+            break;
+    }
+
+    return first_digest ^ second_digest;
+}
+
 }
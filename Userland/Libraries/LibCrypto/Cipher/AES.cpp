@@ -4,12 +4,75 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/Platform.h>
 #include <AK/StringBuilder.h>
 #include <LibCrypto/Cipher/AES.h>
 
+// The kernel builds this file too, without any SSE.
+#if (ARCH(I386) || ARCH(X86_64)) && !defined(KERNEL)
+#    define AES_NI_AVAILABLE 1
+#    include <LibCrypto/CPUFeatures.h>
+#    include <wmmintrin.h>
+#endif
+
 namespace Crypto {
 namespace Cipher {
 
+#ifdef AES_NI_AVAILABLE
+template<bool encrypt>
+[[gnu::target("aes,sse2")]] ALWAYS_INLINE static __m128i aes_ni_round(__m128i block, __m128i key)
+{
+    if constexpr (encrypt)
+        return _mm_aesenc_si128(block, key);
+    else
+        return _mm_aesdec_si128(block, key);
+}
+
+template<bool encrypt>
+[[gnu::target("aes,sse2")]] ALWAYS_INLINE static __m128i aes_ni_last_round(__m128i block, __m128i key)
+{
+    if constexpr (encrypt)
+        return _mm_aesenclast_si128(block, key);
+    else
+        return _mm_aesdeclast_si128(block, key);
+}
+
+// The decryption key schedule is already in the form of the Equivalent Inverse Cipher (FIPS 197 section 5.3.5),
+// which is exactly what AESDEC wants, so both directions share the same loop.
+template<bool encrypt>
+[[gnu::target("aes,sse2")]] static void aes_ni_process_blocks(const u8* round_key_bytes, size_t rounds, const u8* in, u8* out, size_t block_count)
+{
+    __m128i keys[15];
+    for (size_t i = 0; i <= rounds; ++i)
+        keys[i] = _mm_loadu_si128((const __m128i*)(round_key_bytes + i * 16));
+
+    // Work on four blocks at a time, so the next block can go through the AES unit while the previous one is still in flight.
+    for (; block_count >= 4; block_count -= 4, in += 64, out += 64) {
+        __m128i b0 = _mm_xor_si128(_mm_loadu_si128((const __m128i*)(in + 0)), keys[0]);
+        __m128i b1 = _mm_xor_si128(_mm_loadu_si128((const __m128i*)(in + 16)), keys[0]);
+        __m128i b2 = _mm_xor_si128(_mm_loadu_si128((const __m128i*)(in + 32)), keys[0]);
+        __m128i b3 = _mm_xor_si128(_mm_loadu_si128((const __m128i*)(in + 48)), keys[0]);
+        for (size_t i = 1; i < rounds; ++i) {
+            b0 = aes_ni_round<encrypt>(b0, keys[i]);
+            b1 = aes_ni_round<encrypt>(b1, keys[i]);
+            b2 = aes_ni_round<encrypt>(b2, keys[i]);
+            b3 = aes_ni_round<encrypt>(b3, keys[i]);
+        }
+        _mm_storeu_si128((__m128i*)(out + 0), aes_ni_last_round<encrypt>(b0, keys[rounds]));
+        _mm_storeu_si128((__m128i*)(out + 16), aes_ni_last_round<encrypt>(b1, keys[rounds]));
+        _mm_storeu_si128((__m128i*)(out + 32), aes_ni_last_round<encrypt>(b2, keys[rounds]));
+        _mm_storeu_si128((__m128i*)(out + 48), aes_ni_last_round<encrypt>(b3, keys[rounds]));
+    }
+
+    for (; block_count > 0; --block_count, in += 16, out += 16) {
+        __m128i block = _mm_xor_si128(_mm_loadu_si128((const __m128i*)in), keys[0]);
+        for (size_t i = 1; i < rounds; ++i)
+            block = aes_ni_round<encrypt>(block, keys[i]);
+        _mm_storeu_si128((__m128i*)out, aes_ni_last_round<encrypt>(block, keys[rounds]));
+    }
+}
+#endif
+
 template<typename T>
 constexpr u32 get_key(T pt)
 {
@@ -194,8 +257,65 @@ void AESCipherKey::expand_decrypt_key(ReadonlyBytes user_key, size_t bits)
     }
 }
 
+void AESCipherKey::store_round_key_bytes()
+{
+    for (size_t i = 0; i < (rounds() + 1) * 4; ++i) {
+        m_rd_key_bytes[i * 4 + 0] = m_rd_keys[i] >> 24;
+        m_rd_key_bytes[i * 4 + 1] = m_rd_keys[i] >> 16;
+        m_rd_key_bytes[i * 4 + 2] = m_rd_keys[i] >> 8;
+        m_rd_key_bytes[i * 4 + 3] = m_rd_keys[i];
+    }
+}
+
+void AESCipher::encrypt_blocks(ReadonlyBytes in, Bytes out)
+{
+    VERIFY(in.size() % block_size() == 0);
+    VERIFY(out.size() >= in.size());
+
+#ifdef AES_NI_AVAILABLE
+    if (CPUFeatures::the().has_aes_ni) {
+        aes_ni_process_blocks<true>(m_key.round_key_bytes(), m_key.rounds(), in.data(), out.data(), in.size() / block_size());
+        return;
+    }
+#endif
+
+    AESCipherBlock block;
+    for (size_t offset = 0; offset < in.size(); offset += block_size()) {
+        block.overwrite(in.slice(offset, block_size()));
+        encrypt_block(block, block);
+        __builtin_memcpy(out.offset(offset), block.bytes().data(), block_size());
+    }
+}
+
+void AESCipher::decrypt_blocks(ReadonlyBytes in, Bytes out)
+{
+    VERIFY(in.size() % block_size() == 0);
+    VERIFY(out.size() >= in.size());
+
+#ifdef AES_NI_AVAILABLE
+    if (CPUFeatures::the().has_aes_ni) {
+        aes_ni_process_blocks<false>(m_key.round_key_bytes(), m_key.rounds(), in.data(), out.data(), in.size() / block_size());
+        return;
+    }
+#endif
+
+    AESCipherBlock block;
+    for (size_t offset = 0; offset < in.size(); offset += block_size()) {
+        block.overwrite(in.slice(offset, block_size()));
+        decrypt_block(block, block);
+        __builtin_memcpy(out.offset(offset), block.bytes().data(), block_size());
+    }
+}
+
 void AESCipher::encrypt_block(const AESCipherBlock& in, AESCipherBlock& out)
 {
+#ifdef AES_NI_AVAILABLE
+    if (CPUFeatures::the().has_aes_ni) {
+        aes_ni_process_blocks<true>(m_key.round_key_bytes(), m_key.rounds(), in.bytes().data(), out.bytes().data(), 1);
+        return;
+    }
+#endif
+
     u32 s0, s1, s2, s3, t0, t1, t2, t3;
     size_t r { 0 };
 
@@ -288,6 +408,13 @@ void AESCipher::encrypt_block(const AESCipherBlock& in, AESCipherBlock& out)
 
 void AESCipher::decrypt_block(const AESCipherBlock& in, AESCipherBlock& out)
 {
+#ifdef AES_NI_AVAILABLE
+    if (CPUFeatures::the().has_aes_ni) {
+        aes_ni_process_blocks<false>(m_key.round_key_bytes(), m_key.rounds(), in.bytes().data(), out.bytes().data(), 1);
+        return;
+    }
+#endif
+
     u32 s0, s1, s2, s3, t0, t1, t2, t3;
     size_t r { 0 };
 
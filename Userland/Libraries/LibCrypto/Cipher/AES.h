@@ -62,6 +62,9 @@ struct AESCipherKey : public CipherKey {
         return (const u32*)m_rd_keys;
     }
 
+    // The same round keys, laid out byte by byte the way AES-NI expects them.
+    const u8* round_key_bytes() const { return m_rd_key_bytes; }
+
     AESCipherKey(ReadonlyBytes user_key, size_t key_bits, Intent intent)
         : m_bits(key_bits)
     {
@@ -69,6 +72,7 @@ struct AESCipherKey : public CipherKey {
             expand_encrypt_key(user_key, key_bits);
         else
             expand_decrypt_key(user_key, key_bits);
+        store_round_key_bytes();
     }
 
     virtual ~AESCipherKey() override { }
@@ -83,8 +87,11 @@ protected:
     }
 
 private:
+    void store_round_key_bytes();
+
     static constexpr size_t MAX_ROUND_COUNT = 14;
     u32 m_rd_keys[(MAX_ROUND_COUNT + 1) * 4] { 0 };
+    u8 m_rd_key_bytes[(MAX_ROUND_COUNT + 1) * 16] { 0 };
     size_t m_rounds;
     size_t m_bits;
 };
@@ -109,6 +116,10 @@ public:
     virtual void encrypt_block(const BlockType& in, BlockType& out) override;
     virtual void decrypt_block(const BlockType& in, BlockType& out) override;
 
+    // Encrypt or decrypt a run of whole blocks at once, which lets AES-NI keep several blocks in flight.
+    void encrypt_blocks(ReadonlyBytes in, Bytes out);
+    void decrypt_blocks(ReadonlyBytes in, Bytes out);
+
     virtual String class_name() const override { return "AES"; }
 
 protected:
@@ -97,6 +97,36 @@ public:
         m_cipher_block.set_padding_mode(cipher.padding_mode());
         size_t offset { 0 };
 
+        // Unlike encryption, decryption doesn't depend on the previous block's output, so ciphers that
+        // can decrypt a run of blocks in one go get to do so.
+        if constexpr (requires { cipher.decrypt_blocks(ReadonlyBytes {}, Bytes {}); }) {
+            constexpr size_t batch_size = 8 * T::block_size();
+            u8 decrypted[batch_size];
+            u8 last_block[T::block_size()];
+            u8 next_iv[T::block_size()];
+
+            while (length > 0) {
+                size_t batch_length = min(batch_size, length);
+                auto batch = in.slice(offset, batch_length);
+                cipher.decrypt_blocks(batch, { decrypted, batch_length });
+
+                // Hold on to the last ciphertext block before writing anything out, in case we're decrypting in place.
+                __builtin_memcpy(last_block, batch.offset(batch_length - block_size), block_size);
+                VERIFY(offset + batch_length <= out.size());
+                for (size_t i = batch_length; i > block_size;) {
+                    --i;
+                    out[offset + i] = decrypted[i] ^ batch[i - block_size];
+                }
+                for (size_t i = 0; i < block_size; ++i)
+                    out[offset + i] = decrypted[i] ^ iv[i];
+
+                __builtin_memcpy(next_iv, last_block, block_size);
+                iv = { next_iv, block_size };
+                length -= batch_length;
+                offset += batch_length;
+            }
+        }
+
         while (length > 0) {
             auto slice = in.slice(offset);
             m_cipher_block.overwrite(slice.data(), block_size);
@@ -163,6 +163,33 @@ protected:
         size_t offset { 0 };
         auto block_size = cipher.block_size();
 
+        // Ciphers that can encrypt a run of blocks in one go get a batch of counter blocks at a time.
+        if constexpr (requires { cipher.encrypt_blocks(ReadonlyBytes {}, Bytes {}); }) {
+            constexpr size_t batch_size = 8 * T::block_size();
+            u8 counters[batch_size];
+            u8 key_stream[batch_size];
+
+            while (length >= block_size) {
+                size_t batch_length = min(batch_size, length - length % block_size);
+                for (size_t i = 0; i < batch_length; i += block_size) {
+                    __builtin_memcpy(counters + i, iv.data(), block_size);
+                    increment(iv);
+                }
+                cipher.encrypt_blocks({ counters, batch_length }, { key_stream, batch_length });
+
+                VERIFY(offset + batch_length <= out.size());
+                if (in) {
+                    for (size_t i = 0; i < batch_length; ++i)
+                        out[offset + i] = (*in)[offset + i] ^ key_stream[i];
+                } else {
+                    __builtin_memcpy(out.offset(offset), key_stream, batch_length);
+                }
+
+                length -= batch_length;
+                offset += batch_length;
+            }
+        }
+
         while (length > 0) {
             m_cipher_block.overwrite(iv.slice(0, block_size));
 
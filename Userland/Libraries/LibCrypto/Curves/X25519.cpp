@@ -0,0 +1,213 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Random.h>
+#include <LibCrypto/Curves/X25519.h>
+
+namespace Crypto::Curves {
+
+// Field elements modulo 2^255 - 19 are stored as 16 limbs of 16 bits each, in signed 64-bit integers.
+// That leaves enough headroom to multiply without carrying in between, and nothing below ever branches
+// or indexes memory based on secret data.
+using FieldElement = i64[16];
+
+static constexpr FieldElement a24 = { 0xdb41, 1 }; // (486662 - 2) / 4 = 121665
+
+static void carry(FieldElement element)
+{
+    for (size_t i = 0; i < 16; ++i) {
+        element[i] += (i64)1 << 16;
+        i64 carry = element[i] >> 16;
+        // The carry out of the top limb wraps around as 2^256 = 38 (mod p).
+        if (i < 15)
+            element[i + 1] += carry - 1;
+        else
+            element[0] += 38 * (carry - 1);
+        element[i] -= carry << 16;
+    }
+}
+
+// Swaps a and b if swap is 1, and does nothing if it's 0, in constant time.
+static void conditional_swap(FieldElement a, FieldElement b, i64 swap)
+{
+    i64 mask = ~(swap - 1);
+    for (size_t i = 0; i < 16; ++i) {
+        i64 t = mask & (a[i] ^ b[i]);
+        a[i] ^= t;
+        b[i] ^= t;
+    }
+}
+
+static void unpack(FieldElement out, const u8* bytes)
+{
+    for (size_t i = 0; i < 16; ++i)
+        out[i] = bytes[2 * i] + ((i64)bytes[2 * i + 1] << 8);
+    // RFC 7748 section 5: The most significant bit of the u-coordinate is masked.
+    out[15] &= 0x7fff;
+}
+
+static void pack(u8* bytes, const FieldElement element)
+{
+    FieldElement t;
+    FieldElement m;
+    for (size_t i = 0; i < 16; ++i)
+        t[i] = element[i];
+    carry(t);
+    carry(t);
+    carry(t);
+
+    // Fully reduce by subtracting p (at most twice), keeping the result only if it didn't go negative.
+    for (size_t j = 0; j < 2; ++j) {
+        m[0] = t[0] - 0xffed;
+        for (size_t i = 1; i < 15; ++i) {
+            m[i] = t[i] - 0xffff - ((m[i - 1] >> 16) & 1);
+            m[i - 1] &= 0xffff;
+        }
+        m[15] = t[15] - 0x7fff - ((m[14] >> 16) & 1);
+        i64 borrow = (m[15] >> 16) & 1;
+        m[14] &= 0xffff;
+        conditional_swap(t, m, 1 - borrow);
+    }
+
+    for (size_t i = 0; i < 16; ++i) {
+        bytes[2 * i] = t[i] & 0xff;
+        bytes[2 * i + 1] = (t[i] >> 8) & 0xff;
+    }
+}
+
+static void add(FieldElement out, const FieldElement a, const FieldElement b)
+{
+    for (size_t i = 0; i < 16; ++i)
+        out[i] = a[i] + b[i];
+}
+
+static void subtract(FieldElement out, const FieldElement a, const FieldElement b)
+{
+    for (size_t i = 0; i < 16; ++i)
+        out[i] = a[i] - b[i];
+}
+
+static void multiply(FieldElement out, const FieldElement a, const FieldElement b)
+{
+    i64 product[31] = {};
+    for (size_t i = 0; i < 16; ++i) {
+        for (size_t j = 0; j < 16; ++j)
+            product[i + j] += a[i] * b[j];
+    }
+    for (size_t i = 0; i < 15; ++i)
+        product[i] += 38 * product[i + 16];
+    for (size_t i = 0; i < 16; ++i)
+        out[i] = product[i];
+    carry(out);
+    carry(out);
+}
+
+static void square(FieldElement out, const FieldElement a)
+{
+    multiply(out, a, a);
+}
+
+// Computes a^(p - 2), which is the inverse of a by Fermat's little theorem.
+static void invert(FieldElement out, const FieldElement a)
+{
+    FieldElement c;
+    for (size_t i = 0; i < 16; ++i)
+        c[i] = a[i];
+    for (int i = 253; i >= 0; --i) {
+        square(c, c);
+        if (i != 2 && i != 4)
+            multiply(c, c, a);
+    }
+    for (size_t i = 0; i < 16; ++i)
+        out[i] = c[i];
+}
+
+// RFC 7748 section 5: The Montgomery ladder.
+static void scalar_multiply(u8* out, const u8* scalar, const u8* point)
+{
+    u8 clamped[32];
+    for (size_t i = 0; i < 32; ++i)
+        clamped[i] = scalar[i];
+    clamped[0] &= 248;
+    clamped[31] = (clamped[31] & 127) | 64;
+
+    FieldElement x1;
+    unpack(x1, point);
+
+    FieldElement x2 = { 1 };
+    FieldElement z2 = {};
+    FieldElement x3;
+    FieldElement z3 = { 1 };
+    for (size_t i = 0; i < 16; ++i)
+        x3[i] = x1[i];
+
+    FieldElement a, aa, b, bb, e, c, d, da, cb;
+    for (int t = 254; t >= 0; --t) {
+        i64 bit = (clamped[t >> 3] >> (t & 7)) & 1;
+        conditional_swap(x2, x3, bit);
+        conditional_swap(z2, z3, bit);
+
+        add(a, x2, z2);
+        square(aa, a);
+        subtract(b, x2, z2);
+        square(bb, b);
+        subtract(e, aa, bb);
+        add(c, x3, z3);
+        subtract(d, x3, z3);
+        multiply(da, d, a);
+        multiply(cb, c, b);
+
+        add(x3, da, cb);
+        square(x3, x3);
+        subtract(z3, da, cb);
+        square(z3, z3);
+        multiply(z3, z3, x1);
+        multiply(x2, aa, bb);
+        multiply(z2, a24, e);
+        add(z2, z2, aa);
+        multiply(z2, z2, e);
+
+        conditional_swap(x2, x3, bit);
+        conditional_swap(z2, z3, bit);
+    }
+
+    invert(z2, z2);
+    multiply(x2, x2, z2);
+    pack(out, x2);
+}
+
+ByteBuffer X25519::generate_private_key()
+{
+    auto buffer = ByteBuffer::create_uninitialized(key_size);
+    fill_with_random(buffer.data(), key_size);
+    return buffer;
+}
+
+ByteBuffer X25519::generate_public_key(ReadonlyBytes private_key)
+{
+    u8 base_point[key_size] = { 9 };
+    return compute_coordinate(private_key, { base_point, key_size });
+}
+
+ByteBuffer X25519::compute_coordinate(ReadonlyBytes private_key, ReadonlyBytes public_key)
+{
+    if (private_key.size() != key_size || public_key.size() != key_size)
+        return {};
+
+    auto result = ByteBuffer::create_uninitialized(key_size);
+    scalar_multiply(result.data(), private_key.data(), public_key.data());
+
+    // RFC 7748 section 6.1: Reject the all-zero output, which is what points of small order lead to.
+    u8 all_bits = 0;
+    for (auto byte : result.bytes())
+        all_bits |= byte;
+    if (!all_bits)
+        return {};
+
+    return result;
+}
+
+}
@@ -0,0 +1,24 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/ByteBuffer.h>
+
+namespace Crypto::Curves {
+
+// Diffie-Hellman on Curve25519, as defined in RFC 7748.
+class X25519 {
+public:
+    static constexpr size_t key_size = 32;
+
+    static ByteBuffer generate_private_key();
+    static ByteBuffer generate_public_key(ReadonlyBytes private_key);
+    // Returns the shared secret, or an empty buffer if the peer sent us a point of small order.
+    static ByteBuffer compute_coordinate(ReadonlyBytes private_key, ReadonlyBytes public_key);
+};
+
+}
@@ -5,9 +5,16 @@
  */
 
 #include <AK/Endian.h>
+#include <AK/Platform.h>
 #include <AK/Types.h>
 #include <LibCrypto/Hash/SHA1.h>
 
+#if ARCH(I386) || ARCH(X86_64)
+#    define SHA_NI_AVAILABLE 1
+#    include <LibCrypto/CPUFeatures.h>
+#    include <immintrin.h>
+#endif
+
 namespace Crypto {
 namespace Hash {
 
@@ -16,40 +23,120 @@ static constexpr auto ROTATE_LEFT(u32 value, size_t bits)
     return (value << bits) | (value >> (32 - bits));
 }
 
+#ifdef SHA_NI_AVAILABLE
+// Does four rounds with the given round function, and returns the previous ABCD, which is what the next E gets derived from.
+template<int function>
+[[gnu::target("sha,sse4.1")]] ALWAYS_INLINE static __m128i sha1_ni_four_rounds(__m128i& abcd, __m128i e_and_message)
+{
+    auto previous_abcd = abcd;
+    abcd = _mm_sha1rnds4_epu32(abcd, e_and_message, function);
+    return previous_abcd;
+}
+
+// Expands the next four words of the message schedule from the sixteen before them.
+[[gnu::target("sha,sse4.1")]] ALWAYS_INLINE static __m128i sha1_ni_next_message(__m128i w0, __m128i w1, __m128i w2, __m128i w3)
+{
+    return _mm_sha1msg2_epu32(_mm_xor_si128(_mm_sha1msg1_epu32(w0, w1), w2), w3);
+}
+
+[[gnu::target("sha,sse4.1")]] static void sha1_ni_transform_blocks(u32* state, const u8* data, size_t block_count)
+{
+    auto const byte_swap = _mm_set_epi64x(0x0001020304050607ULL, 0x08090a0b0c0d0e0fULL);
+
+    auto abcd = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*)state), 0x1b);
+    auto e0 = _mm_set_epi32(state[4], 0, 0, 0);
+
+    for (; block_count > 0; --block_count, data += 64) {
+        auto saved_abcd = abcd;
+        auto saved_e0 = e0;
+
+        auto w0 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data + 0)), byte_swap);
+        auto w1 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data + 16)), byte_swap);
+        auto w2 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data + 32)), byte_swap);
+        auto w3 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data + 48)), byte_swap);
+
+        auto e = sha1_ni_four_rounds<0>(abcd, _mm_add_epi32(e0, w0));
+        e = sha1_ni_four_rounds<0>(abcd, _mm_sha1nexte_epu32(e, w1));
+        e = sha1_ni_four_rounds<0>(abcd, _mm_sha1nexte_epu32(e, w2));
+        e = sha1_ni_four_rounds<0>(abcd, _mm_sha1nexte_epu32(e, w3));
+        w0 = sha1_ni_next_message(w0, w1, w2, w3);
+        e = sha1_ni_four_rounds<0>(abcd, _mm_sha1nexte_epu32(e, w0));
+
+        w1 = sha1_ni_next_message(w1, w2, w3, w0);
+        e = sha1_ni_four_rounds<1>(abcd, _mm_sha1nexte_epu32(e, w1));
+        w2 = sha1_ni_next_message(w2, w3, w0, w1);
+        e = sha1_ni_four_rounds<1>(abcd, _mm_sha1nexte_epu32(e, w2));
+        w3 = sha1_ni_next_message(w3, w0, w1, w2);
+        e = sha1_ni_four_rounds<1>(abcd, _mm_sha1nexte_epu32(e, w3));
+        w0 = sha1_ni_next_message(w0, w1, w2, w3);
+        e = sha1_ni_four_rounds<1>(abcd, _mm_sha1nexte_epu32(e, w0));
+        w1 = sha1_ni_next_message(w1, w2, w3, w0);
+        e = sha1_ni_four_rounds<1>(abcd, _mm_sha1nexte_epu32(e, w1));
+
+        w2 = sha1_ni_next_message(w2, w3, w0, w1);
+        e = sha1_ni_four_rounds<2>(abcd, _mm_sha1nexte_epu32(e, w2));
+        w3 = sha1_ni_next_message(w3, w0, w1, w2);
+        e = sha1_ni_four_rounds<2>(abcd, _mm_sha1nexte_epu32(e, w3));
+        w0 = sha1_ni_next_message(w0, w1, w2, w3);
+        e = sha1_ni_four_rounds<2>(abcd, _mm_sha1nexte_epu32(e, w0));
+        w1 = sha1_ni_next_message(w1, w2, w3, w0);
+        e = sha1_ni_four_rounds<2>(abcd, _mm_sha1nexte_epu32(e, w1));
+        w2 = sha1_ni_next_message(w2, w3, w0, w1);
+        e = sha1_ni_four_rounds<2>(abcd, _mm_sha1nexte_epu32(e, w2));
+
+        w3 = sha1_ni_next_message(w3, w0, w1, w2);
+        e = sha1_ni_four_rounds<3>(abcd, _mm_sha1nexte_epu32(e, w3));
+        w0 = sha1_ni_next_message(w0, w1, w2, w3);
+        e = sha1_ni_four_rounds<3>(abcd, _mm_sha1nexte_epu32(e, w0));
+        w1 = sha1_ni_next_message(w1, w2, w3, w0);
+        e = sha1_ni_four_rounds<3>(abcd, _mm_sha1nexte_epu32(e, w1));
+        w2 = sha1_ni_next_message(w2, w3, w0, w1);
+        e = sha1_ni_four_rounds<3>(abcd, _mm_sha1nexte_epu32(e, w2));
+        w3 = sha1_ni_next_message(w3, w0, w1, w2);
+        e = sha1_ni_four_rounds<3>(abcd, _mm_sha1nexte_epu32(e, w3));
+
+        e0 = _mm_sha1nexte_epu32(e, saved_e0);
+        abcd = _mm_add_epi32(abcd, saved_abcd);
+    }
+
+    _mm_storeu_si128((__m128i*)state, _mm_shuffle_epi32(abcd, 0x1b));
+    state[4] = _mm_extract_epi32(e0, 3);
+}
+#endif
+
 inline void SHA1::transform(const u8* data)
 {
     u32 blocks[80];
-    for (size_t i = 0; i < 16; ++i)
-        blocks[i] = AK::convert_between_host_and_network_endian(((const u32*)data)[i]);
+    // The data comes straight from the caller's buffer, so it might not be aligned.
+    for (size_t i = 0; i < 16; ++i) {
+        u32 word;
+        __builtin_memcpy(&word, data + i * sizeof(u32), sizeof(u32));
+        blocks[i] = AK::convert_between_host_and_network_endian(word);
+    }
 
     // w[i] = (w[i-3] xor w[i-8] xor w[i-14] xor w[i-16]) leftrotate 1
     for (size_t i = 16; i < Rounds; ++i)
         blocks[i] = ROTATE_LEFT(blocks[i - 3] ^ blocks[i - 8] ^ blocks[i - 14] ^ blocks[i - 16], 1);
 
     auto a = m_state[0], b = m_state[1], c = m_state[2], d = m_state[3], e = m_state[4];
-    u32 f, k;
-
-    for (size_t i = 0; i < Rounds; ++i) {
-        if (i <= 19) {
-            f = (b & c) | ((~b) & d);
-            k = SHA1Constants::RoundConstants[0];
-        } else if (i <= 39) {
-            f = b ^ c ^ d;
-            k = SHA1Constants::RoundConstants[1];
-        } else if (i <= 59) {
-            f = (b & c) | (b & d) | (c & d);
-            k = SHA1Constants::RoundConstants[2];
-        } else {
-            f = b ^ c ^ d;
-            k = SHA1Constants::RoundConstants[3];
-        }
+
+    // Each group of twenty rounds gets its own loop, so the round function doesn't have to be picked every round.
+    auto round = [&](size_t i, u32 f, u32 k) {
         auto temp = ROTATE_LEFT(a, 5) + f + e + k + blocks[i];
         e = d;
         d = c;
         c = ROTATE_LEFT(b, 30);
         b = a;
         a = temp;
-    }
+    };
+    for (size_t i = 0; i < 20; ++i)
+        round(i, (b & c) | ((~b) & d), SHA1Constants::RoundConstants[0]);
+    for (size_t i = 20; i < 40; ++i)
+        round(i, b ^ c ^ d, SHA1Constants::RoundConstants[1]);
+    for (size_t i = 40; i < 60; ++i)
+        round(i, (b & c) | (b & d) | (c & d), SHA1Constants::RoundConstants[2]);
+    for (size_t i = 60; i < Rounds; ++i)
+        round(i, b ^ c ^ d, SHA1Constants::RoundConstants[3]);
 
     m_state[0] += a;
     m_state[1] += b;
@@ -66,16 +153,46 @@ inline void SHA1::transform(const u8* data)
     __builtin_memset(blocks, 0, 16 * sizeof(u32));
 }
 
+void SHA1::transform_blocks(const u8* data, size_t block_count)
+{
+#ifdef SHA_NI_AVAILABLE
+    auto& features = CPUFeatures::the();
+    if (features.has_sha && features.has_sse41 && features.has_ssse3) {
+        sha1_ni_transform_blocks(m_state, data, block_count);
+        return;
+    }
+#endif
+    for (; block_count > 0; --block_count, data += BlockSize)
+        transform(data);
+}
+
 void SHA1::update(const u8* message, size_t length)
 {
-    for (size_t i = 0; i < length; ++i) {
-        if (m_data_length == BlockSize) {
-            transform(m_data_buffer);
-            m_bit_length += 512;
-            m_data_length = 0;
-        }
-        m_data_buffer[m_data_length++] = message[i];
+    if (length == 0)
+        return;
+
+    if (m_data_length > 0) {
+        auto fill_length = min(length, BlockSize - m_data_length);
+        __builtin_memcpy(m_data_buffer + m_data_length, message, fill_length);
+        m_data_length += fill_length;
+        message += fill_length;
+        length -= fill_length;
+        if (m_data_length < BlockSize)
+            return;
+        transform_blocks(m_data_buffer, 1);
+        m_bit_length += BlockSize * 8;
+        m_data_length = 0;
     }
+
+    // Whole blocks get hashed straight out of the message, without going through the buffer.
+    auto block_count = length / BlockSize;
+    transform_blocks(message, block_count);
+    m_bit_length += block_count * BlockSize * 8;
+    message += block_count * BlockSize;
+    length -= block_count * BlockSize;
+
+    __builtin_memcpy(m_data_buffer, message, length);
+    m_data_length = length;
 }
 
 SHA1::DigestType SHA1::digest()
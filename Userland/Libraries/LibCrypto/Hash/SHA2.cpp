@@ -4,9 +4,17 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/Platform.h>
 #include <AK/Types.h>
 #include <LibCrypto/Hash/SHA2.h>
 
+// The kernel builds this file too, without any SSE.
+#if (ARCH(I386) || ARCH(X86_64)) && !defined(KERNEL)
+#    define SHA_NI_AVAILABLE 1
+#    include <LibCrypto/CPUFeatures.h>
+#    include <immintrin.h>
+#endif
+
 namespace Crypto {
 namespace Hash {
 constexpr static auto ROTRIGHT(u32 a, size_t b) { return (a >> b) | (a << (32 - b)); }
@@ -25,6 +33,65 @@ constexpr static auto EP1(u64 x) { return ROTRIGHT(x, 14) ^ ROTRIGHT(x, 18) ^ RO
 constexpr static auto SIGN0(u64 x) { return ROTRIGHT(x, 1) ^ ROTRIGHT(x, 8) ^ (x >> 7); }
 constexpr static auto SIGN1(u64 x) { return ROTRIGHT(x, 19) ^ ROTRIGHT(x, 61) ^ (x >> 6); }
 
+#ifdef SHA_NI_AVAILABLE
+// The SHA extensions keep the state split across two registers as ABEF and CDGH, and do two rounds per SHA256RNDS2.
+[[gnu::target("sha,sse4.1")]] ALWAYS_INLINE static void sha256_ni_four_rounds(__m128i& abef, __m128i& cdgh, __m128i message, size_t round)
+{
+    auto message_and_constants = _mm_add_epi32(message, _mm_loadu_si128((const __m128i*)&SHA256Constants::RoundConstants[round]));
+    cdgh = _mm_sha256rnds2_epu32(cdgh, abef, message_and_constants);
+    abef = _mm_sha256rnds2_epu32(abef, cdgh, _mm_shuffle_epi32(message_and_constants, 0x0e));
+}
+
+// Expands the next four words of the message schedule from the sixteen before them.
+[[gnu::target("sha,sse4.1")]] ALWAYS_INLINE static __m128i sha256_ni_next_message(__m128i w0, __m128i w1, __m128i w2, __m128i w3)
+{
+    return _mm_sha256msg2_epu32(_mm_add_epi32(_mm_sha256msg1_epu32(w0, w1), _mm_alignr_epi8(w3, w2, 4)), w3);
+}
+
+[[gnu::target("sha,sse4.1")]] static void sha256_ni_transform_blocks(u32* state, const u8* data, size_t block_count)
+{
+    auto const byte_swap = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+
+    auto dcba = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*)&state[0]), 0xb1);
+    auto efgh = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*)&state[4]), 0x1b);
+    auto abef = _mm_alignr_epi8(dcba, efgh, 8);
+    auto cdgh = _mm_blend_epi16(efgh, dcba, 0xf0);
+
+    for (; block_count > 0; --block_count, data += 64) {
+        auto saved_abef = abef;
+        auto saved_cdgh = cdgh;
+
+        auto w0 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data + 0)), byte_swap);
+        auto w1 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data + 16)), byte_swap);
+        auto w2 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data + 32)), byte_swap);
+        auto w3 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data + 48)), byte_swap);
+        sha256_ni_four_rounds(abef, cdgh, w0, 0);
+        sha256_ni_four_rounds(abef, cdgh, w1, 4);
+        sha256_ni_four_rounds(abef, cdgh, w2, 8);
+        sha256_ni_four_rounds(abef, cdgh, w3, 12);
+
+        for (size_t round = 16; round < 64; round += 16) {
+            w0 = sha256_ni_next_message(w0, w1, w2, w3);
+            sha256_ni_four_rounds(abef, cdgh, w0, round);
+            w1 = sha256_ni_next_message(w1, w2, w3, w0);
+            sha256_ni_four_rounds(abef, cdgh, w1, round + 4);
+            w2 = sha256_ni_next_message(w2, w3, w0, w1);
+            sha256_ni_four_rounds(abef, cdgh, w2, round + 8);
+            w3 = sha256_ni_next_message(w3, w0, w1, w2);
+            sha256_ni_four_rounds(abef, cdgh, w3, round + 12);
+        }
+
+        abef = _mm_add_epi32(abef, saved_abef);
+        cdgh = _mm_add_epi32(cdgh, saved_cdgh);
+    }
+
+    auto feba = _mm_shuffle_epi32(abef, 0x1b);
+    auto dchg = _mm_shuffle_epi32(cdgh, 0xb1);
+    _mm_storeu_si128((__m128i*)&state[0], _mm_blend_epi16(feba, dchg, 0xf0));
+    _mm_storeu_si128((__m128i*)&state[4], _mm_alignr_epi8(dchg, feba, 8));
+}
+#endif
+
 inline void SHA256::transform(const u8* data)
 {
     u32 m[64];
@@ -66,26 +133,63 @@ inline void SHA256::transform(const u8* data)
     m_state[7] += h;
 }
 
+void SHA256::transform_blocks(const u8* data, size_t block_count)
+{
+#ifdef SHA_NI_AVAILABLE
+    auto& features = CPUFeatures::the();
+    if (features.has_sha && features.has_sse41 && features.has_ssse3) {
+        sha256_ni_transform_blocks(m_state, data, block_count);
+        return;
+    }
+#endif
+    for (; block_count > 0; --block_count, data += BlockSize)
+        transform(data);
+}
+
 void SHA256::update(const u8* message, size_t length)
 {
-    for (size_t i = 0; i < length; ++i) {
-        if (m_data_length == BlockSize) {
-            transform(m_data_buffer);
-            m_bit_length += 512;
-            m_data_length = 0;
-        }
-        m_data_buffer[m_data_length++] = message[i];
+    if (length == 0)
+        return;
+
+    if (m_data_length > 0) {
+        auto fill_length = min(length, BlockSize - m_data_length);
+        __builtin_memcpy(m_data_buffer + m_data_length, message, fill_length);
+        m_data_length += fill_length;
+        message += fill_length;
+        length -= fill_length;
+        if (m_data_length < BlockSize)
+            return;
+        transform_blocks(m_data_buffer, 1);
+        m_bit_length += BlockSize * 8;
+        m_data_length = 0;
     }
+
+    // Whole blocks get hashed straight out of the message, without going through the buffer.
+    auto block_count = length / BlockSize;
+    transform_blocks(message, block_count);
+    m_bit_length += block_count * BlockSize * 8;
+    message += block_count * BlockSize;
+    length -= block_count * BlockSize;
+
+    __builtin_memcpy(m_data_buffer, message, length);
+    m_data_length = length;
 }
 
 SHA256::DigestType SHA256::digest()
 {
-    auto digest = peek();
+    auto digest = finish();
     reset();
     return digest;
 }
 
 SHA256::DigestType SHA256::peek()
+{
+    // Finish a copy, so that more data can still be added to this one afterwards.
+    auto copy = *this;
+    return copy.finish();
+}
+
+SHA256::DigestType SHA256::finish()
 {
     DigestType digest;
     size_t i = m_data_length;
@@ -184,26 +288,56 @@ inline void SHA384::transform(const u8* data)
     m_state[7] += h;
 }
 
+void SHA384::transform_blocks(const u8* data, size_t block_count)
+{
+    for (; block_count > 0; --block_count, data += BlockSize)
+        transform(data);
+}
+
 void SHA384::update(const u8* message, size_t length)
 {
-    for (size_t i = 0; i < length; ++i) {
-        if (m_data_length == BlockSize) {
-            transform(m_data_buffer);
-            m_bit_length += 1024;
-            m_data_length = 0;
-        }
-        m_data_buffer[m_data_length++] = message[i];
+    if (length == 0)
+        return;
+
+    if (m_data_length > 0) {
+        auto fill_length = min(length, BlockSize - m_data_length);
+        __builtin_memcpy(m_data_buffer + m_data_length, message, fill_length);
+        m_data_length += fill_length;
+        message += fill_length;
+        length -= fill_length;
+        if (m_data_length < BlockSize)
+            return;
+        transform_blocks(m_data_buffer, 1);
+        m_bit_length += BlockSize * 8;
+        m_data_length = 0;
     }
+
+    // Whole blocks get hashed straight out of the message, without going through the buffer.
+    auto block_count = length / BlockSize;
+    transform_blocks(message, block_count);
+    m_bit_length += block_count * BlockSize * 8;
+    message += block_count * BlockSize;
+    length -= block_count * BlockSize;
+
+    __builtin_memcpy(m_data_buffer, message, length);
+    m_data_length = length;
 }
 
 SHA384::DigestType SHA384::digest()
 {
-    auto digest = peek();
+    auto digest = finish();
     reset();
     return digest;
 }
 
 SHA384::DigestType SHA384::peek()
+{
+    // Finish a copy, so that more data can still be added to this one afterwards.
+    auto copy = *this;
+    return copy.finish();
+}
+
+SHA384::DigestType SHA384::finish()
 {
     DigestType digest;
     size_t i = m_data_length;
@@ -299,26 +433,56 @@ inline void SHA512::transform(const u8* data)
     m_state[7] += h;
 }
 
+void SHA512::transform_blocks(const u8* data, size_t block_count)
+{
+    for (; block_count > 0; --block_count, data += BlockSize)
+        transform(data);
+}
+
 void SHA512::update(const u8* message, size_t length)
 {
-    for (size_t i = 0; i < length; ++i) {
-        if (m_data_length == BlockSize) {
-            transform(m_data_buffer);
-            m_bit_length += 1024;
-            m_data_length = 0;
-        }
-        m_data_buffer[m_data_length++] = message[i];
+    if (length == 0)
+        return;
+
+    if (m_data_length > 0) {
+        auto fill_length = min(length, BlockSize - m_data_length);
+        __builtin_memcpy(m_data_buffer + m_data_length, message, fill_length);
+        m_data_length += fill_length;
+        message += fill_length;
+        length -= fill_length;
+        if (m_data_length < BlockSize)
+            return;
+        transform_blocks(m_data_buffer, 1);
+        m_bit_length += BlockSize * 8;
+        m_data_length = 0;
     }
+
+    // Whole blocks get hashed straight out of the message, without going through the buffer.
+    auto block_count = length / BlockSize;
+    transform_blocks(message, block_count);
+    m_bit_length += block_count * BlockSize * 8;
+    message += block_count * BlockSize;
+    length -= block_count * BlockSize;
+
+    __builtin_memcpy(m_data_buffer, message, length);
+    m_data_length = length;
 }
 
 SHA512::DigestType SHA512::digest()
 {
-    auto digest = peek();
+    auto digest = finish();
     reset();
     return digest;
 }
 
 SHA512::DigestType SHA512::peek()
+{
+    // Finish a copy, so that more data can still be added to this one afterwards.
+    auto copy = *this;
+    return copy.finish();
+}
+
+SHA512::DigestType SHA512::finish()
 {
     DigestType digest;
     size_t i = m_data_length;
@@ -119,7 +119,9 @@ public:
     }
 
 private:
+    DigestType finish();
     inline void transform(const u8*);
+    void transform_blocks(const u8*, size_t block_count);
 
     u8 m_data_buffer[BlockSize] {};
     size_t m_data_length { 0 };
@@ -169,7 +171,9 @@ public:
     }
 
 private:
+    DigestType finish();
     inline void transform(const u8*);
+    void transform_blocks(const u8*, size_t block_count);
 
     u8 m_data_buffer[BlockSize] {};
     size_t m_data_length { 0 };
@@ -219,7 +223,9 @@ public:
     }
 
 private:
+    DigestType finish();
     inline void transform(const u8*);
+    void transform_blocks(const u8*, size_t block_count);
 
     u8 m_data_buffer[BlockSize] {};
     size_t m_data_length { 0 };
@@ -51,33 +51,23 @@ static LaunchServerConnection& connection()
     return connection;
 }
 
+// Applications set up their allowlist with a few of these calls at startup. They're pipelined, and any failure
+// shows up in seal_allowlist(), which waits for the server to have handled everything sent before it.
 bool Launcher::add_allowed_url(const URL& url)
 {
-    auto response_or_error = connection().try_add_allowed_url(url);
-    if (response_or_error.is_error()) {
-        dbgln("Launcher::add_allowed_url: Failed");
-        return false;
-    }
+    connection().async_add_allowed_url(url, [](auto&) {});
     return true;
 }
 
 bool Launcher::add_allowed_handler_with_any_url(const String& handler)
 {
-    auto response_or_error = connection().try_add_allowed_handler_with_any_url(handler);
-    if (response_or_error.is_error()) {
-        dbgln("Launcher::add_allowed_handler_with_any_url: Failed");
-        return false;
-    }
+    connection().async_add_allowed_handler_with_any_url(handler, [](auto&) {});
     return true;
 }
 
 bool Launcher::add_allowed_handler_with_only_specific_urls(const String& handler, const Vector<URL>& urls)
 {
-    auto response_or_error = connection().try_add_allowed_handler_with_only_specific_urls(handler, urls);
-    if (response_or_error.is_error()) {
-        dbgln("Launcher::add_allowed_handler_with_only_specific_urls: Failed");
-        return false;
-    }
+    connection().async_add_allowed_handler_with_only_specific_urls(handler, urls, [](auto&) {});
     return true;
 }
 
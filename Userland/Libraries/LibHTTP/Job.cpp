@@ -174,6 +174,9 @@ void Job::on_socket_connected()
                     if (on_headers_received)
                         on_headers_received(m_headers, m_code > 0 ? m_code : Optional<u32> {});
                     m_state = State::InBody;
+                    // These never have a body, so don't wait for one (RFC 7230, 3.3.3).
+                    if (m_code == 204 || m_code == 304)
+                        return finish_up();
                 }
                 return;
             }
@@ -7,7 +7,9 @@
 #pragma once
 
 #include <AK/ByteBuffer.h>
+#include <AK/Function.h>
 #include <AK/NonnullOwnPtrVector.h>
+#include <LibCore/AnonymousBuffer.h>
 #include <LibCore/Event.h>
 #include <LibCore/EventLoop.h>
 #include <LibCore/LocalSocket.h>
@@ -15,12 +17,15 @@
 #include <LibCore/Timer.h>
 #include <LibIPC/Message.h>
 #include <errno.h>
+#include <fcntl.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <sys/select.h>
 #include <sys/socket.h>
+#include <sys/stat.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
 namespace IPC {
@@ -49,12 +54,25 @@ public:
         return wait_for_specific_endpoint_message<MessageType, LocalEndpoint>();
     }
 
+    // Lets large messages go through anonymous buffers instead of being copied through the socket. This needs the
+    // "sendfd" and "recvfd" promises, so both ends have to ask for it; until the peer has, everything goes through
+    // the socket as usual.
+    void enable_out_of_line_messages()
+    {
+#ifdef __serenity__
+        if (m_out_of_line_messages_enabled || !m_socket->is_open())
+            return;
+        m_out_of_line_messages_enabled = true;
+        u32 marker = out_of_line_messages_enabled_marker;
+        write_to_peer({ reinterpret_cast<const u8*>(&marker), sizeof(marker) }, {});
+#endif
+    }
+
     void post_message(const Message& message)
     {
         post_message(message.encode());
     }
 
-    // FIXME: unnecessary copy
     void post_message(MessageBuffer buffer)
     {
         // NOTE: If this connection is being shut down, but has not yet been destroyed,
@@ -62,11 +80,22 @@ public:
         if (!m_socket->is_open())
             return;
 
-        // Prepend the message size.
-        uint32_t message_size = buffer.data.size();
-        buffer.data.prepend(reinterpret_cast<const u8*>(&message_size), sizeof(message_size));
-
 #ifdef __serenity__
+        // Large messages go through an anonymous buffer, so they don't have to be copied through the socket
+        // in small pieces. Its fd goes first, so the peer receives it before any fds the message itself carries.
+        Core::AnonymousBuffer out_of_line_buffer;
+        if (m_out_of_line_messages_enabled && m_peer_enabled_out_of_line_messages && buffer.data.size() >= out_of_line_message_threshold) {
+            out_of_line_buffer = Core::AnonymousBuffer::create_with_size(buffer.data.size());
+            if (out_of_line_buffer.is_valid()) {
+                memcpy(out_of_line_buffer.data<u8>(), buffer.data.data(), buffer.data.size());
+                if (sendfd(m_socket->fd(), out_of_line_buffer.fd()) < 0) {
+                    perror("sendfd");
+                    shutdown();
+                    return;
+                }
+            }
+        }
+
         for (auto& fd : buffer.fds) {
             auto rc = sendfd(m_socket->fd(), fd->value());
             if (rc < 0) {
@@ -74,34 +103,22 @@ public:
                 shutdown();
             }
         }
+
+        if (out_of_line_buffer.is_valid()) {
+            u32 header[2] = { out_of_line_message_marker, (u32)buffer.data.size() };
+            if (write_to_peer({ reinterpret_cast<const u8*>(header), sizeof(header) }, {}))
+                m_responsiveness_timer->start();
+            return;
+        }
 #else
         if (!buffer.fds.is_empty())
             warnln("fd passing is not supported on this platform, sorry :(");
 #endif
 
-        size_t total_nwritten = 0;
-        while (total_nwritten < buffer.data.size()) {
-            auto nwritten = write(m_socket->fd(), buffer.data.data() + total_nwritten, buffer.data.size() - total_nwritten);
-            if (nwritten < 0) {
-                switch (errno) {
-                case EPIPE:
-                    dbgln("{}::post_message: Disconnected from peer", *this);
-                    shutdown();
-                    return;
-                case EAGAIN:
-                    dbgln("{}::post_message: Peer buffer overflowed", *this);
-                    shutdown();
-                    return;
-                default:
-                    perror("Connection::post_message write");
-                    shutdown();
-                    return;
-                }
-            }
-            total_nwritten += nwritten;
-        }
-
-        m_responsiveness_timer->start();
+        // Prepend the message size.
+        uint32_t message_size = buffer.data.size();
+        if (write_to_peer({ reinterpret_cast<const u8*>(&message_size), sizeof(message_size) }, buffer.data.span()))
+            m_responsiveness_timer->start();
     }
 
     template<typename RequestType, typename... Args>
@@ -120,6 +137,20 @@ public:
         return wait_for_specific_endpoint_message<typename RequestType::ResponseType, PeerEndpoint>();
     }
 
+    // Doesn't wait for the response, but calls back with it once it arrives. The callback runs in the order the response
+    // arrived in, relative to the other messages from the peer. The peer answers requests in order, so responses are
+    // matched to callbacks by message ID alone.
+    // If the peer disconnects before responding, the callback is destroyed without being called; die() runs instead.
+    template<typename RequestType, typename... Args>
+    void post_message_with_response(Function<void(typename RequestType::ResponseType&)> on_response, Args&&... args)
+    {
+        using ResponseType = typename RequestType::ResponseType;
+        m_pending_responses.append({ ResponseType::static_message_id(), [on_response = move(on_response)](Message& response) {
+                                        on_response(static_cast<ResponseType&>(response));
+                                    } });
+        post_message(RequestType(forward<Args>(args)...));
+    }
+
     virtual void may_have_become_unresponsive() { }
     virtual void did_become_responsive() { }
 
@@ -142,11 +173,14 @@ protected:
             // Double check we don't already have the event waiting for us.
             // Otherwise we might end up blocked for a while for no reason.
             for (size_t i = 0; i < m_unprocessed_messages.size(); ++i) {
-                auto& message = m_unprocessed_messages[i];
+                auto& unprocessed_message = m_unprocessed_messages[i];
+                if (unprocessed_message.on_response)
+                    continue;
+                auto& message = *unprocessed_message.message;
                 if (message.endpoint_magic() != Endpoint::static_magic())
                     continue;
                 if (message.message_id() == MessageType::static_message_id())
-                    return m_unprocessed_messages.take(i).template release_nonnull<MessageType>();
+                    return m_unprocessed_messages.take(i).message.template release_nonnull<MessageType>();
             }
 
             if (!m_socket->is_open())
@@ -175,16 +209,14 @@ protected:
 
     bool drain_messages_from_peer()
     {
-        Vector<u8> bytes;
-
-        if (!m_unprocessed_bytes.is_empty()) {
-            bytes.append(m_unprocessed_bytes.data(), m_unprocessed_bytes.size());
-            m_unprocessed_bytes.clear();
-        }
-
+        bool did_receive_anything = false;
         while (m_socket->is_open()) {
-            u8 buffer[4096];
-            ssize_t nread = recv(m_socket->fd(), buffer, sizeof(buffer), MSG_DONTWAIT);
+            // Messages are parsed in place and whatever is left of a partial one moves to the front,
+            // so the receive buffer only grows when a single message doesn't fit.
+            if (m_receive_buffer.size() - m_received_byte_count < receive_chunk_size)
+                m_receive_buffer.resize(max(m_receive_buffer.size() * 2, m_received_byte_count + receive_chunk_size));
+
+            ssize_t nread = recv(m_socket->fd(), m_receive_buffer.data() + m_received_byte_count, m_receive_buffer.size() - m_received_byte_count, MSG_DONTWAIT);
             if (nread < 0) {
                 if (errno == EAGAIN)
                     break;
@@ -193,64 +225,174 @@ protected:
                 return false;
             }
             if (nread == 0) {
-                if (bytes.is_empty()) {
+                if (!did_receive_anything && m_received_byte_count == 0) {
                     deferred_invoke([this](auto&) { die(); });
                 }
                 return false;
             }
-            bytes.append(buffer, nread);
+            if (!did_receive_anything) {
+                did_receive_anything = true;
+                m_responsiveness_timer->stop();
+                did_become_responsive();
+            }
+            m_received_byte_count += nread;
+            if (!parse_received_messages())
+                return false;
+        }
+
+        if (m_receive_buffer.size() > max_idle_receive_buffer_size && m_received_byte_count <= default_receive_buffer_size)
+            m_receive_buffer.resize(default_receive_buffer_size);
+
+        if (!m_unprocessed_messages.is_empty()) {
+            deferred_invoke([this](auto&) {
+                handle_messages();
+            });
+        }
+        return true;
+    }
+
+    bool write_to_peer(ReadonlyBytes header, ReadonlyBytes data)
+    {
+        while (!header.is_empty() || !data.is_empty()) {
+            iovec iov[2];
+            int iov_count = 0;
+            if (!header.is_empty())
+                iov[iov_count++] = { const_cast<u8*>(header.data()), header.size() };
+            if (!data.is_empty())
+                iov[iov_count++] = { const_cast<u8*>(data.data()), data.size() };
+            auto nwritten = writev(m_socket->fd(), iov, iov_count);
+            if (nwritten < 0) {
+                switch (errno) {
+                case EPIPE:
+                    dbgln("{}::post_message: Disconnected from peer", *this);
+                    shutdown();
+                    return false;
+                case EAGAIN:
+                    dbgln("{}::post_message: Peer buffer overflowed", *this);
+                    shutdown();
+                    return false;
+                default:
+                    perror("Connection::post_message writev");
+                    shutdown();
+                    return false;
+                }
+            }
+            auto nwritten_from_header = min((size_t)nwritten, header.size());
+            header = header.slice(nwritten_from_header);
+            data = data.slice(nwritten - nwritten_from_header);
         }
+        return true;
+    }
 
-        if (!bytes.is_empty()) {
-            m_responsiveness_timer->stop();
-            did_become_responsive();
+    bool decode_message(ReadonlyBytes bytes)
+    {
+        if (auto message = LocalEndpoint::decode_message(bytes, m_socket->fd())) {
+            m_unprocessed_messages.append({ message.release_nonnull(), {} });
+        } else if (auto message = PeerEndpoint::decode_message(bytes, m_socket->fd())) {
+            // A response that an earlier pipelined request is waiting for must not be taken by a synchronous request.
+            for (size_t i = 0; i < m_pending_responses.size(); ++i) {
+                if (m_pending_responses[i].message_id == message->message_id()) {
+                    auto pending_response = m_pending_responses.take(i);
+                    m_unprocessed_messages.append({ message.release_nonnull(), move(pending_response.callback) });
+                    return true;
+                }
+            }
+            m_unprocessed_messages.append({ message.release_nonnull(), {} });
+        } else {
+            dbgln("Failed to parse a message");
+            return false;
         }
+        return true;
+    }
 
+    bool parse_received_messages()
+    {
+        auto bytes = m_receive_buffer.bytes().slice(0, m_received_byte_count);
         size_t index = 0;
-        u32 message_size = 0;
-        for (; index + sizeof(message_size) < bytes.size(); index += message_size) {
+        while (index + sizeof(u32) <= bytes.size()) {
+            u32 message_size = 0;
             memcpy(&message_size, bytes.data() + index, sizeof(message_size));
-            if (message_size == 0 || bytes.size() - index - sizeof(uint32_t) < message_size)
+            if (message_size == out_of_line_messages_enabled_marker) {
+                m_peer_enabled_out_of_line_messages = true;
+                index += sizeof(u32);
+                continue;
+            }
+            if (message_size == out_of_line_message_marker) {
+                if (bytes.size() - index < 2 * sizeof(u32))
+                    break;
+                memcpy(&message_size, bytes.data() + index + sizeof(u32), sizeof(message_size));
+                index += 2 * sizeof(u32);
+                if (!receive_out_of_line_message(message_size)) {
+                    shutdown();
+                    return false;
+                }
+                continue;
+            }
+            if (message_size == 0 || bytes.size() - index - sizeof(u32) < message_size)
                 break;
             index += sizeof(message_size);
-            auto remaining_bytes = ReadonlyBytes { bytes.data() + index, bytes.size() - index };
-            if (auto message = LocalEndpoint::decode_message(remaining_bytes, m_socket->fd())) {
-                m_unprocessed_messages.append(message.release_nonnull());
-            } else if (auto message = PeerEndpoint::decode_message(remaining_bytes, m_socket->fd())) {
-                m_unprocessed_messages.append(message.release_nonnull());
-            } else {
-                dbgln("Failed to parse a message");
-                break;
-            }
-        }
-
-        if (index < bytes.size()) {
-            // Sometimes we might receive a partial message. That's okay, just stash away
-            // the unprocessed bytes and we'll prepend them to the next incoming message
-            // in the next run of this function.
-            auto remaining_bytes = ByteBuffer::copy(bytes.data() + index, bytes.size() - index);
-            if (!m_unprocessed_bytes.is_empty()) {
-                dbgln("{}::drain_messages_from_peer: Already have unprocessed bytes", *this);
+            if (!decode_message(bytes.slice(index))) {
                 shutdown();
                 return false;
             }
-            m_unprocessed_bytes = remaining_bytes;
+            index += message_size;
         }
 
-        if (!m_unprocessed_messages.is_empty()) {
-            deferred_invoke([this](auto&) {
-                handle_messages();
-            });
+        // Sometimes we might receive a partial message. That's okay, just keep the bytes
+        // around and we'll continue with them once the rest of the message arrives.
+        if (index > 0) {
+            memmove(m_receive_buffer.data(), m_receive_buffer.data() + index, m_received_byte_count - index);
+            m_received_byte_count -= index;
         }
         return true;
     }
 
+    bool receive_out_of_line_message([[maybe_unused]] u32 message_size)
+    {
+#ifdef __serenity__
+        // Without having enabled it, we may not even be allowed to receive the buffer.
+        if (!m_out_of_line_messages_enabled) {
+            dbgln("{}::receive_out_of_line_message: Peer sent one without us enabling them", *this);
+            return false;
+        }
+        int fd = recvfd(m_socket->fd(), O_CLOEXEC);
+        if (fd < 0) {
+            perror("recvfd");
+            return false;
+        }
+        // Don't map more than the sender actually gave us.
+        struct stat st;
+        if (fstat(fd, &st) < 0 || message_size == 0 || (u64)message_size > (u64)st.st_size) {
+            dbgln("{}::receive_out_of_line_message: Message of {} bytes doesn't fit its buffer", *this, message_size);
+            close(fd);
+            return false;
+        }
+        auto buffer = Core::AnonymousBuffer::create_from_anon_fd(fd, message_size);
+        if (!buffer.is_valid()) {
+            dbgln("{}::receive_out_of_line_message: Couldn't map {} bytes", *this, message_size);
+            close(fd);
+            return false;
+        }
+        // The sender still has the buffer mapped and could change it while we decode, so decode from a private copy.
+        auto message = ByteBuffer::copy(buffer.data<u8>(), message_size);
+        return decode_message(message.bytes());
+#else
+        dbgln("{}::receive_out_of_line_message: Not supported on this platform", *this);
+        return false;
+#endif
+    }
+
     void handle_messages()
     {
+        // Responses to pipelined requests and messages from the peer are handled in the order they arrived in.
         auto messages = move(m_unprocessed_messages);
         for (auto& message : messages) {
-            if (message.endpoint_magic() == LocalEndpoint::static_magic())
-                if (auto response = m_local_stub.handle(message))
+            if (message.on_response) {
+                message.on_response(*message.message);
+                continue;
+            }
+            if (message.message->endpoint_magic() == LocalEndpoint::static_magic())
+                if (auto response = m_local_stub.handle(*message.message))
                     post_message(*response);
         }
     }
@@ -261,8 +403,28 @@ protected:
     RefPtr<Core::Timer> m_responsiveness_timer;
 
     RefPtr<Core::Notifier> m_notifier;
-    NonnullOwnPtrVector<Message> m_unprocessed_messages;
-    ByteBuffer m_unprocessed_bytes;
+
+    struct UnprocessedMessage {
+        NonnullOwnPtr<Message> message;
+        // Set for responses that a pipelined request is waiting for.
+        Function<void(Message&)> on_response;
+    };
+    Vector<UnprocessedMessage> m_unprocessed_messages;
+
+    struct PendingResponse {
+        int message_id { 0 };
+        Function<void(Message&)> callback;
+    };
+    Vector<PendingResponse> m_pending_responses;
+
+    static constexpr size_t receive_chunk_size = 4 * KiB;
+    static constexpr size_t default_receive_buffer_size = 16 * KiB;
+    static constexpr size_t max_idle_receive_buffer_size = 1 * MiB;
+    ByteBuffer m_receive_buffer { ByteBuffer::create_uninitialized(default_receive_buffer_size) };
+    size_t m_received_byte_count { 0 };
+
+    bool m_out_of_line_messages_enabled { false };
+    bool m_peer_enabled_out_of_line_messages { false };
 };
 
 }
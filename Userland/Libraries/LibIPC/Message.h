@@ -33,6 +33,14 @@ private:
     int m_fd;
 };
 
+// Messages at least this big are sent through an anonymous buffer, with only a small header over the socket,
+// if both ends of the connection have enabled that.
+constexpr size_t out_of_line_message_threshold = 64 * KiB;
+// Takes the place of the message size in that header, and is followed by the actual size.
+constexpr u32 out_of_line_message_marker = 0xffffffff;
+// Sent on its own (in place of a message size) by an end that can take messages through anonymous buffers.
+constexpr u32 out_of_line_messages_enabled_marker = 0xfffffffe;
+
 struct MessageBuffer {
     Vector<u8, 1024> data;
     Vector<RefPtr<AutoCloseFileDescriptor>> fds;
@@ -186,6 +186,7 @@ int pthread_mutex_unlock(pthread_mutex_t* mutex)
 int pthread_mutexattr_init(pthread_mutexattr_t* attr)
 {
     attr->type = PTHREAD_MUTEX_NORMAL;
+    attr->protocol = PTHREAD_PRIO_NONE;
     return 0;
 }
 
@@ -210,6 +211,24 @@ int pthread_mutexattr_gettype(pthread_mutexattr_t* attr, int* type)
     return 0;
 }
 
+int pthread_mutexattr_setprotocol(pthread_mutexattr_t* attr, int protocol)
+{
+    if (!attr)
+        return EINVAL;
+    if (protocol == PTHREAD_PRIO_PROTECT)
+        return ENOTSUP;
+    if (protocol != PTHREAD_PRIO_NONE && protocol != PTHREAD_PRIO_INHERIT)
+        return EINVAL;
+    attr->protocol = protocol;
+    return 0;
+}
+
+int pthread_mutexattr_getprotocol(const pthread_mutexattr_t* attr, int* protocol)
+{
+    *protocol = attr->protocol;
+    return 0;
+}
+
 int pthread_attr_init(pthread_attr_t* attributes)
 {
     auto* impl = new PthreadAttrImpl {};
@@ -444,6 +463,8 @@ int pthread_cond_init(pthread_cond_t* cond, const pthread_condattr_t* attr)
     cond->value = 0;
     cond->previous = 0;
     cond->clockid = attr ? attr->clockid : CLOCK_MONOTONIC_COARSE;
+    cond->mutex = nullptr;
+    cond->waiters = 0;
     return 0;
 }
 
@@ -469,15 +490,28 @@ static int cond_wait(pthread_cond_t* cond, pthread_mutex_t* mutex, const struct
 {
     u32 value = cond->value;
     cond->previous = value;
+    cond->mutex = mutex;
+    AK::atomic_fetch_add(&cond->waiters, 1u, AK::memory_order_relaxed);
     pthread_mutex_unlock(mutex);
     int rc = futex_wait(cond->value, value, abstime);
-    pthread_mutex_lock(mutex);
+    // pthread_cond_broadcast() may have moved other waiters over to the mutex,
+    // so make sure our unlock wakes them up.
+    int lock_rc = __pthread_mutex_lock_pessimistic(mutex);
+    // Once nobody is waiting anymore, the mutex may go away, so don't let
+    // pthread_cond_broadcast() requeue onto it.
+    if (AK::atomic_fetch_sub(&cond->waiters, 1u, AK::memory_order_relaxed) == 1)
+        cond->mutex = nullptr;
+    if (lock_rc != 0)
+        return lock_rc;
     return rc;
 }
 
 int pthread_cond_wait(pthread_cond_t* cond, pthread_mutex_t* mutex)
 {
     int rc = cond_wait(cond, mutex, nullptr);
+    // Relocking a priority inheriting mutex can fail.
+    if (rc > 0)
+        return rc;
     VERIFY(rc == 0);
     return 0;
 }
@@ -517,6 +551,20 @@ int pthread_cond_broadcast(pthread_cond_t* cond)
 {
     u32 value = cond->previous + 1;
     cond->value = value;
+
+    // Waking everyone up would only have them all fight over the mutex. Instead, wake up
+    // one of them and move the rest over to the mutex, so they get woken up one by one
+    // as it's unlocked. (We can't requeue onto priority inheriting mutexes.)
+    // If the requeue fails for any reason, fall back to waking everyone up.
+    auto* mutex = cond->mutex;
+    if (mutex && mutex->protocol != PTHREAD_PRIO_INHERIT) {
+        int saved_errno = errno;
+        int rc = futex(&cond->value, FUTEX_CMP_REQUEUE, 1, (const struct timespec*)INT32_MAX, &mutex->lock, value);
+        if (rc >= 0)
+            return 0;
+        errno = saved_errno;
+    }
+
     int rc = futex(&cond->value, FUTEX_WAKE, INT32_MAX, nullptr, nullptr, 0);
     VERIFY(rc >= 0);
     return 0;
@@ -70,6 +70,10 @@ int pthread_setschedparam(pthread_t thread, int policy, const struct sched_param
 #define PTHREAD_PROCESS_PRIVATE 1
 #define PTHREAD_PROCESS_SHARED 2
 
+#define PTHREAD_PRIO_NONE __PTHREAD_PRIO_NONE
+#define PTHREAD_PRIO_INHERIT __PTHREAD_PRIO_INHERIT
+#define PTHREAD_PRIO_PROTECT 2
+
 #define PTHREAD_COND_INITIALIZER     \
     {                                \
         0, 0, CLOCK_MONOTONIC_COARSE \
@@ -116,6 +120,8 @@ int pthread_equal(pthread_t, pthread_t);
 int pthread_mutexattr_init(pthread_mutexattr_t*);
 int pthread_mutexattr_settype(pthread_mutexattr_t*, int);
 int pthread_mutexattr_gettype(pthread_mutexattr_t*, int*);
+int pthread_mutexattr_setprotocol(pthread_mutexattr_t*, int);
+int pthread_mutexattr_getprotocol(const pthread_mutexattr_t*, int*);
 int pthread_mutexattr_destroy(pthread_mutexattr_t*);
 
 int pthread_setname_np(pthread_t, const char*);
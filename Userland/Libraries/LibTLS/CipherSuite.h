@@ -30,6 +30,8 @@ enum class CipherSuite {
     // RFC 5289 - ECDHE for AES-GCM
     ECDHE_ECDSA_WITH_AES_128_GCM_SHA256 = 0xC02B,
     ECDHE_ECDSA_WITH_AES_256_GCM_SHA384 = 0xC02C,
+    ECDHE_RSA_WITH_AES_128_GCM_SHA256 = 0xC02F,
+    ECDHE_RSA_WITH_AES_256_GCM_SHA384 = 0xC030,
 
     // RFC 5487 - Pre-shared keys
     DHE_PSK_WITH_AES_128_GCM_SHA256 = 0x00AA,
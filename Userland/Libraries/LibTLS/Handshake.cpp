@@ -34,6 +34,7 @@ ByteBuffer TLSv12::build_hello()
     builder.append(version);
     builder.append(m_context.local_random, sizeof(m_context.local_random));
 
+    offer_cached_session();
     builder.append(m_context.session_id_size);
     if (m_context.session_id_size)
         builder.append(m_context.session_id, m_context.session_id_size);
@@ -77,6 +78,25 @@ ByteBuffer TLSv12::build_hello()
     if (sni_length)
         extension_length += sni_length + 9;
 
+    // supported_groups and ec_point_formats, if we're offering any ECDHE cipher suites (RFC 8422 section 5.1)
+    bool offers_ecdhe = false;
+    for (auto suite : m_context.options.usable_cipher_suites) {
+        if (get_key_exchange_algorithm(suite) == KeyExchangeAlgorithm::ECDHE_RSA)
+            offers_ecdhe = true;
+    }
+    if (offers_ecdhe) {
+        // supported_groups: 2b extension ID, 2b extension length, 2b vector length, one 2b group
+        extension_length += 2 + 2 + 2 + 2;
+        // ec_point_formats: 2b extension ID, 2b extension length, 1b vector length, one 1b format
+        extension_length += 2 + 2 + 1 + 1;
+    }
+
+    // session_ticket: 2b extension ID, 2b extension length, and the ticket (if we have one)
+    size_t ticket_length = 0;
+    if (m_context.offered_session.has_value())
+        ticket_length = m_context.offered_session->ticket.size();
+    extension_length += 2 + 2 + ticket_length;
+
     builder.append((u16)extension_length);
 
     if (sni_length) {
@@ -105,6 +125,27 @@ ByteBuffer TLSv12::build_hello()
         builder.append((u8)entry.signature);
     }
 
+    if (offers_ecdhe) {
+        // supported_groups extension, we only implement x25519
+        builder.append((u16)HandshakeExtension::SupportedGroups);
+        builder.append((u16)4);
+        builder.append((u16)2);
+        builder.append((u16)NamedCurve::x25519);
+
+        // ec_point_formats extension
+        builder.append((u16)HandshakeExtension::ECPointFormats);
+        builder.append((u16)2);
+        builder.append((u8)1);
+        builder.append((u8)ECPointFormat::Uncompressed);
+    }
+
+    // session_ticket extension
+    // An empty one tells the server that we'd like a ticket (RFC 5077 section 3.2).
+    builder.append((u16)HandshakeExtension::SessionTicket);
+    builder.append((u16)ticket_length);
+    if (ticket_length)
+        builder.append(m_context.offered_session->ticket.bytes());
+
     if (alpn_length) {
         // TODO
         VERIFY_NOT_REACHED();
@@ -153,7 +194,7 @@ ByteBuffer TLSv12::build_handshake_finished()
     auto outbuffer = Bytes { out, verify_data_length };
     auto dummy = ByteBuffer::create_zeroed(0);
 
-    auto digest = m_context.handshake_hash.digest();
+    auto digest = m_context.handshake_hash.peek();
     auto hashbuf = ReadonlyBytes { digest.immutable_data(), m_context.handshake_hash.digest_size() };
     pseudorandom_function(outbuffer, m_context.master_key, (const u8*)"client finished", 15, hashbuf, dummy);
 
@@ -186,14 +227,38 @@ ssize_t TLSv12::handle_handshake_finished(ReadonlyBytes buffer, WritePacketStage
         return (i8)Error::BrokenPacket;
     }
 
-    if (size < buffer.size() - index) {
+    if (size > buffer.size() - index) {
         dbgln_if(TLS_DEBUG, "not enough data after length: {} > {}", size, buffer.size() - index);
         return (i8)Error::NeedMoreData;
     }
 
-    // TODO: Compare Hashes
-    dbgln_if(TLS_DEBUG, "FIXME: handle_handshake_finished :: Check message validity");
+    // RFC 5246 section 7.4.9: verify_data = PRF(master_secret, "server finished", Hash(handshake_messages)),
+    // where the handshake messages are everything up to, but not including, this one.
+    // Simplification: Assume that verify_data_length is always 12, like build_handshake_finished() does.
+    constexpr u32 verify_data_length = 12;
+    if (size != verify_data_length) {
+        dbgln("finished message has unexpected verify_data length {}", size);
+        return (i8)Error::BrokenPacket;
+    }
+
+    u8 expected_verify_data[verify_data_length];
+    auto dummy = ByteBuffer::create_zeroed(0);
+    auto digest = m_context.handshake_hash.peek();
+    auto hashbuf = ReadonlyBytes { digest.immutable_data(), m_context.handshake_hash.digest_size() };
+    pseudorandom_function(Bytes { expected_verify_data, verify_data_length }, m_context.master_key, (const u8*)"server finished", 15, hashbuf, dummy);
+
+    // Whoever sent this doesn't know the master secret (or saw different handshake messages), so don't trust the session.
+    if (buffer.slice(index, size) != ReadonlyBytes { expected_verify_data, verify_data_length }) {
+        dbgln("finished message failed verification");
+        return (i8)Error::NotVerified;
+    }
+
+    // In an abbreviated handshake, the server finishes first, and we still have to send our own finished message.
+    if (m_context.is_resuming)
+        write_packets = WritePacketStage::Finished;
+
     m_context.connection_status = ConnectionStatus::Established;
+    store_session();
 
     if (m_handshake_timeout_timer) {
         // Disable the handshake timeout timer as handshake has been established.
@@ -202,7 +267,7 @@ ssize_t TLSv12::handle_handshake_finished(ReadonlyBytes buffer, WritePacketStage
         m_handshake_timeout_timer = nullptr;
     }
 
-    if (on_tls_ready_to_write)
+    if (!m_context.is_resuming && on_tls_ready_to_write)
         on_tls_ready_to_write(*this);
 
     return index + size;
@@ -274,6 +339,15 @@ ssize_t TLSv12::handle_handshake_payload(ReadonlyBytes vbuffer)
             dbgln("unsupported: DTLS");
             payload_res = (i8)Error::UnexpectedMessage;
             break;
+        case NewSessionTicket:
+            if (m_context.is_server || m_context.connection_status != ConnectionStatus::KeyExchange) {
+                dbgln("unexpected new session ticket message");
+                payload_res = (i8)Error::UnexpectedMessage;
+                break;
+            }
+            dbgln_if(TLS_DEBUG, "new session ticket");
+            payload_res = handle_new_session_ticket(buffer.slice(1, payload_size));
+            break;
         case CertificateMessage:
             if (m_context.handshake_messages[4] >= 1) {
                 dbgln("unexpected certificate message");
@@ -523,6 +597,8 @@ ssize_t TLSv12::handle_handshake_payload(ReadonlyBytes vbuffer)
                 write_packet(packet);
             }
             m_context.connection_status = ConnectionStatus::Established;
+            if (on_tls_ready_to_write)
+                on_tls_ready_to_write(*this);
             break;
         }
         payload_size++;
@@ -7,6 +7,7 @@
 #include <AK/Debug.h>
 #include <AK/Random.h>
 #include <LibCrypto/ASN1/DER.h>
+#include <LibCrypto/Curves/X25519.h>
 #include <LibCrypto/PK/Code/EMSA_PSS.h>
 #include <LibTLS/TLSv12.h>
 
@@ -135,6 +136,65 @@ bool TLSv12::compute_master_secret_from_pre_master_secret(size_t length)
     return true;
 }
 
+void TLSv12::offer_cached_session()
+{
+    m_context.offered_session.clear();
+    m_context.is_resuming = false;
+    m_context.session_ticket.clear();
+
+    if (m_context.is_server || m_context.session_cache_key.is_null())
+        return;
+
+    auto session = SessionCache::the().get(m_context.session_cache_key);
+    if (!session.has_value() || !m_context.options.usable_cipher_suites.contains_slow(session->cipher))
+        return;
+
+    if (!session->session_id.is_empty()) {
+        m_context.session_id_size = session->session_id.size();
+        memcpy(m_context.session_id, session->session_id.data(), session->session_id.size());
+    } else {
+        // RFC 5077 section 3.4: When offering a ticket, we can make up a session ID, which the server echoes if it accepts the ticket.
+        m_context.session_id_size = sizeof(m_context.session_id);
+        fill_with_random(m_context.session_id, sizeof(m_context.session_id));
+    }
+    m_context.offered_session = session.release_value();
+}
+
+void TLSv12::store_session()
+{
+    if (m_context.is_server || m_context.session_cache_key.is_null() || m_context.master_key.is_empty())
+        return;
+
+    // A session that authenticated us with a client certificate shouldn't be picked up by other connections.
+    if (!m_context.client_certificates.is_empty())
+        return;
+
+    Session session;
+    session.cipher = m_context.cipher;
+    session.master_key = m_context.master_key;
+    if (m_context.session_id_size)
+        session.session_id = ByteBuffer::copy(m_context.session_id, m_context.session_id_size);
+
+    auto lifetime = SessionCache::max_lifetime_in_seconds;
+    if (!m_context.session_ticket.is_empty()) {
+        session.ticket = m_context.session_ticket;
+        if (m_context.session_ticket_lifetime_hint)
+            lifetime = min(lifetime, (time_t)m_context.session_ticket_lifetime_hint);
+    } else if (m_context.is_resuming) {
+        // The server accepted our ticket but didn't hand out a new one, so the old one is still good.
+        session.ticket = m_context.offered_session->ticket;
+        lifetime = m_context.offered_session->expiry - time(nullptr);
+    }
+
+    if (session.session_id.is_empty() && session.ticket.is_empty()) {
+        SessionCache::the().remove(m_context.session_cache_key);
+        return;
+    }
+
+    session.expiry = time(nullptr) + lifetime;
+    SessionCache::the().set(m_context.session_cache_key, move(session));
+}
+
 static bool wildcard_matches(const StringView& host, const StringView& subject)
 {
     if (host.matches(subject))
@@ -224,6 +284,41 @@ void TLSv12::build_rsa_pre_master_secret(PacketBuilder& builder)
     builder.append(outbuf);
 }
 
+void TLSv12::build_ecdhe_rsa_pre_master_secret(PacketBuilder& builder)
+{
+    if (m_context.server_ephemeral_public_key.is_empty()) {
+        dbgln("Server didn't send us its ephemeral key");
+        alert(AlertLevel::Critical, AlertDescription::HandshakeFailure);
+        return;
+    }
+
+    auto private_key = Crypto::Curves::X25519::generate_private_key();
+    auto public_key = Crypto::Curves::X25519::generate_public_key(private_key);
+
+    // RFC 8422 section 5.10: The premaster secret is the x-coordinate of the shared point.
+    m_context.premaster_key = Crypto::Curves::X25519::compute_coordinate(private_key, m_context.server_ephemeral_public_key);
+    if (m_context.premaster_key.is_empty()) {
+        dbgln("Server sent us a point of small order");
+        alert(AlertLevel::Critical, AlertDescription::IllegalParameter);
+        return;
+    }
+
+    if constexpr (TLS_DEBUG) {
+        dbgln("PreMaster secret");
+        print_buffer(m_context.premaster_key);
+    }
+
+    if (!compute_master_secret_from_pre_master_secret(48)) {
+        dbgln("oh noes we could not derive a master key :(");
+        return;
+    }
+
+    // ClientECDiffieHellmanPublic: our public point, with a u8 length.
+    builder.append_u24(public_key.size() + 1);
+    builder.append((u8)public_key.size());
+    builder.append(public_key.bytes());
+}
+
 ByteBuffer TLSv12::build_certificate()
 {
     PacketBuilder builder { MessageType::Handshake, m_context.options.version };
@@ -304,11 +399,13 @@ ByteBuffer TLSv12::build_client_key_exchange()
         TODO();
         break;
     case KeyExchangeAlgorithm::ECDHE_RSA:
+        build_ecdhe_rsa_pre_master_secret(builder);
+        break;
     case KeyExchangeAlgorithm::ECDH_ECDSA:
     case KeyExchangeAlgorithm::ECDH_RSA:
     case KeyExchangeAlgorithm::ECDHE_ECDSA:
     case KeyExchangeAlgorithm::ECDH_anon:
-        dbgln("Client key exchange for ECDHE algorithms is not implemented");
+        dbgln("Client key exchange for ECDH and ECDHE_ECDSA algorithms is not implemented");
         TODO();
         break;
     default:
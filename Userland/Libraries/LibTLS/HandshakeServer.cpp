@@ -10,6 +10,8 @@
 
 #include <LibCore/Timer.h>
 #include <LibCrypto/ASN1/DER.h>
+#include <LibCrypto/Curves/X25519.h>
+#include <LibCrypto/NumberTheory/ModularFunctions.h>
 #include <LibCrypto/PK/Code/EMSA_PSS.h>
 #include <LibTLS/TLSv12.h>
 
@@ -55,6 +57,11 @@ ssize_t TLSv12::handle_server_hello(ReadonlyBytes buffer, WritePacketStage& writ
         return (i8)Error::NeedMoreData;
     }
 
+    // If the server echoes the session ID we offered, it has agreed to resume that session.
+    auto& offered_session = m_context.offered_session;
+    m_context.is_resuming = offered_session.has_value() && session_length && session_length == m_context.session_id_size
+        && !memcmp(m_context.session_id, buffer.offset_pointer(res), session_length);
+
     if (session_length && session_length <= 32) {
         memcpy(m_context.session_id, buffer.offset_pointer(res), session_length);
         m_context.session_id_size = session_length;
@@ -93,6 +100,20 @@ ssize_t TLSv12::handle_server_hello(ReadonlyBytes buffer, WritePacketStage& writ
 
     if (m_context.connection_status != ConnectionStatus::Renegotiating)
         m_context.connection_status = ConnectionStatus::Negotiating;
+
+    if (m_context.is_resuming) {
+        if (cipher != offered_session->cipher) {
+            dbgln("Server resumed a session with a different cipher");
+            return (i8)Error::UnexpectedMessage;
+        }
+        dbgln_if(TLS_DEBUG, "Resuming session");
+        // The next messages are the server's change cipher spec and finished, so we're ready for them now.
+        m_context.master_key = offered_session->master_key;
+        if (!expand_key())
+            return (i8)Error::UnknownError;
+        m_context.connection_status = ConnectionStatus::KeyExchange;
+    }
+
     if (m_context.is_server) {
         dbgln("unsupported: server mode");
         write_packets = WritePacketStage::ServerHandshake;
@@ -166,6 +187,14 @@ ssize_t TLSv12::handle_server_hello(ReadonlyBytes buffer, WritePacketStage& writ
                 }
             }
             res += extension_length;
+        } else if (extension_type == HandshakeExtension::SessionTicket) {
+            // RFC 5077 section 3.2: The server will send us a NewSessionTicket message.
+            dbgln_if(TLS_DEBUG, "Server will issue a session ticket");
+            res += extension_length;
+        } else if (extension_type == HandshakeExtension::ECPointFormats) {
+            // RFC 8422 section 5.2: The server lists the point formats it can parse; x25519 has only the one.
+            dbgln_if(TLS_DEBUG, "Server supports {} EC point formats", extension_length ? buffer[res] : 0);
+            res += extension_length;
         } else if (extension_type == HandshakeExtension::SignatureAlgorithms) {
             dbgln("supported signatures: ");
             print_buffer(buffer.slice(res, extension_length));
@@ -193,13 +222,40 @@ ssize_t TLSv12::handle_server_hello_done(ReadonlyBytes buffer)
     return size + 3;
 }
 
+ssize_t TLSv12::handle_new_session_ticket(ReadonlyBytes buffer)
+{
+    if (buffer.size() < 3)
+        return (i8)Error::NeedMoreData;
+
+    size_t size = buffer[0] * 0x10000 + buffer[1] * 0x100 + buffer[2];
+
+    if (buffer.size() - 3 < size)
+        return (i8)Error::NeedMoreData;
+
+    // RFC 5077 section 3.3: u32 ticket_lifetime_hint, followed by opaque ticket<0..2^16-1>
+    if (size < 6)
+        return (i8)Error::BrokenPacket;
+
+    auto lifetime_hint = AK::convert_between_host_and_network_endian(ByteReader::load32(buffer.offset_pointer(3)));
+    auto ticket_length = AK::convert_between_host_and_network_endian(ByteReader::load16(buffer.offset_pointer(7)));
+    if (ticket_length + 6u != size)
+        return (i8)Error::BrokenPacket;
+
+    // An empty ticket means that the server changed its mind about giving us one.
+    m_context.session_ticket = ByteBuffer::copy(buffer.offset_pointer(9), ticket_length);
+    m_context.session_ticket_lifetime_hint = lifetime_hint;
+    dbgln_if(TLS_DEBUG, "Received a session ticket of {} bytes, lifetime hint {}s", ticket_length, lifetime_hint);
+
+    return size + 3;
+}
+
 ByteBuffer TLSv12::build_server_key_exchange()
 {
     dbgln("FIXME: build_server_key_exchange");
     return {};
 }
 
-ssize_t TLSv12::handle_server_key_exchange(ReadonlyBytes)
+ssize_t TLSv12::handle_server_key_exchange(ReadonlyBytes buffer)
 {
     switch (get_key_exchange_algorithm(m_context.cipher)) {
     case KeyExchangeAlgorithm::RSA:
@@ -222,11 +278,12 @@ ssize_t TLSv12::handle_server_key_exchange(ReadonlyBytes)
         TODO();
         break;
     case KeyExchangeAlgorithm::ECDHE_RSA:
+        return handle_ecdhe_rsa_server_key_exchange(buffer);
     case KeyExchangeAlgorithm::ECDH_ECDSA:
     case KeyExchangeAlgorithm::ECDH_RSA:
     case KeyExchangeAlgorithm::ECDHE_ECDSA:
     case KeyExchangeAlgorithm::ECDH_anon:
-        dbgln("Server key exchange for ECDHE algorithms is not implemented");
+        dbgln("Server key exchange for ECDH and ECDHE_ECDSA algorithms is not implemented");
         TODO();
         break;
     default:
@@ -237,4 +294,148 @@ ssize_t TLSv12::handle_server_key_exchange(ReadonlyBytes)
     return 0;
 }
 
+ssize_t TLSv12::handle_ecdhe_rsa_server_key_exchange(ReadonlyBytes buffer)
+{
+    if (buffer.size() < 3)
+        return (i8)Error::NeedMoreData;
+
+    size_t size = buffer[0] * 0x10000 + buffer[1] * 0x100 + buffer[2];
+
+    if (buffer.size() - 3 < size)
+        return (i8)Error::NeedMoreData;
+
+    // RFC 8422 section 5.4: ServerECDHParams (curve type, named curve, public point),
+    //                       followed by a digitally-signed hash of the randoms and those parameters.
+    auto payload = buffer.slice(3, size);
+    if (payload.size() < 4)
+        return (i8)Error::BrokenPacket;
+
+    if (payload[0] != (u8)ECCurveType::NamedCurve) {
+        dbgln("Server key exchange uses an unsupported curve type {}", payload[0]);
+        return (i8)Error::NotUnderstood;
+    }
+
+    auto curve = AK::convert_between_host_and_network_endian(ByteReader::load16(payload.offset_pointer(1)));
+    if (curve != (u16)NamedCurve::x25519) {
+        dbgln("Server picked a curve we didn't offer: {}", curve);
+        return (i8)Error::NotUnderstood;
+    }
+
+    size_t public_key_length = payload[3];
+    if (public_key_length != Crypto::Curves::X25519::key_size)
+        return (i8)Error::BrokenPacket;
+
+    size_t server_key_info_length = 4 + public_key_length;
+    if (payload.size() < server_key_info_length + 4)
+        return (i8)Error::BrokenPacket;
+
+    auto hash_algorithm = (HashAlgorithm)payload[server_key_info_length];
+    auto signature_algorithm = (SignatureAlgorithm)payload[server_key_info_length + 1];
+    auto signature_length = AK::convert_between_host_and_network_endian(ByteReader::load16(payload.offset_pointer(server_key_info_length + 2)));
+    if (payload.size() - server_key_info_length - 4 < signature_length)
+        return (i8)Error::BrokenPacket;
+
+    if (signature_algorithm != SignatureAlgorithm::RSA) {
+        dbgln("Server key exchange signed with unexpected signature algorithm {}", (u8)signature_algorithm);
+        return (i8)Error::NotUnderstood;
+    }
+
+    auto signature = payload.slice(server_key_info_length + 4, signature_length);
+    if (!verify_rsa_server_key_exchange(payload.slice(0, server_key_info_length), signature, hash_algorithm)) {
+        dbgln("Server key exchange signature verification failed");
+        return (i8)Error::BadCertificate;
+    }
+
+    m_context.server_ephemeral_public_key = ByteBuffer::copy(payload.slice(4, public_key_length));
+
+    if constexpr (TLS_DEBUG) {
+        dbgln("ECDHE server public key");
+        print_buffer(m_context.server_ephemeral_public_key);
+    }
+
+    return size + 3;
+}
+
+bool TLSv12::verify_rsa_server_key_exchange(ReadonlyBytes server_key_info_buffer, ReadonlyBytes signature_buffer, HashAlgorithm hash_algorithm)
+{
+    // RFC 8017 section 9.2: The DER encoding of the DigestInfo that precedes the hash in EMSA-PKCS1-v1_5.
+    static constexpr u8 sha1_digest_info[] { 0x30, 0x21, 0x30, 0x09, 0x06, 0x05, 0x2b, 0x0e, 0x03, 0x02, 0x1a, 0x05, 0x00, 0x04, 0x14 };
+    static constexpr u8 sha256_digest_info[] { 0x30, 0x31, 0x30, 0x0d, 0x06, 0x09, 0x60, 0x86, 0x48, 0x01, 0x65, 0x03, 0x04, 0x02, 0x01, 0x05, 0x00, 0x04, 0x20 };
+    static constexpr u8 sha384_digest_info[] { 0x30, 0x41, 0x30, 0x0d, 0x06, 0x09, 0x60, 0x86, 0x48, 0x01, 0x65, 0x03, 0x04, 0x02, 0x02, 0x05, 0x00, 0x04, 0x30 };
+    static constexpr u8 sha512_digest_info[] { 0x30, 0x51, 0x30, 0x0d, 0x06, 0x09, 0x60, 0x86, 0x48, 0x01, 0x65, 0x03, 0x04, 0x02, 0x03, 0x05, 0x00, 0x04, 0x40 };
+
+    Crypto::Hash::HashKind hash_kind;
+    ReadonlyBytes digest_info;
+    switch (hash_algorithm) {
+    case HashAlgorithm::SHA1:
+        hash_kind = Crypto::Hash::HashKind::SHA1;
+        digest_info = { sha1_digest_info, sizeof(sha1_digest_info) };
+        break;
+    case HashAlgorithm::SHA256:
+        hash_kind = Crypto::Hash::HashKind::SHA256;
+        digest_info = { sha256_digest_info, sizeof(sha256_digest_info) };
+        break;
+    case HashAlgorithm::SHA384:
+        hash_kind = Crypto::Hash::HashKind::SHA384;
+        digest_info = { sha384_digest_info, sizeof(sha384_digest_info) };
+        break;
+    case HashAlgorithm::SHA512:
+        hash_kind = Crypto::Hash::HashKind::SHA512;
+        digest_info = { sha512_digest_info, sizeof(sha512_digest_info) };
+        break;
+    default:
+        dbgln("Server key exchange signed with unsupported hash algorithm {}", (u8)hash_algorithm);
+        return false;
+    }
+
+    auto certificate_option = verify_chain_and_get_matching_certificate(m_context.extensions.SNI);
+    if (!certificate_option.has_value()) {
+        dbgln("certificate verification failed :(");
+        return false;
+    }
+    auto& public_key = m_context.certificates[certificate_option.value()].public_key;
+
+    // RFC 5246 section 7.4.3: The signature covers client_random + server_random + params.
+    Crypto::Hash::Manager hash { hash_kind };
+    hash.update(m_context.local_random, sizeof(m_context.local_random));
+    hash.update(m_context.remote_random, sizeof(m_context.remote_random));
+    hash.update(server_key_info_buffer);
+    auto digest = hash.digest();
+
+    // RFC 8017 section 8.2.2: The signature has to be exactly as long as the modulus, and so does EM.
+    auto& modulus = public_key.modulus();
+    size_t modulus_word_count = modulus.trimmed_length();
+    if (modulus_word_count == 0)
+        return false;
+    size_t modulus_length = modulus_word_count * sizeof(u32) - __builtin_clz(modulus.words()[modulus_word_count - 1]) / 8;
+    if (signature_buffer.size() != modulus_length) {
+        dbgln("Server key exchange signature is {} bytes long, but the key is {} bytes", signature_buffer.size(), modulus_length);
+        return false;
+    }
+
+    // EM = 0x00 || 0x01 || PS (0xff...) || 0x00 || DigestInfo || H
+    // Comparing it as an integer sidesteps the leading zero.
+    size_t encoded_length = modulus_length;
+    size_t digest_length = hash.digest_size();
+    if (encoded_length < digest_info.size() + digest_length + 11)
+        return false;
+
+    auto expected = ByteBuffer::create_uninitialized(encoded_length);
+    size_t padding_end = encoded_length - digest_info.size() - digest_length - 1;
+    expected[0] = 0x00;
+    expected[1] = 0x01;
+    for (size_t i = 2; i < padding_end; ++i)
+        expected[i] = 0xff;
+    expected[padding_end] = 0x00;
+    expected.overwrite(padding_end + 1, digest_info.data(), digest_info.size());
+    expected.overwrite(padding_end + 1 + digest_info.size(), digest.immutable_data(), digest_length);
+
+    auto signature = Crypto::UnsignedBigInteger::import_data(signature_buffer.data(), signature_buffer.size());
+    if (!(signature < modulus))
+        return false;
+
+    auto encoded = Crypto::NumberTheory::ModularPower(signature, public_key.public_exponent(), modulus);
+    return encoded == Crypto::UnsignedBigInteger::import_data(expected.data(), expected.size());
+}
+
 }
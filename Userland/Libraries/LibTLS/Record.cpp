@@ -489,7 +489,8 @@ ssize_t TLSv12::handle_message(ReadonlyBytes buffer)
 
             if (code == (u8)AlertDescription::CloseNotify) {
                 res += 2;
-                alert(AlertLevel::Critical, AlertDescription::CloseNotify);
+                // RFC 5246 section 7.2.1: close_notify is a warning. Servers invalidate the session if we send a fatal alert.
+                alert(AlertLevel::Warning, AlertDescription::CloseNotify);
                 m_context.connection_finished = true;
                 if (!m_context.cipher_spec_set) {
                     // AWS CloudFront hits this.
@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Debug.h>
+#include <LibTLS/SessionCache.h>
+
+namespace TLS {
+
+SessionCache& SessionCache::the()
+{
+    static SessionCache* s_the;
+    if (!s_the)
+        s_the = new SessionCache;
+    return *s_the;
+}
+
+Optional<Session> SessionCache::get(const String& key)
+{
+    auto it = m_sessions.find(key);
+    if (it == m_sessions.end())
+        return {};
+
+    if (it->value.expiry <= time(nullptr)) {
+        m_sessions.remove(it);
+        return {};
+    }
+
+    dbgln_if(TLS_DEBUG, "Found a session to resume for {}", key);
+    return it->value;
+}
+
+void SessionCache::set(const String& key, Session session)
+{
+    if (!m_sessions.contains(key) && m_sessions.size() >= max_sessions) {
+        // Make room by dropping the session that would have expired first.
+        auto oldest = m_sessions.begin();
+        for (auto it = m_sessions.begin(); it != m_sessions.end(); ++it) {
+            if (it->value.expiry < oldest->value.expiry)
+                oldest = it;
+        }
+        m_sessions.remove(oldest);
+    }
+    m_sessions.set(key, move(session));
+}
+
+void SessionCache::remove(const String& key)
+{
+    m_sessions.remove(key);
+}
+
+}
@@ -0,0 +1,46 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/ByteBuffer.h>
+#include <AK/HashMap.h>
+#include <AK/Optional.h>
+#include <AK/String.h>
+#include <LibTLS/CipherSuite.h>
+#include <time.h>
+
+namespace TLS {
+
+// Everything needed to resume a session with an abbreviated handshake (RFC 5246 section 7.3, RFC 5077).
+struct Session {
+    ByteBuffer session_id;
+    ByteBuffer ticket;
+    ByteBuffer master_key;
+    CipherSuite cipher { CipherSuite::Invalid };
+    time_t expiry { 0 };
+};
+
+// Remembers the last session negotiated with every "host:port", for all connections in this process.
+class SessionCache {
+public:
+    static SessionCache& the();
+
+    static constexpr size_t max_sessions = 256;
+    // RFC 5246 suggests an upper limit of 24 hours; keep sessions around for a lot less than that.
+    static constexpr time_t max_lifetime_in_seconds = 60 * 60;
+
+    Optional<Session> get(const String& key);
+    void set(const String& key, Session);
+    void remove(const String& key);
+
+private:
+    SessionCache() = default;
+
+    HashMap<String, Session> m_sessions;
+};
+
+}
@@ -74,6 +74,8 @@ bool TLSv12::write(ReadonlyBytes buffer)
 bool TLSv12::connect(const String& hostname, int port)
 {
     set_sni(hostname);
+    if (!m_context.is_server)
+        m_context.session_cache_key = String::formatted("{}:{}", hostname, port);
     return Core::Socket::connect(hostname, port);
 }
 
@@ -190,6 +192,10 @@ bool TLSv12::check_connection_state(bool read)
     if (m_context.critical_error) {
         dbgln_if(TLS_DEBUG, "CRITICAL ERROR {} :(", m_context.critical_error);
 
+        // RFC 5246 section 7.2.2: A session that ended in a fatal error can't be resumed.
+        if (!m_context.session_cache_key.is_null())
+            SessionCache::the().remove(m_context.session_cache_key);
+
         if (on_tls_error)
             on_tls_error((AlertDescription)m_context.critical_error);
         return false;
@@ -18,6 +18,7 @@
 #include <LibCrypto/Hash/HashManager.h>
 #include <LibCrypto/PK/RSA.h>
 #include <LibTLS/CipherSuite.h>
+#include <LibTLS/SessionCache.h>
 #include <LibTLS/TLSPacketBuilder.h>
 
 namespace TLS {
@@ -121,6 +122,7 @@ enum HandshakeType {
     ClientHello = 0x01,
     ServerHello = 0x02,
     HelloVerifyRequest = 0x03,
+    NewSessionTicket = 0x04,
     CertificateMessage = 0x0b,
     ServerKeyExchange = 0x0c,
     CertificateRequest = 0x0d,
@@ -133,13 +135,31 @@ enum HandshakeType {
 enum class HandshakeExtension : u16 {
     ServerName = 0x00,
     ApplicationLayerProtocolNegotiation = 0x10,
+    SupportedGroups = 0x0a,
+    ECPointFormats = 0x0b,
     SignatureAlgorithms = 0x0d,
+    SessionTicket = 0x23,
 };
 
 enum class NameType : u8 {
     HostName = 0x00,
 };
 
+// Defined in RFC 8422 section 5.1.1
+enum class NamedCurve : u16 {
+    x25519 = 29,
+};
+
+// Defined in RFC 8422 section 5.4
+enum class ECCurveType : u8 {
+    NamedCurve = 3,
+};
+
+// Defined in RFC 8422 section 5.1.2
+enum class ECPointFormat : u8 {
+    Uncompressed = 0,
+};
+
 enum class WritePacketStage {
     Initial = 0,
     ClientHandshake = 1,
@@ -164,12 +184,14 @@ enum ClientVerificationStaus {
 // 4 bytes of fixed IV, 8 random (nonce) bytes, 4 bytes for counter
 // GCM specifically asks us to transmit only the nonce, the counter is zero
 // and the fixed IV is derived from the premaster key.
-#define ENUMERATE_CIPHERS(C)                                                                                                                    \
-    C(true, CipherSuite::RSA_WITH_AES_128_CBC_SHA, KeyExchangeAlgorithm::RSA, CipherAlgorithm::AES_128_CBC, Crypto::Hash::SHA1, 16, false)      \
-    C(true, CipherSuite::RSA_WITH_AES_256_CBC_SHA, KeyExchangeAlgorithm::RSA, CipherAlgorithm::AES_256_CBC, Crypto::Hash::SHA1, 16, false)      \
-    C(true, CipherSuite::RSA_WITH_AES_128_CBC_SHA256, KeyExchangeAlgorithm::RSA, CipherAlgorithm::AES_128_CBC, Crypto::Hash::SHA256, 16, false) \
-    C(true, CipherSuite::RSA_WITH_AES_256_CBC_SHA256, KeyExchangeAlgorithm::RSA, CipherAlgorithm::AES_256_CBC, Crypto::Hash::SHA256, 16, false) \
-    C(true, CipherSuite::RSA_WITH_AES_128_GCM_SHA256, KeyExchangeAlgorithm::RSA, CipherAlgorithm::AES_128_GCM, Crypto::Hash::SHA256, 8, true)   \
+#define ENUMERATE_CIPHERS(C)                                                                                                                              \
+    C(true, CipherSuite::ECDHE_RSA_WITH_AES_128_GCM_SHA256, KeyExchangeAlgorithm::ECDHE_RSA, CipherAlgorithm::AES_128_GCM, Crypto::Hash::SHA256, 8, true) \
+    C(true, CipherSuite::ECDHE_RSA_WITH_AES_256_GCM_SHA384, KeyExchangeAlgorithm::ECDHE_RSA, CipherAlgorithm::AES_256_GCM, Crypto::Hash::SHA384, 8, true) \
+    C(true, CipherSuite::RSA_WITH_AES_128_CBC_SHA, KeyExchangeAlgorithm::RSA, CipherAlgorithm::AES_128_CBC, Crypto::Hash::SHA1, 16, false)                \
+    C(true, CipherSuite::RSA_WITH_AES_256_CBC_SHA, KeyExchangeAlgorithm::RSA, CipherAlgorithm::AES_256_CBC, Crypto::Hash::SHA1, 16, false)                \
+    C(true, CipherSuite::RSA_WITH_AES_128_CBC_SHA256, KeyExchangeAlgorithm::RSA, CipherAlgorithm::AES_128_CBC, Crypto::Hash::SHA256, 16, false)           \
+    C(true, CipherSuite::RSA_WITH_AES_256_CBC_SHA256, KeyExchangeAlgorithm::RSA, CipherAlgorithm::AES_256_CBC, Crypto::Hash::SHA256, 16, false)           \
+    C(true, CipherSuite::RSA_WITH_AES_128_GCM_SHA256, KeyExchangeAlgorithm::RSA, CipherAlgorithm::AES_128_GCM, Crypto::Hash::SHA256, 8, true)             \
     C(true, CipherSuite::RSA_WITH_AES_256_GCM_SHA384, KeyExchangeAlgorithm::RSA, CipherAlgorithm::AES_256_GCM, Crypto::Hash::SHA384, 8, true)
 
 constexpr KeyExchangeAlgorithm get_key_exchange_algorithm(CipherSuite suite)
@@ -249,6 +271,8 @@ struct Context {
     Vector<Certificate> client_certificates;
     ByteBuffer master_key;
     ByteBuffer premaster_key;
+    // The ephemeral public key from the server's ServerKeyExchange, for ECDHE key exchange.
+    ByteBuffer server_ephemeral_public_key;
     u8 cipher_spec_set { 0 };
     struct {
         int created { 0 };
@@ -300,6 +324,13 @@ struct Context {
     size_t send_retries { 0 };
 
     time_t handshake_initiation_timestamp { 0 };
+
+    // Session resumption (client side)
+    String session_cache_key;
+    Optional<Session> offered_session;
+    bool is_resuming { false };
+    ByteBuffer session_ticket;
+    u32 session_ticket_lifetime_hint { 0 };
 };
 
 class TLSv12 : public Core::Socket {
@@ -307,6 +338,8 @@ class TLSv12 : public Core::Socket {
 public:
     ByteBuffer& write_buffer() { return m_context.tls_buffer; }
     bool is_established() const { return m_context.connection_status == ConnectionStatus::Established; }
+    // Whether the server accepted the session we offered, and we did the abbreviated handshake.
+    bool is_resumed_session() const { return m_context.is_resuming; }
     virtual bool connect(const String&, int) override;
 
     void set_sni(const StringView& sni)
@@ -397,6 +430,7 @@ private:
     ByteBuffer build_change_cipher_spec();
     ByteBuffer build_verify_request();
     void build_rsa_pre_master_secret(PacketBuilder&);
+    void build_ecdhe_rsa_pre_master_secret(PacketBuilder&);
 
     bool flush();
     void write_into_socket();
@@ -408,7 +442,10 @@ private:
     ssize_t handle_handshake_finished(ReadonlyBytes, WritePacketStage&);
     ssize_t handle_certificate(ReadonlyBytes);
     ssize_t handle_server_key_exchange(ReadonlyBytes);
+    ssize_t handle_ecdhe_rsa_server_key_exchange(ReadonlyBytes);
+    bool verify_rsa_server_key_exchange(ReadonlyBytes server_key_info, ReadonlyBytes signature, HashAlgorithm);
     ssize_t handle_server_hello_done(ReadonlyBytes);
+    ssize_t handle_new_session_ticket(ReadonlyBytes);
     ssize_t handle_certificate_verify(ReadonlyBytes);
     ssize_t handle_handshake_payload(ReadonlyBytes);
     ssize_t handle_message(ReadonlyBytes);
@@ -488,6 +525,9 @@ private:
 
     bool compute_master_secret_from_pre_master_secret(size_t length);
 
+    void offer_cached_session();
+    void store_session();
+
     Optional<size_t> verify_chain_and_get_matching_certificate(const StringView& host) const;
 
     void try_disambiguate_error() const;
@@ -21,7 +21,8 @@ Threading::Thread::Thread(Function<intptr_t()> action, StringView thread_name)
 Threading::Thread::~Thread()
 {
     if (m_tid) {
-        dbgln("Destroying thread \"{}\"({}) while it is still running!", m_thread_name, m_tid);
+        if (!m_has_exited)
+            dbgln("Destroying thread \"{}\"({}) while it is still running!", m_thread_name, m_tid);
         [[maybe_unused]] auto res = join();
     }
 }
@@ -34,7 +35,7 @@ void Threading::Thread::start()
         [](void* arg) -> void* {
             Thread* self = static_cast<Thread*>(arg);
             auto exit_code = self->m_action();
-            self->m_tid = 0;
+            self->m_has_exited = true;
             return reinterpret_cast<void*>(exit_code);
         },
         static_cast<void*>(this));
@@ -42,7 +43,8 @@ void Threading::Thread::start()
     VERIFY(rc == 0);
     if (!m_thread_name.is_empty()) {
         rc = pthread_setname_np(m_tid, m_thread_name.characters());
-        VERIFY(rc == 0);
+        // A short-lived thread may already be gone by now.
+        VERIFY(rc == 0 || m_has_exited);
     }
     dbgln("Started thread \"{}\", tid = {}", m_thread_name, m_tid);
 }
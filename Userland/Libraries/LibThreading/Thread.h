@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <AK/Atomic.h>
 #include <AK/DistinctNumeric.h>
 #include <AK/Function.h>
 #include <AK/Result.h>
@@ -30,11 +31,14 @@ public:
 
     String thread_name() const { return m_thread_name; }
     pthread_t tid() const { return m_tid; }
+    bool has_exited() const { return m_has_exited; }
 
 private:
     explicit Thread(Function<intptr_t()> action, StringView thread_name = nullptr);
     Function<intptr_t()> m_action;
+    // Stays set until the thread is joined, even after it has exited.
     pthread_t m_tid { 0 };
+    Atomic<bool> m_has_exited { false };
     String m_thread_name;
 };
 
@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/NumericLimits.h>
+#include <LibWeb/CSS/AncestorFilter.h>
+#include <LibWeb/DOM/Element.h>
+#include <LibWeb/HTML/AttributeNames.h>
+
+namespace Web::CSS {
+
+void AncestorFilter::add(u32 hash)
+{
+    for (auto index : { hash & counter_mask, (hash >> 12) & counter_mask }) {
+        if (m_counters[index] != NumericLimits<u8>::max())
+            ++m_counters[index];
+    }
+}
+
+void AncestorFilter::remove(u32 hash)
+{
+    for (auto index : { hash & counter_mask, (hash >> 12) & counter_mask }) {
+        // A saturated counter has lost track of how many entries it holds, so it has to stay set.
+        if (m_counters[index] != NumericLimits<u8>::max())
+            --m_counters[index];
+    }
+}
+
+void AncestorFilter::push_ancestor(const DOM::Element& element)
+{
+    m_ancestors.append({ &element, m_hashes.size() });
+
+    auto id = element.attribute(HTML::AttributeNames::id);
+    if (!id.is_empty())
+        m_hashes.append(hash_for(KeyType::Id, id.hash()));
+    for (auto& class_name : element.class_names())
+        m_hashes.append(hash_for(KeyType::Class, class_name.hash()));
+    m_hashes.append(hash_for(KeyType::TagName, element.local_name().hash()));
+
+    for (size_t i = m_ancestors.last().first_hash; i < m_hashes.size(); ++i)
+        add(m_hashes[i]);
+}
+
+void AncestorFilter::pop_ancestor(const DOM::Element& element)
+{
+    VERIFY(!m_ancestors.is_empty() && m_ancestors.last().element == &element);
+    auto ancestor = m_ancestors.take_last();
+    while (m_hashes.size() > ancestor.first_hash)
+        remove(m_hashes.take_last());
+}
+
+bool AncestorFilter::is_valid_for(const DOM::Element& element) const
+{
+    auto* parent = element.parent_element();
+    if (m_ancestors.is_empty())
+        return !parent;
+    return parent == m_ancestors.last().element;
+}
+
+}
@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Array.h>
+#include <AK/HashFunctions.h>
+#include <AK/Span.h>
+#include <AK/Vector.h>
+#include <LibWeb/Forward.h>
+
+namespace Web::CSS {
+
+// A counting Bloom filter over the ids, classes and tag names of the elements on the current
+// path from the root, maintained while walking the DOM during style resolution. It lets the
+// style resolver throw away descendant/child selectors whose ancestor parts cannot possibly
+// match, without walking up the tree. False positives are fine, false negatives are not.
+class AncestorFilter {
+public:
+    enum class KeyType : u32 {
+        Id = 1,
+        Class,
+        TagName,
+    };
+
+    static u32 hash_for(KeyType type, u32 string_hash)
+    {
+        auto hash = pair_int_hash(string_hash, (u32)type);
+        // Zero terminates a list of hashes, see Selector::ancestor_hashes().
+        return hash ? hash : 1;
+    }
+
+    void push_ancestor(const DOM::Element&);
+    void pop_ancestor(const DOM::Element&);
+
+    // The filter only describes the ancestors of an element if the walk that fed it is currently at that element's parent.
+    bool is_valid_for(const DOM::Element&) const;
+
+    bool may_contain_all(Span<const u32> hashes) const
+    {
+        for (auto hash : hashes) {
+            if (!hash)
+                break;
+            if (!m_counters[hash & counter_mask] || !m_counters[(hash >> 12) & counter_mask])
+                return false;
+        }
+        return true;
+    }
+
+private:
+    static constexpr size_t counter_count = 4096;
+    static constexpr size_t counter_mask = counter_count - 1;
+
+    void add(u32 hash);
+    void remove(u32 hash);
+
+    struct Ancestor {
+        const DOM::Element* element { nullptr };
+        size_t first_hash { 0 };
+    };
+
+    Array<u8, counter_count> m_counters {};
+    Vector<Ancestor, 32> m_ancestors;
+    // The hashes each ancestor was pushed with, so popping doesn't depend on its attributes staying the same.
+    Vector<u32, 128> m_hashes;
+};
+
+}
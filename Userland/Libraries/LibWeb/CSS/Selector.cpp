@@ -6,6 +6,7 @@
 
 #include "Selector.h"
 #include <AK/StringUtils.h>
+#include <LibWeb/CSS/AncestorFilter.h>
 #include <LibWeb/CSS/Selector.h>
 #include <ctype.h>
 
@@ -14,6 +15,16 @@ namespace Web::CSS {
 Selector::Selector(Vector<ComplexSelector>&& component_lists)
     : m_complex_selectors(move(component_lists))
 {
+    collect_ancestor_hashes();
+
+    for (auto& complex_selector : m_complex_selectors) {
+        if (complex_selector.relation == ComplexSelector::Relation::AdjacentSibling || complex_selector.relation == ComplexSelector::Relation::GeneralSibling)
+            m_is_state_or_position_dependent = true;
+        for (auto& simple_selector : complex_selector.compound_selector) {
+            if (simple_selector.pseudo_class != SimpleSelector::PseudoClass::None)
+                m_is_state_or_position_dependent = true;
+        }
+    }
 }
 
 Selector::~Selector()
@@ -47,6 +58,38 @@ u32 Selector::specificity() const
     return ids * 0x10000 + classes * 0x100 + tag_names;
 }
 
+void Selector::collect_ancestor_hashes()
+{
+    size_t next_hash = 0;
+    auto append = [&](AncestorFilter::KeyType type, const FlyString& value) {
+        if (next_hash < m_ancestor_hashes.size())
+            m_ancestor_hashes[next_hash++] = AncestorFilter::hash_for(type, value.hash());
+    };
+
+    // Only compounds that are reached through child and descendant combinators are guaranteed to
+    // match an ancestor; anything behind a sibling combinator may match a sibling of one instead.
+    for (ssize_t i = m_complex_selectors.size() - 1; i > 0; --i) {
+        auto relation = m_complex_selectors[i].relation;
+        if (relation != ComplexSelector::Relation::Descendant && relation != ComplexSelector::Relation::ImmediateChild)
+            break;
+        for (auto& simple_selector : m_complex_selectors[i - 1].compound_selector) {
+            switch (simple_selector.type) {
+            case SimpleSelector::Type::Id:
+                append(AncestorFilter::KeyType::Id, simple_selector.value);
+                break;
+            case SimpleSelector::Type::Class:
+                append(AncestorFilter::KeyType::Class, simple_selector.value);
+                break;
+            case SimpleSelector::Type::TagName:
+                append(AncestorFilter::KeyType::TagName, simple_selector.value);
+                break;
+            default:
+                break;
+            }
+        }
+    }
+}
+
 Selector::SimpleSelector::NthChildPattern Selector::SimpleSelector::NthChildPattern::parse(const StringView& args)
 {
     CSS::Selector::SimpleSelector::NthChildPattern pattern;
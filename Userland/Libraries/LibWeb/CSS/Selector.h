@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <AK/Array.h>
 #include <AK/FlyString.h>
 #include <AK/String.h>
 #include <AK/Vector.h>
@@ -103,8 +104,21 @@ public:
 
     u32 specificity() const;
 
+    // Hashes (see AncestorFilter) of ids, classes and tag names that some ancestor of a matching element must have.
+    // Zero-terminated unless all slots are used.
+    const Array<u32, 4>& ancestor_hashes() const { return m_ancestor_hashes; }
+
+    // Whether matching looks at anything besides the names and attributes of the element and its ancestors,
+    // i.e. pseudo-classes and sibling combinators. Elements that only differ in position or state can't share style
+    // if one of these might match them.
+    bool is_state_or_position_dependent() const { return m_is_state_or_position_dependent; }
+
 private:
+    void collect_ancestor_hashes();
+
     Vector<ComplexSelector> m_complex_selectors;
+    Array<u32, 4> m_ancestor_hashes {};
+    bool m_is_state_or_position_dependent { false };
 };
 
 }
@@ -4,52 +4,61 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
-#include <LibWeb/CSS/CSSStyleRule.h>
 #include <LibWeb/CSS/StyleInvalidator.h>
+#include <LibWeb/CSS/StyleResolver.h>
 #include <LibWeb/DOM/Document.h>
 #include <LibWeb/DOM/Element.h>
 
 namespace Web::CSS {
 
-StyleInvalidator::StyleInvalidator(DOM::Document& document)
-    : m_document(document)
+StyleInvalidator::StyleInvalidator(DOM::Element& element, const FlyString& attribute_name)
+    : m_element(element)
+    , m_attribute_name(attribute_name)
 {
-    if (!m_document.should_invalidate_styles_on_attribute_changes())
+    if (!m_element.document().should_invalidate_styles_on_attribute_changes())
         return;
-    auto& style_resolver = m_document.style_resolver();
-    m_document.for_each_in_inclusive_subtree_of_type<DOM::Element>([&](auto& element) {
-        m_elements_and_matching_rules_before.set(&element, style_resolver.collect_matching_rules(element));
-        return IterationDecision::Continue;
-    });
+    m_had_attribute = m_element.has_attribute(m_attribute_name);
+    m_old_value = m_element.attribute(m_attribute_name);
+    if (m_attribute_name == HTML::AttributeNames::class_)
+        m_old_class_names = m_element.class_names();
 }
 
 StyleInvalidator::~StyleInvalidator()
 {
-    if (!m_document.should_invalidate_styles_on_attribute_changes())
+    auto& document = m_element.document();
+    if (!document.should_invalidate_styles_on_attribute_changes())
         return;
-    auto& style_resolver = m_document.style_resolver();
-    m_document.for_each_in_inclusive_subtree_of_type<DOM::Element>([&](auto& element) {
-        auto maybe_matching_rules_before = m_elements_and_matching_rules_before.get(&element);
-        if (!maybe_matching_rules_before.has_value()) {
-            element.set_needs_style_update(true);
-            return IterationDecision::Continue;
-        }
-        auto& matching_rules_before = maybe_matching_rules_before.value();
-        auto matching_rules_after = style_resolver.collect_matching_rules(element);
-        if (matching_rules_before.size() != matching_rules_after.size()) {
-            element.set_needs_style_update(true);
-            return IterationDecision::Continue;
+    if (m_had_attribute == m_element.has_attribute(m_attribute_name) && m_old_value == m_element.attribute(m_attribute_name))
+        return;
+
+    auto& style_resolver = document.style_resolver();
+    auto invalidation = style_resolver.invalidation_for_attribute(m_attribute_name);
+
+    if (m_attribute_name == HTML::AttributeNames::id) {
+        invalidation.merge(style_resolver.invalidation_for_id(m_old_value));
+        invalidation.merge(style_resolver.invalidation_for_id(m_element.attribute(m_attribute_name)));
+    } else if (m_attribute_name == HTML::AttributeNames::class_) {
+        // Only the classes that were added or removed matter.
+        auto& new_class_names = m_element.class_names();
+        for (auto& class_name : m_old_class_names) {
+            if (!new_class_names.contains_slow(class_name))
+                invalidation.merge(style_resolver.invalidation_for_class(class_name));
         }
-        style_resolver.sort_matching_rules(matching_rules_before);
-        style_resolver.sort_matching_rules(matching_rules_after);
-        for (size_t i = 0; i < matching_rules_before.size(); ++i) {
-            if (matching_rules_before[i].rule != matching_rules_after[i].rule) {
-                element.set_needs_style_update(true);
-                break;
-            }
+        for (auto& class_name : new_class_names) {
+            if (!m_old_class_names.contains_slow(class_name))
+                invalidation.merge(style_resolver.invalidation_for_class(class_name));
         }
-        return IterationDecision::Continue;
-    });
+    }
+
+    if (invalidation.descendants)
+        m_element.invalidate_style();
+    else if (invalidation.element)
+        m_element.set_needs_style_update(true);
+
+    if (invalidation.later_siblings) {
+        for (auto* sibling = m_element.next_sibling(); sibling; sibling = sibling->next_sibling())
+            sibling->invalidate_style();
+    }
 }
 
 }
@@ -6,21 +6,26 @@
 
 #pragma once
 
-#include <AK/HashMap.h>
-#include <LibWeb/CSS/StyleResolver.h>
-#include <LibWeb/DOM/Document.h>
+#include <AK/FlyString.h>
+#include <AK/String.h>
+#include <AK/Vector.h>
 #include <LibWeb/DOM/Element.h>
 
 namespace Web::CSS {
 
+// Put one of these on the stack while changing an attribute of an element. When it goes out of scope, it marks the
+// elements whose style may have changed because of it, according to the document's style sheets.
 class StyleInvalidator {
 public:
-    explicit StyleInvalidator(DOM::Document&);
+    StyleInvalidator(DOM::Element&, const FlyString& attribute_name);
     ~StyleInvalidator();
 
 private:
-    DOM::Document& m_document;
-    HashMap<DOM::Element*, Vector<MatchingRule>> m_elements_and_matching_rules_before;
+    DOM::Element& m_element;
+    FlyString m_attribute_name;
+    bool m_had_attribute { false };
+    String m_old_value;
+    Vector<FlyString> m_old_class_names;
 };
 
 }
@@ -14,6 +14,7 @@
 #include <LibWeb/DOM/Document.h>
 #include <LibWeb/DOM/Element.h>
 #include <LibWeb/Dump.h>
+#include <LibWeb/HTML/AttributeNames.h>
 #include <ctype.h>
 #include <stdio.h>
 
@@ -61,9 +62,73 @@ void StyleResolver::for_each_stylesheet(Callback callback) const
     }
 }
 
-Vector<MatchingRule> StyleResolver::collect_matching_rules(const DOM::Element& element) const
+void StyleResolver::invalidate_rule_cache()
 {
-    Vector<MatchingRule> matching_rules;
+    m_rule_cache = nullptr;
+    m_style_sharing_candidates.clear();
+}
+
+void StyleResolver::collect_invalidation_sets(const Selector& selector, RuleCache& rule_cache)
+{
+    auto& complex_selectors = selector.complex_selectors();
+    StyleInvalidation invalidation;
+    invalidation.element = true;
+
+    // Walk from the subject leftwards. A compound that's further left only matters to the elements its
+    // combinators lead to: descendants for child and descendant combinators, later siblings for sibling combinators.
+    for (ssize_t i = complex_selectors.size() - 1; i >= 0; --i) {
+        for (auto& simple_selector : complex_selectors[i].compound_selector) {
+            if (simple_selector.type == Selector::SimpleSelector::Type::Id)
+                rule_cache.invalidation_by_id.ensure(simple_selector.value).merge(invalidation);
+            else if (simple_selector.type == Selector::SimpleSelector::Type::Class)
+                rule_cache.invalidation_by_class.ensure(simple_selector.value).merge(invalidation);
+
+            if (simple_selector.attribute_match_type != Selector::SimpleSelector::AttributeMatchType::None)
+                rule_cache.invalidation_by_attribute.ensure(simple_selector.attribute_name).merge(invalidation);
+
+            switch (simple_selector.pseudo_class) {
+            case Selector::SimpleSelector::PseudoClass::Link:
+            case Selector::SimpleSelector::PseudoClass::Visited:
+                rule_cache.invalidation_by_attribute.ensure(HTML::AttributeNames::href).merge(invalidation);
+                break;
+            case Selector::SimpleSelector::PseudoClass::Disabled:
+            case Selector::SimpleSelector::PseudoClass::Enabled:
+                rule_cache.invalidation_by_attribute.ensure(HTML::AttributeNames::disabled).merge(invalidation);
+                break;
+            case Selector::SimpleSelector::PseudoClass::Checked:
+                rule_cache.invalidation_by_attribute.ensure(HTML::AttributeNames::checked).merge(invalidation);
+                break;
+            case Selector::SimpleSelector::PseudoClass::Not:
+                rule_cache.invalidation_for_any_attribute.merge(invalidation);
+                break;
+            default:
+                break;
+            }
+        }
+
+        switch (complex_selectors[i].relation) {
+        case Selector::ComplexSelector::Relation::AdjacentSibling:
+        case Selector::ComplexSelector::Relation::GeneralSibling:
+            invalidation.later_siblings = true;
+            break;
+        case Selector::ComplexSelector::Relation::None:
+            break;
+        default:
+            invalidation.descendants = true;
+            break;
+        }
+        invalidation.element = false;
+    }
+}
+
+const StyleResolver::RuleCache& StyleResolver::rule_cache() const
+{
+    if (m_rule_cache && m_rule_cache->in_quirks_mode == document().in_quirks_mode())
+        return *m_rule_cache;
+
+    auto rule_cache = make<RuleCache>();
+    rule_cache->in_quirks_mode = document().in_quirks_mode();
+    m_style_sharing_candidates.clear();
 
     size_t style_sheet_index = 0;
     for_each_stylesheet([&](auto& sheet) {
@@ -73,10 +138,31 @@ Vector<MatchingRule> StyleResolver::collect_matching_rules(const DOM::Element& e
         static_cast<const CSSStyleSheet&>(sheet).for_each_effective_style_rule([&](auto& rule) {
             size_t selector_index = 0;
             for (auto& selector : rule.selectors()) {
-                if (SelectorEngine::matches(selector, element)) {
-                    matching_rules.append({ rule, style_sheet_index, rule_index, selector_index, selector.specificity() });
-                    break;
+                MatchingRule matching_rule { rule, style_sheet_index, rule_index, selector_index, selector.specificity() };
+                const FlyString* id = nullptr;
+                const FlyString* class_name = nullptr;
+                const FlyString* tag_name = nullptr;
+                for (auto& simple_selector : selector.complex_selectors().last().compound_selector) {
+                    if (simple_selector.type == Selector::SimpleSelector::Type::Id && !id)
+                        id = &simple_selector.value;
+                    else if (simple_selector.type == Selector::SimpleSelector::Type::Class && !class_name)
+                        class_name = &simple_selector.value;
+                    else if (simple_selector.type == Selector::SimpleSelector::Type::TagName && !tag_name)
+                        tag_name = &simple_selector.value;
                 }
+                auto& bucket = [&]() -> RuleBucket& {
+                    if (id)
+                        return rule_cache->rules_by_id.ensure(*id);
+                    if (class_name)
+                        return rule_cache->rules_by_class.ensure(*class_name);
+                    if (tag_name)
+                        return rule_cache->rules_by_tag_name.ensure(*tag_name);
+                    return rule_cache->other_rules;
+                }();
+                bucket.rules.append(move(matching_rule));
+                if (selector.is_state_or_position_dependent())
+                    bucket.has_state_or_position_dependent_selectors = true;
+                collect_invalidation_sets(selector, *rule_cache);
                 ++selector_index;
             }
             ++rule_index;
@@ -84,6 +170,76 @@ Vector<MatchingRule> StyleResolver::collect_matching_rules(const DOM::Element& e
         ++style_sheet_index;
     });
 
+    m_rule_cache = move(rule_cache);
+    return *m_rule_cache;
+}
+
+StyleInvalidation StyleResolver::invalidation_for_id(const FlyString& id) const
+{
+    return rule_cache().invalidation_by_id.get(id).value_or({});
+}
+
+StyleInvalidation StyleResolver::invalidation_for_class(const FlyString& class_name) const
+{
+    return rule_cache().invalidation_by_class.get(class_name).value_or({});
+}
+
+StyleInvalidation StyleResolver::invalidation_for_attribute(const FlyString& attribute_name) const
+{
+    auto& rule_cache = this->rule_cache();
+    auto invalidation = rule_cache.invalidation_for_any_attribute;
+    if (auto it = rule_cache.invalidation_by_attribute.find(attribute_name); it != rule_cache.invalidation_by_attribute.end())
+        invalidation.merge(it->value);
+    return invalidation;
+}
+
+template<typename Callback>
+void StyleResolver::for_each_rule_bucket(const DOM::Element& element, Callback callback) const
+{
+    auto& rule_cache = this->rule_cache();
+    if (auto id = element.attribute(HTML::AttributeNames::id); !id.is_empty()) {
+        if (auto it = rule_cache.rules_by_id.find(id); it != rule_cache.rules_by_id.end())
+            callback(it->value);
+    }
+    for (auto& class_name : element.class_names()) {
+        if (auto it = rule_cache.rules_by_class.find(class_name); it != rule_cache.rules_by_class.end())
+            callback(it->value);
+    }
+    if (auto it = rule_cache.rules_by_tag_name.find(element.local_name()); it != rule_cache.rules_by_tag_name.end())
+        callback(it->value);
+    callback(rule_cache.other_rules);
+}
+
+Vector<MatchingRule> StyleResolver::collect_matching_rules(const DOM::Element& element) const
+{
+    bool can_use_ancestor_filter = m_ancestor_filter.is_valid_for(element);
+
+    Vector<MatchingRule> matching_rules;
+    for_each_rule_bucket(element, [&](const RuleBucket& bucket) {
+        for (auto& candidate : bucket.rules) {
+            auto& selector = candidate.rule->selectors()[candidate.selector_index];
+            if (can_use_ancestor_filter && !m_ancestor_filter.may_contain_all(selector.ancestor_hashes().span()))
+                continue;
+            if (SelectorEngine::matches(selector, element))
+                matching_rules.append(candidate);
+        }
+    });
+
+    // Put the rules back into style sheet order, and only keep the first matching selector of each rule.
+    quick_sort(matching_rules, [](auto& a, auto& b) {
+        if (a.style_sheet_index != b.style_sheet_index)
+            return a.style_sheet_index < b.style_sheet_index;
+        if (a.rule_index != b.rule_index)
+            return a.rule_index < b.rule_index;
+        return a.selector_index < b.selector_index;
+    });
+    for (size_t i = 1; i < matching_rules.size();) {
+        if (matching_rules[i].style_sheet_index == matching_rules[i - 1].style_sheet_index && matching_rules[i].rule_index == matching_rules[i - 1].rule_index)
+            matching_rules.remove(i);
+        else
+            ++i;
+    }
+
     return matching_rules;
 }
 
@@ -861,8 +1017,94 @@ Optional<StyleProperty> StyleResolver::resolve_custom_property(DOM::Element& ele
     return resolved_with_specificity.style;
 }
 
+static bool have_same_name_and_attributes(const DOM::Element& a, const DOM::Element& b)
+{
+    if (a.local_name() != b.local_name() || a.namespace_() != b.namespace_())
+        return false;
+    if (a.inline_style() || b.inline_style())
+        return false;
+    if (a.attribute_list_size() != b.attribute_list_size())
+        return false;
+    bool same = true;
+    a.for_each_attribute([&](auto& name, auto& value) {
+        if (same && b.attribute(name) != value)
+            same = false;
+    });
+    return same;
+}
+
+bool StyleResolver::can_share_style(const DOM::Element& element) const
+{
+    // Sharing is limited to tree walks, which keep the candidates' ancestors alive and unchanged.
+    if (!element.parent_element() || !m_ancestor_filter.is_valid_for(element))
+        return false;
+    if (element.inline_style())
+        return false;
+    bool has_state_or_position_dependent_selectors = false;
+    for_each_rule_bucket(element, [&](const RuleBucket& bucket) {
+        if (bucket.has_state_or_position_dependent_selectors)
+            has_state_or_position_dependent_selectors = true;
+    });
+    return !has_state_or_position_dependent_selectors;
+}
+
+RefPtr<StyleProperties> StyleResolver::find_shared_style(const DOM::Element& element) const
+{
+    auto* parent = element.parent_element();
+    for (ssize_t i = m_style_sharing_candidates.size() - 1; i >= 0; --i) {
+        auto& candidate = m_style_sharing_candidates[i];
+        if (!have_same_name_and_attributes(*candidate.element, element))
+            continue;
+        auto* candidate_parent = candidate.element->parent_element();
+        if (candidate_parent != parent) {
+            // Cousins: the parents must be interchangeable siblings that already share one style.
+            auto* grandparent = parent->parent_element();
+            if (!grandparent || candidate_parent->parent_element() != grandparent)
+                continue;
+            if (!parent->specified_css_values() || parent->specified_css_values() != candidate_parent->specified_css_values())
+                continue;
+            if (!have_same_name_and_attributes(*candidate_parent, *parent))
+                continue;
+            bool parent_has_state_or_position_dependent_selectors = false;
+            for_each_rule_bucket(*parent, [&](const RuleBucket& bucket) {
+                if (bucket.has_state_or_position_dependent_selectors)
+                    parent_has_state_or_position_dependent_selectors = true;
+            });
+            if (parent_has_state_or_position_dependent_selectors)
+                continue;
+        }
+        return candidate.style;
+    }
+    return nullptr;
+}
+
+void StyleResolver::add_style_sharing_candidate(const DOM::Element& element, NonnullRefPtr<StyleProperties> style) const
+{
+    static constexpr size_t max_candidates = 16;
+    if (m_style_sharing_candidates.size() == max_candidates)
+        m_style_sharing_candidates.remove(0);
+
+    auto* parent = element.parent_element();
+    auto* grandparent = parent->parent_element();
+    m_style_sharing_candidates.append({ &element, grandparent ? grandparent : parent, move(style) });
+}
+
+void StyleResolver::pop_ancestor(const DOM::Element& element)
+{
+    m_ancestor_filter.pop_ancestor(element);
+    m_style_sharing_candidates.remove_all_matching([&](auto& candidate) {
+        return candidate.scope == &element;
+    });
+}
+
 NonnullRefPtr<StyleProperties> StyleResolver::resolve_style(DOM::Element& element) const
 {
+    bool can_share_style = this->can_share_style(element);
+    if (can_share_style) {
+        if (auto shared_style = find_shared_style(element))
+            return shared_style.release_nonnull();
+    }
+
     auto style = StyleProperties::create();
 
     if (auto* parent_style = element.parent_element() ? element.parent_element()->specified_css_values() : nullptr) {
@@ -898,6 +1140,9 @@ NonnullRefPtr<StyleProperties> StyleResolver::resolve_style(DOM::Element& elemen
         }
     }
 
+    if (can_share_style)
+        add_style_sharing_candidate(element, style);
+
     return style;
 }
 
@@ -6,8 +6,11 @@
 
 #pragma once
 
+#include <AK/FlyString.h>
+#include <AK/HashMap.h>
 #include <AK/NonnullRefPtrVector.h>
 #include <AK/OwnPtr.h>
+#include <LibWeb/CSS/AncestorFilter.h>
 #include <LibWeb/CSS/CSSStyleDeclaration.h>
 #include <LibWeb/CSS/StyleProperties.h>
 #include <LibWeb/Forward.h>
@@ -22,6 +25,21 @@ struct MatchingRule {
     u32 specificity { 0 };
 };
 
+// What has to be restyled when an element gains or loses an id, class or attribute that some selector looks at.
+struct StyleInvalidation {
+    bool element { false };
+    bool descendants { false };
+    bool later_siblings { false }; // Along with their descendants.
+
+    bool is_empty() const { return !element && !descendants && !later_siblings; }
+    void merge(const StyleInvalidation& other)
+    {
+        element |= other.element;
+        descendants |= other.descendants;
+        later_siblings |= other.later_siblings;
+    }
+};
+
 class StyleResolver {
 public:
     explicit StyleResolver(DOM::Document&);
@@ -43,11 +61,63 @@ public:
 
     static bool is_inherited_property(CSS::PropertyID);
 
+    // Must be called whenever the set of style rules in the document's style sheets changes.
+    void invalidate_rule_cache();
+
+    // Which elements around an element may match different selectors once the element's id, classes or attributes change.
+    StyleInvalidation invalidation_for_id(const FlyString&) const;
+    StyleInvalidation invalidation_for_class(const FlyString&) const;
+    StyleInvalidation invalidation_for_attribute(const FlyString&) const;
+
+    // Tree walks that resolve style for many elements should push each element before descending into its
+    // children and pop it afterwards, so that selectors with ancestor parts can be rejected cheaply.
+    void push_ancestor(const DOM::Element& element) { m_ancestor_filter.push_ancestor(element); }
+    void pop_ancestor(const DOM::Element&);
+
 private:
     template<typename Callback>
     void for_each_stylesheet(Callback) const;
 
+    // Every selector of every style rule, filed under the id, class or tag name its rightmost compound
+    // requires (in that order of preference), or under other_rules if it requires none of them.
+    struct RuleBucket {
+        Vector<MatchingRule> rules;
+        bool has_state_or_position_dependent_selectors { false };
+    };
+    struct RuleCache {
+        HashMap<FlyString, RuleBucket> rules_by_id;
+        HashMap<FlyString, RuleBucket> rules_by_class;
+        HashMap<FlyString, RuleBucket> rules_by_tag_name;
+        RuleBucket other_rules;
+        HashMap<FlyString, StyleInvalidation> invalidation_by_id;
+        HashMap<FlyString, StyleInvalidation> invalidation_by_class;
+        HashMap<FlyString, StyleInvalidation> invalidation_by_attribute;
+        StyleInvalidation invalidation_for_any_attribute; // From selectors we can't see into, like :not().
+        bool in_quirks_mode { false };
+    };
+    const RuleCache& rule_cache() const;
+    static void collect_invalidation_sets(const Selector&, RuleCache&);
+
+    // Calls the callback with every bucket that may contain rules matching the element.
+    template<typename Callback>
+    void for_each_rule_bucket(const DOM::Element&, Callback) const;
+
+    // Elements with the same name and attributes whose parents are the same element, or equivalent siblings
+    // sharing one style, end up with the same style unless a state or position dependent selector is involved.
+    // The last few elements resolved during a tree walk are remembered so their style can be reused.
+    struct StyleSharingCandidate {
+        const DOM::Element* element { nullptr };
+        const DOM::Element* scope { nullptr }; // The outermost ancestor that has to match, the entry goes away when it's popped.
+        NonnullRefPtr<StyleProperties> style;
+    };
+    bool can_share_style(const DOM::Element&) const;
+    RefPtr<StyleProperties> find_shared_style(const DOM::Element&) const;
+    void add_style_sharing_candidate(const DOM::Element&, NonnullRefPtr<StyleProperties>) const;
+
     DOM::Document& m_document;
+    mutable OwnPtr<RuleCache> m_rule_cache;
+    AncestorFilter m_ancestor_filter;
+    mutable Vector<StyleSharingCandidate, 16> m_style_sharing_candidates;
 };
 
 }
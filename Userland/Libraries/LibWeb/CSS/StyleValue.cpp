@@ -24,6 +24,55 @@ StyleValue::~StyleValue()
 {
 }
 
+// Style values never change once created, so the common ones are handed out as shared instances instead of
+// being allocated again for every declaration and every element that expands a shorthand.
+
+NonnullRefPtr<InitialStyleValue> InitialStyleValue::create()
+{
+    static NonnullRefPtr<InitialStyleValue> value = adopt_ref(*new InitialStyleValue);
+    return value;
+}
+
+NonnullRefPtr<InheritStyleValue> InheritStyleValue::create()
+{
+    static NonnullRefPtr<InheritStyleValue> value = adopt_ref(*new InheritStyleValue);
+    return value;
+}
+
+NonnullRefPtr<LengthStyleValue> LengthStyleValue::create(const Length& length)
+{
+    static NonnullRefPtr<LengthStyleValue> auto_value = adopt_ref(*new LengthStyleValue(Length::make_auto()));
+    static NonnullRefPtr<LengthStyleValue> zero_px_value = adopt_ref(*new LengthStyleValue(Length::make_px(0)));
+    if (length == auto_value->length())
+        return auto_value;
+    if (length == zero_px_value->length())
+        return zero_px_value;
+    return adopt_ref(*new LengthStyleValue(length));
+}
+
+NonnullRefPtr<ColorStyleValue> ColorStyleValue::create(Color color)
+{
+    // Pages tend to use a handful of colors over and over, but there's no upper bound, so stop interning at some point.
+    static constexpr size_t max_interned_colors = 256;
+    static HashMap<u32, NonnullRefPtr<ColorStyleValue>> interned_values;
+    if (auto it = interned_values.find(color.value()); it != interned_values.end())
+        return it->value;
+    auto value = adopt_ref(*new ColorStyleValue(color));
+    if (interned_values.size() < max_interned_colors)
+        interned_values.set(color.value(), value);
+    return value;
+}
+
+NonnullRefPtr<IdentifierStyleValue> IdentifierStyleValue::create(CSS::ValueID id)
+{
+    static HashMap<unsigned, NonnullRefPtr<IdentifierStyleValue>> interned_values;
+    if (auto it = interned_values.find((unsigned)id); it != interned_values.end())
+        return it->value;
+    auto value = adopt_ref(*new IdentifierStyleValue(id));
+    interned_values.set((unsigned)id, value);
+    return value;
+}
+
 String IdentifierStyleValue::to_string() const
 {
     return CSS::string_from_value_id(m_id);
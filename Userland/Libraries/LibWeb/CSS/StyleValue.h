@@ -310,10 +310,7 @@ private:
 
 class LengthStyleValue : public StyleValue {
 public:
-    static NonnullRefPtr<LengthStyleValue> create(const Length& length)
-    {
-        return adopt_ref(*new LengthStyleValue(length));
-    }
+    static NonnullRefPtr<LengthStyleValue> create(const Length&);
     virtual ~LengthStyleValue() override { }
 
     virtual String to_string() const override { return m_length.to_string(); }
@@ -342,7 +339,7 @@ private:
 
 class InitialStyleValue final : public StyleValue {
 public:
-    static NonnullRefPtr<InitialStyleValue> create() { return adopt_ref(*new InitialStyleValue); }
+    static NonnullRefPtr<InitialStyleValue> create();
     virtual ~InitialStyleValue() override { }
 
     String to_string() const override { return "initial"; }
@@ -356,7 +353,7 @@ private:
 
 class InheritStyleValue final : public StyleValue {
 public:
-    static NonnullRefPtr<InheritStyleValue> create() { return adopt_ref(*new InheritStyleValue); }
+    static NonnullRefPtr<InheritStyleValue> create();
     virtual ~InheritStyleValue() override { }
 
     String to_string() const override { return "inherit"; }
@@ -370,10 +367,7 @@ private:
 
 class ColorStyleValue : public StyleValue {
 public:
-    static NonnullRefPtr<ColorStyleValue> create(Color color)
-    {
-        return adopt_ref(*new ColorStyleValue(color));
-    }
+    static NonnullRefPtr<ColorStyleValue> create(Color);
     virtual ~ColorStyleValue() override { }
 
     Color color() const { return m_color; }
@@ -399,10 +393,7 @@ private:
 
 class IdentifierStyleValue final : public StyleValue {
 public:
-    static NonnullRefPtr<IdentifierStyleValue> create(CSS::ValueID id)
-    {
-        return adopt_ref(*new IdentifierStyleValue(id));
-    }
+    static NonnullRefPtr<IdentifierStyleValue> create(CSS::ValueID);
     virtual ~IdentifierStyleValue() override { }
 
     CSS::ValueID id() const { return m_id; }
@@ -6,6 +6,7 @@
 
 #include <LibWeb/DOM/CharacterData.h>
 #include <LibWeb/DOM/Document.h>
+#include <LibWeb/Layout/Node.h>
 
 namespace Web::DOM {
 
@@ -24,8 +25,13 @@ void CharacterData::set_data(String data)
     if (m_data == data)
         return;
     m_data = move(data);
-    // FIXME: This is definitely too aggressive.
-    document().schedule_forced_layout();
+    if (layout_node()) {
+        layout_node()->set_needs_layout();
+        document().schedule_layout_update();
+    } else if (parent() && parent()->layout_node()) {
+        // We may need a layout node now, e.g. if we were all whitespace before.
+        document().invalidate_layout_for_children_of(*parent());
+    }
 }
 
 }
@@ -69,6 +69,10 @@ Document::Document(const URL& url)
         update_style();
     });
 
+    m_layout_update_timer = Core::Timer::create_single_shot(0, [this] {
+        update_layout();
+    });
+
     m_forced_layout_timer = Core::Timer::create_single_shot(0, [this] {
         force_layout();
     });
@@ -97,6 +101,7 @@ void Document::removed_last_ref()
         m_inspected_node = nullptr;
         m_scripts_to_execute_when_parsing_has_finished.clear();
         m_scripts_to_execute_as_soon_as_possible.clear();
+        m_nodes_with_invalidated_layout_children.clear();
         m_associated_inert_template_document = nullptr;
 
         m_interpreter = nullptr;
@@ -150,6 +155,13 @@ void Document::schedule_style_update()
     m_style_update_timer->start();
 }
 
+void Document::schedule_layout_update()
+{
+    if (m_layout_update_timer->is_active())
+        return;
+    m_layout_update_timer->start();
+}
+
 void Document::schedule_forced_layout()
 {
     if (m_forced_layout_timer->is_active())
@@ -301,6 +313,8 @@ void Document::detach_from_browsing_context(Badge<BrowsingContext>, BrowsingCont
 
 void Document::tear_down_layout_tree()
 {
+    m_nodes_with_invalidated_layout_children.clear();
+
     if (!m_layout_root)
         return;
 
@@ -391,24 +405,93 @@ void Document::invalidate_layout()
     tear_down_layout_tree();
 }
 
+void Document::invalidate_layout_for_children_of(Node& node)
+{
+    // Without a layout tree there's nothing to patch, the next layout update builds all of it anyway.
+    if (!m_layout_root)
+        return;
+    m_nodes_with_invalidated_layout_children.append(node);
+    schedule_layout_update();
+}
+
 void Document::force_layout()
 {
     invalidate_layout();
     update_layout();
 }
 
+void Document::rebuild_invalidated_layout_subtrees()
+{
+    auto nodes = move(m_nodes_with_invalidated_layout_children);
+
+    auto is_invalidated = [&](Node& node) {
+        for (auto& other : nodes) {
+            if (&other == &node)
+                return true;
+        }
+        return false;
+    };
+
+    for (auto& node : nodes) {
+        if (&node.document() != this || !node.is_connected())
+            continue;
+
+        // Nothing to do if an ancestor is rebuilt as well.
+        bool has_invalidated_ancestor = false;
+        for (auto* ancestor = node.parent_or_shadow_host(); ancestor; ancestor = ancestor->parent_or_shadow_host()) {
+            if (is_invalidated(*ancestor)) {
+                has_invalidated_ancestor = true;
+                break;
+            }
+        }
+        if (has_invalidated_ancestor)
+            continue;
+
+        // Only the children of block containers can be rebuilt in isolation, inline and table
+        // layout nodes may have siblings that were generated on their behalf.
+        Node* container = &node;
+        while (container && !Layout::TreeBuilder::can_rebuild_children(*container))
+            container = container->parent_or_shadow_host();
+        if (!container) {
+            tear_down_layout_tree();
+            break;
+        }
+
+        Layout::TreeBuilder tree_builder;
+        tree_builder.rebuild_children(*container);
+    }
+}
+
 void Document::update_layout()
 {
     if (!browsing_context())
         return;
 
+    if (m_layout_root && !m_nodes_with_invalidated_layout_children.is_empty())
+        rebuild_invalidated_layout_subtrees();
+
     if (!m_layout_root) {
         Layout::TreeBuilder tree_builder;
         m_layout_root = static_ptr_cast<Layout::InitialContainingBlockBox>(tree_builder.build(*this));
     }
 
+    // Viewport-relative lengths can be anywhere in the tree, so a new viewport size invalidates all of it.
+    auto viewport_size = browsing_context()->viewport_rect().size();
+    if (viewport_size != m_viewport_size_at_last_layout) {
+        m_layout_root->for_each_in_inclusive_subtree([](auto& layout_node) {
+            layout_node.set_needs_layout();
+            return IterationDecision::Continue;
+        });
+        m_viewport_size_at_last_layout = viewport_size;
+    }
+
+    // Nothing moved, so whatever needs repainting has been invalidated already.
+    if (!m_layout_root->needs_layout() && !m_layout_root->child_needs_layout())
+        return;
+
     Layout::BlockFormattingContext root_formatting_context(*m_layout_root, nullptr);
     root_formatting_context.run(*m_layout_root, Layout::LayoutMode::Default);
+    m_layout_root->clear_needs_layout();
 
     m_layout_root->set_needs_display();
 
@@ -427,7 +510,12 @@ static void update_style_recursively(DOM::Node& node)
             child.set_needs_style_update(false);
         }
         if (child.child_needs_style_update()) {
+            auto* element = is<Element>(child) ? &verify_cast<Element>(child) : nullptr;
+            if (element)
+                child.document().style_resolver().push_ancestor(*element);
             update_style_recursively(child);
+            if (element)
+                child.document().style_resolver().pop_ancestor(*element);
             child.set_child_needs_style_update(false);
         }
         return IterationDecision::Continue;
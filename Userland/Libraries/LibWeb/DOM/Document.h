@@ -141,15 +141,24 @@ public:
     void force_layout();
     void invalidate_layout();
 
+    // Throws away the layout nodes below the node's layout node and builds them again on the next layout update,
+    // leaving the rest of the layout tree (and its layout, where possible) alone.
+    void invalidate_layout_for_children_of(Node&);
+
     void update_style();
     void update_layout();
 
+    // How many times a layout update kept the previous layout of a subtree instead of laying it out again.
+    size_t reused_layout_count() const { return m_reused_layout_count; }
+    void did_reuse_layout() { ++m_reused_layout_count; }
+
     virtual bool is_child_allowed(const Node&) const override;
 
     const Layout::InitialContainingBlockBox* layout_node() const;
     Layout::InitialContainingBlockBox* layout_node();
 
     void schedule_style_update();
+    void schedule_layout_update();
     void schedule_forced_layout();
 
     NonnullRefPtr<HTMLCollection> get_elements_by_name(String const&);
@@ -279,6 +288,7 @@ private:
     virtual EventTarget& global_event_handlers_to_event_target() final { return *this; }
 
     void tear_down_layout_tree();
+    void rebuild_invalidated_layout_subtrees();
 
     void increment_referencing_node_count()
     {
@@ -309,12 +319,16 @@ private:
     RefPtr<Window> m_window;
 
     RefPtr<Layout::InitialContainingBlockBox> m_layout_root;
+    NonnullRefPtrVector<Node> m_nodes_with_invalidated_layout_children;
+    Gfx::IntSize m_viewport_size_at_last_layout;
+    size_t m_reused_layout_count { 0 };
 
     Optional<Color> m_link_color;
     Optional<Color> m_active_link_color;
     Optional<Color> m_visited_link_color;
 
     RefPtr<Core::Timer> m_style_update_timer;
+    RefPtr<Core::Timer> m_layout_update_timer;
     RefPtr<Core::Timer> m_forced_layout_timer;
 
     String m_source;
@@ -25,7 +25,6 @@
 #include <LibWeb/Layout/TableCellBox.h>
 #include <LibWeb/Layout/TableRowBox.h>
 #include <LibWeb/Layout/TableRowGroupBox.h>
-#include <LibWeb/Layout/TreeBuilder.h>
 #include <LibWeb/Namespace.h>
 
 namespace Web::DOM {
@@ -72,7 +71,7 @@ ExceptionOr<void> Element::set_attribute(const FlyString& name, const String& va
     if (name.is_empty())
         return InvalidCharacterError::create("Attribute name must not be empty");
 
-    CSS::StyleInvalidator style_invalidator(document());
+    CSS::StyleInvalidator style_invalidator(*this, name);
 
     if (auto* attribute = find_attribute(name))
         attribute->set_value(value);
@@ -85,7 +84,7 @@ ExceptionOr<void> Element::set_attribute(const FlyString& name, const String& va
 
 void Element::remove_attribute(const FlyString& name)
 {
-    CSS::StyleInvalidator style_invalidator(document());
+    CSS::StyleInvalidator style_invalidator(*this, name);
 
     m_attributes.remove_first_matching([&](auto& attribute) { return attribute.name() == name; });
 }
@@ -168,6 +167,7 @@ enum class StyleDifference {
     None,
     NeedsRepaint,
     NeedsRelayout,
+    NeedsRebuild,
 };
 
 static StyleDifference compute_style_difference(const CSS::StyleProperties& old_style, const CSS::StyleProperties& new_style, const Document& document)
@@ -175,22 +175,28 @@ static StyleDifference compute_style_difference(const CSS::StyleProperties& old_
     if (old_style == new_style)
         return StyleDifference::None;
 
-    bool needs_repaint = false;
-    bool needs_relayout = false;
-
     if (new_style.display() != old_style.display())
-        needs_relayout = true;
+        return StyleDifference::NeedsRebuild;
+
+    bool needs_repaint = false;
 
     if (new_style.color_or_fallback(CSS::PropertyID::Color, document, Color::Black) != old_style.color_or_fallback(CSS::PropertyID::Color, document, Color::Black))
         needs_repaint = true;
     else if (new_style.color_or_fallback(CSS::PropertyID::BackgroundColor, document, Color::Black) != old_style.color_or_fallback(CSS::PropertyID::BackgroundColor, document, Color::Black))
         needs_repaint = true;
 
-    if (needs_relayout)
+    if (!needs_repaint)
         return StyleDifference::NeedsRelayout;
-    if (needs_repaint)
+
+    // If the colors are the only thing that changed, there's no need to lay anything out again.
+    auto old_style_with_new_colors = old_style.clone();
+    for (auto property_id : { CSS::PropertyID::Color, CSS::PropertyID::BackgroundColor }) {
+        if (auto value = new_style.property(property_id); value.has_value())
+            old_style_with_new_colors->set_property(property_id, value.release_value());
+    }
+    if (*old_style_with_new_colors == new_style)
         return StyleDifference::NeedsRepaint;
-    return StyleDifference::None;
+    return StyleDifference::NeedsRelayout;
 }
 
 void Element::recompute_style()
@@ -203,20 +209,26 @@ void Element::recompute_style()
     if (!layout_node()) {
         if (new_specified_css_values->display() == CSS::Display::None)
             return;
-        // We need a new layout tree here!
-        Layout::TreeBuilder tree_builder;
-        tree_builder.build(*this);
+        // We need new layout nodes here, so rebuild our siblings' layout nodes along with ours.
+        if (parent()->layout_node())
+            document().invalidate_layout_for_children_of(*parent());
         return;
     }
 
-    auto diff = StyleDifference::NeedsRelayout;
+    auto diff = StyleDifference::NeedsRebuild;
     if (old_specified_css_values)
         diff = compute_style_difference(*old_specified_css_values, *new_specified_css_values, document());
     if (diff == StyleDifference::None)
         return;
+    if (diff == StyleDifference::NeedsRebuild) {
+        // A different display type may need a different kind of layout node.
+        document().invalidate_layout_for_children_of(*parent());
+        return;
+    }
     layout_node()->apply_style(*new_specified_css_values);
     if (diff == StyleDifference::NeedsRelayout) {
-        document().schedule_forced_layout();
+        layout_node()->set_needs_layout();
+        document().schedule_layout_update();
         return;
     }
     if (diff == StyleDifference::NeedsRepaint) {
@@ -261,7 +273,7 @@ void Element::set_inner_html(StringView markup)
     }
 
     set_needs_style_update(true);
-    document().invalidate_layout();
+    document().invalidate_layout_for_children_of(*this);
 }
 
 String Element::inner_html() const
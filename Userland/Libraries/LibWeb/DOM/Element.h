@@ -47,6 +47,7 @@ public:
 
     bool has_attribute(const FlyString& name) const { return !attribute(name).is_null(); }
     bool has_attributes() const { return !m_attributes.is_empty(); }
+    size_t attribute_list_size() const { return m_attributes.size(); }
     String attribute(const FlyString& name) const;
     String get_attribute(const FlyString& name) const { return attribute(name); }
     ExceptionOr<void> set_attribute(const FlyString& name, const String& value);
@@ -90,7 +90,9 @@ void Node::set_text_content(const String& content)
     }
 
     set_needs_style_update(true);
-    document().invalidate_layout();
+    if (is_text())
+        return;
+    document().invalidate_layout_for_children_of(*this);
 }
 
 RefPtr<Layout::Node> Node::create_layout_node()
@@ -312,6 +314,10 @@ void Node::remove(bool suppress_observers)
     // FIXME: Let oldPreviousSibling be node’s previous sibling. (Currently unused so not included)
     // FIXME: Let oldNextSibling be node’s next sibling. (Currently unused so not included)
 
+    // Our layout nodes may be spread over an ancestor's children, so let the document rebuild those.
+    if (layout_node())
+        document().invalidate_layout_for_children_of(*parent);
+
     parent->remove_child(*this);
 
     // FIXME: If node is assigned, then run assign slottables for node’s assigned slot.
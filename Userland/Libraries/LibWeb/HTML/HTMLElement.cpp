@@ -15,6 +15,7 @@
 #include <LibWeb/HTML/HTMLAnchorElement.h>
 #include <LibWeb/HTML/HTMLBodyElement.h>
 #include <LibWeb/HTML/HTMLElement.h>
+#include <LibWeb/Layout/Box.h>
 #include <LibWeb/Layout/BreakNode.h>
 #include <LibWeb/Layout/TextNode.h>
 #include <LibWeb/UIEvents/EventNames.h>
@@ -95,7 +96,7 @@ void HTMLElement::set_inner_text(StringView text)
     append_child(document().create_text_node(text));
 
     set_needs_style_update(true);
-    document().invalidate_layout();
+    document().invalidate_layout_for_children_of(*this);
 }
 
 String HTMLElement::inner_text()
@@ -123,6 +124,7 @@ String HTMLElement::inner_text()
 
 unsigned HTMLElement::offset_top() const
 {
+    const_cast<DOM::Document&>(document()).update_layout();
     if (is<HTML::HTMLBodyElement>(this) || !layout_node() || !parent_element() || !parent_element()->layout_node())
         return 0;
     auto position = layout_node()->box_type_agnostic_position();
@@ -132,6 +134,7 @@ unsigned HTMLElement::offset_top() const
 
 unsigned HTMLElement::offset_left() const
 {
+    const_cast<DOM::Document&>(document()).update_layout();
     if (is<HTML::HTMLBodyElement>(this) || !layout_node() || !parent_element() || !parent_element()->layout_node())
         return 0;
     auto position = layout_node()->box_type_agnostic_position();
@@ -139,6 +142,24 @@ unsigned HTMLElement::offset_left() const
     return position.x() - parent_position.x();
 }
 
+// https://drafts.csswg.org/cssom-view/#dom-htmlelement-offsetwidth
+unsigned HTMLElement::offset_width() const
+{
+    const_cast<DOM::Document&>(document()).update_layout();
+    if (!layout_node() || !layout_node()->is_box())
+        return 0;
+    return verify_cast<Layout::Box>(*layout_node()).border_box_width();
+}
+
+// https://drafts.csswg.org/cssom-view/#dom-htmlelement-offsetheight
+unsigned HTMLElement::offset_height() const
+{
+    const_cast<DOM::Document&>(document()).update_layout();
+    if (!layout_node() || !layout_node()->is_box())
+        return 0;
+    return verify_cast<Layout::Box>(*layout_node()).border_box_height();
+}
+
 bool HTMLElement::cannot_navigate() const
 {
     // FIXME: Return true if element's node document is not fully active
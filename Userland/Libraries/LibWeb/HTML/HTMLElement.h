@@ -32,6 +32,8 @@ public:
 
     unsigned offset_top() const;
     unsigned offset_left() const;
+    unsigned offset_width() const;
+    unsigned offset_height() const;
 
     bool cannot_navigate() const;
 
@@ -207,20 +207,16 @@ void HTMLScriptElement::prepare_script()
             auto request = LoadRequest::create_for_url_on_page(url, document().page());
 
             // FIXME: This load should be made asynchronous and the parser should spin an event loop etc.
+            //        Going through the resource cache at least lets it pick up what the preload scanner started loading.
             m_script_filename = url.to_string();
-            ResourceLoader::the().load_sync(
-                request,
-                [this, url](auto data, auto&, auto) {
-                    if (data.is_null()) {
-                        dbgln("HTMLScriptElement: Failed to load {}", url);
-                        return;
-                    }
-                    m_script_source = String::copy(data);
-                    script_became_ready();
-                },
-                [this](auto&, auto) {
-                    m_failed_to_load = true;
-                });
+            auto resource = ResourceLoader::the().load_resource_sync(Resource::Type::Generic, request);
+            if (!resource || resource->is_failed()) {
+                dbgln("HTMLScriptElement: Failed to load {}", url);
+                m_failed_to_load = true;
+            } else {
+                m_script_source = String::copy(resource->encoded_data());
+                script_became_ready();
+            }
         } else {
             TODO();
         }
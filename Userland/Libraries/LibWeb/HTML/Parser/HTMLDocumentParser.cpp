@@ -23,6 +23,7 @@
 #include <LibWeb/HTML/HTMLTemplateElement.h>
 #include <LibWeb/HTML/Parser/HTMLDocumentParser.h>
 #include <LibWeb/HTML/Parser/HTMLEncodingDetection.h>
+#include <LibWeb/HTML/Parser/HTMLPreloadScanner.h>
 #include <LibWeb/HTML/Parser/HTMLToken.h>
 #include <LibWeb/Namespace.h>
 #include <LibWeb/SVG/TagNames.h>
@@ -1891,6 +1892,14 @@ void HTMLDocumentParser::handle_text(HTMLToken& token)
         m_stack_of_open_elements.pop();
         m_insertion_mode = m_original_insertion_mode;
         // FIXME: Handle tokenizer insertion point stuff here.
+        // Loading the script blocks the parser, so get the resources further down the document on their way first.
+        // The whole input is available up front, so one scan finds everything there is to find.
+        if (script->has_attribute(HTML::AttributeNames::src) && !m_parsing_fragment && !m_did_run_preload_scanner) {
+            m_did_run_preload_scanner = true;
+            HTMLPreloadScanner preload_scanner(document(), m_tokenizer.remaining_source());
+            preload_scanner.scan();
+        }
+
         increment_script_nesting_level();
         script->prepare_script({});
         decrement_script_nesting_level();
@@ -154,6 +154,7 @@ private:
     bool m_foster_parenting { false };
     bool m_frameset_ok { true };
     bool m_parsing_fragment { false };
+    bool m_did_run_preload_scanner { false };
     bool m_scripting_enabled { true };
     bool m_invoked_via_document_write { false };
     bool m_aborted { false };
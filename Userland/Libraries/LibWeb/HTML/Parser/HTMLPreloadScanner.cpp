@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Debug.h>
+#include <LibWeb/DOM/Document.h>
+#include <LibWeb/HTML/AttributeNames.h>
+#include <LibWeb/HTML/Parser/HTMLPreloadScanner.h>
+#include <LibWeb/HTML/TagNames.h>
+#include <LibWeb/Loader/LoadRequest.h>
+#include <LibWeb/Loader/ResourceLoader.h>
+
+namespace Web::HTML {
+
+HTMLPreloadScanner::HTMLPreloadScanner(DOM::Document& document, const StringView& input)
+    : m_document(document)
+    , m_tokenizer(input, "utf-8")
+{
+}
+
+HTMLPreloadScanner::~HTMLPreloadScanner()
+{
+}
+
+void HTMLPreloadScanner::scan()
+{
+    for (;;) {
+        auto optional_token = m_tokenizer.next_token();
+        if (!optional_token.has_value())
+            break;
+        auto& token = optional_token.value();
+        if (token.is_end_of_file())
+            break;
+        if (!token.is_start_tag())
+            continue;
+
+        auto tag_name = token.tag_name();
+        if (tag_name == HTML::TagNames::script) {
+            if (token.has_attribute(HTML::AttributeNames::src))
+                preload(Resource::Type::Generic, token.attribute(HTML::AttributeNames::src));
+        } else if (tag_name == HTML::TagNames::link) {
+            auto relationships = token.attribute(HTML::AttributeNames::rel).split_view(' ');
+            bool is_stylesheet = false;
+            bool is_alternate = false;
+            for (auto& relationship : relationships) {
+                if (relationship.equals_ignoring_case("stylesheet"))
+                    is_stylesheet = true;
+                else if (relationship.equals_ignoring_case("alternate"))
+                    is_alternate = true;
+            }
+            if (is_stylesheet && !is_alternate && token.has_attribute(HTML::AttributeNames::href))
+                preload(Resource::Type::Generic, token.attribute(HTML::AttributeNames::href));
+        } else if (tag_name == HTML::TagNames::img) {
+            if (token.has_attribute(HTML::AttributeNames::src))
+                preload(Resource::Type::Image, token.attribute(HTML::AttributeNames::src));
+        }
+
+        // Switch states the way the tree builder would, so markup inside scripts and the like isn't mistaken for tags.
+        if (tag_name == HTML::TagNames::script)
+            m_tokenizer.switch_to(HTMLTokenizer::State::ScriptData);
+        else if (tag_name.is_one_of(HTML::TagNames::style, HTML::TagNames::xmp, HTML::TagNames::iframe, HTML::TagNames::noembed, HTML::TagNames::noframes, HTML::TagNames::noscript))
+            m_tokenizer.switch_to(HTMLTokenizer::State::RAWTEXT);
+        else if (tag_name.is_one_of(HTML::TagNames::textarea, HTML::TagNames::title))
+            m_tokenizer.switch_to(HTMLTokenizer::State::RCDATA);
+        else if (tag_name == HTML::TagNames::plaintext)
+            break;
+    }
+}
+
+void HTMLPreloadScanner::preload(Resource::Type type, const String& url_string)
+{
+    auto url = m_document->complete_url(url_string);
+    if (!url.is_valid())
+        return;
+    // Only network loads are worth doing ahead of time.
+    if (url.protocol() != "http" && url.protocol() != "https")
+        return;
+    if (m_preloaded_urls.set(url.to_string()) != AK::HashSetResult::InsertedNewEntry)
+        return;
+
+    dbgln_if(RESOURCE_DEBUG, "HTMLPreloadScanner: Preloading {}", url);
+    auto request = LoadRequest::create_for_url_on_page(url, m_document->page());
+    // The resource cache holds on to the resource until the parser asks for it.
+    ResourceLoader::the().load_resource(type, request);
+}
+
+}
@@ -0,0 +1,37 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/HashTable.h>
+#include <AK/NonnullRefPtr.h>
+#include <LibWeb/Forward.h>
+#include <LibWeb/HTML/Parser/HTMLTokenizer.h>
+#include <LibWeb/Loader/Resource.h>
+
+namespace Web::HTML {
+
+// While the parser waits for a script to load, this tokenizes the rest of the document with a tokenizer
+// of its own and starts loading the style sheets, scripts and images it finds, so they are already on
+// their way (or in the resource cache) by the time the parser gets to them.
+class HTMLPreloadScanner {
+public:
+    HTMLPreloadScanner(DOM::Document&, const StringView& input);
+    ~HTMLPreloadScanner();
+
+    void scan();
+
+    size_t preload_count() const { return m_preloaded_urls.size(); }
+
+private:
+    void preload(Resource::Type, const String& url);
+
+    NonnullRefPtr<DOM::Document> m_document;
+    HTMLTokenizer m_tokenizer;
+    HashTable<String> m_preloaded_urls;
+};
+
+}
@@ -119,6 +119,8 @@ public:
     bool is_blocked() const { return m_blocked; }
 
     String source() const { return m_decoded_input; }
+    // The part of the input that hasn't been tokenized yet.
+    StringView remaining_source() const { return m_decoded_input.substring_view(m_utf8_view.byte_offset_of(m_utf8_iterator)); }
 
 private:
     void skip(size_t count);
@@ -5,6 +5,7 @@
  */
 
 #include <LibWeb/CSS/Length.h>
+#include <LibWeb/DOM/Document.h>
 #include <LibWeb/DOM/Node.h>
 #include <LibWeb/Layout/BlockBox.h>
 #include <LibWeb/Layout/BlockFormattingContext.h>
@@ -377,10 +378,33 @@ void BlockFormattingContext::compute_position(Box& box)
 
 void BlockFormattingContext::layout_inline_children(Box& box, LayoutMode layout_mode)
 {
+    // FIXME: Inline content is always laid out from scratch. Line boxes before the first dirty fragment could be kept.
     InlineFormattingContext context(box, this);
     context.run(box, layout_mode);
 }
 
+static Box::ContainingBlockSize containing_block_size_for_reusable_layout(const Box& containing_block)
+{
+    // The containing block's own height is only computed once its children are laid out, so only a definite height is
+    // known (and used, see compute_theoretical_height()) at this point.
+    if (containing_block.computed_values().height().is_absolute())
+        return { containing_block.width(), containing_block.height() };
+    return { containing_block.width(), {} };
+}
+
+bool BlockFormattingContext::can_reuse_layout(const Box& child_box, const Box& containing_block, LayoutMode layout_mode) const
+{
+    if (layout_mode != LayoutMode::Default)
+        return false;
+    if (child_box.needs_layout() || child_box.child_needs_layout())
+        return false;
+    // Floats in this context shorten the line boxes of any inline content in the child.
+    if (!m_left_floating_boxes.is_empty() || !m_right_floating_boxes.is_empty())
+        return false;
+    auto& size = child_box.containing_block_size_for_reusable_layout();
+    return size.has_value() && size.value() == containing_block_size_for_reusable_layout(containing_block);
+}
+
 void BlockFormattingContext::layout_block_level_children(Box& box, LayoutMode layout_mode)
 {
     float content_height = 0;
@@ -395,9 +419,26 @@ void BlockFormattingContext::layout_block_level_children(Box& box, LayoutMode la
             return IterationDecision::Continue;
         }
 
-        compute_width(child_box);
-        layout_inside(child_box, layout_mode);
-        compute_height(child_box);
+        if (can_reuse_layout(child_box, box, layout_mode)) {
+            child_box.document().did_reuse_layout();
+        } else {
+            bool had_floats = !m_left_floating_boxes.is_empty() || !m_right_floating_boxes.is_empty();
+            size_t floating_box_count_before = m_floating_box_count;
+
+            compute_width(child_box);
+            layout_inside(child_box, layout_mode);
+            compute_height(child_box);
+
+            // Intrinsic sizing passes lay the subtree out at some other width, and floats make it depend on its surroundings.
+            bool is_reusable = layout_mode == LayoutMode::Default
+                && !had_floats
+                && floating_box_count_before == m_floating_box_count
+                && !child_box.has_absolutely_positioned_descendants();
+            if (is_reusable)
+                child_box.set_containing_block_size_for_reusable_layout(containing_block_size_for_reusable_layout(box));
+            else
+                child_box.set_containing_block_size_for_reusable_layout({});
+        }
 
         if (child_box.computed_values().position() == CSS::Position::Relative)
             compute_position(child_box);
@@ -568,6 +609,8 @@ void BlockFormattingContext::layout_floating_child(Box& box, Box& containing_blo
     layout_inside(box, LayoutMode::Default);
     compute_height(box);
 
+    ++m_floating_box_count;
+
     // First we place the box normally (to get the right y coordinate.)
     place_block_level_non_replaced_element_in_normal_flow(box, containing_block);
 
@@ -48,8 +48,13 @@ private:
 
     void layout_floating_child(Box&, Box& containing_block);
 
+    bool can_reuse_layout(const Box& child, const Box& containing_block, LayoutMode) const;
+
     Vector<Box*> m_left_floating_boxes;
     Vector<Box*> m_right_floating_boxes;
+
+    // Counts every float placed in this context, including ones that were cleared again.
+    size_t m_floating_box_count { 0 };
 };
 
 }
@@ -292,8 +292,14 @@ HitTestResult Box::hit_test(const Gfx::IntPoint& position, HitTestType type) con
 
 void Box::set_needs_display()
 {
+    // The root element's background covers the whole canvas, and the body's may be propagated to it.
+    if (is_root_element() || is_body()) {
+        browsing_context().set_needs_display(browsing_context().viewport_rect());
+        return;
+    }
+
     if (!is_inline()) {
-        browsing_context().set_needs_display(enclosing_int_rect(absolute_rect()));
+        browsing_context().set_needs_display(enclosing_int_rect(bordered_rect()));
         return;
     }
 
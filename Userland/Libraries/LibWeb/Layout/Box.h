@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <AK/Optional.h>
 #include <AK/OwnPtr.h>
 #include <LibGfx/Rect.h>
 #include <LibWeb/Layout/LineBox.h>
@@ -121,6 +122,25 @@ public:
 
     virtual float width_of_logical_containing_block() const;
 
+    // The parts of its containing block that the layout of a box in normal flow depends on: the width, and the height
+    // only if it is definite. Percentage heights are treated like 'auto' otherwise, so the height doesn't matter then.
+    struct ContainingBlockSize {
+        float width { 0 };
+        Optional<float> height;
+
+        bool operator==(const ContainingBlockSize& other) const { return width == other.width && height == other.height; }
+    };
+
+    // When a box in normal flow has been laid out without looking at anything outside of its subtree, this is the
+    // size its containing block had at the time. As long as that doesn't change and neither the box nor any of its
+    // descendants need layout, the previous layout of the subtree is still valid and can be reused.
+    const Optional<ContainingBlockSize>& containing_block_size_for_reusable_layout() const { return m_containing_block_size_for_reusable_layout; }
+    void set_containing_block_size_for_reusable_layout(Optional<ContainingBlockSize> size) { m_containing_block_size_for_reusable_layout = move(size); }
+
+    // Absolutely positioned descendants are placed relative to a containing block that may lie outside of this box.
+    bool has_absolutely_positioned_descendants() const { return m_has_absolutely_positioned_descendants; }
+    void set_has_absolutely_positioned_descendants() { m_has_absolutely_positioned_descendants = true; }
+
     struct BorderRadiusData {
         // FIXME: Use floats here
         int top_left { 0 };
@@ -158,6 +178,9 @@ private:
     WeakPtr<LineBoxFragment> m_containing_line_box_fragment;
 
     OwnPtr<StackingContext> m_stacking_context;
+
+    Optional<ContainingBlockSize> m_containing_block_size_for_reusable_layout;
+    bool m_has_absolutely_positioned_descendants { false };
 };
 
 template<>
@@ -554,6 +554,11 @@ void FormattingContext::compute_height_for_absolutely_positioned_non_replaced_el
 void FormattingContext::layout_absolutely_positioned_element(Box& box)
 {
     auto& containing_block = *box.containing_block();
+
+    for (auto* ancestor = box.parent(); ancestor && ancestor != &containing_block; ancestor = ancestor->parent()) {
+        if (is<Box>(*ancestor))
+            verify_cast<Box>(*ancestor).set_has_absolutely_positioned_descendants();
+    }
     auto& box_model = box.box_model();
 
     auto specified_width = box.computed_values().width().resolved_or_auto(box, containing_block.width());
@@ -22,7 +22,9 @@ ListItemBox::~ListItemBox()
 void ListItemBox::layout_marker()
 {
     if (m_marker) {
-        remove_child(*m_marker);
+        // The marker is gone already if our children were rebuilt since the last layout.
+        if (m_marker->parent() == this)
+            remove_child(*m_marker);
         m_marker = nullptr;
     }
 
@@ -136,6 +136,13 @@ public:
 
     virtual void set_needs_display();
 
+    // A node needs layout when something that affects its own geometry changed, e.g. its style or its children.
+    // Its ancestors are marked with child_needs_layout, so relayout can skip over the subtrees that are still clean.
+    bool needs_layout() const { return m_needs_layout; }
+    bool child_needs_layout() const { return m_child_needs_layout; }
+    void set_needs_layout();
+    void clear_needs_layout();
+
     bool children_are_inline() const { return m_children_are_inline; }
     void set_children_are_inline(bool value) { m_children_are_inline = value; }
 
@@ -184,6 +191,8 @@ private:
     bool m_has_style { false };
     bool m_visible { true };
     bool m_children_are_inline { false };
+    bool m_needs_layout { true };
+    bool m_child_needs_layout { false };
     SelectionState m_selection_state { SelectionState::None };
 
     bool m_is_flex_item { false };
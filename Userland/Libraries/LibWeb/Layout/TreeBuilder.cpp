@@ -9,6 +9,7 @@
 #include <LibWeb/DOM/ParentNode.h>
 #include <LibWeb/DOM/ShadowRoot.h>
 #include <LibWeb/Dump.h>
+#include <LibWeb/Layout/BlockBox.h>
 #include <LibWeb/Layout/InitialContainingBlockBox.h>
 #include <LibWeb/Layout/Node.h>
 #include <LibWeb/Layout/TableBox.h>
@@ -102,21 +103,34 @@ void TreeBuilder::create_layout_tree(DOM::Node& dom_node)
             insertion_point.set_children_are_inline(false);
         }
     }
+    layout_node->set_needs_layout();
 
     auto* shadow_root = is<DOM::Element>(dom_node) ? verify_cast<DOM::Element>(dom_node).shadow_root() : nullptr;
 
     if ((dom_node.has_children() || shadow_root) && layout_node->can_have_children()) {
         push_parent(verify_cast<NodeWithStyle>(*layout_node));
-        if (shadow_root)
-            create_layout_tree(*shadow_root);
-        verify_cast<DOM::ParentNode>(dom_node).for_each_child([&](auto& dom_child) {
-            create_layout_tree(dom_child);
-        });
+        auto* element = is<DOM::Element>(dom_node) ? &verify_cast<DOM::Element>(dom_node) : nullptr;
+        if (element)
+            dom_node.document().style_resolver().push_ancestor(*element);
+        create_layout_tree_for_children(dom_node);
+        if (element)
+            dom_node.document().style_resolver().pop_ancestor(*element);
         pop_parent();
     }
 }
 
-RefPtr<Node> TreeBuilder::build(DOM::Node& dom_node)
+void TreeBuilder::create_layout_tree_for_children(DOM::Node& dom_node)
+{
+    if (is<DOM::Element>(dom_node)) {
+        if (auto* shadow_root = verify_cast<DOM::Element>(dom_node).shadow_root())
+            create_layout_tree(*shadow_root);
+    }
+    verify_cast<DOM::ParentNode>(dom_node).for_each_child([&](auto& dom_child) {
+        create_layout_tree(dom_child);
+    });
+}
+
+void TreeBuilder::push_ancestors(DOM::Node& dom_node)
 {
     if (dom_node.parent()) {
         // We're building a partial layout tree, so start by building up the stack of parent layout nodes.
@@ -124,7 +138,30 @@ RefPtr<Node> TreeBuilder::build(DOM::Node& dom_node)
             m_parent_stack.prepend(verify_cast<NodeWithStyle>(ancestor));
     }
 
+    // Let the style resolver know about the ancestors of a partial build as well, outermost first.
+    for (auto* ancestor = dom_node.parent_element(); ancestor; ancestor = ancestor->parent_element())
+        m_ancestor_elements.append(*ancestor);
+    auto& style_resolver = dom_node.document().style_resolver();
+    for (ssize_t i = m_ancestor_elements.size() - 1; i >= 0; --i)
+        style_resolver.push_ancestor(m_ancestor_elements[i]);
+}
+
+void TreeBuilder::pop_ancestors()
+{
+    if (m_ancestor_elements.is_empty())
+        return;
+    auto& style_resolver = m_ancestor_elements.first().document().style_resolver();
+    for (auto& ancestor : m_ancestor_elements)
+        style_resolver.pop_ancestor(ancestor);
+    m_ancestor_elements.clear();
+    m_parent_stack.clear();
+}
+
+RefPtr<Node> TreeBuilder::build(DOM::Node& dom_node)
+{
+    push_ancestors(dom_node);
     create_layout_tree(dom_node);
+    pop_ancestors();
 
     if (auto* root = dom_node.document().layout_node())
         fixup_tables(*root);
@@ -132,6 +169,56 @@ RefPtr<Node> TreeBuilder::build(DOM::Node& dom_node)
     return move(m_layout_root);
 }
 
+bool TreeBuilder::can_rebuild_children(const DOM::Node& dom_node)
+{
+    auto* layout_node = dom_node.layout_node();
+    if (!layout_node)
+        return false;
+    if (is<InitialContainingBlockBox>(*layout_node))
+        return true;
+    if (!is<BlockBox>(*layout_node) || layout_node->is_anonymous())
+        return false;
+
+    // Table boxes get anonymous wrappers generated around their children by fixup_tables(), and those
+    // would need to be rebuilt along with them.
+    auto display = layout_node->computed_values().display();
+    return display == CSS::Display::Block || display == CSS::Display::ListItem || display == CSS::Display::InlineBlock;
+}
+
+void TreeBuilder::rebuild_children(DOM::Node& dom_node)
+{
+    VERIFY(can_rebuild_children(dom_node));
+    auto& layout_node = verify_cast<NodeWithStyle>(*dom_node.layout_node());
+
+    {
+        // Detach the whole subtree first, so that no stale layout node outlives this scope while
+        // its DOM node is already pointing at a new one.
+        NonnullRefPtrVector<Layout::Node> old_layout_nodes;
+        layout_node.for_each_in_subtree([&](auto& descendant) {
+            old_layout_nodes.append(descendant);
+            return IterationDecision::Continue;
+        });
+        for (auto& old_layout_node : old_layout_nodes)
+            old_layout_node.parent()->remove_child(old_layout_node);
+    }
+    layout_node.set_children_are_inline(false);
+
+    push_ancestors(dom_node);
+    push_parent(layout_node);
+    auto* element = is<DOM::Element>(dom_node) ? &verify_cast<DOM::Element>(dom_node) : nullptr;
+    if (element)
+        dom_node.document().style_resolver().push_ancestor(*element);
+
+    create_layout_tree_for_children(dom_node);
+
+    if (element)
+        dom_node.document().style_resolver().pop_ancestor(*element);
+    pop_ancestors();
+
+    fixup_tables(*dom_node.document().layout_node());
+    layout_node.set_needs_layout();
+}
+
 template<CSS::Display display, typename Callback>
 void TreeBuilder::for_each_in_tree_with_display(NodeWithStyle& root, Callback callback)
 {
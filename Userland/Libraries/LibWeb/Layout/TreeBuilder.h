@@ -18,8 +18,17 @@ public:
 
     RefPtr<Layout::Node> build(DOM::Node&);
 
+    // Replaces the layout nodes below the DOM node's layout node with freshly built ones. Only valid for
+    // DOM nodes where can_rebuild_children() is true, as other layout nodes may share children with their siblings.
+    static bool can_rebuild_children(const DOM::Node&);
+    void rebuild_children(DOM::Node&);
+
 private:
     void create_layout_tree(DOM::Node&);
+    void create_layout_tree_for_children(DOM::Node&);
+
+    void push_ancestors(DOM::Node&);
+    void pop_ancestors();
 
     void push_parent(Layout::NodeWithStyle& node) { m_parent_stack.append(&node); }
     void pop_parent() { m_parent_stack.take_last(); }
@@ -34,6 +43,7 @@ private:
 
     RefPtr<Layout::Node> m_layout_root;
     Vector<Layout::NodeWithStyle*> m_parent_stack;
+    Vector<DOM::Element&> m_ancestor_elements;
 };
 
 }
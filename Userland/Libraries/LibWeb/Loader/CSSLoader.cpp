@@ -66,6 +66,8 @@ void CSSLoader::resource_did_load()
         m_style_sheet->rules() = sheet->rules();
     }
 
+    m_owner_element.document().style_resolver().invalidate_rule_cache();
+
     if (on_load)
         on_load();
 
@@ -89,6 +89,50 @@ RefPtr<Resource> ResourceLoader::load_resource(Resource::Type type, const LoadRe
     return resource;
 }
 
+class SyncResourceClient final : public ResourceClient {
+public:
+    SyncResourceClient(Resource::Type type, Core::EventLoop& loop)
+        : m_type(type)
+        , m_loop(loop)
+    {
+    }
+
+    void wait_for(Resource& resource)
+    {
+        set_resource(&resource);
+        if (!m_done)
+            m_loop.exec();
+        set_resource(nullptr);
+    }
+
+private:
+    virtual Resource::Type client_type() const override { return m_type; }
+    virtual void resource_did_load() override { done(); }
+    virtual void resource_did_fail() override { done(); }
+
+    void done()
+    {
+        m_done = true;
+        m_loop.quit(0);
+    }
+
+    Resource::Type m_type;
+    Core::EventLoop& m_loop;
+    bool m_done { false };
+};
+
+RefPtr<Resource> ResourceLoader::load_resource_sync(Resource::Type type, const LoadRequest& request)
+{
+    auto resource = load_resource(type, request);
+    if (!resource || resource->is_loaded() || resource->is_failed())
+        return resource;
+
+    Core::EventLoop loop;
+    SyncResourceClient client(type, loop);
+    client.wait_for(*resource);
+    return resource;
+}
+
 void ResourceLoader::load(const LoadRequest& request, Function<void(ReadonlyBytes, const HashMap<String, String, CaseInsensitiveStringTraits>& response_headers, Optional<u32> status_code)> success_callback, Function<void(const String&, Optional<u32> status_code)> error_callback)
 {
     auto& url = request.url();
@@ -215,6 +259,7 @@ void ResourceLoader::clear_cache()
 {
     dbgln("Clearing {} items from ResourceLoader cache", s_resource_cache.size());
     s_resource_cache.clear();
+    protocol_client().async_clear_cache();
 }
 
 }
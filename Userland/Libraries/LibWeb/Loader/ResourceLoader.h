@@ -25,6 +25,8 @@ public:
     static ResourceLoader& the();
 
     RefPtr<Resource> load_resource(Resource::Type, const LoadRequest&);
+    // Like load_resource(), but doesn't return until the resource has loaded or failed to.
+    RefPtr<Resource> load_resource_sync(Resource::Type, const LoadRequest&);
 
     void load(const LoadRequest&, Function<void(ReadonlyBytes, const HashMap<String, String, CaseInsensitiveStringTraits>& response_headers, Optional<u32> status_code)> success_callback, Function<void(const String&, Optional<u32> status_code)> error_callback = nullptr);
     void load(const URL&, Function<void(ReadonlyBytes, const HashMap<String, String, CaseInsensitiveStringTraits>& response_headers, Optional<u32> status_code)> success_callback, Function<void(const String&, Optional<u32> status_code)> error_callback = nullptr);
@@ -197,15 +197,22 @@ void OutOfProcessWebView::screen_rects_change_event(GUI::ScreenRectsChangeEvent&
     client().async_update_screen_rects(event.rects(), event.main_screen_index());
 }
 
-void OutOfProcessWebView::notify_server_did_paint(Badge<WebContentClient>, i32 bitmap_id)
+void OutOfProcessWebView::notify_server_did_paint(Badge<WebContentClient>, i32 bitmap_id, const Vector<Gfx::IntRect>& changed_rects)
 {
     if (m_client_state.back_bitmap_id == bitmap_id) {
+        // The server only reports what changed compared to the bitmap we're showing, so anything else needs a full update.
+        bool can_update_partially = m_client_state.has_usable_bitmap;
         m_client_state.has_usable_bitmap = true;
         swap(m_client_state.back_bitmap, m_client_state.front_bitmap);
         swap(m_client_state.back_bitmap_id, m_client_state.front_bitmap_id);
         // We don't need the backup bitmap anymore, so drop it.
         m_backup_bitmap = nullptr;
-        update();
+        if (!can_update_partially) {
+            update();
+            return;
+        }
+        for (auto& rect : changed_rects)
+            update(rect.translated(frame_thickness(), frame_thickness()));
     }
 }
 
@@ -0,0 +1,57 @@
+describe("BlockFormattingContext", () => {
+    loadLocalPage("IncrementalLayout.html");
+
+    afterInitialPageLoad(page => {
+        const geometry = element => [
+            element.offsetLeft,
+            element.offsetTop,
+            element.offsetWidth,
+            element.offsetHeight,
+        ];
+
+        test("Clean siblings keep their layout when the parent changes height", () => {
+            const first = page.document.getElementById("first");
+            const changing = page.document.getElementById("changing");
+            const last = page.document.getElementById("last");
+
+            const firstGeometry = geometry(first);
+            const lastGeometry = geometry(last);
+            const changingHeight = changing.offsetHeight;
+
+            let reuseCount = layoutReuseCount();
+            changing.innerHTML = "One<br>Two<br>Three";
+            const grownHeight = changing.offsetHeight;
+            expect(grownHeight).toBeGreaterThan(changingHeight);
+            expect(layoutReuseCount()).toBeGreaterThan(reuseCount);
+            expect(geometry(first)).toEqual(firstGeometry);
+            expect(last.offsetTop).toBe(lastGeometry[1] + grownHeight - changingHeight);
+            expect(last.offsetHeight).toBe(lastGeometry[3]);
+
+            // The body has a different height now, which must not keep its children from being reused.
+            reuseCount = layoutReuseCount();
+            changing.innerHTML = "Changing block";
+            expect(changing.offsetHeight).toBe(changingHeight);
+            expect(layoutReuseCount()).toBeGreaterThan(reuseCount);
+            expect(geometry(first)).toEqual(firstGeometry);
+            expect(geometry(last)).toEqual(lastGeometry);
+        });
+
+        test("Reused layout inside a block with a definite height", () => {
+            const fixed = page.document.getElementById("fixed");
+            const insideFixed = page.document.getElementById("inside-fixed");
+            const changing = page.document.getElementById("changing-inside-fixed");
+
+            const fixedGeometry = geometry(fixed);
+            const insideFixedGeometry = geometry(insideFixed);
+            expect(fixedGeometry[3]).toBe(200);
+
+            for (const text of ["Changed once", "Changed<br>twice"]) {
+                changing.innerHTML = text;
+                expect(geometry(fixed)).toEqual(fixedGeometry);
+                expect(geometry(insideFixed)).toEqual(insideFixedGeometry);
+            }
+        });
+    });
+
+    waitForPageToLoad();
+});
@@ -15,6 +15,8 @@ WebContentClient::WebContentClient(OutOfProcessWebView& view)
     : IPC::ServerConnection<WebContentClientEndpoint, WebContentServerEndpoint>(*this, "/tmp/portal/webcontent")
     , m_view(view)
 {
+    // HTML and page sources can get big, and we're both pledged to pass fds anyway.
+    enable_out_of_line_messages();
 }
 
 void WebContentClient::die()
@@ -23,9 +25,9 @@ void WebContentClient::die()
     on_web_content_process_crash();
 }
 
-void WebContentClient::did_paint(const Gfx::IntRect&, i32 bitmap_id)
+void WebContentClient::did_paint(const Gfx::IntRect&, i32 bitmap_id, Vector<Gfx::IntRect> const& changed_rects)
 {
-    m_view.notify_server_did_paint({}, bitmap_id);
+    m_view.notify_server_did_paint({}, bitmap_id, changed_rects);
 }
 
 void WebContentClient::did_finish_loading(URL const& url)
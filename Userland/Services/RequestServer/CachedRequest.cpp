@@ -0,0 +1,40 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <RequestServer/CachedRequest.h>
+#include <RequestServer/Protocol.h>
+
+namespace RequestServer {
+
+CachedRequest::CachedRequest(ClientConnection& client, NonnullRefPtr<HTTPCache::Entry> entry, NonnullOwnPtr<ResponseBodyStream>&& output_stream)
+    : Request(client, move(output_stream))
+    , m_entry(move(entry))
+{
+}
+
+CachedRequest::~CachedRequest()
+{
+}
+
+OwnPtr<CachedRequest> CachedRequest::create(ClientConnection& client, NonnullRefPtr<HTTPCache::Entry> entry)
+{
+    auto pipe_result = Protocol::get_pipe_for_request();
+    if (pipe_result.is_error())
+        return {};
+
+    auto output_stream = make<ResponseBodyStream>(pipe_result.value().write_fd);
+    output_stream->make_unbuffered();
+    auto request = adopt_own(*new CachedRequest(client, move(entry), move(output_stream)));
+    request->set_request_fd(pipe_result.value().read_fd);
+    return request;
+}
+
+void CachedRequest::start()
+{
+    send_cached_response(m_entry);
+}
+
+}
@@ -0,0 +1,29 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/OwnPtr.h>
+#include <RequestServer/Request.h>
+
+namespace RequestServer {
+
+// A request that is answered from the HTTP cache, without going to the network.
+class CachedRequest final : public Request {
+public:
+    virtual ~CachedRequest() override;
+    static OwnPtr<CachedRequest> create(ClientConnection&, NonnullRefPtr<HTTPCache::Entry>);
+
+    // Call once the client knows about the request.
+    void start();
+
+private:
+    explicit CachedRequest(ClientConnection&, NonnullRefPtr<HTTPCache::Entry>, NonnullOwnPtr<ResponseBodyStream>&&);
+
+    NonnullRefPtr<HTTPCache::Entry> m_entry;
+};
+
+}
@@ -5,7 +5,9 @@
  */
 
 #include <AK/Badge.h>
+#include <RequestServer/CachedRequest.h>
 #include <RequestServer/ClientConnection.h>
+#include <RequestServer/HTTPCache.h>
 #include <RequestServer/Protocol.h>
 #include <RequestServer/Request.h>
 #include <RequestServer/RequestClientEndpoint.h>
@@ -48,17 +50,57 @@ Messages::RequestServer::StartRequestResponse ClientConnection::start_request(St
         dbgln("StartRequest: No protocol handler for URL: '{}'", url);
         return { -1, Optional<IPC::File> {} };
     }
-    auto request = protocol->start_request(*this, method, url, request_headers.entries(), request_body);
+
+    auto& cache = HTTPCache::the();
+    bool use_http_cache = HTTPCache::can_use_cache_for(method, url, request_headers.entries(), request_body);
+    RefPtr<HTTPCache::Entry> cached_entry;
+    if (use_http_cache)
+        cached_entry = cache.lookup(url);
+
+    if (cached_entry && cached_entry->is_fresh()) {
+        auto request = CachedRequest::create(*this, cached_entry.release_nonnull());
+        if (!request) {
+            dbgln("StartRequest: Failed to start cached request: '{}'", url);
+            return { -1, Optional<IPC::File> {} };
+        }
+        auto id = request->id();
+        auto fd = request->request_fd();
+        m_requests.set(id, move(request));
+        // The client has to know the request ID before it gets any messages about it.
+        deferred_invoke([this, id](auto&) {
+            if (auto request = m_requests.get(id); request.has_value())
+                static_cast<CachedRequest&>(*request.value()).start();
+        });
+        return { id, IPC::File(fd, IPC::File::CloseAfterSending) };
+    }
+
+    auto headers = request_headers.entries();
+    // A stale entry can still be used if the server tells us it hasn't changed.
+    if (cached_entry && cached_entry->has_validators())
+        cache.add_validators(*cached_entry, headers);
+    else
+        cached_entry = nullptr;
+
+    auto request = protocol->start_request(*this, method, url, headers, request_body);
     if (!request) {
         dbgln("StartRequest: Protocol handler failed to start request: '{}'", url);
         return { -1, Optional<IPC::File> {} };
     }
+    if (use_http_cache)
+        request->set_cacheable(url, move(cached_entry));
+    else if (!method.equals_ignoring_case("GET") && !method.equals_ignoring_case("HEAD"))
+        request->set_invalidates_cached_response(url);
     auto id = request->id();
     auto fd = request->request_fd();
     m_requests.set(id, move(request));
     return { id, IPC::File(fd, IPC::File::CloseAfterSending) };
 }
 
+void ClientConnection::clear_cache()
+{
+    HTTPCache::the().clear();
+}
+
 Messages::RequestServer::StopRequestResponse ClientConnection::stop_request(i32 request_id)
 {
     auto* request = const_cast<Request*>(m_requests.get(request_id).value_or(nullptr));
@@ -33,6 +33,7 @@ private:
     virtual Messages::RequestServer::IsSupportedProtocolResponse is_supported_protocol(String const&) override;
     virtual Messages::RequestServer::StartRequestResponse start_request(String const&, URL const&, IPC::Dictionary const&, ByteBuffer const&) override;
     virtual Messages::RequestServer::StopRequestResponse stop_request(i32) override;
+    virtual void clear_cache() override;
     virtual Messages::RequestServer::SetCertificateResponse set_certificate(i32, String const&, String const&) override;
 
     HashMap<i32, OwnPtr<Request>> m_requests;
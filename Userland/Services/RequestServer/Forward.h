@@ -9,6 +9,7 @@
 namespace RequestServer {
 
 class ClientConnection;
+class CachedRequest;
 class Request;
 class GeminiProtocol;
 class HttpRequest;
@@ -30,7 +30,7 @@ OwnPtr<Request> GeminiProtocol::start_request(ClientConnection& client, const St
     if (pipe_result.is_error())
         return {};
 
-    auto output_stream = make<OutputFileStream>(pipe_result.value().write_fd);
+    auto output_stream = make<ResponseBodyStream>(pipe_result.value().write_fd);
     output_stream->make_unbuffered();
     auto job = Gemini::GeminiJob::construct(request, *output_stream);
     auto protocol_request = GeminiRequest::create_with_job({}, client, (Gemini::GeminiJob&)*job, move(output_stream));
@@ -0,0 +1,508 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Debug.h>
+#include <AK/LexicalPath.h>
+#include <AK/QuickSort.h>
+#include <AK/StringBuilder.h>
+#include <LibCore/DateTime.h>
+#include <LibCore/DirIterator.h>
+#include <LibCore/File.h>
+#include <LibCore/StandardPaths.h>
+#include <RequestServer/HTTPCache.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace RequestServer {
+
+static constexpr size_t memory_budget = 32 * MiB;
+static constexpr size_t max_memory_entry_size = 4 * MiB;
+static constexpr size_t disk_budget = 256 * MiB;
+
+// Without explicit freshness information, a response with Last-Modified stays fresh for a tenth of
+// its age, like most browsers do (RFC 7234, 4.2.2). Cap that so we don't hold on to things for too long.
+static constexpr time_t max_heuristic_freshness_lifetime = 24 * 60 * 60;
+
+static constexpr auto disk_format_magic = "RequestServer HTTP cache 1";
+
+HTTPCache& HTTPCache::the()
+{
+    static HTTPCache* cache = new HTTPCache;
+    return *cache;
+}
+
+HTTPCache::HTTPCache()
+{
+}
+
+String HTTPCache::default_disk_cache_path()
+{
+    return String::formatted("{}/.cache/http", Core::StandardPaths::home_directory());
+}
+
+bool HTTPCache::enable_disk_cache(const String& path)
+{
+    auto can_use_directory = [&] {
+        auto parent_directory = LexicalPath(path).dirname();
+        if (mkdir(parent_directory.characters(), 0700) < 0 && errno != EEXIST)
+            return false;
+        if (mkdir(path.characters(), 0700) < 0 && errno != EEXIST)
+            return false;
+        return access(path.characters(), R_OK | W_OK) == 0;
+    };
+    if (!can_use_directory()) {
+        dbgln("HTTPCache: Can't use {}, only caching in memory", path);
+        return false;
+    }
+    m_disk_cache_path = path;
+    m_disk_usage.clear();
+    m_has_disk_cache = true;
+    return true;
+}
+
+static Optional<time_t> parse_http_date(const String& string)
+{
+    // Only the preferred format (RFC 7231, 7.1.1.1). Anything else counts as already expired.
+    auto date = Core::DateTime::parse("%a, %d %b %Y %H:%M:%S GMT", string);
+    if (!date.has_value())
+        return {};
+    return date->timestamp();
+}
+
+struct CacheControl {
+    bool no_store { false };
+    bool no_cache { false };
+    Optional<time_t> max_age;
+};
+
+static CacheControl parse_cache_control(const HTTPCache::Headers& headers)
+{
+    CacheControl cache_control;
+    auto header = headers.get("Cache-Control");
+    if (!header.has_value())
+        return cache_control;
+    for (auto& directive : header->split_view(',')) {
+        auto trimmed = directive.trim_whitespace();
+        auto name = trimmed;
+        StringView value;
+        if (auto equals = trimmed.find_first_of('='); equals.has_value()) {
+            name = trimmed.substring_view(0, *equals).trim_whitespace();
+            value = trimmed.substring_view(*equals + 1).trim_whitespace();
+            if (value.length() >= 2 && value.starts_with('"') && value.ends_with('"'))
+                value = value.substring_view(1, value.length() - 2);
+        }
+        if (name.equals_ignoring_case("no-store")) {
+            cache_control.no_store = true;
+        } else if (name.equals_ignoring_case("no-cache")) {
+            cache_control.no_cache = true;
+        } else if (name.equals_ignoring_case("max-age")) {
+            if (auto seconds = value.to_uint(); seconds.has_value())
+                cache_control.max_age = *seconds;
+            else
+                cache_control.max_age = 0;
+        }
+    }
+    return cache_control;
+}
+
+bool HTTPCache::can_use_cache_for(const String& method, const URL& url, const HashMap<String, String>& request_headers, ReadonlyBytes request_body)
+{
+    if (url.protocol() != "http" && url.protocol() != "https")
+        return false;
+    if (!method.equals_ignoring_case("GET") || !request_body.is_empty())
+        return false;
+    // Responses to authenticated requests are only for whoever made them.
+    for (auto& header : request_headers) {
+        if (header.key.equals_ignoring_case("Authorization"))
+            return false;
+        if (header.key.equals_ignoring_case("Cache-Control") && header.value.contains("no-store", CaseSensitivity::CaseInsensitive))
+            return false;
+        // Clients that send their own validators do their own caching.
+        if (header.key.equals_ignoring_case("If-None-Match") || header.key.equals_ignoring_case("If-Modified-Since"))
+            return false;
+    }
+    return true;
+}
+
+bool HTTPCache::Entry::is_fresh() const
+{
+    if (m_requires_revalidation)
+        return false;
+    auto current_age = m_initial_age + max<time_t>(0, time(nullptr) - m_response_time);
+    return current_age < m_freshness_lifetime;
+}
+
+bool HTTPCache::Entry::has_validators() const
+{
+    return m_response_headers.contains("ETag") || m_response_headers.contains("Last-Modified");
+}
+
+size_t HTTPCache::Entry::memory_size() const
+{
+    size_t size = sizeof(Entry) + m_url.length() + m_body.size();
+    for (auto& header : m_response_headers)
+        size += header.key.length() + header.value.length();
+    return size;
+}
+
+void HTTPCache::update_freshness(Entry& entry) const
+{
+    auto& headers = entry.m_response_headers;
+    auto cache_control = parse_cache_control(headers);
+    entry.m_requires_revalidation = cache_control.no_cache || headers.get("Pragma").value_or({}).contains("no-cache", CaseSensitivity::CaseInsensitive);
+
+    entry.m_initial_age = 0;
+    if (auto age = headers.get("Age"); age.has_value())
+        entry.m_initial_age = age->to_uint().value_or(0);
+
+    auto date = entry.m_response_time;
+    if (auto date_header = headers.get("Date"); date_header.has_value())
+        date = parse_http_date(*date_header).value_or(entry.m_response_time);
+
+    entry.m_freshness_lifetime = 0;
+    if (cache_control.max_age.has_value()) {
+        entry.m_freshness_lifetime = *cache_control.max_age;
+    } else if (auto expires = headers.get("Expires"); expires.has_value()) {
+        if (auto expiry = parse_http_date(*expires); expiry.has_value())
+            entry.m_freshness_lifetime = max<time_t>(0, *expiry - date);
+    } else if (auto last_modified = headers.get("Last-Modified"); last_modified.has_value()) {
+        if (auto modified = parse_http_date(*last_modified); modified.has_value())
+            entry.m_freshness_lifetime = min(max<time_t>(0, date - *modified) / 10, max_heuristic_freshness_lifetime);
+    }
+}
+
+RefPtr<HTTPCache::Entry> HTTPCache::lookup(const URL& url)
+{
+    auto url_string = url.to_string();
+    RefPtr<Entry> entry;
+    if (auto it = m_entries.find(url_string); it != m_entries.end()) {
+        entry = it->value;
+    } else {
+        // Another RequestServer process may have fetched it in the meantime.
+        entry = read_from_disk(url_string);
+        if (!entry)
+            return nullptr;
+        if (entry->m_body.size() <= max_memory_entry_size)
+            insert_into_memory(*entry);
+    }
+    entry->m_last_used = ++m_use_counter;
+    dbgln_if(CACHE_DEBUG, "HTTPCache: Found {} in cache ({})", url_string, entry->is_fresh() ? "fresh" : "stale");
+    return entry;
+}
+
+void HTTPCache::add_validators(const Entry& entry, HashMap<String, String>& request_headers) const
+{
+    if (auto etag = entry.m_response_headers.get("ETag"); etag.has_value())
+        request_headers.set("If-None-Match", *etag);
+    if (auto last_modified = entry.m_response_headers.get("Last-Modified"); last_modified.has_value())
+        request_headers.set("If-Modified-Since", *last_modified);
+}
+
+static bool is_cacheable_by_default(u32 status_code)
+{
+    // RFC 7231, 6.1
+    switch (status_code) {
+    case 200:
+    case 203:
+    case 300:
+    case 301:
+    case 404:
+    case 410:
+        return true;
+    default:
+        return false;
+    }
+}
+
+static bool should_store_header(const String& name)
+{
+    // Cookies were already handled when the response came in; replaying them from the cache would be wrong.
+    // The body we get has already been decoded, so its Content-Encoding doesn't apply to what we store.
+    return !name.equals_ignoring_case("Connection")
+        && !name.equals_ignoring_case("Keep-Alive")
+        && !name.equals_ignoring_case("Transfer-Encoding")
+        && !name.equals_ignoring_case("Set-Cookie")
+        && !name.equals_ignoring_case("Content-Encoding");
+}
+
+void HTTPCache::store(const URL& url, u32 status_code, const Headers& response_headers, ReadonlyBytes body)
+{
+    auto url_string = url.to_string();
+
+    auto is_storable = [&] {
+        if (!is_cacheable_by_default(status_code))
+            return false;
+        if (parse_cache_control(response_headers).no_store)
+            return false;
+        // We always send the same request headers, so the only variation we could see is the encoding.
+        if (auto vary = response_headers.get("Vary"); vary.has_value() && !vary->trim_whitespace().equals_ignoring_case("Accept-Encoding"))
+            return false;
+        return body.size() <= max_body_size;
+    };
+
+    if (!is_storable()) {
+        // Don't keep serving an older response to the same request.
+        remove(url);
+        return;
+    }
+
+    auto entry = adopt_ref(*new Entry);
+    entry->m_url = url_string;
+    entry->m_status_code = status_code;
+    for (auto& header : response_headers) {
+        if (should_store_header(header.key))
+            entry->m_response_headers.set(header.key, header.value);
+    }
+    if (entry->m_response_headers.contains("Content-Length"))
+        entry->m_response_headers.set("Content-Length", String::number(body.size()));
+    entry->m_body = ByteBuffer::copy(body);
+    entry->m_response_time = time(nullptr);
+    update_freshness(*entry);
+
+    if (!entry->is_fresh() && !entry->has_validators()) {
+        remove(url);
+        return;
+    }
+
+    dbgln_if(CACHE_DEBUG, "HTTPCache: Storing {} ({} bytes, fresh for {}s)", url_string, body.size(), entry->m_freshness_lifetime);
+    entry->m_last_used = ++m_use_counter;
+    write_to_disk(*entry);
+    if (body.size() <= max_memory_entry_size)
+        insert_into_memory(move(entry));
+    else
+        remove_from_memory(url_string);
+}
+
+NonnullRefPtr<HTTPCache::Entry> HTTPCache::did_revalidate(const Entry& stale_entry, const Headers& response_headers)
+{
+    // Entries may be shared with loads that are still in flight, so make a new one instead of updating in place.
+    auto entry = adopt_ref(*new Entry);
+    entry->m_url = stale_entry.m_url;
+    entry->m_status_code = stale_entry.m_status_code;
+    entry->m_response_headers = stale_entry.m_response_headers;
+    for (auto& header : response_headers) {
+        // A 304 has no body, so its framing headers don't describe ours.
+        if (!should_store_header(header.key) || header.key.equals_ignoring_case("Content-Length"))
+            continue;
+        entry->m_response_headers.set(header.key, header.value);
+    }
+    entry->m_body = stale_entry.m_body;
+    entry->m_response_time = time(nullptr);
+    entry->m_last_used = ++m_use_counter;
+    update_freshness(*entry);
+
+    dbgln_if(CACHE_DEBUG, "HTTPCache: Revalidated {}, fresh for {}s", entry->m_url, entry->m_freshness_lifetime);
+    write_to_disk(*entry);
+    insert_into_memory(entry);
+    return entry;
+}
+
+void HTTPCache::remove(const URL& url)
+{
+    auto url_string = url.to_string();
+    remove_from_memory(url_string);
+    if (m_has_disk_cache) {
+        // Only remove the file if it's really for this URL, and not for another one with the same hash.
+        if (read_from_disk(url_string))
+            unlink(path_for(url_string).characters());
+    }
+}
+
+void HTTPCache::clear()
+{
+    dbgln_if(CACHE_DEBUG, "HTTPCache: Clearing {} items", m_entries.size());
+    m_entries.clear();
+    m_memory_usage = 0;
+
+    if (!m_has_disk_cache)
+        return;
+    Core::DirIterator iterator(m_disk_cache_path, Core::DirIterator::SkipDots);
+    while (iterator.has_next())
+        unlink(iterator.next_full_path().characters());
+    m_disk_usage = 0;
+}
+
+void HTTPCache::remove_from_memory(const String& url)
+{
+    if (auto it = m_entries.find(url); it != m_entries.end()) {
+        m_memory_usage -= it->value->memory_size();
+        m_entries.remove(it);
+    }
+}
+
+void HTTPCache::insert_into_memory(NonnullRefPtr<Entry> entry)
+{
+    auto url = entry->m_url;
+    remove_from_memory(url);
+    m_memory_usage += entry->memory_size();
+    m_entries.set(url, move(entry));
+    evict_from_memory_if_needed();
+}
+
+void HTTPCache::evict_from_memory_if_needed()
+{
+    while (m_memory_usage > memory_budget && !m_entries.is_empty()) {
+        auto least_recently_used = m_entries.begin();
+        for (auto it = m_entries.begin(); it != m_entries.end(); ++it) {
+            if (it->value->m_last_used < least_recently_used->value->m_last_used)
+                least_recently_used = it;
+        }
+        dbgln_if(CACHE_DEBUG, "HTTPCache: Evicting {} from memory", least_recently_used->key);
+        m_memory_usage -= least_recently_used->value->memory_size();
+        m_entries.remove(least_recently_used);
+    }
+}
+
+String HTTPCache::path_for(const String& url) const
+{
+    return String::formatted("{}/{:08x}{:08x}", m_disk_cache_path, url.hash(), string_hash(url.characters(), url.length() / 2));
+}
+
+// The on-disk format is a few lines of metadata followed by the body:
+//
+//     RequestServer HTTP cache 1
+//     <url>
+//     <status code> <response time> <initial age> <freshness lifetime> <requires revalidation>
+//     <header count>
+//     <name>: <value>
+//     ...
+//     <body>
+RefPtr<HTTPCache::Entry> HTTPCache::read_from_disk(const String& url)
+{
+    if (!m_has_disk_cache)
+        return nullptr;
+    auto file_or_error = Core::File::open(path_for(url), Core::OpenMode::ReadOnly);
+    if (file_or_error.is_error())
+        return nullptr;
+    auto data = file_or_error.value()->read_all();
+    StringView view { data.data(), data.size() };
+
+    size_t offset = 0;
+    auto read_line = [&]() -> Optional<StringView> {
+        auto newline = view.substring_view(offset).find_first_of('\n');
+        if (!newline.has_value())
+            return {};
+        auto line = view.substring_view(offset, *newline);
+        offset += *newline + 1;
+        return line;
+    };
+
+    if (read_line().value_or({}) != disk_format_magic)
+        return nullptr;
+    if (read_line().value_or({}) != url)
+        return nullptr;
+
+    auto metadata = read_line();
+    if (!metadata.has_value())
+        return nullptr;
+    auto fields = metadata->split_view(' ');
+    auto header_count = read_line().value_or({}).to_uint();
+    if (fields.size() != 5 || !header_count.has_value())
+        return nullptr;
+
+    auto entry = adopt_ref(*new Entry);
+    entry->m_url = url;
+    entry->m_status_code = fields[0].to_uint().value_or(0);
+    entry->m_response_time = fields[1].to_uint().value_or(0);
+    entry->m_initial_age = fields[2].to_uint().value_or(0);
+    entry->m_freshness_lifetime = fields[3].to_uint().value_or(0);
+    entry->m_requires_revalidation = fields[4] == "1";
+
+    for (u32 i = 0; i < *header_count; ++i) {
+        auto line = read_line();
+        if (!line.has_value())
+            return nullptr;
+        auto colon = line->find_first_of(':');
+        if (!colon.has_value())
+            return nullptr;
+        entry->m_response_headers.set(line->substring_view(0, *colon), line->substring_view(*colon + 1).trim_whitespace());
+    }
+    entry->m_body = ByteBuffer::copy(data.bytes().slice(offset));
+    return entry;
+}
+
+void HTTPCache::write_to_disk(const Entry& entry)
+{
+    if (!m_has_disk_cache || entry.m_body.size() > max_body_size)
+        return;
+
+    StringBuilder builder;
+    builder.appendff("{}\n{}\n", disk_format_magic, entry.m_url);
+    builder.appendff("{} {} {} {} {}\n", entry.m_status_code, entry.m_response_time, entry.m_initial_age, entry.m_freshness_lifetime, entry.m_requires_revalidation ? 1 : 0);
+    builder.appendff("{}\n", entry.m_response_headers.size());
+    for (auto& header : entry.m_response_headers)
+        builder.appendff("{}: {}\n", header.key, header.value);
+    auto metadata = builder.to_byte_buffer();
+
+    // Write to a temporary file first, so other processes never see a partially written entry.
+    auto path = path_for(entry.m_url);
+    auto temporary_path = String::formatted("{}.{}", path, getpid());
+    int fd = open(temporary_path.characters(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+    if (fd < 0)
+        return;
+    auto write_all = [&](ReadonlyBytes bytes) {
+        while (!bytes.is_empty()) {
+            auto nwritten = write(fd, bytes.data(), bytes.size());
+            if (nwritten <= 0)
+                return false;
+            bytes = bytes.slice(nwritten);
+        }
+        return true;
+    };
+    bool ok = write_all(metadata) && write_all(entry.m_body);
+    close(fd);
+    if (!ok || rename(temporary_path.characters(), path.characters()) < 0) {
+        unlink(temporary_path.characters());
+        return;
+    }
+
+    if (m_disk_usage.has_value())
+        *m_disk_usage += metadata.size() + entry.m_body.size();
+    evict_from_disk_if_needed();
+}
+
+void HTTPCache::evict_from_disk_if_needed()
+{
+    struct File {
+        String path;
+        time_t modification_time;
+        size_t size;
+    };
+
+    // The usage is only an estimate, since other processes write to the same directory.
+    // When it goes over the budget, look at what's really there and delete the oldest files.
+    if (m_disk_usage.has_value() && *m_disk_usage <= disk_budget)
+        return;
+
+    Vector<File> files;
+    size_t usage = 0;
+    Core::DirIterator iterator(m_disk_cache_path, Core::DirIterator::SkipDots);
+    while (iterator.has_next()) {
+        auto path = iterator.next_full_path();
+        struct stat st;
+        if (stat(path.characters(), &st) < 0 || !S_ISREG(st.st_mode))
+            continue;
+        files.append({ move(path), st.st_mtime, (size_t)st.st_size });
+        usage += st.st_size;
+    }
+    m_disk_usage = usage;
+    if (usage <= disk_budget)
+        return;
+
+    quick_sort(files, [](auto& a, auto& b) { return a.modification_time < b.modification_time; });
+    for (auto& file : files) {
+        if (*m_disk_usage <= disk_budget * 3 / 4)
+            break;
+        dbgln_if(CACHE_DEBUG, "HTTPCache: Evicting {} from disk", file.path);
+        if (unlink(file.path.characters()) == 0)
+            *m_disk_usage -= file.size;
+    }
+}
+
+}
@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/ByteBuffer.h>
+#include <AK/HashMap.h>
+#include <AK/RefCounted.h>
+#include <AK/String.h>
+#include <AK/URL.h>
+
+namespace RequestServer {
+
+// A private HTTP cache (RFC 7234) for the requests that go through RequestServer.
+// Responses are kept in memory up to a budget. Processes that enable the disk cache also write them
+// to a directory on disk, so that other RequestServer processes (and later sessions) can reuse them.
+class HTTPCache {
+public:
+    static HTTPCache& the();
+
+    using Headers = HashMap<String, String, CaseInsensitiveStringTraits>;
+
+    class Entry : public RefCounted<Entry> {
+    public:
+        const String& url() const { return m_url; }
+        u32 status_code() const { return m_status_code; }
+        const Headers& response_headers() const { return m_response_headers; }
+        ReadonlyBytes body() const { return m_body; }
+
+        bool is_fresh() const;
+        bool has_validators() const;
+
+    private:
+        friend class HTTPCache;
+
+        size_t memory_size() const;
+
+        String m_url;
+        u32 m_status_code { 0 };
+        Headers m_response_headers;
+        ByteBuffer m_body;
+
+        // When we received the response (or last revalidated it), and how old it already was then.
+        time_t m_response_time { 0 };
+        time_t m_initial_age { 0 };
+        time_t m_freshness_lifetime { 0 };
+        bool m_requires_revalidation { false };
+
+        u64 m_last_used { 0 };
+    };
+
+    // Bodies larger than this are never stored.
+    static constexpr size_t max_body_size = 32 * MiB;
+
+    static bool can_use_cache_for(const String& method, const URL&, const HashMap<String, String>& request_headers, ReadonlyBytes request_body);
+
+    static String default_disk_cache_path();
+
+    // Creates the directory if needed, so this has to happen before unveil() and needs the cpath pledge.
+    // Returns false (and only caches in memory) if the directory can't be used.
+    bool enable_disk_cache(const String& path);
+    bool has_disk_cache() const { return m_has_disk_cache; }
+    const String& disk_cache_path() const { return m_disk_cache_path; }
+
+    RefPtr<Entry> lookup(const URL&);
+    void add_validators(const Entry&, HashMap<String, String>& request_headers) const;
+
+    // Called with every response to a cacheable request. Stores it if the response allows that.
+    void store(const URL&, u32 status_code, const Headers& response_headers, ReadonlyBytes body);
+    // Called when the server answered a conditional request with 304 Not Modified.
+    NonnullRefPtr<Entry> did_revalidate(const Entry&, const Headers& response_headers);
+
+    void remove(const URL&);
+    void clear();
+
+private:
+    HTTPCache();
+
+    void update_freshness(Entry&) const;
+    void insert_into_memory(NonnullRefPtr<Entry>);
+    void remove_from_memory(const String& url);
+    void evict_from_memory_if_needed();
+
+    String path_for(const String& url) const;
+    RefPtr<Entry> read_from_disk(const String& url);
+    void write_to_disk(const Entry&);
+    void evict_from_disk_if_needed();
+
+    HashMap<String, NonnullRefPtr<Entry>> m_entries;
+    size_t m_memory_usage { 0 };
+    u64 m_use_counter { 0 };
+
+    String m_disk_cache_path;
+    bool m_has_disk_cache { false };
+    Optional<size_t> m_disk_usage;
+};
+
+}
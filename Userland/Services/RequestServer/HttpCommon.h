@@ -71,7 +71,7 @@ OwnPtr<Request> start_request(TBadgedProtocol&& protocol, ClientConnection& clie
     request.set_headers(headers);
     request.set_body(body);
 
-    auto output_stream = make<OutputFileStream>(pipe_result.value().write_fd);
+    auto output_stream = make<ResponseBodyStream>(pipe_result.value().write_fd);
     output_stream->make_unbuffered();
     auto job = TJob::construct(request, *output_stream);
     auto protocol_request = TRequest::create_with_job(forward<TBadgedProtocol>(protocol), client, (TJob&)*job, move(output_stream));
@@ -11,7 +11,7 @@
 
 namespace RequestServer {
 
-HttpRequest::HttpRequest(ClientConnection& client, NonnullRefPtr<HTTP::HttpJob> job, NonnullOwnPtr<OutputFileStream>&& output_stream)
+HttpRequest::HttpRequest(ClientConnection& client, NonnullRefPtr<HTTP::HttpJob> job, NonnullOwnPtr<ResponseBodyStream>&& output_stream)
     : Request(client, move(output_stream))
     , m_job(job)
 {
@@ -25,7 +25,7 @@ HttpRequest::~HttpRequest()
     m_job->shutdown();
 }
 
-NonnullOwnPtr<HttpRequest> HttpRequest::create_with_job(Badge<HttpProtocol>&&, ClientConnection& client, NonnullRefPtr<HTTP::HttpJob> job, NonnullOwnPtr<OutputFileStream>&& output_stream)
+NonnullOwnPtr<HttpRequest> HttpRequest::create_with_job(Badge<HttpProtocol>&&, ClientConnection& client, NonnullRefPtr<HTTP::HttpJob> job, NonnullOwnPtr<ResponseBodyStream>&& output_stream)
 {
     return adopt_own(*new HttpRequest(client, move(job), move(output_stream)));
 }
@@ -22,14 +22,15 @@ public:
 
     static Protocol* find_by_name(const String&);
 
-protected:
-    explicit Protocol(const String& name);
     struct Pipe {
         int read_fd { -1 };
         int write_fd { -1 };
     };
     static Result<Pipe, String> get_pipe_for_request();
 
+protected:
+    explicit Protocol(const String& name);
+
 private:
     String m_name;
 };
@@ -5,6 +5,7 @@
  */
 
 #include <AK/Badge.h>
+#include <LibCore/Timer.h>
 #include <RequestServer/ClientConnection.h>
 #include <RequestServer/Request.h>
 
@@ -13,7 +14,7 @@ namespace RequestServer {
 // FIXME: What about rollover?
 static i32 s_next_id = 1;
 
-Request::Request(ClientConnection& client, NonnullOwnPtr<OutputFileStream>&& output_stream)
+Request::Request(ClientConnection& client, NonnullOwnPtr<ResponseBodyStream>&& output_stream)
     : m_client(client)
     , m_id(s_next_id++)
     , m_output_stream(move(output_stream))
@@ -29,18 +30,80 @@ void Request::stop()
     m_client.did_finish_request({}, *this, false);
 }
 
+void Request::set_cacheable(const URL& url, RefPtr<HTTPCache::Entry> entry_being_revalidated)
+{
+    m_cache_url = url;
+    m_is_cacheable = true;
+    m_entry_being_revalidated = move(entry_being_revalidated);
+    m_output_stream->keep_copy(HTTPCache::max_body_size);
+}
+
+void Request::set_invalidates_cached_response(const URL& url)
+{
+    m_cache_url = url;
+    m_invalidates_cached_response = true;
+}
+
 void Request::set_response_headers(const HashMap<String, String, CaseInsensitiveStringTraits>& response_headers)
 {
-    m_response_headers = response_headers;
+    if (m_entry_being_revalidated && m_status_code == 304u) {
+        // The job reports the headers again when it finishes, so only revalidate once.
+        if (!m_cached_response)
+            m_cached_response = HTTPCache::the().did_revalidate(*m_entry_being_revalidated, response_headers);
+        m_status_code = m_cached_response->status_code();
+        m_response_headers = m_cached_response->response_headers();
+    } else {
+        m_response_headers = response_headers;
+    }
     m_client.did_receive_headers({}, *this);
 }
 
+void Request::send_cached_response(NonnullRefPtr<HTTPCache::Entry> entry)
+{
+    m_cached_response = move(entry);
+    m_status_code = m_cached_response->status_code();
+    set_response_headers(m_cached_response->response_headers());
+    flush_cached_response();
+}
+
+void Request::flush_cached_response()
+{
+    auto body = m_cached_response->body();
+    m_cached_response_offset += m_output_stream->write(body.slice(m_cached_response_offset));
+    m_output_stream->handle_any_error();
+    if (m_cached_response_offset < body.size()) {
+        // The pipe is full, wait for the client to read from it.
+        if (!m_cached_response_flush_timer)
+            m_cached_response_flush_timer = Core::Timer::create_single_shot(50, [this] { flush_cached_response(); });
+        m_cached_response_flush_timer->start();
+        return;
+    }
+    m_downloaded_size = body.size();
+    did_progress(body.size(), body.size());
+    m_client.did_finish_request({}, *this, true);
+}
+
 void Request::set_certificate(String, String)
 {
 }
 
 void Request::did_finish(bool success)
 {
+    if (success && m_cached_response) {
+        // The server only gave us a 304, so the body comes from the cache.
+        flush_cached_response();
+        return;
+    }
+    if (success && m_status_code.has_value()) {
+        if (m_is_cacheable) {
+            if (m_output_stream->has_complete_copy())
+                HTTPCache::the().store(m_cache_url, m_status_code.value(), m_response_headers, m_output_stream->copy());
+            else
+                HTTPCache::the().remove(m_cache_url);
+        } else if (m_invalidates_cached_response && m_status_code.value() < 400) {
+            HTTPCache::the().remove(m_cache_url);
+        }
+    }
     m_client.did_finish_request({}, *this, success);
 }
 
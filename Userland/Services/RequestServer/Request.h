@@ -6,13 +6,15 @@
 
 #pragma once
 
-#include <AK/FileStream.h>
 #include <AK/HashMap.h>
 #include <AK/NonnullOwnPtr.h>
 #include <AK/Optional.h>
 #include <AK/RefCounted.h>
 #include <AK/URL.h>
+#include <LibCore/Forward.h>
 #include <RequestServer/Forward.h>
+#include <RequestServer/HTTPCache.h>
+#include <RequestServer/ResponseBodyStream.h>
 
 namespace RequestServer {
 
@@ -31,6 +33,14 @@ public:
     void stop();
     virtual void set_certificate(String, String);
 
+    // Stores the response in the HTTP cache when the request finishes. If the server says that the
+    // stale entry we asked it to validate is still good, the client gets the stored response instead.
+    void set_cacheable(const URL&, RefPtr<HTTPCache::Entry> entry_being_revalidated);
+    // A successful request with an unsafe method means our stored response for its URL is outdated.
+    void set_invalidates_cached_response(const URL&);
+
+    void send_cached_response(NonnullRefPtr<HTTPCache::Entry>);
+
     // FIXME: Want Badge<Protocol>, but can't make one from HttpProtocol, etc.
     void set_request_fd(int fd) { m_request_fd = fd; }
     int request_fd() const { return m_request_fd; }
@@ -41,12 +51,14 @@ public:
     void did_request_certificates();
     void set_response_headers(const HashMap<String, String, CaseInsensitiveStringTraits>&);
     void set_downloaded_size(size_t size) { m_downloaded_size = size; }
-    const OutputFileStream& output_stream() const { return *m_output_stream; }
+    const ResponseBodyStream& output_stream() const { return *m_output_stream; }
 
 protected:
-    explicit Request(ClientConnection&, NonnullOwnPtr<OutputFileStream>&&);
+    explicit Request(ClientConnection&, NonnullOwnPtr<ResponseBodyStream>&&);
 
 private:
+    void flush_cached_response();
+
     ClientConnection& m_client;
     i32 m_id { 0 };
     int m_request_fd { -1 }; // Passed to client.
@@ -54,8 +66,16 @@ private:
     Optional<u32> m_status_code;
     Optional<u32> m_total_size {};
     size_t m_downloaded_size { 0 };
-    NonnullOwnPtr<OutputFileStream> m_output_stream;
+    NonnullOwnPtr<ResponseBodyStream> m_output_stream;
     HashMap<String, String, CaseInsensitiveStringTraits> m_response_headers;
+
+    URL m_cache_url;
+    bool m_is_cacheable { false };
+    bool m_invalidates_cached_response { false };
+    RefPtr<HTTPCache::Entry> m_entry_being_revalidated;
+    RefPtr<HTTPCache::Entry> m_cached_response;
+    size_t m_cached_response_offset { 0 };
+    RefPtr<Core::Timer> m_cached_response_flush_timer;
 };
 
 }
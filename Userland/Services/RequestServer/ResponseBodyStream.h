@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/ByteBuffer.h>
+#include <AK/FileStream.h>
+
+namespace RequestServer {
+
+// Where a job writes the response body, i.e. the pipe to the client.
+// For responses that may go into the HTTP cache, it also keeps a copy of everything that was written.
+class ResponseBodyStream final : public OutputFileStream {
+public:
+    explicit ResponseBodyStream(int fd)
+        : OutputFileStream(fd)
+    {
+    }
+
+    virtual size_t write(ReadonlyBytes bytes) override
+    {
+        auto nwritten = OutputFileStream::write(bytes);
+        if (m_keeps_copy) {
+            if (m_copy.size() + nwritten > m_max_copy_size)
+                stop_keeping_copy();
+            else
+                m_copy.append(bytes.data(), nwritten);
+        }
+        return nwritten;
+    }
+
+    void keep_copy(size_t max_size)
+    {
+        m_keeps_copy = true;
+        m_max_copy_size = max_size;
+    }
+
+    // False if the body turned out to be too large to keep.
+    bool has_complete_copy() const { return m_keeps_copy; }
+    ReadonlyBytes copy() const { return m_copy; }
+
+private:
+    void stop_keeping_copy()
+    {
+        m_keeps_copy = false;
+        m_copy.clear();
+    }
+
+    bool m_keeps_copy { false };
+    size_t m_max_copy_size { 0 };
+    ByteBuffer m_copy;
+};
+
+}
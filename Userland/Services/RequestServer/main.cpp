@@ -10,12 +10,13 @@
 #include <LibTLS/Certificate.h>
 #include <RequestServer/ClientConnection.h>
 #include <RequestServer/GeminiProtocol.h>
+#include <RequestServer/HTTPCache.h>
 #include <RequestServer/HttpProtocol.h>
 #include <RequestServer/HttpsProtocol.h>
 
 int main(int, char**)
 {
-    if (pledge("stdio inet accept unix rpath sendfd recvfd", nullptr) < 0) {
+    if (pledge("stdio inet accept unix rpath wpath cpath sendfd recvfd", nullptr) < 0) {
         perror("pledge");
         return 1;
     }
@@ -23,9 +24,23 @@ int main(int, char**)
     // Ensure the certificates are read out here.
     [[maybe_unused]] auto& certs = DefaultRootCACertificates::the();
 
+    // The HTTP cache is shared with other RequestServer processes through a directory on disk.
+    // Set it up now, since it has to be created before we can unveil it.
+    auto& http_cache = RequestServer::HTTPCache::the();
+    http_cache.enable_disk_cache(RequestServer::HTTPCache::default_disk_cache_path());
+
     Core::EventLoop event_loop;
     // FIXME: Establish a connection to LookupServer and then drop "unix"?
-    if (pledge("stdio inet accept unix sendfd recvfd", nullptr) < 0) {
+    if (http_cache.has_disk_cache()) {
+        if (pledge("stdio inet accept unix rpath wpath cpath sendfd recvfd", nullptr) < 0) {
+            perror("pledge");
+            return 1;
+        }
+        if (unveil(http_cache.disk_cache_path().characters(), "rwc") < 0) {
+            perror("unveil");
+            return 1;
+        }
+    } else if (pledge("stdio inet accept unix sendfd recvfd", nullptr) < 0) {
         perror("pledge");
         return 1;
     }
@@ -36,6 +36,8 @@ ClientConnection::ClientConnection(NonnullRefPtr<Core::LocalSocket> socket, int
     , m_page_host(PageHost::create(*this))
 {
     s_connections.set(client_id, *this);
+    // HTML and page sources can get big, and we're both pledged to pass fds anyway.
+    enable_out_of_line_messages();
     m_paint_flush_timer = Core::Timer::create_single_shot(0, [this] { flush_pending_paint_requests(); });
 }
 
@@ -112,6 +114,8 @@ void ClientConnection::add_backing_store(i32 backing_store_id, const Gfx::Sharea
 
 void ClientConnection::remove_backing_store(i32 backing_store_id)
 {
+    if (auto it = m_backing_stores.find(backing_store_id); it != m_backing_stores.end())
+        m_page_host->did_remove_backing_store(*it->value);
     m_backing_stores.remove(backing_store_id);
 }
 
@@ -138,8 +142,8 @@ void ClientConnection::paint(const Gfx::IntRect& content_rect, i32 backing_store
 void ClientConnection::flush_pending_paint_requests()
 {
     for (auto& pending_paint : m_pending_paint_requests) {
-        m_page_host->paint(pending_paint.content_rect, *pending_paint.bitmap);
-        async_did_paint(pending_paint.content_rect, pending_paint.bitmap_id);
+        auto changed_rects = m_page_host->paint(pending_paint.content_rect, *pending_paint.bitmap);
+        async_did_paint(pending_paint.content_rect, pending_paint.bitmap_id, move(changed_rects));
     }
     m_pending_paint_requests.clear();
 }
@@ -9,6 +9,7 @@
 #include <LibGfx/Painter.h>
 #include <LibGfx/SystemTheme.h>
 #include <LibWeb/Cookie/ParsedCookie.h>
+#include <LibWeb/HTML/HTMLHtmlElement.h>
 #include <LibWeb/Layout/InitialContainingBlockBox.h>
 #include <LibWeb/Page/BrowsingContext.h>
 #include <WebContent/WebContentClientEndpoint.h>
@@ -44,6 +45,7 @@ Gfx::Palette PageHost::palette() const
 void PageHost::set_palette_impl(const Gfx::PaletteImpl& impl)
 {
     m_palette_impl = impl;
+    m_needs_full_repaint = true;
 }
 
 Web::Layout::InitialContainingBlockBox* PageHost::layout_root()
@@ -54,7 +56,65 @@ Web::Layout::InitialContainingBlockBox* PageHost::layout_root()
     return document->layout_node();
 }
 
-void PageHost::paint(const Gfx::IntRect& content_rect, Gfx::Bitmap& target)
+// Scrolling can only reuse painted content if none of it stays put relative to the viewport.
+static bool can_scroll_by_copying(Web::Layout::InitialContainingBlockBox& layout_root)
+{
+    auto& document = layout_root.document();
+    if (document.background_image())
+        return false;
+    if (auto* html = document.html_element(); html && html->layout_node() && html->layout_node()->has_style()) {
+        if (verify_cast<Web::Layout::NodeWithStyle>(*html->layout_node()).background_image())
+            return false;
+    }
+
+    bool has_fixed_position_boxes = false;
+    layout_root.for_each_in_inclusive_subtree([&](auto& layout_node) {
+        if (!layout_node.is_fixed_position())
+            return IterationDecision::Continue;
+        has_fixed_position_boxes = true;
+        return IterationDecision::Break;
+    });
+    return !has_fixed_position_boxes;
+}
+
+Gfx::DisjointRectSet PageHost::reuse_previous_paint(const Gfx::IntRect& content_rect, Gfx::Bitmap& target, Gfx::Painter& painter)
+{
+    auto previous_bitmap = move(m_previous_paint_bitmap);
+    auto previous_content_rect = m_previous_paint_content_rect;
+    auto invalidated_content_rects = move(m_invalidated_content_rects);
+    bool needs_full_repaint = exchange(m_needs_full_repaint, false);
+
+    if (needs_full_repaint || !previous_bitmap || previous_bitmap->size() != target.size())
+        return content_rect;
+
+    auto reusable_rect = content_rect.intersected(previous_content_rect);
+    if (reusable_rect.is_empty())
+        return content_rect;
+
+    if (previous_content_rect != content_rect) {
+        // Copying within the same bitmap would overwrite pixels that are still to be copied.
+        if (previous_bitmap.ptr() == &target || !can_scroll_by_copying(*layout_root()))
+            return content_rect;
+        painter.blit(reusable_rect.location() - content_rect.location(), *previous_bitmap, reusable_rect.translated(-previous_content_rect.location()));
+    } else if (previous_bitmap.ptr() != &target) {
+        painter.blit({}, *previous_bitmap, reusable_rect.translated(-previous_content_rect.location()));
+    }
+
+    auto content_rects_to_paint = Gfx::DisjointRectSet(content_rect).shatter(reusable_rect);
+    content_rects_to_paint.add(invalidated_content_rects.intersected(reusable_rect));
+
+    // Lots of small rects cost more in repeated tree walks than painting a bit more area does.
+    static constexpr size_t max_rects_to_paint = 16;
+    if (content_rects_to_paint.size() > max_rects_to_paint) {
+        Gfx::IntRect bounding_rect;
+        for (auto& rect : content_rects_to_paint.rects())
+            bounding_rect = bounding_rect.united(rect);
+        return bounding_rect;
+    }
+    return content_rects_to_paint;
+}
+
+Vector<Gfx::IntRect> PageHost::paint(const Gfx::IntRect& content_rect, Gfx::Bitmap& target)
 {
     Gfx::Painter painter(target);
     Gfx::IntRect bitmap_rect { {}, content_rect.size() };
@@ -62,13 +122,38 @@ void PageHost::paint(const Gfx::IntRect& content_rect, Gfx::Bitmap& target)
     auto* layout_root = this->layout_root();
     if (!layout_root) {
         painter.fill_rect(bitmap_rect, Color::White);
-        return;
+        m_previous_paint_bitmap = nullptr;
+        return { bitmap_rect };
+    }
+
+    auto content_rects_to_paint = reuse_previous_paint(content_rect, target, painter);
+    for (auto& rect : content_rects_to_paint.rects()) {
+        Gfx::PainterStateSaver saver(painter);
+        painter.add_clip_rect(rect.translated(-content_rect.location()));
+        painter.fill_rect(bitmap_rect, palette().base());
+
+        Web::PaintContext context(painter, palette(), content_rect.top_left());
+        context.set_should_show_line_box_borders(m_should_show_line_box_borders);
+        context.set_viewport_rect(content_rect);
+        layout_root->paint_all_phases(context);
     }
 
-    Web::PaintContext context(painter, palette(), content_rect.top_left());
-    context.set_should_show_line_box_borders(m_should_show_line_box_borders);
-    context.set_viewport_rect(content_rect);
-    layout_root->paint_all_phases(context);
+    auto previous_content_rect = exchange(m_previous_paint_content_rect, content_rect);
+    m_previous_paint_bitmap = target;
+
+    // After scrolling, every pixel has moved as far as the client is concerned.
+    if (previous_content_rect != content_rect)
+        return { bitmap_rect };
+    Vector<Gfx::IntRect> changed_rects;
+    for (auto& rect : content_rects_to_paint.rects())
+        changed_rects.append(rect.translated(-content_rect.location()));
+    return changed_rects;
+}
+
+void PageHost::did_remove_backing_store(const Gfx::Bitmap& bitmap)
+{
+    if (m_previous_paint_bitmap.ptr() == &bitmap)
+        m_previous_paint_bitmap = nullptr;
 }
 
 void PageHost::set_viewport_rect(const Gfx::IntRect& rect)
@@ -78,11 +163,14 @@ void PageHost::set_viewport_rect(const Gfx::IntRect& rect)
 
 void PageHost::page_did_invalidate(const Gfx::IntRect& content_rect)
 {
+    m_invalidated_content_rects.add(content_rect);
     m_client.async_did_invalidate_content_rect(content_rect);
 }
 
 void PageHost::page_did_change_selection()
 {
+    // Selections aren't invalidated piecemeal, so there's no telling what changed.
+    m_needs_full_repaint = true;
     m_client.async_did_change_selection();
 }
 
@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <LibGfx/DisjointRectSet.h>
 #include <LibGfx/Rect.h>
 #include <LibWeb/Page/Page.h>
 
@@ -24,13 +25,19 @@ public:
     Web::Page& page() { return *m_page; }
     const Web::Page& page() const { return *m_page; }
 
-    void paint(const Gfx::IntRect& content_rect, Gfx::Bitmap&);
+    // Returns the parts of the target bitmap that ended up different from the previously painted one.
+    Vector<Gfx::IntRect> paint(const Gfx::IntRect& content_rect, Gfx::Bitmap&);
+    void did_remove_backing_store(const Gfx::Bitmap&);
 
     void set_palette_impl(const Gfx::PaletteImpl&);
     void set_viewport_rect(const Gfx::IntRect&);
     void set_screen_rects(const Vector<Gfx::IntRect, 4>& rects, size_t main_screen_index) { m_screen_rect = rects[main_screen_index]; };
 
-    void set_should_show_line_box_borders(bool b) { m_should_show_line_box_borders = b; }
+    void set_should_show_line_box_borders(bool b)
+    {
+        m_should_show_line_box_borders = b;
+        m_needs_full_repaint = true;
+    }
 
 private:
     // ^PageClient
@@ -66,12 +73,20 @@ private:
 
     Web::Layout::InitialContainingBlockBox* layout_root();
     void setup_palette();
+    Gfx::DisjointRectSet reuse_previous_paint(const Gfx::IntRect& content_rect, Gfx::Bitmap&, Gfx::Painter&);
 
     ClientConnection& m_client;
     NonnullOwnPtr<Web::Page> m_page;
     RefPtr<Gfx::PaletteImpl> m_palette_impl;
     Gfx::IntRect m_screen_rect;
     bool m_should_show_line_box_borders { false };
+
+    // What the most recent paint left in which bitmap, and what has been invalidated since.
+    // Paints reuse the pixels that are still valid instead of painting the whole viewport again.
+    RefPtr<Gfx::Bitmap> m_previous_paint_bitmap;
+    Gfx::IntRect m_previous_paint_content_rect;
+    Gfx::DisjointRectSet m_invalidated_content_rects;
+    bool m_needs_full_repaint { true };
 };
 
 }
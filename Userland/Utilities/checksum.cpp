@@ -65,8 +65,9 @@ int main(int argc, char** argv)
             continue;
         }
 
+        // Read in large chunks, so that the hash function rather than the syscalls sets the pace on big files.
         while (!file->eof() && !file->has_error())
-            hash.update(file->read(PAGE_SIZE));
+            hash.update(file->read(64 * KiB));
         auto digest = hash.digest();
         auto digest_data = digest.immutable_data();
         StringBuilder builder;
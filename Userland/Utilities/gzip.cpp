@@ -4,27 +4,70 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/Atomic.h>
 #include <AK/MappedFile.h>
+#include <AK/NonnullRefPtrVector.h>
 #include <LibCompress/Gzip.h>
 #include <LibCore/ArgsParser.h>
 #include <LibCore/FileStream.h>
+#include <LibThreading/Thread.h>
 #include <unistd.h>
 
+static Optional<ByteBuffer> compress_in_parallel(ReadonlyBytes input, size_t thread_count)
+{
+    auto chunk_count = Compress::GzipCompressor::chunk_count(input);
+    thread_count = min(thread_count, chunk_count);
+
+    Vector<Optional<Compress::GzipCompressor::CompressedChunk>> compressed_chunks;
+    compressed_chunks.resize(chunk_count);
+    Atomic<size_t> next_chunk_index { 0 };
+
+    // Every thread keeps taking the next chunk nobody has started on yet, and each chunk has its own output slot.
+    NonnullRefPtrVector<Threading::Thread> threads;
+    for (size_t i = 0; i < thread_count; ++i) {
+        threads.append(Threading::Thread::construct([&] {
+            for (size_t chunk_index; (chunk_index = next_chunk_index++) < chunk_count;)
+                compressed_chunks[chunk_index] = Compress::GzipCompressor::compress_chunk(input, chunk_index);
+            return 0;
+        },
+            "gzip worker"));
+        threads.last().start();
+    }
+    for (auto& thread : threads)
+        [[maybe_unused]] auto result = thread.join();
+
+    Vector<Compress::GzipCompressor::CompressedChunk> chunks;
+    chunks.ensure_capacity(chunk_count);
+    for (auto& compressed_chunk : compressed_chunks) {
+        if (!compressed_chunk.has_value())
+            return {};
+        chunks.unchecked_append(compressed_chunk.release_value());
+    }
+    return Compress::GzipCompressor::assemble_chunks(input, chunks);
+}
+
 int main(int argc, char** argv)
 {
     Vector<String> filenames;
     bool keep_input_files { false };
     bool write_to_stdout { false };
+    int thread_count { 0 };
 
     Core::ArgsParser args_parser;
     args_parser.add_option(keep_input_files, "Keep (don't delete) input files", "keep", 'k');
     args_parser.add_option(write_to_stdout, "Write to stdout, keep original files unchanged", "stdout", 'c');
+    args_parser.add_option(thread_count, "Compress in independent chunks on this many threads", "processes", 'p', "N");
     args_parser.add_positional_argument(filenames, "File to compress", "FILE");
     args_parser.parse(argc, argv);
 
     if (write_to_stdout)
         keep_input_files = true;
 
+    if (thread_count < 0) {
+        warnln("Invalid number of threads: {}", thread_count);
+        return 1;
+    }
+
     for (auto const& input_filename : filenames) {
         auto output_filename = String::formatted("{}.gz", input_filename);
 
@@ -37,7 +80,9 @@ int main(int argc, char** argv)
         }
         auto file = file_or_error.value();
 
-        auto compressed_file = Compress::GzipCompressor::compress_all(file->bytes());
+        auto compressed_file = thread_count > 0
+            ? compress_in_parallel(file->bytes(), thread_count)
+            : Compress::GzipCompressor::compress_all(file->bytes());
         if (!compressed_file.has_value()) {
             warnln("Failed gzip compressing input file");
             return 1;
@@ -4,47 +4,394 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/BinaryHeap.h>
+#include <AK/NonnullRefPtrVector.h>
 #include <AK/QuickSort.h>
 #include <AK/String.h>
+#include <AK/StringImpl.h>
 #include <AK/Vector.h>
+#include <LibCore/ArgsParser.h>
+#include <LibThreading/Thread.h>
+#include <ctype.h>
 #include <errno.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
 
-int main([[maybe_unused]] int argc, [[maybe_unused]] char** argv)
+// Runs are merged at most this many at a time; with more runs than that, groups of them get merged into bigger runs first.
+static constexpr size_t max_merge_width = 32;
+
+// Slices of a run smaller than this aren't worth sorting on a separate thread.
+static constexpr size_t min_lines_per_thread = 4096;
+
+struct SortOptions {
+    size_t key_start_field { 0 }; // 0 means the key is the whole line
+    size_t key_end_field { 0 };   // 0 means the key extends to the end of the line
+    Optional<char> field_separator;
+    bool numeric { false };
+    bool reverse { false };
+};
+
+static SortOptions s_options;
+
+static int compare_bytes(StringView a, StringView b)
+{
+    auto result = memcmp(a.characters_without_null_termination(), b.characters_without_null_termination(), min(a.length(), b.length()));
+    if (result != 0)
+        return result;
+    return a.length() < b.length() ? -1 : (a.length() > b.length() ? 1 : 0);
+}
+
+// Returns where the given field (counting from 1) starts, or where it ends if end is true.
+// Without a separator, a field is a run of non-blank characters along with the blanks in front of it.
+static size_t field_boundary(StringView line, size_t field, bool end)
 {
-    if (pledge("stdio", nullptr) > 0) {
+    auto is_separator = [](char c) {
+        return s_options.field_separator.has_value() ? c == s_options.field_separator.value() : isblank(c);
+    };
+
+    size_t position = 0;
+    for (size_t current_field = 1;; ++current_field) {
+        size_t field_end = position;
+        if (!s_options.field_separator.has_value()) {
+            while (field_end < line.length() && isblank(line[field_end]))
+                ++field_end;
+        }
+        while (field_end < line.length() && !is_separator(line[field_end]))
+            ++field_end;
+        if (current_field == field)
+            return end ? field_end : position;
+        if (field_end == line.length())
+            return line.length();
+        position = s_options.field_separator.has_value() ? field_end + 1 : field_end;
+    }
+}
+
+static StringView sort_key(StringView line)
+{
+    if (s_options.key_start_field == 0)
+        return line;
+    auto start = field_boundary(line, s_options.key_start_field, false);
+    auto end = s_options.key_end_field == 0 ? line.length() : field_boundary(line, s_options.key_end_field, true);
+    if (end <= start)
+        return {};
+    return line.substring_view(start, end - start);
+}
+
+// Reads the number at the start of the key: leading blanks, an optional minus sign, digits and an optional fraction.
+// A key that doesn't start with a number counts as zero.
+static double parse_number(StringView key)
+{
+    size_t position = 0;
+    while (position < key.length() && isblank(key[position]))
+        ++position;
+    bool negative = position < key.length() && key[position] == '-';
+    if (negative)
+        ++position;
+
+    double value = 0;
+    for (; position < key.length() && isdigit(key[position]); ++position)
+        value = value * 10 + (key[position] - '0');
+    if (position < key.length() && key[position] == '.') {
+        double scale = 1;
+        for (++position; position < key.length() && isdigit(key[position]); ++position) {
+            scale /= 10;
+            value += (key[position] - '0') * scale;
+        }
+    }
+    return negative ? -value : value;
+}
+
+static int compare_lines(StringView a, StringView b)
+{
+    int result;
+    auto a_key = sort_key(a);
+    auto b_key = sort_key(b);
+    if (s_options.numeric) {
+        auto a_number = parse_number(a_key);
+        auto b_number = parse_number(b_key);
+        result = a_number < b_number ? -1 : (a_number > b_number ? 1 : 0);
+    } else {
+        result = compare_bytes(a_key, b_key);
+    }
+
+    // Lines with equal keys are ordered by their whole text, so the output doesn't depend on how the input was split up.
+    if (result == 0 && (s_options.key_start_field != 0 || s_options.numeric))
+        result = compare_bytes(a, b);
+    return s_options.reverse ? -result : result;
+}
+
+static bool write_line(StringView line, FILE* output)
+{
+    if (fwrite(line.characters_without_null_termination(), 1, line.length(), output) != line.length())
+        return false;
+    return fputc('\n', output) != EOF;
+}
+
+// A sorted part of the lines in memory.
+class SortedSlice {
+public:
+    explicit SortedSlice(Span<String> lines)
+        : m_lines(lines)
+    {
+    }
+
+    bool advance() { return ++m_index < m_lines.size(); }
+    StringView line() const { return m_lines[m_index]; }
+
+private:
+    Span<String> m_lines;
+    size_t m_index { NumericLimits<size_t>::max() };
+};
+
+// A sorted run that was spilled to a temporary file.
+class SpilledRun {
+    AK_MAKE_NONCOPYABLE(SpilledRun);
+
+public:
+    explicit SpilledRun(FILE* file)
+        : m_file(file)
+    {
+    }
+
+    SpilledRun(SpilledRun&& other)
+        : m_file(exchange(other.m_file, nullptr))
+        , m_buffer(exchange(other.m_buffer, nullptr))
+        , m_buffer_size(exchange(other.m_buffer_size, 0))
+        , m_line(other.m_line)
+    {
+    }
+
+    ~SpilledRun()
+    {
+        free(m_buffer);
+        if (m_file)
+            fclose(m_file);
+    }
+
+    bool advance()
+    {
+        auto length = getline(&m_buffer, &m_buffer_size, m_file);
+        if (length <= 0)
+            return false;
+        m_line = { m_buffer, static_cast<size_t>(length) - 1 };
+        return true;
+    }
+
+    StringView line() const { return m_line; }
+
+private:
+    FILE* m_file { nullptr };
+    char* m_buffer { nullptr };
+    size_t m_buffer_size { 0 };
+    StringView m_line;
+};
+
+struct MergeKey {
+    StringView line;
+    bool operator<(MergeKey const& other) const { return compare_lines(line, other.line) < 0; }
+    bool operator<=(MergeKey const& other) const { return compare_lines(line, other.line) <= 0; }
+    bool operator>=(MergeKey const& other) const { return compare_lines(line, other.line) >= 0; }
+};
+
+// Merges the sorted sources into the output, by always writing out the smallest of their current lines.
+template<typename Source>
+static bool merge(Span<Source> sources, FILE* output)
+{
+    VERIFY(sources.size() <= max_merge_width);
+    BinaryHeap<MergeKey, size_t, max_merge_width> heap;
+    for (size_t i = 0; i < sources.size(); ++i) {
+        if (sources[i].advance())
+            heap.insert({ sources[i].line() }, i);
+    }
+    while (!heap.is_empty()) {
+        auto index = heap.pop_min();
+        if (!write_line(sources[index].line(), output))
+            return false;
+        if (sources[index].advance())
+            heap.insert({ sources[index].line() }, index);
+    }
+    return true;
+}
+
+// Sorts the lines in up to thread_count slices on as many threads, and writes them out merged.
+static bool sort_and_write(Vector<String>& lines, size_t thread_count, FILE* output)
+{
+    auto compare = [](auto& a, auto& b) { return compare_lines(a, b) < 0; };
+
+    thread_count = clamp(lines.size() / min_lines_per_thread, static_cast<size_t>(1), thread_count);
+    if (thread_count == 1) {
+        quick_sort(lines, compare);
+        for (auto& line : lines) {
+            if (!write_line(line, output))
+                return false;
+        }
+        return true;
+    }
+
+    Vector<SortedSlice> slices;
+    NonnullRefPtrVector<Threading::Thread> threads;
+    auto slice_length = ceil_div(lines.size(), thread_count);
+    for (size_t start = 0; start < lines.size(); start += slice_length) {
+        auto slice = lines.span().slice(start, min(slice_length, lines.size() - start));
+        slices.append(SortedSlice { slice });
+        threads.append(Threading::Thread::construct([slice, compare]() mutable {
+            quick_sort(slice, compare);
+            return 0;
+        },
+            "sort worker"));
+        threads.last().start();
+    }
+    for (auto& thread : threads)
+        [[maybe_unused]] auto result = thread.join();
+
+    return merge(slices.span(), output);
+}
+
+// Merges groups of runs into bigger ones until they can all be merged at once.
+static bool reduce_runs(Vector<SpilledRun>& runs)
+{
+    while (runs.size() > max_merge_width) {
+        FILE* merged_file = tmpfile();
+        if (!merged_file) {
+            perror("tmpfile");
+            return false;
+        }
+
+        Vector<SpilledRun> group;
+        for (size_t i = 0; i < max_merge_width; ++i)
+            group.append(runs.take_first());
+        if (!merge(group.span(), merged_file) || fflush(merged_file) != 0) {
+            perror("write");
+            fclose(merged_file);
+            return false;
+        }
+        rewind(merged_file);
+        runs.append(SpilledRun { merged_file });
+    }
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    if (pledge("stdio rpath wpath cpath thread", nullptr) < 0) {
         perror("pledge");
         return 1;
     }
 
-    Vector<String> lines;
+    Vector<const char*> paths;
+    const char* key_fields = nullptr;
+    const char* field_separator = nullptr;
+    int buffer_size_in_mib = 64;
+    int thread_count = 1;
+
+    Core::ArgsParser args_parser;
+    args_parser.set_general_help("Sort lines of text. Input that doesn't fit in the buffer is sorted in runs, which are spilled to temporary files and merged.");
+    args_parser.add_option(key_fields, "Sort by the fields START through END (counting from 1), or by START through the end of the line", "key", 'k', "START[,END]");
+    args_parser.add_option(field_separator, "Separate fields by this character instead of by blanks", "field-separator", 't', "SEP");
+    args_parser.add_option(s_options.numeric, "Compare the keys as numbers", "numeric-sort", 'n');
+    args_parser.add_option(s_options.reverse, "Reverse the order", "reverse", 'r');
+    args_parser.add_option(buffer_size_in_mib, "Keep at most this many MiB of lines in memory (64 by default)", "buffer-size", 'S', "MiB");
+    args_parser.add_option(thread_count, "Sort on this many threads", "parallel", 0, "N");
+    args_parser.add_positional_argument(paths, "Files to sort (standard input by default)", "FILE", Core::ArgsParser::Required::No);
+    args_parser.parse(argc, argv);
 
-    for (;;) {
-        char* buffer = nullptr;
-        ssize_t buflen = 0;
-        size_t n;
-        errno = 0;
-        buflen = getline(&buffer, &n, stdin);
-        if (buflen == -1 && errno != 0) {
-            perror("getline");
-            exit(1);
+    if (key_fields) {
+        auto parts = StringView(key_fields).split_view(',', true);
+        auto start = parts.is_empty() ? Optional<unsigned> {} : parts[0].to_uint();
+        auto end = parts.size() == 2 ? parts[1].to_uint() : Optional<unsigned> {};
+        if (parts.size() > 2 || start.value_or(0) == 0 || (parts.size() == 2 && end.value_or(0) < start.value())) {
+            warnln("Invalid key: {}", key_fields);
+            return 1;
+        }
+        s_options.key_start_field = start.value();
+        s_options.key_end_field = end.value_or(0);
+    }
+    if (field_separator) {
+        if (strlen(field_separator) != 1) {
+            warnln("The field separator has to be a single character");
+            return 1;
         }
-        if (buflen == -1)
-            break;
-        lines.append({ buffer, AK::ShouldChomp::Chomp });
+        s_options.field_separator = field_separator[0];
+    }
+    if (buffer_size_in_mib <= 0 || thread_count <= 0) {
+        warnln("The buffer size and number of threads have to be positive");
+        return 1;
     }
+    size_t buffer_size = static_cast<size_t>(buffer_size_in_mib) * MiB;
+
+    if (paths.is_empty())
+        paths.append("-");
+
+    Vector<String> lines;
+    size_t lines_size = 0;
+    Vector<SpilledRun> runs;
+
+    auto spill_run = [&] {
+        FILE* run_file = tmpfile();
+        if (!run_file) {
+            perror("tmpfile");
+            return false;
+        }
+        if (!sort_and_write(lines, thread_count, run_file) || fflush(run_file) != 0) {
+            perror("write");
+            fclose(run_file);
+            return false;
+        }
+        rewind(run_file);
+        runs.append(SpilledRun { run_file });
+        lines.clear();
+        lines_size = 0;
+        return true;
+    };
+
+    char* buffer = nullptr;
+    size_t buffer_capacity = 0;
+    for (auto* path : paths) {
+        bool is_stdin = StringView(path) == "-";
+        FILE* file = is_stdin ? stdin : fopen(path, "r");
+        if (!file) {
+            perror(path);
+            return 1;
+        }
 
-    quick_sort(lines, [](auto& a, auto& b) {
-        return strcmp(a.characters(), b.characters()) < 0;
-    });
+        for (;;) {
+            errno = 0;
+            auto length = getline(&buffer, &buffer_capacity, file);
+            if (length == -1 && errno != 0) {
+                perror("getline");
+                return 1;
+            }
+            if (length == -1)
+                break;
+            lines.append({ buffer, static_cast<size_t>(length), AK::ShouldChomp::Chomp });
+            lines_size += length + sizeof(String) + sizeof(StringImpl);
+            if (lines_size >= buffer_size && !spill_run())
+                return 1;
+        }
 
-    for (auto& line : lines) {
-        fputs(line.characters(), stdout);
-        fputc('\n', stdout);
+        if (!is_stdin)
+            fclose(file);
     }
+    free(buffer);
 
+    // Everything fit in memory, so no merging is needed.
+    if (runs.is_empty()) {
+        if (!sort_and_write(lines, thread_count, stdout)) {
+            perror("write");
+            return 1;
+        }
+        return 0;
+    }
+
+    if (!lines.is_empty() && !spill_run())
+        return 1;
+    if (!reduce_runs(runs))
+        return 1;
+    if (!merge(runs.span(), stdout)) {
+        perror("write");
+        return 1;
+    }
     return 0;
 }
@@ -38,6 +38,7 @@ static bool binary = false;
 static bool interactive = false;
 static bool run_tests = false;
 static int port = 443;
+static int handshake_count = 100;
 static bool in_ci = false;
 
 static struct timeval start_time {
@@ -79,6 +80,7 @@ static int rsa_tests();
 
 // TLS
 static int tls_tests();
+static int tls_handshake_benchmark();
 
 // Big Integer
 static int bigint_tests();
@@ -303,6 +305,7 @@ auto main(int argc, char** argv) -> int
     parser.add_option(suite, "Set the suite used", "suite-name", 'n', "suite name");
     parser.add_option(server, "Set the server to talk to (only for `tls')", "server-address", 's', "server-address");
     parser.add_option(port, "Set the port to talk to (only for `tls')", "port", 'p', "port");
+    parser.add_option(handshake_count, "Number of handshakes to perform (only for `tls-bench')", "handshakes", 0, "count");
     parser.add_option(ca_certs_file, "INI file to read root CA certificates from (only for `tls')", "ca-certs-file", 0, "file");
     parser.add_option(in_ci, "CI Test mode", "ci-mode", 'c');
     parser.parse(argc, argv);
@@ -316,6 +319,7 @@ auto main(int argc, char** argv) -> int
         outln("\tencrypt -- Access encryption functions");
         outln("\tdecrypt -- Access decryption functions");
         outln("\ttls -- Connect to a peer over TLS 1.2");
+        outln("\ttls-bench -- Measure full TLS 1.2 handshakes per second against a peer (suite 'RSA', 'ECDHE' or 'all')");
         outln("\tlist -- List all known modes");
         outln("these modes only contain tests");
         outln("\ttest -- Run every test suite");
@@ -434,6 +438,9 @@ auto main(int argc, char** argv) -> int
             return tls_tests();
         return run(tls);
     }
+    if (mode_sv == "tls-bench") {
+        return tls_handshake_benchmark();
+    }
     if (mode_sv == "test") {
         encrypting = true;
         aes_cbc_tests();
@@ -2055,6 +2062,73 @@ static void tls_test_client_hello()
     loop.exec();
 }
 
+static int tls_handshake_benchmark()
+{
+    StringView key_exchange { suite ?: "all" };
+    TLS::Options options;
+    // The peer is expected to be a local test server with a self-signed certificate.
+    options.validate_certificates = false;
+    options.usable_cipher_suites.clear();
+    for (auto cipher_suite : TLS::Options::default_usable_cipher_suites()) {
+        auto algorithm = TLS::get_key_exchange_algorithm(cipher_suite);
+        if (key_exchange == "all"
+            || (key_exchange == "RSA" && algorithm == TLS::KeyExchangeAlgorithm::RSA)
+            || (key_exchange == "ECDHE" && algorithm == TLS::KeyExchangeAlgorithm::ECDHE_RSA))
+            options.usable_cipher_suites.append(cipher_suite);
+    }
+    if (options.usable_cipher_suites.is_empty()) {
+        warnln("Unknown key exchange '{}', expected 'RSA', 'ECDHE' or 'all'", key_exchange);
+        return 1;
+    }
+
+    auto* the_server = server ?: "localhost";
+    auto session_cache_key = String::formatted("{}:{}", the_server, port);
+
+    Core::EventLoop loop;
+    size_t failures = 0;
+    timeval benchmark_start, benchmark_end;
+    gettimeofday(&benchmark_start, nullptr);
+    for (int i = 0; i < handshake_count; ++i) {
+        // Every handshake should be a full one, so don't let the session cache shortcut it.
+        TLS::SessionCache::the().remove(session_cache_key);
+
+        auto tls = TLS::TLSv12::construct(nullptr, options);
+        bool did_fail = false;
+        tls->on_tls_ready_to_write = [&](auto&) {
+            loop.quit(0);
+        };
+        tls->on_tls_error = [&](auto) {
+            did_fail = true;
+            loop.quit(1);
+        };
+        tls->on_tls_finished = [&] {
+            did_fail = true;
+            loop.quit(1);
+        };
+        if (!tls->connect(the_server, port)) {
+            warnln("connect() failed");
+            return 1;
+        }
+        loop.exec();
+        loop.unquit();
+
+        tls->on_tls_ready_to_write = nullptr;
+        tls->on_tls_error = nullptr;
+        tls->on_tls_finished = nullptr;
+        tls->close();
+        if (did_fail)
+            ++failures;
+    }
+    gettimeofday(&benchmark_end, nullptr);
+
+    timeval elapsed;
+    timersub(&benchmark_end, &benchmark_start, &elapsed);
+    auto elapsed_ms = elapsed.tv_sec * 1000.0 + elapsed.tv_usec / 1000.0;
+    outln("{} handshakes ({} failed) with {} key exchange in {:.1} ms: {:.1} handshakes/s, {:.2} ms/handshake",
+        handshake_count, failures, key_exchange, elapsed_ms, handshake_count * 1000.0 / elapsed_ms, elapsed_ms / handshake_count);
+    return failures ? 1 : 0;
+}
+
 static int adler32_tests()
 {
     auto do_test = [](ReadonlyBytes input, u32 expected_result) {